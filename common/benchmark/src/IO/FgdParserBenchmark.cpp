@@ -0,0 +1,183 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "Assets/EntityDefinition.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/EntityDefinitionClassInfo.h"
+#include "IO/FgdParser.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+
+#include <kdl/vector_utils.h>
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+constexpr auto NumBaseClasses = size_t(64);
+constexpr auto NumIncludes = size_t(16);
+constexpr auto NumPointClassesPerInclude = size_t(250);
+constexpr auto NumProperties = size_t(8);
+
+std::string makeProperties(const std::string& prefix)
+{
+  auto str = std::string{};
+  for (size_t i = 0; i < NumProperties; ++i)
+  {
+    str += fmt::format(
+      "  {0}_{1}(string) : \"{0} property {1}\" : \"default\" : \"Description\"\n",
+      prefix,
+      i);
+  }
+  str += "  spawnflags(flags) =\n  [\n";
+  str += fmt::format("    {} : \"{} flag\" : 0\n", 1 << (prefix.size() % 8), prefix);
+  str += "  ]\n";
+  return str;
+}
+
+/**
+ * Generates a chain of base classes where every base class inherits from the previous
+ * one.
+ */
+std::string makeBaseClasses()
+{
+  auto str = std::string{};
+  for (size_t i = 0; i < NumBaseClasses; ++i)
+  {
+    const auto name = "base_" + std::to_string(i);
+    const auto base = i > 0 ? "base(base_" + std::to_string(i - 1) + ") " : "";
+    str += fmt::format(
+      "@BaseClass {}= {}\n[\n{}]\n\n", base, name, makeProperties(name));
+  }
+  return str;
+}
+
+/**
+ * Generates point classes which inherit from the last base class of the chain and from
+ * some base class in the middle of the chain.
+ */
+std::string makePointClasses(const size_t includeIndex)
+{
+  auto str = std::string{};
+  for (size_t i = 0; i < NumPointClassesPerInclude; ++i)
+  {
+    const auto name = fmt::format("point_{}_{}", includeIndex, i);
+    str += fmt::format(
+      "@PointClass base(base_{}, base_{}) size(-8 -8 -8, 8 8 8) = {} : \"{}\"\n"
+      "[\n{}]\n\n",
+      NumBaseClasses - 1,
+      i % NumBaseClasses,
+      name,
+      name,
+      makeProperties(name));
+  }
+  return str;
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+  auto stream = std::ofstream{path};
+  stream << contents;
+}
+
+std::vector<EntityDefinitionClassInfo> parseFgd(
+  const std::filesystem::path& path, std::vector<EntityDefinitionSourceFile>& sourceFiles)
+{
+  auto file = Disk::openFile(path);
+  auto reader = file->reader().buffer();
+  auto parser =
+    FgdParser{reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, file->path()};
+
+  auto status = TestParserStatus{};
+  auto classInfos = parser.parseResolvedClassInfos(status);
+
+  sourceFiles = kdl::vec_concat(
+    std::vector<EntityDefinitionSourceFile>{
+      {file->path(), hashEntityDefinitionSource(reader.stringView())}},
+    parser.includedFiles());
+  return classInfos;
+}
+} // namespace
+
+TEST_CASE("FgdParserBenchmark.parseIncludes")
+{
+  const auto dir = std::filesystem::temp_directory_path() / "FgdParserBenchmark";
+  std::filesystem::create_directories(dir);
+
+  auto host = makeBaseClasses();
+  for (size_t i = 0; i < NumIncludes; ++i)
+  {
+    const auto filename = "include_" + std::to_string(i) + ".fgd";
+    writeFile(dir / filename, makePointClasses(i));
+    host += "@include \"" + filename + "\"\n";
+  }
+
+  const auto hostPath = dir / "host.fgd";
+  writeFile(hostPath, host);
+
+  const auto numClasses = std::to_string(NumIncludes * NumPointClassesPerInclude);
+  const auto numBaseClasses = std::to_string(NumBaseClasses);
+  const auto numIncludes = std::to_string(NumIncludes);
+
+  auto sourceFiles = std::vector<EntityDefinitionSourceFile>{};
+  auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+  timeLambda(
+    [&]() { classInfos = parseFgd(hostPath, sourceFiles); },
+    "parse " + numClasses + " classes with " + numBaseClasses
+      + " chained base classes in " + numIncludes + " included files");
+
+  CHECK(classInfos.size() == NumIncludes * NumPointClassesPerInclude);
+  CHECK(sourceFiles.size() == NumIncludes + 1);
+
+  auto status = TestParserStatus{};
+  auto cache = EntityDefinitionCache{};
+  cache.setClassInfos(hostPath, sourceFiles, classInfos, {});
+
+  auto definitions = std::vector<Assets::EntityDefinition*>{};
+  timeLambda(
+    [&]() {
+      const auto* cachedClassInfos = cache.classInfos(hostPath, status);
+      REQUIRE(cachedClassInfos != nullptr);
+      definitions =
+        createEntityDefinitions(*cachedClassInfos, Color{1.0f, 1.0f, 1.0f, 1.0f});
+    },
+    "create " + numClasses + " definitions from cached class infos");
+
+  CHECK(definitions.size() == classInfos.size());
+  kdl::vec_clear_and_delete(definitions);
+
+  std::filesystem::remove_all(dir);
+}
+} // namespace IO
+} // namespace TrenchBroom
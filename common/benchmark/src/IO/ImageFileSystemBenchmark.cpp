@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/PathInfo.h"
+#include "IO/ZipFileSystem.h"
+
+#include <kdl/string_format.h>
+
+#include <fmt/format.h>
+
+#include <miniz/miniz.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+/**
+ * Returns the paths of the entries of a synthetic PK3 file with the given number of
+ * files. The files are spread over 100 directories like the textures of a large game.
+ */
+std::vector<std::string> makeEntryPaths(const size_t numFiles)
+{
+  auto result = std::vector<std::string>{};
+  result.reserve(numFiles);
+
+  for (size_t i = 0; i < numFiles; ++i)
+  {
+    result.push_back(fmt::format("textures/set{}/Texture_{}.tga", i % 100, i));
+  }
+  return result;
+}
+
+void writePk3(const std::filesystem::path& path, const std::vector<std::string>& entries)
+{
+  auto archive = mz_zip_archive{};
+  mz_zip_zero_struct(&archive);
+  REQUIRE(mz_zip_writer_init_heap(&archive, 0, 0));
+
+  const auto contents = std::string{"contents"};
+  for (const auto& entry : entries)
+  {
+    REQUIRE(mz_zip_writer_add_mem(
+      &archive, entry.c_str(), contents.data(), contents.size(), MZ_NO_COMPRESSION));
+  }
+
+  void* buffer = nullptr;
+  auto size = size_t(0);
+  REQUIRE(mz_zip_writer_finalize_heap_archive(&archive, &buffer, &size));
+
+  auto stream = std::ofstream{path, std::ios::out | std::ios::binary};
+  stream.write(static_cast<const char*>(buffer), std::streamsize(size));
+  stream.close();
+
+  mz_zip_writer_end(&archive);
+}
+} // namespace
+
+TEST_CASE("ImageFileSystemBenchmark.resolvePaths")
+{
+  constexpr auto NumFiles = size_t(50'000);
+  constexpr auto NumLookups = size_t(100'000);
+
+  const auto entries = makeEntryPaths(NumFiles);
+  const auto pk3Path =
+    std::filesystem::temp_directory_path() / "ImageFileSystemBenchmark.pk3";
+  writePk3(pk3Path, entries);
+
+  {
+    auto fs = std::unique_ptr<ZipFileSystem>{};
+    timeLambda(
+      [&]() { fs = std::make_unique<ZipFileSystem>(pk3Path); },
+      "mount PK3 with " + std::to_string(NumFiles) + " files");
+
+    // mix the case of the lookups to exercise the case insensitive matching
+    auto lookups = std::vector<std::filesystem::path>{};
+    lookups.reserve(NumLookups);
+    for (size_t i = 0; i < NumLookups; ++i)
+    {
+      const auto& entry = entries[(i * 7919) % NumFiles];
+      lookups.emplace_back(i % 2 == 0 ? entry : kdl::str_to_upper(entry));
+    }
+
+    auto numFound = size_t(0);
+    timeLambda(
+      [&]() {
+        for (const auto& path : lookups)
+        {
+          if (fs->pathInfo(path) == PathInfo::File)
+          {
+            ++numFound;
+          }
+        }
+      },
+      "resolve " + std::to_string(NumLookups) + " paths");
+
+    auto numOpened = size_t(0);
+    timeLambda(
+      [&]() {
+        for (const auto& path : lookups)
+        {
+          if (fs->openFile(path))
+          {
+            ++numOpened;
+          }
+        }
+      },
+      "open " + std::to_string(NumLookups) + " files");
+
+    CHECK(numFound == NumLookups);
+    CHECK(numOpened == NumLookups);
+  }
+
+  std::filesystem::remove(pk3Path);
+}
+} // namespace IO
+} // namespace TrenchBroom
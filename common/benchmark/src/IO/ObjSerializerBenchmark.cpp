@@ -0,0 +1,135 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/ExportOptions.h"
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "Model/BezierPatch.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/result.h>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+constexpr auto NumBrushesPerAxis = size_t(40); // 64'000 brushes
+constexpr auto NumPatches = size_t(4'000);
+constexpr auto NumTextures = size_t(64);
+
+/**
+ * Creates a curved 5x5 patch at the given offset.
+ */
+Model::BezierPatch makePatch(const double offset, const std::string& textureName)
+{
+  using P = Model::BezierPatch::Point;
+
+  auto controlPoints = std::vector<P>{};
+  for (size_t row = 0; row < 5; ++row)
+  {
+    for (size_t col = 0; col < 5; ++col)
+    {
+      const auto z = (row % 2 == 1 && col % 2 == 1) ? 16.0 : 0.0;
+      controlPoints.push_back(
+        P{offset + double(col) * 16.0, double(row) * 16.0, z, double(col), double(row)});
+    }
+  }
+  return Model::BezierPatch{5, 5, std::move(controlPoints), textureName};
+}
+
+void addBrushesAndPatches(Model::WorldNode& world)
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = Model::BrushBuilder{world.mapFormat(), worldBounds};
+
+  auto nodes = std::vector<Model::Node*>{};
+  for (size_t x = 0; x < NumBrushesPerAxis; ++x)
+  {
+    for (size_t y = 0; y < NumBrushesPerAxis; ++y)
+    {
+      for (size_t z = 0; z < NumBrushesPerAxis; ++z)
+      {
+        // vary the brush sizes so that the brushes don't share texture coordinates
+        const auto min = vm::vec3{double(x), double(y), double(z)} * 96.0;
+        const auto size = vm::vec3{double(32 + x), double(32 + y), double(32 + z)};
+        const auto textureName = "texture" + std::to_string((x + y + z) % NumTextures);
+        nodes.push_back(new Model::BrushNode{
+          builder.createCuboid(vm::bbox3{min, min + size}, textureName).value()});
+      }
+    }
+  }
+
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto textureName = "texture" + std::to_string(i % NumTextures);
+    nodes.push_back(new Model::PatchNode{makePatch(double(i) * 80.0, textureName)});
+  }
+
+  world.defaultLayer()->addChildren(nodes);
+}
+} // namespace
+
+TEST_CASE("ObjSerializerBenchmark.exportMap")
+{
+  auto world = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+  addBrushesAndPatches(world);
+
+  const auto options =
+    ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+
+  auto objStream = std::ostringstream{};
+  auto mtlStream = std::ostringstream{};
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  timeLambda(
+    [&]() {
+      auto writer = NodeWriter{
+        world,
+        std::make_unique<ObjSerializer>(objStream, mtlStream, "path.mtl", options)};
+      writer.setExporting(true);
+      writer.writeMap();
+    },
+    "export " + std::to_string(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis)
+      + " brushes and " + std::to_string(NumPatches) + " patches to OBJ");
+
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  const auto megabytes = double(objStream.tellp()) / (1024.0 * 1024.0);
+  const auto seconds = std::chrono::duration<double>(end - start).count();
+  printf("Wrote %fMB at %fMB/s\n", megabytes, megabytes / seconds);
+
+  CHECK(objStream.tellp() > 0);
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/WorldNode.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <string>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+/**
+ * Generates a Valve 220 map containing the given number of axis aligned cubes. Every
+ * cube has integer vertices and fractional texture offsets and scales, like most brushes
+ * in real maps.
+ */
+std::string makeValveMap(const size_t numBrushes)
+{
+  auto str = std::string{};
+  str += "{\n\"classname\" \"worldspawn\"\n\"mapversion\" \"220\"\n";
+
+  for (size_t i = 0; i < numBrushes; ++i)
+  {
+    const auto x = double(int(i % 100) * 64 - 3200);
+    const auto y = double(int((i / 100) % 100) * 64 - 3200);
+    const auto z = double(int(i / 10000) * 64 - 3200);
+    const auto offset = double(i % 64) + 0.25;
+
+    str += fmt::format(
+      R"({{
+( {0} {1} {2} ) ( {0} {4} {2} ) ( {0} {1} {5} ) tex{6} [ 0 -1 0 {7} ] [ 0 0 -1 -16 ] 0 0.5 1.25
+( {0} {1} {2} ) ( {0} {1} {5} ) ( {3} {1} {2} ) tex{6} [ 1 0 0 {7} ] [ 0 0 -1 -16 ] 0 0.5 1.25
+( {0} {1} {2} ) ( {3} {1} {2} ) ( {0} {4} {2} ) tex{6} [ -1 0 0 {7} ] [ 0 -1 0 -16 ] 0 0.5 1.25
+( {3} {4} {5} ) ( {3} {1} {5} ) ( {0} {4} {5} ) tex{6} [ 1 0 0 {7} ] [ 0 -1 0 -16 ] 0 0.5 1.25
+( {3} {4} {5} ) ( {3} {4} {2} ) ( {3} {1} {5} ) tex{6} [ 0 1 0 {7} ] [ 0 0 -1 -16 ] 0 0.5 1.25
+( {3} {4} {5} ) ( {0} {4} {5} ) ( {3} {4} {2} ) tex{6} [ -1 0 0 {7} ] [ 0 0 -1 -16 ] 0 0.5 1.25
+}}
+)",
+      x,
+      y,
+      z,
+      x + 64.0,
+      y + 64.0,
+      z + 64.0,
+      i % 256,
+      offset);
+  }
+
+  str += "}\n";
+  return str;
+}
+} // namespace
+
+TEST_CASE("WorldReaderBenchmark.loadValveMap")
+{
+  constexpr auto NumBrushes = size_t(100'000);
+
+  const auto data = makeValveMap(NumBrushes);
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto status = TestParserStatus{};
+  auto reader = WorldReader{data, Model::MapFormat::Valve, {}};
+
+  auto world = std::unique_ptr<Model::WorldNode>{};
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  timeLambda(
+    [&]() { world = reader.read(worldBounds, status); },
+    "load " + std::to_string(NumBrushes) + " brushes");
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  const auto megabytes = double(data.size()) / (1024.0 * 1024.0);
+  const auto seconds = std::chrono::duration<double>(end - start).count();
+  printf("Parsed %fMB at %fMB/s\n", megabytes, megabytes / seconds);
+
+  REQUIRE(world != nullptr);
+  CHECK(world->defaultLayer()->childCount() == NumBrushes);
+}
+} // namespace IO
+} // namespace TrenchBroom
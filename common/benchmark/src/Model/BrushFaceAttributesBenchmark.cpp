@@ -0,0 +1,161 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/interned_string.h>
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NumBrushes = size_t(100'000);
+constexpr auto NumTextures = size_t(64);
+
+std::vector<std::string> makeTextureNames()
+{
+  auto result = std::vector<std::string>{};
+  for (size_t i = 0; i < NumTextures; ++i)
+  {
+    // long enough to not fit into the small string buffer
+    result.push_back("base_wall/metal_panel_" + std::to_string(i));
+  }
+  return result;
+}
+
+std::vector<Brush> makeBrushes(const std::vector<std::string>& textureNames)
+{
+  const auto builder = BrushBuilder{MapFormat::Standard, vm::bbox3{8192.0}};
+
+  auto result = std::vector<Brush>{};
+  result.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    const auto min = vm::vec3::fill(double(i % 64) * 16.0);
+    const auto bounds = vm::bbox3{min, min + vm::vec3::fill(16.0)};
+    const auto& textureName = textureNames[i % textureNames.size()];
+    result.push_back(builder.createCuboid(bounds, textureName).value());
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("BrushFaceAttributesBenchmark.copyTextureNames")
+{
+  const auto textureNames = makeTextureNames();
+  const auto brushes = makeBrushes(textureNames);
+
+  auto faceCount = size_t(0);
+  for (const auto& brush : brushes)
+  {
+    faceCount += brush.faceCount();
+  }
+
+  auto stringNames = std::vector<std::string>{};
+  auto internedNames = std::vector<kdl::interned_string>{};
+  stringNames.reserve(faceCount);
+  internedNames.reserve(faceCount);
+  for (const auto& brush : brushes)
+  {
+    for (const auto& face : brush.faces())
+    {
+      stringNames.push_back(face.attributes().textureName());
+      internedNames.push_back(face.attributes().internedTextureName());
+    }
+  }
+
+  const auto count = std::to_string(faceCount);
+
+  auto stringCopies = std::vector<std::string>{};
+  timeLambda(
+    [&]() { stringCopies = stringNames; },
+    "copy " + count + " texture names as std::string");
+
+  auto internedCopies = std::vector<kdl::interned_string>{};
+  timeLambda(
+    [&]() { internedCopies = internedNames; },
+    "copy " + count + " texture names as kdl::interned_string");
+
+  auto attributeCopies = std::vector<BrushFaceAttributes>{};
+  timeLambda(
+    [&]() {
+      attributeCopies.clear();
+      attributeCopies.reserve(faceCount);
+      for (const auto& brush : brushes)
+      {
+        for (const auto& face : brush.faces())
+        {
+          attributeCopies.push_back(face.attributes());
+        }
+      }
+    },
+    "copy " + count + " brush face attributes");
+
+  auto brushCopies = std::vector<Brush>{};
+  timeLambda(
+    [&]() { brushCopies = brushes; }, "copy " + std::to_string(NumBrushes) + " brushes");
+
+  // every std::string copy owns a heap allocation for its characters, while an interned
+  // string is a pointer to a pooled string which is stored only once
+  auto stringBytes = size_t(0);
+  for (const auto& name : stringNames)
+  {
+    stringBytes += sizeof(std::string) + name.capacity() + 1;
+  }
+
+  auto pooledBytes = size_t(0);
+  for (const auto& name : textureNames)
+  {
+    pooledBytes += sizeof(std::string) + name.capacity() + 1;
+  }
+  const auto internedBytes = faceCount * sizeof(kdl::interned_string) + pooledBytes;
+
+  printf(
+    "Memory used by %s texture names: %zu bytes as std::string, %zu bytes as "
+    "kdl::interned_string\n",
+    count.c_str(),
+    stringBytes,
+    internedBytes);
+
+  CHECK(stringCopies == stringNames);
+  CHECK(internedCopies == internedNames);
+  CHECK(attributeCopies.size() == faceCount);
+  CHECK(brushCopies == brushes);
+  CHECK(internedBytes < stringBytes);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,161 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushPickCache.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NumBrushes = size_t(100);
+constexpr auto NumRaysPerBrush = size_t(10000);
+
+/**
+ * Creates a prism with the given number of sides, rotated by the given angle around an
+ * oblique axis so that none of its faces are axis aligned.
+ */
+Brush makeRotatedPrism(
+  const BrushBuilder& builder,
+  const vm::bbox3& worldBounds,
+  const size_t sides,
+  const double angle)
+{
+  auto points = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < sides; ++i)
+  {
+    const auto a = 2.0 * vm::constants<double>::pi() * double(i) / double(sides);
+    const auto x = std::round(64.0 * std::cos(a));
+    const auto y = std::round(64.0 * std::sin(a));
+    points.emplace_back(x, y, -32.0);
+    points.emplace_back(x, y, 32.0);
+  }
+
+  auto brush = builder.createBrush(points, "texture").value();
+  REQUIRE(brush
+            .transform(
+              worldBounds,
+              vm::rotation_matrix(vm::normalize(vm::vec3{1, 2, 3}), angle),
+              false)
+            .is_success());
+  return brush;
+}
+
+std::optional<std::tuple<FloatType, size_t>> findFaceHitNaive(
+  const Brush& brush, const vm::ray3& ray)
+{
+  for (size_t i = 0u; i < brush.faceCount(); ++i)
+  {
+    const auto distance = brush.face(i).intersectWithRay(ray);
+    if (!vm::is_nan(distance))
+    {
+      return std::make_tuple(distance, i);
+    }
+  }
+  return std::nullopt;
+}
+} // namespace
+
+TEST_CASE("BrushPickCacheBenchmark.findFaceHit")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brushes = std::vector<Brush>{};
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    brushes.push_back(
+      makeRotatedPrism(builder, worldBounds, 8 + i % 24, vm::to_radians(double(i))));
+  }
+
+  const auto caches =
+    kdl::vec_transform(brushes, [](const auto& brush) { return BrushPickCache{brush}; });
+
+  // rays which pass through the bounds of the brushes, like the ones that reach
+  // BrushNode::findFaceHit
+  auto randEngine = std::mt19937{};
+  auto coord = std::uniform_real_distribution<double>{-80.0, 80.0};
+  auto rays = std::vector<vm::ray3>{};
+  for (size_t i = 0; i < NumRaysPerBrush; ++i)
+  {
+    const auto origin =
+      vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)} * 4.0;
+    const auto target = vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)};
+    rays.emplace_back(origin, vm::normalize(target - origin));
+  }
+
+  const auto count = std::to_string(NumBrushes * NumRaysPerBrush);
+
+  auto naiveHits = std::vector<std::optional<std::tuple<FloatType, size_t>>>{};
+  naiveHits.reserve(NumBrushes * NumRaysPerBrush);
+  timeLambda(
+    [&]() {
+      for (const auto& brush : brushes)
+      {
+        for (const auto& ray : rays)
+        {
+          naiveHits.push_back(findFaceHitNaive(brush, ray));
+        }
+      }
+    },
+    "find " + count + " face hits by testing every face");
+
+  auto cachedHits = std::vector<std::optional<std::tuple<FloatType, size_t>>>{};
+  cachedHits.reserve(NumBrushes * NumRaysPerBrush);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < brushes.size(); ++i)
+      {
+        for (const auto& ray : rays)
+        {
+          cachedHits.push_back(caches[i].findFaceHit(brushes[i], ray));
+        }
+      }
+    },
+    "find " + count + " face hits using pick cache");
+
+  CHECK(cachedHits == naiveHits);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
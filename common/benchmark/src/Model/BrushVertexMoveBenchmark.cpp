@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NumBrushes = size_t(100);
+constexpr auto NumDragSteps = size_t(10);
+
+/**
+ * Creates a prism with the given number of sides at the given offset.
+ */
+Brush makePrism(const BrushBuilder& builder, const size_t sides, const vm::vec3& offset)
+{
+  auto points = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < sides; ++i)
+  {
+    const auto a = 2.0 * vm::constants<double>::pi() * double(i) / double(sides);
+    const auto x = std::round(64.0 * std::cos(a));
+    const auto y = std::round(64.0 * std::sin(a));
+    points.push_back(offset + vm::vec3{x, y, -32.0});
+    points.push_back(offset + vm::vec3{x, y, 32.0});
+  }
+
+  return builder.createBrush(points, "texture").value();
+}
+} // namespace
+
+TEST_CASE("BrushVertexMoveBenchmark.dragVertex")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+
+  // every brush shares the dragged vertex, like a selection of brushes that meet at the
+  // dragged vertex
+  auto brushes = std::vector<Brush>{};
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    brushes.push_back(makePrism(builder, 6 + i % 6, vm::vec3{-64.0, 0.0, 0.0}));
+  }
+  const auto initialVertex = vm::vec3{0.0, 0.0, 32.0};
+
+  // each drag step moves the vertex a little further, like a mouse drag would
+  const auto delta = vm::vec3{1.0, 1.0, 1.0};
+  const auto count = std::to_string(NumBrushes);
+  const auto steps = std::to_string(NumDragSteps);
+
+  auto checkedBrushes = brushes;
+  timeLambda(
+    [&]() {
+      auto vertex = initialVertex;
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        for (auto& brush : checkedBrushes)
+        {
+          if (brush.canMoveVertices(worldBounds, {vertex}, delta))
+          {
+            REQUIRE(
+              brush.moveVertices(worldBounds, {vertex}, delta, true).is_success());
+          }
+        }
+        vertex = vertex + delta;
+      }
+    },
+    "drag a vertex of " + count + " brushes " + steps
+      + " times using canMoveVertices and moveVertices");
+
+  auto preparedBrushes = brushes;
+  timeLambda(
+    [&]() {
+      auto vertex = initialVertex;
+      for (size_t i = 0; i < NumDragSteps; ++i)
+      {
+        for (auto& brush : preparedBrushes)
+        {
+          if (auto move = brush.prepareMoveVertices(worldBounds, {vertex}, delta))
+          {
+            REQUIRE(
+              brush.applyVertexMove(worldBounds, std::move(*move), true).is_success());
+          }
+        }
+        vertex = vertex + delta;
+      }
+    },
+    "drag a vertex of " + count + " brushes " + steps + " times using prepared moves");
+
+  CHECK(preparedBrushes == checkedBrushes);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,159 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/EmptyPropertyKeyValidator.h"
+#include "Model/EmptyPropertyValueValidator.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Issue.h"
+#include "Model/IssueValidation.h"
+#include "Model/LayerNode.h"
+#include "Model/LongPropertyValueValidator.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingClassnameValidator.h"
+#include "Model/NonIntegerVerticesValidator.h"
+#include "Model/WorldBoundsValidator.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NodeCount = size_t(100'000);
+
+/**
+ * Adds brushes and entities to the default layer of the given world in alternating
+ * order. Some of the brushes have non-integer vertices and some of the entities have
+ * properties with empty values, so that the validators find some issues.
+ */
+std::vector<Node*> addNodes(WorldNode& world, const BrushBuilder& builder)
+{
+  auto nodes = std::vector<Node*>{};
+  nodes.reserve(NodeCount);
+
+  for (size_t i = 0; i < NodeCount / 2; ++i)
+  {
+    const auto offset = i % 10 == 0 ? 0.5 : 0.0;
+    const auto min = vm::vec3{double(i % 100) * 80.0, double(i / 100) * 8.0, offset};
+    const auto bounds = vm::bbox3{min, min + vm::vec3{64, 4, 64}};
+    nodes.push_back(new BrushNode{builder.createCuboid(bounds, "texture").value()});
+
+    auto properties = std::vector<EntityProperty>{
+      {"classname", "light"},
+      {"origin", std::to_string(i % 100) + " 0 0"},
+    };
+    if (i % 10 == 0)
+    {
+      properties.emplace_back("target", "");
+    }
+    nodes.push_back(new EntityNode{Entity{{}, std::move(properties)}});
+  }
+
+  world.defaultLayer()->addChildren(nodes);
+  return nodes;
+}
+} // namespace
+
+TEST_CASE("IssueValidationBenchmark.validateIssues")
+{
+  constexpr auto mapFormat = MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto world = WorldNode{{}, {}, mapFormat};
+  const auto nodes = addNodes(world, builder);
+
+  const auto nonIntegerVerticesValidator = NonIntegerVerticesValidator{};
+  const auto worldBoundsValidator = WorldBoundsValidator{worldBounds};
+  const auto emptyPropertyKeyValidator = EmptyPropertyKeyValidator{};
+  const auto emptyPropertyValueValidator = EmptyPropertyValueValidator{};
+  const auto longPropertyValueValidator = LongPropertyValueValidator{1023};
+  const auto missingClassnameValidator = MissingClassnameValidator{};
+  const auto validators = std::vector<const Validator*>{
+    &nonIntegerVerticesValidator,
+    &worldBoundsValidator,
+    &emptyPropertyKeyValidator,
+    &emptyPropertyValueValidator,
+    &longPropertyValueValidator,
+    &missingClassnameValidator,
+  };
+
+  const auto nodeCount = std::to_string(nodes.size());
+  const auto invalidateAll = [&]() {
+    for (auto* node : nodes)
+    {
+      node->invalidateIssues();
+    }
+  };
+
+  // this is what the issue browser did before validation was parallelized
+  auto serialIssues = std::vector<const Issue*>{};
+  invalidateAll();
+  timeLambda(
+    [&]() {
+      for (auto* node : nodes)
+      {
+        serialIssues = kdl::vec_concat(std::move(serialIssues), node->issues(validators));
+      }
+    },
+    "validate " + nodeCount + " nodes serially");
+  const auto serialTypes =
+    kdl::vec_transform(serialIssues, [](const auto* issue) { return issue->type(); });
+
+  auto parallelIssues = std::vector<const Issue*>{};
+  invalidateAll();
+  timeLambda(
+    [&]() { parallelIssues = validateIssues(nodes, validators); },
+    "validate " + nodeCount + " nodes in parallel");
+  const auto parallelTypes =
+    kdl::vec_transform(parallelIssues, [](const auto* issue) { return issue->type(); });
+
+  CHECK(parallelTypes == serialTypes);
+  CHECK(parallelIssues.size() == NodeCount / 10);
+
+  auto* entityNode = static_cast<EntityNode*>(nodes[1]);
+  auto entity = entityNode->entity();
+  entity.addOrUpdateProperty({}, "target", "t1");
+  entityNode->setEntity(std::move(entity));
+
+  auto incrementalIssues = std::vector<const Issue*>{};
+  timeLambda(
+    [&]() { incrementalIssues = validateIssues(nodes, validators); },
+    "revalidate " + nodeCount + " nodes after changing one entity");
+  CHECK(incrementalIssues.size() == parallelIssues.size() - 1u);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeContents.h"
+#include "Model/UpdateLinkedGroupsError.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NumLinkedGroups = size_t(50);
+constexpr auto NumBrushesPerGroup = size_t(500);
+
+/**
+ * Creates a group containing a row of cube brushes.
+ */
+std::unique_ptr<GroupNode> makeSourceGroup(const BrushBuilder& builder)
+{
+  auto groupNode = std::make_unique<GroupNode>(Group{"group"});
+  for (size_t i = 0; i < NumBrushesPerGroup; ++i)
+  {
+    const auto min = vm::vec3{double(i % 50) * 80.0, double(i / 50) * 80.0, 0.0};
+    const auto bounds = vm::bbox3{min, min + vm::vec3::fill(64.0)};
+    groupNode->addChild(new BrushNode{builder.createCuboid(bounds, "texture").value()});
+  }
+  return groupNode;
+}
+} // namespace
+
+TEST_CASE("LinkedGroupsBenchmark.updateSingleBrush")
+{
+  constexpr auto mapFormat = MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto sourceGroupNode = makeSourceGroup(builder);
+
+  auto targetGroupNodes = std::vector<std::unique_ptr<GroupNode>>{};
+  for (size_t i = 0; i < NumLinkedGroups; ++i)
+  {
+    auto* groupNode =
+      static_cast<GroupNode*>(sourceGroupNode->cloneRecursively(worldBounds));
+    auto group = groupNode->group();
+    group.transform(vm::translation_matrix(vm::vec3{0.0, 0.0, double(i + 1) * 80.0}));
+    groupNode->setGroup(std::move(group));
+    targetGroupNodes.emplace_back(groupNode);
+  }
+  const auto targetGroupNodePtrs =
+    kdl::vec_transform(targetGroupNodes, [](const auto& g) { return g.get(); });
+
+  // edit a single brush of the source group
+  auto* changedBrushNode =
+    static_cast<BrushNode*>(sourceGroupNode->children()[NumBrushesPerGroup / 2]);
+  auto brush = changedBrushNode->brush();
+  REQUIRE(
+    brush.transform(worldBounds, vm::translation_matrix(vm::vec3{0.0, 0.0, 8.0}), false)
+      .is_success());
+  changedBrushNode->setBrush(std::move(brush));
+
+  const auto description = std::to_string(NumLinkedGroups) + " linked groups with "
+                           + std::to_string(NumBrushesPerGroup) + " brushes";
+
+  auto fullUpdateCount = size_t(0);
+  timeLambda(
+    [&]() {
+      updateLinkedGroups(*sourceGroupNode, targetGroupNodePtrs, worldBounds)
+        .transform([&](const auto& r) { fullUpdateCount = r.size(); });
+    },
+    "update " + description + " by replacing all children");
+
+  auto changedNodeCount = size_t(0);
+  timeLambda(
+    [&]() {
+      updateLinkedGroupNodes(
+        *sourceGroupNode, {changedBrushNode}, targetGroupNodePtrs, worldBounds)
+        .transform([&](const auto& r) { changedNodeCount = r.size(); });
+    },
+    "update " + description + " by updating the changed brush");
+
+  CHECK(fullUpdateCount == NumLinkedGroups);
+  CHECK(changedNodeCount == NumLinkedGroups);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,147 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelUtils.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto NumBrushesPerAxis = size_t(48); // 110'592 brushes
+constexpr auto BrushSize = 64.0;
+constexpr auto BrushSpacing = 80.0;
+
+/**
+ * Adds a regular grid of cube brushes to the default layer of the given world.
+ */
+void addBrushGrid(WorldNode& world, const BrushBuilder& builder)
+{
+  const auto offset = -BrushSpacing * double(NumBrushesPerAxis) / 2.0;
+
+  auto brushes = std::vector<Node*>{};
+  brushes.reserve(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis);
+
+  for (size_t x = 0; x < NumBrushesPerAxis; ++x)
+  {
+    for (size_t y = 0; y < NumBrushesPerAxis; ++y)
+    {
+      for (size_t z = 0; z < NumBrushesPerAxis; ++z)
+      {
+        const auto min = vm::vec3{double(x), double(y), double(z)} * BrushSpacing
+                         + vm::vec3::fill(offset);
+        const auto bounds = vm::bbox3{min, min + vm::vec3::fill(BrushSize)};
+        brushes.push_back(new BrushNode{builder.createCuboid(bounds, "texture").value()});
+      }
+    }
+  }
+
+  world.defaultLayer()->addChildren(brushes);
+}
+
+/**
+ * Creates query brushes which are spread over the grid. Each of them touches a few grid
+ * brushes and contains some others.
+ */
+std::vector<std::unique_ptr<BrushNode>> makeQueryBrushes(
+  const BrushBuilder& builder, const size_t count)
+{
+  const auto extent = BrushSpacing * double(NumBrushesPerAxis);
+
+  auto result = std::vector<std::unique_ptr<BrushNode>>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    // spread the brushes along a diagonal of the grid
+    const auto t = (double(i) + 0.5) / double(count);
+    const auto center = vm::vec3::fill(t * extent - extent / 2.0);
+    const auto bounds =
+      vm::bbox3{center - vm::vec3::fill(100.0), center + vm::vec3::fill(100.0)};
+    result.push_back(
+      std::make_unique<BrushNode>(builder.createCuboid(bounds, "texture").value()));
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("ModelUtilsBenchmark.collectTouchingNodes")
+{
+  constexpr auto mapFormat = MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto world = WorldNode{{}, {}, mapFormat};
+  addBrushGrid(world, builder);
+
+  const auto queryBrushNodes = makeQueryBrushes(builder, 100);
+  const auto queryBrushes =
+    kdl::vec_transform(queryBrushNodes, [](const auto& b) { return b.get(); });
+
+  // Passing the layer instead of the world bypasses the world's spatial index, this is
+  // what every query did before the spatial index was used.
+  const auto worldNodes = std::vector<Node*>{&world};
+  const auto layerNodes = std::vector<Node*>{world.defaultLayer()};
+
+  const auto brushCount = std::to_string(world.defaultLayer()->childCount());
+  const auto queryCount = std::to_string(queryBrushes.size());
+
+  auto touchingWithIndex = std::vector<Node*>{};
+  auto touchingWithoutIndex = std::vector<Node*>{};
+  timeLambda(
+    [&]() { touchingWithIndex = collectTouchingNodes(worldNodes, queryBrushes); },
+    "collect nodes touching " + queryCount + " brushes in " + brushCount
+      + " brushes using spatial index");
+  timeLambda(
+    [&]() { touchingWithoutIndex = collectTouchingNodes(layerNodes, queryBrushes); },
+    "collect nodes touching " + queryCount + " brushes in " + brushCount
+      + " brushes without spatial index");
+  CHECK(touchingWithIndex == touchingWithoutIndex);
+  CHECK_FALSE(touchingWithIndex.empty());
+
+  auto containedWithIndex = std::vector<Node*>{};
+  auto containedWithoutIndex = std::vector<Node*>{};
+  timeLambda(
+    [&]() { containedWithIndex = collectContainedNodes(worldNodes, queryBrushes); },
+    "collect nodes contained in " + queryCount + " brushes in " + brushCount
+      + " brushes using spatial index");
+  timeLambda(
+    [&]() { containedWithoutIndex = collectContainedNodes(layerNodes, queryBrushes); },
+    "collect nodes contained in " + queryCount + " brushes in " + brushCount
+      + " brushes without spatial index");
+  CHECK(containedWithIndex == containedWithoutIndex);
+  CHECK_FALSE(containedWithIndex.empty());
+}
+
+} // namespace Model
+} // namespace TrenchBroom
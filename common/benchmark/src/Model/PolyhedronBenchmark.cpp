@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron3.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+std::vector<vm::vec3> makeCylinderPoints(const size_t sides)
+{
+  auto result = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < sides; ++i)
+  {
+    const auto angle = 2.0 * vm::constants<double>::pi() * double(i) / double(sides);
+    const auto x = std::round(64.0 * std::cos(angle));
+    const auto y = std::round(64.0 * std::sin(angle));
+    result.emplace_back(x, y, -32.0);
+    result.emplace_back(x, y, 32.0);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("PolyhedronBenchmark.copyBrush")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+  const auto brush = builder.createBrush(makeCylinderPoints(24), "texture").value();
+
+  constexpr auto NumCopies = size_t(10000);
+
+  auto copies = std::vector<Brush>{};
+  copies.reserve(NumCopies);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumCopies; ++i)
+      {
+        copies.push_back(brush);
+      }
+    },
+    "copy a brush with " + std::to_string(brush.faceCount()) + " faces "
+      + std::to_string(NumCopies) + " times");
+  timeLambda(
+    [&]() { copies.clear(); }, "destroy " + std::to_string(NumCopies) + " brushes");
+
+  CHECK(copies.empty());
+}
+
+TEST_CASE("PolyhedronBenchmark.subtractBrush")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto minuend = builder.createCube(512.0, "texture").value();
+
+  // a grid of cylinders which pierce the minuend
+  auto subtrahends = std::vector<Brush>{};
+  for (size_t x = 0; x < 4; ++x)
+  {
+    for (size_t y = 0; y < 4; ++y)
+    {
+      auto points = makeCylinderPoints(12);
+      for (auto& point : points)
+      {
+        point = point * vm::vec3{0.5, 0.5, 10.0}
+                + vm::vec3{double(x) * 128.0 - 192.0, double(y) * 128.0 - 192.0, 0.0};
+      }
+      subtrahends.push_back(builder.createBrush(points, "texture").value());
+    }
+  }
+
+  auto subtrahendPtrs = std::vector<const Brush*>{};
+  for (const auto& subtrahend : subtrahends)
+  {
+    subtrahendPtrs.push_back(&subtrahend);
+  }
+
+  constexpr auto NumIterations = size_t(20);
+
+  auto fragmentCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        fragmentCount +=
+          minuend.subtract(MapFormat::Standard, worldBounds, "texture", subtrahendPtrs)
+            .size();
+      }
+    },
+    "subtract " + std::to_string(subtrahends.size()) + " brushes "
+      + std::to_string(NumIterations) + " times");
+
+  CHECK(fragmentCount > 0u);
+}
+
+TEST_CASE("PolyhedronBenchmark.convexHull")
+{
+  auto randEngine = std::mt19937{};
+  auto coord = std::uniform_real_distribution<double>{-1.0, 1.0};
+
+  // random points on a sphere, so that every point is a vertex of the hull
+  auto points = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < 50; ++i)
+  {
+    auto point = vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)};
+    points.push_back(vm::normalize(point) * 1024.0);
+  }
+
+  constexpr auto NumIterations = size_t(100);
+
+  auto vertexCount = size_t(0);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        const auto polyhedron = Polyhedron3{points};
+        vertexCount += polyhedron.vertexCount();
+      }
+    },
+    "build the convex hull of " + std::to_string(points.size()) + " points "
+      + std::to_string(NumIterations) + " times");
+
+  CHECK(vertexCount > 0u);
+}
+
+} // namespace Model
+} // namespace TrenchBroom
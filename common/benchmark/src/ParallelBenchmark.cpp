@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace
+{
+/**
+ * The implementation of kdl::parallel_for before it used a thread pool. Spawns a new set
+ * of threads on every call.
+ */
+template <class L>
+void asyncParallelFor(const size_t count, L&& lambda)
+{
+  const auto numThreads =
+    std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+
+  auto nextIndex = std::atomic<size_t>{0};
+
+  auto threads = std::vector<std::future<void>>{};
+  threads.reserve(numThreads);
+
+  for (size_t i = 0; i < numThreads; ++i)
+  {
+    threads.push_back(std::async(std::launch::async, [&]() {
+      while (true)
+      {
+        const auto ourIndex = nextIndex.fetch_add(1);
+        if (ourIndex >= count)
+        {
+          break;
+        }
+        lambda(ourIndex);
+      }
+    }));
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.wait();
+  }
+}
+
+double work(const size_t i, const size_t iterations)
+{
+  auto result = double(i);
+  for (size_t j = 0; j < iterations; ++j)
+  {
+    result = std::sqrt(result + double(j));
+  }
+  return result;
+}
+
+template <class ParallelFor>
+void runBatches(
+  ParallelFor parallelFor,
+  const size_t numBatches,
+  const size_t batchSize,
+  const size_t iterations,
+  std::vector<double>& results)
+{
+  for (size_t b = 0; b < numBatches; ++b)
+  {
+    parallelFor(
+      batchSize, [&](const size_t i) { results[i] = work(b * batchSize + i, iterations); });
+  }
+}
+
+void benchmark(
+  const size_t numBatches, const size_t batchSize, const size_t iterations)
+{
+  auto asyncResults = std::vector<double>(batchSize);
+  auto poolResults = std::vector<double>(batchSize);
+
+  const auto description = std::to_string(numBatches) + " batches of "
+                           + std::to_string(batchSize) + " items with "
+                           + std::to_string(iterations) + " iterations each";
+
+  timeLambda(
+    [&]() {
+      runBatches(
+        [](const size_t count, auto&& lambda) { asyncParallelFor(count, lambda); },
+        numBatches,
+        batchSize,
+        iterations,
+        asyncResults);
+    },
+    "std::async parallel_for, " + description);
+
+  timeLambda(
+    [&]() {
+      runBatches(
+        [](const size_t count, auto&& lambda) { kdl::parallel_for(count, lambda); },
+        numBatches,
+        batchSize,
+        iterations,
+        poolResults);
+    },
+    "thread pool parallel_for, " + description);
+
+  CHECK(asyncResults == poolResults);
+}
+} // namespace
+
+TEST_CASE("ParallelBenchmark.parallelFor")
+{
+  // make sure that the default thread pool is created outside of the measurements
+  kdl::parallel_for(kdl::default_thread_pool().concurrency(), [](const size_t) {});
+
+  benchmark(10'000, 16, 100);
+  benchmark(1'000, 1'000, 100);
+  benchmark(10, 100'000, 100);
+  benchmark(1, 1'000'000, 100);
+}
+} // namespace TrenchBroom
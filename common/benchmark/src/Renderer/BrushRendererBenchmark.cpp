@@ -28,7 +28,9 @@
 #include "Model/MapFormat.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
 
+#include <kdl/parallel.h>
 #include <kdl/result.h>
 
 #include <algorithm>
@@ -153,5 +155,143 @@ TEST_CASE("BrushRendererBenchmark.benchBrushRenderer")
   kdl::vec_clear_and_delete(brushes);
   kdl::vec_clear_and_delete(textures);
 }
+
+TEST_CASE("BrushRendererBenchmark.churn")
+{
+  auto [brushes, textures] = makeBrushes();
+
+  BrushRenderer r;
+  for (auto* brush : brushes)
+  {
+    r.addBrush(brush);
+  }
+  r.validate();
+
+  const auto brushCount = std::to_string(brushes.size());
+  constexpr auto NumRounds = 10;
+
+  // this is what happens when a large selection is transformed repeatedly: every brush is
+  // invalidated and then validated again
+  timeLambda(
+    [&]() {
+      for (int round = 0; round < NumRounds; ++round)
+      {
+        for (auto* brush : brushes)
+        {
+          r.invalidateBrush(brush);
+        }
+        r.validate();
+      }
+    },
+    "invalidate and validate " + brushCount + " brushes "
+      + std::to_string(NumRounds) + " times");
+
+  // this is what happens when a large selection is selected and deselected repeatedly:
+  // brushes are moved between the renderers
+  timeLambda(
+    [&]() {
+      for (int round = 0; round < NumRounds; ++round)
+      {
+        for (auto* brush : brushes)
+        {
+          r.removeBrush(brush);
+        }
+        for (auto* brush : brushes)
+        {
+          r.addBrush(brush);
+        }
+        r.validate();
+      }
+    },
+    "remove, add and validate " + brushCount + " brushes " + std::to_string(NumRounds)
+      + " times");
+
+  // only the bookkeeping, without the work of validating the brushes
+  timeLambda(
+    [&]() {
+      for (int round = 0; round < NumRounds; ++round)
+      {
+        r.invalidate();
+        for (size_t i = 0; i < brushes.size(); i += 2)
+        {
+          r.removeBrush(brushes[i]);
+        }
+        for (size_t i = 0; i < brushes.size(); i += 2)
+        {
+          r.addBrush(brushes[i]);
+        }
+        for (auto* brush : brushes)
+        {
+          r.invalidateBrush(brush);
+        }
+      }
+    },
+    "invalidate, remove and add " + brushCount + " brushes "
+      + std::to_string(NumRounds) + " times without validating");
+
+  CHECK_FALSE(r.valid());
+  r.validate();
+  CHECK(r.valid());
+
+  kdl::vec_clear_and_delete(brushes);
+  kdl::vec_clear_and_delete(textures);
+}
+
+TEST_CASE("BrushRendererBenchmark.validateVertexCaches")
+{
+  auto [brushes, textures] = makeBrushes();
+
+  const auto invalidateVertexCaches = [&]() {
+    for (auto* brush : brushes)
+    {
+      brush->invalidateVertexCache();
+    }
+  };
+
+  const auto brushCount = std::to_string(brushes.size());
+
+  // the two phases of BrushRenderer::validate: building the vertex caches, which
+  // happens in parallel, and copying them into the vertex and index arrays
+  invalidateVertexCaches();
+  timeLambda(
+    [&]() {
+      for (auto* brush : brushes)
+      {
+        brush->brushRendererBrushCache().validateVertexCache(*brush);
+      }
+    },
+    "build vertex caches of " + brushCount + " brushes serially");
+
+  invalidateVertexCaches();
+  timeLambda(
+    [&]() {
+      kdl::parallel_for(brushes.size(), [&](const size_t i) {
+        brushes[i]->brushRendererBrushCache().validateVertexCache(*brushes[i]);
+      });
+    },
+    "build vertex caches of " + brushCount + " brushes in parallel");
+
+  BrushRenderer r;
+  for (auto* brush : brushes)
+  {
+    r.addBrush(brush);
+  }
+  timeLambda(
+    [&]() { r.validate(); },
+    "validate " + brushCount + " brushes with valid vertex caches");
+
+  r.clear();
+  for (auto* brush : brushes)
+  {
+    r.addBrush(brush);
+  }
+  invalidateVertexCaches();
+  timeLambda(
+    [&]() { r.validate(); },
+    "validate " + brushCount + " brushes with invalid vertex caches");
+
+  kdl::vec_clear_and_delete(brushes);
+  kdl::vec_clear_and_delete(textures);
+}
 } // namespace Renderer
 } // namespace TrenchBroom
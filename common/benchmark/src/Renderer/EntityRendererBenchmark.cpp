@@ -0,0 +1,115 @@
+/*
+ Copyright (C) 2018 Eric Wasylishen
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "../../test/src/Renderer/EntityRendererTestUtils.h"
+#include "Assets/EntityModelManager.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "Logger.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Renderer/EntityRenderer.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+constexpr auto NumEntities = size_t(20'000);
+
+/**
+ * Creates a point entity without a model at the given position.
+ */
+Model::EntityNode* makePointEntity(const size_t i)
+{
+  const auto origin = std::to_string(i % 128 * 64) + " " + std::to_string(i / 128 * 64)
+                      + " 0";
+  return new Model::EntityNode{
+    Model::Entity{{}, {{"classname", "info_null"}, {"origin", origin}}}};
+}
+} // namespace
+
+TEST_CASE("EntityRendererBenchmark.editSingleEntity")
+{
+  auto entityNodes = std::vector<Model::EntityNode*>{};
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    entityNodes.push_back(makePointEntity(i));
+  }
+
+  auto logger = NullLogger{};
+  auto entityModelManager = Assets::EntityModelManager{0, 0, logger};
+  const auto editorContext = Model::EditorContext{};
+  auto r = EntityRenderer{logger, entityModelManager, editorContext};
+
+  const auto entityCount = std::to_string(entityNodes.size());
+  timeLambda(
+    [&]() {
+      for (const auto* entityNode : entityNodes)
+      {
+        r.addEntity(entityNode);
+      }
+      EntityRendererTestAccess::validateBounds(r);
+    },
+    "add and validate " + entityCount + " entities");
+
+  constexpr auto NumEdits = size_t(100);
+  auto* editedEntity = entityNodes[NumEntities / 2];
+
+  // moving an entity only invalidates that entity, the renderer must then only rebuild
+  // its bounds
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEdits; ++i)
+      {
+        editedEntity->setEntity(Model::Entity{
+          {},
+          {{"classname", "info_null"}, {"origin", std::to_string(i) + " 0 0"}}});
+        r.invalidateEntity(editedEntity);
+        EntityRendererTestAccess::validateBounds(r);
+      }
+    },
+    "edit and validate one of " + entityCount + " entities " + std::to_string(NumEdits)
+      + " times");
+
+  // this is what every edit did before entity bounds were validated individually
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEdits; ++i)
+      {
+        r.setBoundsColor(i % 2 == 0 ? Color{1.0f, 0.0f, 0.0f} : Color{0.0f, 1.0f, 0.0f});
+        EntityRendererTestAccess::validateBounds(r);
+      }
+    },
+    "invalidate and validate all " + entityCount + " entities "
+      + std::to_string(NumEdits) + " times");
+
+  r.clear();
+  kdl::vec_clear_and_delete(entityNodes);
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,166 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/FrustumCulling.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <kdl/result.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+constexpr auto NumBrushesPerAxis = size_t(40); // 64'000 brushes
+constexpr auto BrushSize = 64.0;
+constexpr auto BrushSpacing = 80.0;
+constexpr auto NumIndicesPerBrush = size_t(36);
+constexpr auto NumIterations = size_t(100);
+
+/**
+ * Adds a regular grid of cube brushes centered at the origin to the default layer of the
+ * given world and returns the added brushes.
+ */
+std::vector<Model::BrushNode*> addBrushGrid(
+  Model::WorldNode& world, const Model::BrushBuilder& builder)
+{
+  const auto offset = -BrushSpacing * double(NumBrushesPerAxis) / 2.0;
+
+  auto brushes = std::vector<Model::BrushNode*>{};
+  brushes.reserve(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis);
+
+  for (size_t x = 0; x < NumBrushesPerAxis; ++x)
+  {
+    for (size_t y = 0; y < NumBrushesPerAxis; ++y)
+    {
+      for (size_t z = 0; z < NumBrushesPerAxis; ++z)
+      {
+        const auto min = vm::vec3{double(x), double(y), double(z)} * BrushSpacing
+                         + vm::vec3::fill(offset);
+        const auto bounds = vm::bbox3{min, min + vm::vec3::fill(BrushSize)};
+        brushes.push_back(
+          new Model::BrushNode{builder.createCuboid(bounds, "texture").value()});
+      }
+    }
+  }
+
+  world.defaultLayer()->addChildren(brushes.begin(), brushes.end(), brushes.size());
+  return brushes;
+}
+} // namespace
+
+TEST_CASE("FrustumCullingBenchmark.findVisibleNodes")
+{
+  constexpr auto mapFormat = Model::MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = Model::BrushBuilder{mapFormat, worldBounds};
+
+  auto world = Model::WorldNode{{}, {}, mapFormat};
+  const auto brushNodes = addBrushGrid(world, builder);
+
+  // a camera in the middle of the grid, looking diagonally into one of its corners
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    8192.0f,
+    Camera::Viewport{0, 0, 1920, 1080},
+    vm::vec3f{0, 0, 0},
+    vm::normalize(vm::vec3f{1, 1, -0.5f}),
+    vm::vec3f{0, 0, 1}};
+  const auto frustum = ViewFrustum::fromCamera(camera);
+
+  const auto brushCount = std::to_string(brushNodes.size());
+  const auto iterations = std::to_string(NumIterations);
+
+  auto visibleNodes = findVisibleNodes(world, frustum);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        visibleNodes = findVisibleNodes(world, frustum);
+      }
+    },
+    "find visible nodes among " + brushCount + " brushes " + iterations
+      + " times using spatial index");
+
+  auto visibleBrushNodes = std::vector<const Model::BrushNode*>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        visibleBrushNodes.clear();
+        for (const auto* brushNode : brushNodes)
+        {
+          if (frustum.intersects(brushNode->physicalBounds()))
+          {
+            visibleBrushNodes.push_back(brushNode);
+          }
+        }
+      }
+    },
+    "find visible nodes among " + brushCount + " brushes " + iterations
+      + " times without spatial index");
+
+  CHECK_THAT(visibleNodes.brushNodes, Catch::UnorderedEquals(visibleBrushNodes));
+  CHECK_FALSE(visibleBrushNodes.empty());
+  CHECK(visibleBrushNodes.size() < brushNodes.size());
+
+  // the index ranges that each brush would occupy in an index array
+  auto brushIndex = std::unordered_map<const Model::BrushNode*, size_t>{};
+  for (size_t i = 0; i < brushNodes.size(); ++i)
+  {
+    brushIndex[brushNodes[i]] = i;
+  }
+
+  auto ranges = std::vector<IndexRange>{};
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumIterations; ++i)
+      {
+        ranges.clear();
+        for (const auto* brushNode : visibleNodes.brushNodes)
+        {
+          const auto index = brushIndex[brushNode];
+          ranges.push_back({index * NumIndicesPerBrush, NumIndicesPerBrush});
+        }
+        mergeIndexRanges(ranges);
+      }
+    },
+    "collect and merge index ranges of " + std::to_string(visibleNodes.brushNodes.size())
+      + " visible brushes " + iterations + " times");
+
+  CHECK_FALSE(ranges.empty());
+  CHECK(ranges.size() <= visibleNodes.brushNodes.size());
+}
+
+} // namespace Renderer
+} // namespace TrenchBroom
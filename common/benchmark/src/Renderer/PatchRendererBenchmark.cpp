@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "../../test/src/Catch2.h"
+#include "Assets/Texture.h"
+#include "BenchmarkUtils.h"
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchNode.h"
+#include "Renderer/PatchRenderer.h"
+
+#include <kdl/vector_utils.h>
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+constexpr auto NumPatches = size_t(4'000);
+constexpr auto NumTextures = size_t(64);
+
+/**
+ * Creates a curved 5x5 patch at the given offset.
+ */
+Model::BezierPatch makePatch(const double offset, const double height)
+{
+  using P = Model::BezierPatch::Point;
+
+  auto controlPoints = std::vector<P>{};
+  for (size_t row = 0; row < 5; ++row)
+  {
+    for (size_t col = 0; col < 5; ++col)
+    {
+      const auto z = (row % 2 == 1 && col % 2 == 1) ? height : 0.0;
+      controlPoints.push_back(
+        P{offset + double(col) * 16.0, double(row) * 16.0, z, double(col), double(row)});
+    }
+  }
+  return Model::BezierPatch{5, 5, std::move(controlPoints), "texture"};
+}
+} // namespace
+
+TEST_CASE("PatchRendererBenchmark.editSinglePatch")
+{
+  auto textures = std::vector<Assets::Texture*>{};
+  for (size_t i = 0; i < NumTextures; ++i)
+  {
+    textures.push_back(new Assets::Texture{"texture " + std::to_string(i), 64, 64});
+  }
+
+  auto patchNodes = std::vector<Model::PatchNode*>{};
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    auto* patchNode = new Model::PatchNode{makePatch(double(i) * 80.0, 16.0)};
+    patchNode->setTexture(textures[i % NumTextures]);
+    patchNodes.push_back(patchNode);
+  }
+
+  const auto editorContext = Model::EditorContext{};
+  auto r = PatchRenderer{editorContext};
+
+  const auto patchCount = std::to_string(patchNodes.size());
+  timeLambda(
+    [&]() {
+      for (const auto* patchNode : patchNodes)
+      {
+        r.addPatch(patchNode);
+      }
+      r.validate();
+    },
+    "add and validate " + patchCount + " patches");
+
+  constexpr auto NumEdits = size_t(100);
+  auto* editedPatch = patchNodes[NumPatches / 2];
+
+  // editing a patch replaces its grid, the renderer must then only rebuild that patch
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEdits; ++i)
+      {
+        editedPatch->setPatch(makePatch(double(NumPatches / 2) * 80.0, double(i)));
+        editedPatch->setTexture(textures[(NumPatches / 2) % NumTextures]);
+        r.invalidatePatch(editedPatch);
+        r.validate();
+      }
+    },
+    "edit and validate one of " + patchCount + " patches " + std::to_string(NumEdits)
+      + " times");
+
+  // this is what every edit did before patches were validated individually
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumEdits; ++i)
+      {
+        r.invalidate();
+        r.validate();
+      }
+    },
+    "invalidate and validate all " + patchCount + " patches "
+      + std::to_string(NumEdits) + " times");
+
+  CHECK(r.valid());
+
+  r.clear();
+  kdl::vec_clear_and_delete(patchNodes);
+  kdl::vec_clear_and_delete(textures);
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -28,10 +28,44 @@
 #include "Model/EntityNode.h"
 #include "Renderer/TexturedIndexRangeRenderer.h"
 
+#include <kdl/thread_pool.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <utility>
+
 namespace TrenchBroom
 {
 namespace Assets
 {
+namespace
+{
+struct LoadedModel
+{
+  std::filesystem::path path;
+  std::unique_ptr<EntityModel> model;
+  DeferredLogger logger;
+};
+} // namespace
+
+/**
+ * The state shared between the manager and the loading tasks. The tasks only access the
+ * manager's loader, and the manager waits for all tasks to finish before the loader is
+ * changed or destroyed.
+ *
+ * The loader may be used by several tasks and the main thread at the same time, see
+ * IO::EntityModelLoader.
+ */
+struct EntityModelManager::ModelLoadQueue
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t pendingCount = 0;
+  std::vector<LoadedModel> loadedModels;
+  std::function<void()> modelLoadedCallback;
+};
+
 EntityModelManager::EntityModelManager(
   const int magFilter, const int minFilter, Logger& logger)
   : m_logger(logger)
@@ -39,6 +73,7 @@ EntityModelManager::EntityModelManager(
   , m_minFilter(minFilter)
   , m_magFilter(magFilter)
   , m_resetTextureMode(false)
+  , m_loadQueue(std::make_shared<ModelLoadQueue>())
 {
 }
 
@@ -49,6 +84,13 @@ EntityModelManager::~EntityModelManager()
 
 void EntityModelManager::clear()
 {
+  waitForPendingModels();
+  {
+    const auto lock = std::lock_guard{m_loadQueue->mutex};
+    m_loadQueue->loadedModels.clear();
+  }
+  m_pendingModels.clear();
+
   m_renderers.clear();
   m_models.clear();
   m_rendererMismatches.clear();
@@ -76,7 +118,7 @@ void EntityModelManager::setLoader(const IO::EntityModelLoader* loader)
 Renderer::TexturedRenderer* EntityModelManager::renderer(
   const Assets::ModelSpecification& spec) const
 {
-  auto* entityModel = safeGetModel(spec.path);
+  auto* entityModel = model(spec);
 
   if (entityModel == nullptr)
   {
@@ -118,7 +160,7 @@ Renderer::TexturedRenderer* EntityModelManager::renderer(
 const EntityModelFrame* EntityModelManager::frame(
   const Assets::ModelSpecification& spec) const
 {
-  auto* model = this->safeGetModel(spec.path);
+  auto* model = this->model(spec);
   if (model == nullptr)
   {
     return nullptr;
@@ -137,62 +179,126 @@ const EntityModelFrame* EntityModelManager::frame(
   }
 }
 
-EntityModel* EntityModelManager::model(const std::filesystem::path& path) const
+void EntityModelManager::setModelLoadedCallback(
+  std::function<void()> modelLoadedCallback)
 {
-  if (path.empty())
-  {
-    return nullptr;
-  }
+  const auto lock = std::lock_guard{m_loadQueue->mutex};
+  m_loadQueue->modelLoadedCallback = std::move(modelLoadedCallback);
+}
 
-  auto it = m_models.find(path);
-  if (it != std::end(m_models))
+std::vector<std::filesystem::path> EntityModelManager::processLoadedModels()
+{
+  auto loadedModels = std::vector<LoadedModel>{};
   {
-    return it->second.get();
+    const auto lock = std::lock_guard{m_loadQueue->mutex};
+    loadedModels = std::move(m_loadQueue->loadedModels);
+    m_loadQueue->loadedModels.clear();
   }
 
-  if (m_modelMismatches.count(path) > 0)
-  {
-    return nullptr;
-  }
+  auto result = std::vector<std::filesystem::path>{};
+  result.reserve(loadedModels.size());
 
-  try
+  for (auto& loadedModel : loadedModels)
   {
-    const auto [pos, success] = m_models.emplace(path, loadModel(path));
-    assert(success);
-    unused(success);
+    loadedModel.logger.logTo(m_logger);
+    m_pendingModels.erase(loadedModel.path);
 
-    auto* model = pos->second.get();
-    m_unpreparedModels.push_back(model);
+    if (loadedModel.model)
+    {
+      const auto [pos, success] =
+        m_models.emplace(loadedModel.path, std::move(loadedModel.model));
+      assert(success);
+      unused(success);
 
-    m_logger.debug() << "Loaded entity model " << path;
+      m_unpreparedModels.push_back(pos->second.get());
+      m_logger.debug() << "Loaded entity model " << loadedModel.path;
+    }
+    else
+    {
+      m_modelMismatches.insert(loadedModel.path);
+    }
 
-    return model;
-  }
-  catch (const GameException& e)
-  {
-    m_logger.error() << e.what();
-    m_modelMismatches.insert(path);
-    throw;
+    result.push_back(std::move(loadedModel.path));
   }
+
+  return result;
 }
 
-EntityModel* EntityModelManager::safeGetModel(const std::filesystem::path& path) const
+void EntityModelManager::waitForPendingModels() const
 {
-  try
+  auto lock = std::unique_lock{m_loadQueue->mutex};
+  m_loadQueue->condition.wait(lock, [&]() { return m_loadQueue->pendingCount == 0; });
+}
+
+EntityModel* EntityModelManager::model(const ModelSpecification& spec) const
+{
+  if (spec.path.empty())
   {
-    return model(path);
+    return nullptr;
   }
-  catch (const GameException&)
+
+  auto it = m_models.find(spec.path);
+  if (it != std::end(m_models))
   {
-    return nullptr;
+    return it->second.get();
+  }
+
+  if (m_modelMismatches.count(spec.path) == 0 && m_pendingModels.count(spec.path) == 0)
+  {
+    loadModelInBackground(spec);
   }
+
+  return nullptr;
 }
 
-std::unique_ptr<EntityModel> EntityModelManager::loadModel(
-  const std::filesystem::path& path) const
+void EntityModelManager::loadModelInBackground(const ModelSpecification& spec) const
 {
   ensure(m_loader != nullptr, "loader is null");
-  return m_loader->initializeModel(path, m_logger);
+
+  m_pendingModels.insert(spec.path);
+  {
+    const auto lock = std::lock_guard{m_loadQueue->mutex};
+    ++m_loadQueue->pendingCount;
+  }
+
+  kdl::default_thread_pool().submit(
+    [loadQueue = m_loadQueue, loader = m_loader, spec]() {
+      auto loadedModel = LoadedModel{spec.path, nullptr, {}};
+      try
+      {
+        loadedModel.model = loader->initializeModel(spec.path, loadedModel.logger);
+      }
+      catch (const std::exception& e)
+      {
+        loadedModel.logger.error() << e.what();
+      }
+
+      // load the requested frame as well since loading a frame can be expensive, too
+      auto& model = loadedModel.model;
+      if (model && spec.frameIndex < model->frameCount())
+      {
+        try
+        {
+          loader->loadFrame(spec.path, spec.frameIndex, *model, loadedModel.logger);
+        }
+        catch (const std::exception& e)
+        {
+          loadedModel.logger.error() << "Could not load entity model frame " << spec
+                                     << ": " << e.what();
+        }
+      }
+
+      auto lock = std::lock_guard{loadQueue->mutex};
+      loadQueue->loadedModels.push_back(std::move(loadedModel));
+      --loadQueue->pendingCount;
+      loadQueue->condition.notify_all();
+
+      // only notify once until the loaded models are processed
+      if (loadQueue->loadedModels.size() == 1u && loadQueue->modelLoadedCallback)
+      {
+        loadQueue->modelLoadedCallback();
+      }
+    });
 }
 
 void EntityModelManager::loadFrame(
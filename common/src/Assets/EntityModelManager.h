@@ -22,6 +22,7 @@
 #include <kdl/vector_set.h>
 
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -53,9 +54,19 @@ class EntityModelFrame;
 struct ModelSpecification;
 enum class Orientation;
 
+/**
+ * Loads entity models on demand and caches them.
+ *
+ * Models are loaded in the background. Until a requested model has been loaded, the
+ * manager returns null for it, so callers fall back to the bounds of the entity
+ * definition. Loaded models are added to the manager when processLoadedModels is called
+ * on the main thread.
+ */
 class EntityModelManager
 {
 private:
+  struct ModelLoadQueue;
+
   using ModelCache = std::map<std::filesystem::path, std::unique_ptr<EntityModel>>;
   using ModelMismatches = kdl::vector_set<std::filesystem::path>;
   using ModelList = std::vector<EntityModel*>;
@@ -80,6 +91,9 @@ private:
   mutable ModelList m_unpreparedModels;
   mutable RendererList m_unpreparedRenderers;
 
+  mutable kdl::vector_set<std::filesystem::path> m_pendingModels;
+  std::shared_ptr<ModelLoadQueue> m_loadQueue;
+
 public:
   EntityModelManager(int magFilter, int minFilter, Logger& logger);
   ~EntityModelManager();
@@ -92,10 +106,30 @@ public:
 
   const EntityModelFrame* frame(const ModelSpecification& spec) const;
 
+  /**
+   * Sets a callback which is called when a model has finished loading in the background.
+   * The callback is called on the loading thread, so it should only schedule a call to
+   * processLoadedModels on the main thread.
+   */
+  void setModelLoadedCallback(std::function<void()> modelLoadedCallback);
+
+  /**
+   * Adds the models which have finished loading in the background to this manager.
+   *
+   * @return the paths of the models that have finished loading, including those that
+   * could not be loaded
+   */
+  std::vector<std::filesystem::path> processLoadedModels();
+
+  /**
+   * Blocks until all models that are currently loading in the background have finished
+   * loading. This must be called before changing the file system used by the loader.
+   */
+  void waitForPendingModels() const;
+
 private:
-  EntityModel* model(const std::filesystem::path& path) const;
-  EntityModel* safeGetModel(const std::filesystem::path& path) const;
-  std::unique_ptr<EntityModel> loadModel(const std::filesystem::path& path) const;
+  EntityModel* model(const ModelSpecification& spec) const;
+  void loadModelInBackground(const ModelSpecification& spec) const;
   void loadFrame(const ModelSpecification& spec, EntityModel& model) const;
 
 public:
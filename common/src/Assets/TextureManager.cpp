@@ -23,6 +23,7 @@
 #include "Assets/TextureCollection.h"
 #include "Exceptions.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/TextureCache.h"
 #include "Logger.h"
 
 #include <kdl/map_utils.h>
@@ -56,6 +57,11 @@ void TextureManager::reload(
   setTextureCollections(findTextureCollections(fs, textureConfig), fs, textureConfig);
 }
 
+void TextureManager::setTextureCache(std::shared_ptr<IO::TextureCache> textureCache)
+{
+  m_textureCache = std::move(textureCache);
+}
+
 void TextureManager::setTextureCollections(std::vector<TextureCollection> collections)
 {
   for (auto& collection : collections)
@@ -82,7 +88,7 @@ void TextureManager::setTextureCollections(
 
     if (it == collections.end() || !it->loaded())
     {
-      IO::loadTextureCollection(path, fs, textureConfig, m_logger)
+      IO::loadTextureCollection(path, fs, textureConfig, m_logger, m_textureCache.get())
         .or_else([&](const auto& error) {
           if (it == collections.end())
           {
@@ -110,6 +116,11 @@ void TextureManager::setTextureCollections(
     }
   }
 
+  if (m_textureCache)
+  {
+    m_textureCache->trim();
+  }
+
   updateTextures();
   m_toRemove = kdl::vec_concat(std::move(m_toRemove), std::move(collections));
 }
@@ -133,6 +144,7 @@ void TextureManager::clear()
 
   m_toPrepare.clear();
   m_texturesByName.clear();
+  m_texturesByInternedName.clear();
   m_textures.clear();
 
   // Remove logging because it might fail when the document is already destroyed.
@@ -163,6 +175,19 @@ Texture* TextureManager::texture(const std::string& name)
   return const_cast<Texture*>(const_cast<const TextureManager*>(this)->texture(name));
 }
 
+Texture* TextureManager::texture(const kdl::interned_string& name)
+{
+  if (const auto it = m_texturesByInternedName.find(name);
+      it != m_texturesByInternedName.end())
+  {
+    return it->second;
+  }
+
+  auto* result = texture(name.str());
+  m_texturesByInternedName.emplace(name, result);
+  return result;
+}
+
 const std::vector<const Texture*>& TextureManager::textures() const
 {
   return m_textures;
@@ -198,6 +223,7 @@ void TextureManager::prepare()
 void TextureManager::updateTextures()
 {
   m_texturesByName.clear();
+  m_texturesByInternedName.clear();
   m_textures.clear();
 
   for (auto& collection : m_collections)
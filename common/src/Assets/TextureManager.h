@@ -21,9 +21,13 @@
 
 #include "Assets/TextureCollection.h"
 
+#include <kdl/interned_string.h>
+
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -33,6 +37,7 @@ class Logger;
 namespace IO
 {
 class FileSystem;
+class TextureCache;
 } // namespace IO
 
 namespace Model
@@ -49,6 +54,7 @@ class TextureManager
 {
 private:
   Logger& m_logger;
+  std::shared_ptr<IO::TextureCache> m_textureCache;
 
   std::vector<TextureCollection> m_collections;
 
@@ -56,6 +62,8 @@ private:
   std::vector<TextureCollection> m_toRemove;
 
   std::map<std::string, Texture*> m_texturesByName;
+  // caches the results of looking up interned names, including missing textures
+  std::unordered_map<kdl::interned_string, Texture*> m_texturesByInternedName;
   std::vector<const Texture*> m_textures;
 
   int m_minFilter;
@@ -68,6 +76,12 @@ public:
 
   void reload(const IO::FileSystem& fs, const Model::TextureConfig& textureConfig);
 
+  /**
+   * Sets the cache that is used to avoid decoding textures again when they are reloaded.
+   * Pass nullptr to disable caching.
+   */
+  void setTextureCache(std::shared_ptr<IO::TextureCache> textureCache);
+
   // for testing
   void setTextureCollections(std::vector<TextureCollection> collections);
 
@@ -88,6 +102,12 @@ public:
   const Texture* texture(const std::string& name) const;
   Texture* texture(const std::string& name);
 
+  /**
+   * Looks up the texture with the given name. Repeated lookups of the same name are
+   * answered from a cache and do not need to convert the name to lower case.
+   */
+  Texture* texture(const kdl::interned_string& name);
+
   const std::vector<const Texture*>& textures() const;
   const std::vector<TextureCollection>& collections() const;
 
@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BufferedParserStatus.h"
+
+#include <string>
+#include <utility>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+BufferedParserStatus::BufferedParserStatus(ParserStatus& target)
+  : ParserStatus{target.m_logger, target.m_prefix}
+  , m_target{target}
+{
+}
+
+BufferedParserStatus::BufferedParserStatus(
+  ParserStatus& target, std::vector<std::tuple<LogLevel, std::string>> messages)
+  : ParserStatus{target.m_logger, target.m_prefix}
+  , m_target{target}
+  , m_messages{std::move(messages)}
+{
+}
+
+const std::vector<std::tuple<LogLevel, std::string>>& BufferedParserStatus::messages()
+  const
+{
+  return m_messages;
+}
+
+void BufferedParserStatus::flush()
+{
+  for (const auto& [level, str] : m_messages)
+  {
+    m_target.doLog(level, str);
+  }
+  m_messages.clear();
+}
+
+void BufferedParserStatus::doProgress(const double /* progress */) {}
+
+void BufferedParserStatus::doLog(const LogLevel level, const std::string& str)
+{
+  m_messages.emplace_back(level, str);
+}
+} // namespace IO
+} // namespace TrenchBroom
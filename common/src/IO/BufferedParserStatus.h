@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/ParserStatus.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+/**
+ * Records the messages logged by a parser that runs on a worker thread so that they can
+ * be forwarded to the given target status later on the thread that owns the target.
+ *
+ * Messages are formatted exactly as the target would format them. Progress is not
+ * forwarded.
+ */
+class BufferedParserStatus : public ParserStatus
+{
+private:
+  ParserStatus& m_target;
+  std::vector<std::tuple<LogLevel, std::string>> m_messages;
+
+public:
+  explicit BufferedParserStatus(ParserStatus& target);
+
+  /**
+   * Creates a status that forwards the given messages, which were recorded earlier by
+   * another buffered status, to the given target when it is flushed.
+   */
+  BufferedParserStatus(
+    ParserStatus& target, std::vector<std::tuple<LogLevel, std::string>> messages);
+
+  /**
+   * Returns the messages that were recorded and not flushed yet.
+   */
+  const std::vector<std::tuple<LogLevel, std::string>>& messages() const;
+
+  /**
+   * Forwards the recorded messages to the target status in the order in which they were
+   * logged and clears them.
+   */
+  void flush();
+
+private:
+  void doProgress(double progress) override;
+  void doLog(LogLevel level, const std::string& str) override;
+};
+} // namespace IO
+} // namespace TrenchBroom
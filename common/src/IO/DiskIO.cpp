@@ -43,6 +43,15 @@ namespace Disk
 namespace
 {
 
+/**
+ * Files of at least this size are mapped into memory when they are opened. Mapping
+ * smaller files costs more than it saves.
+ *
+ * The files returned by openFile are read and released right away, so they are only
+ * mapped for a short time, see MmapFile.
+ */
+constexpr auto MinMappedFileSize = size_t(64 * 1024);
+
 std::vector<std::filesystem::path> doGetDirectoryContents(
   const std::filesystem::path& fixedPath)
 {
@@ -159,6 +168,19 @@ std::shared_ptr<File> openFile(const std::filesystem::path& path)
     throw FileNotFoundException(fixedPath.string());
   }
 
+  const auto size = QFileInfo{pathAsQString(fixedPath)}.size();
+  if (size >= qint64(MinMappedFileSize))
+  {
+    try
+    {
+      return std::make_shared<MmapFile>(fixedPath);
+    }
+    catch (const FileSystemException&)
+    {
+      // not every file can be mapped, fall back to reading it
+    }
+  }
+
   return std::make_shared<CFile>(fixedPath);
 }
 
@@ -109,7 +109,8 @@ DkPakFileSystem::DkPakFileSystem(std::filesystem::path path)
 
 void DkPakFileSystem::doReadDirectory()
 {
-  auto reader = m_file->reader();
+  const auto file = mapArchive();
+  auto reader = file->reader();
   reader.seekFromBegin(DkPakLayout::HeaderMagicLength);
 
   const auto directoryAddress = reader.readSize<int32_t>();
@@ -128,22 +129,24 @@ void DkPakFileSystem::doReadDirectory()
     const auto entrySize = compressed ? compressedSize : uncompressedSize;
 
     const auto entryPath = std::filesystem::path(kdl::str_to_lower(entryName));
-    auto entryFile =
-      std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
 
     if (compressed)
     {
       addFile(
         entryPath,
-        [entryFile = std::move(entryFile), uncompressedSize]() -> std::shared_ptr<File> {
+        [this, entryPath, entryAddress, entrySize, uncompressedSize]()
+          -> std::shared_ptr<File> {
+          auto entryFile = openArchiveFile(entryPath, entryAddress, entrySize);
           auto data = decompress(entryFile, uncompressedSize);
           return std::make_shared<OwningBufferFile>(
-            entryFile->path(), std::move(data), uncompressedSize);
+            entryPath, std::move(data), uncompressedSize);
         });
     }
     else
     {
-      addFile(entryPath, [entryFile = std::move(entryFile)]() { return entryFile; });
+      addFile(entryPath, [this, entryPath, entryAddress, entrySize]() {
+        return openArchiveFile(entryPath, entryAddress, entrySize);
+      });
     }
   }
 }
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityDefinitionCache.h"
+
+#include "Exceptions.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionClassInfo.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+size_t hashEntityDefinitionSource(const std::string_view contents)
+{
+  return std::hash<std::string_view>{}(contents);
+}
+
+namespace
+{
+std::optional<size_t> hashFile(const std::filesystem::path& path)
+{
+  try
+  {
+    auto file = Disk::openFile(path);
+    auto reader = file->reader().buffer();
+    return hashEntityDefinitionSource(reader.stringView());
+  }
+  catch (const Exception&)
+  {
+    return std::nullopt;
+  }
+}
+
+bool isUnchanged(const EntityDefinitionSourceFile& sourceFile)
+{
+  return hashFile(sourceFile.path) == sourceFile.hash;
+}
+} // namespace
+
+EntityDefinitionCache::EntityDefinitionCache() = default;
+
+EntityDefinitionCache::~EntityDefinitionCache() = default;
+
+const std::vector<EntityDefinitionClassInfo>* EntityDefinitionCache::classInfos(
+  const std::filesystem::path& path, ParserStatus& status)
+{
+  const auto it = m_entries.find(path);
+  if (it == m_entries.end())
+  {
+    return nullptr;
+  }
+
+  const auto& sourceFiles = it->second.sourceFiles;
+  if (!std::all_of(sourceFiles.begin(), sourceFiles.end(), isUnchanged))
+  {
+    m_entries.erase(it);
+    return nullptr;
+  }
+
+  BufferedParserStatus{status, it->second.messages}.flush();
+  return &it->second.classInfos;
+}
+
+void EntityDefinitionCache::setClassInfos(
+  const std::filesystem::path& path,
+  std::vector<EntityDefinitionSourceFile> sourceFiles,
+  std::vector<EntityDefinitionClassInfo> classInfos,
+  std::vector<std::tuple<LogLevel, std::string>> messages)
+{
+  m_entries[path] =
+    Entry{std::move(sourceFiles), std::move(classInfos), std::move(messages)};
+}
+
+void EntityDefinitionCache::clear()
+{
+  m_entries.clear();
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+enum class LogLevel;
+
+namespace IO
+{
+struct EntityDefinitionClassInfo;
+class ParserStatus;
+
+/**
+ * A file that entity definitions were parsed from, with the hash of its contents or
+ * std::nullopt if the file could not be read.
+ */
+struct EntityDefinitionSourceFile
+{
+  std::filesystem::path path;
+  std::optional<size_t> hash;
+};
+
+size_t hashEntityDefinitionSource(std::string_view contents);
+
+/**
+ * Caches the resolved class infos of entity definition files so that the files need not
+ * be parsed again if the entity definitions are reloaded.
+ *
+ * The cached class infos of a file are only returned if none of the files they were
+ * parsed from have changed since, including the files included by an FGD file. The
+ * messages that the parser logged are cached along with the class infos so that they
+ * are reported again when the cached class infos are used.
+ */
+class EntityDefinitionCache
+{
+private:
+  struct Entry
+  {
+    std::vector<EntityDefinitionSourceFile> sourceFiles;
+    std::vector<EntityDefinitionClassInfo> classInfos;
+    std::vector<std::tuple<LogLevel, std::string>> messages;
+  };
+
+  std::map<std::filesystem::path, Entry> m_entries;
+
+public:
+  EntityDefinitionCache();
+  ~EntityDefinitionCache();
+
+  /**
+   * Returns the cached class infos for the entity definition file at the given path, or
+   * nullptr if there are none or if any of the files they were parsed from has changed.
+   * Stale entries are removed.
+   *
+   * If class infos are returned, the messages that were logged while parsing them are
+   * added to the given status again.
+   */
+  const std::vector<EntityDefinitionClassInfo>* classInfos(
+    const std::filesystem::path& path, ParserStatus& status);
+
+  /**
+   * Caches the given class infos for the entity definition file at the given path. The
+   * given source files must contain every file the class infos were parsed from, and the
+   * given messages are the messages that were logged while parsing them.
+   */
+  void setClassInfos(
+    const std::filesystem::path& path,
+    std::vector<EntityDefinitionSourceFile> sourceFiles,
+    std::vector<EntityDefinitionClassInfo> classInfos,
+    std::vector<std::tuple<LogLevel, std::string>> messages);
+
+  void clear();
+};
+} // namespace IO
+} // namespace TrenchBroom
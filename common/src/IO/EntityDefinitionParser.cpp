@@ -22,11 +22,13 @@
 #include "Assets/EntityDefinition.h"
 #include "Assets/ModelDefinition.h"
 #include "Assets/PropertyDefinition.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/EntityDefinitionClassInfo.h"
 #include "IO/ParserStatus.h"
 #include "Macros.h"
 #include "Model/EntityProperties.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <unordered_map>
@@ -45,6 +47,11 @@ EntityDefinitionParser::EntityDefinitionParser(const Color& defaultEntityColor)
 
 EntityDefinitionParser::~EntityDefinitionParser() {}
 
+const Color& EntityDefinitionParser::defaultEntityColor() const
+{
+  return m_defaultEntityColor;
+}
+
 static std::shared_ptr<Assets::PropertyDefinition> mergeAttributes(
   const Assets::PropertyDefinition& inheritingClassAttribute,
   const Assets::PropertyDefinition& superClassAttribute)
@@ -103,9 +110,14 @@ static std::shared_ptr<Assets::PropertyDefinition> mergeAttributes(
  * class, except for the following:
  * - spawnflags are merged together
  * - model definitions are merged together
+ *
+ * The given property indices map the keys of the property definitions of the inheriting
+ * class to their positions and are updated when a property definition is inherited.
  */
 static void inheritAttributes(
-  EntityDefinitionClassInfo& inheritingClass, const EntityDefinitionClassInfo& superClass)
+  EntityDefinitionClassInfo& inheritingClass,
+  std::unordered_map<std::string, size_t>& propertyIndices,
+  const EntityDefinitionClassInfo& superClass)
 {
   if (!inheritingClass.description)
   {
@@ -122,20 +134,19 @@ static void inheritAttributes(
 
   for (const auto& attribute : superClass.propertyDefinitions)
   {
-    auto it = std::find_if(
-      std::begin(inheritingClass.propertyDefinitions),
-      std::end(inheritingClass.propertyDefinitions),
-      [&](const auto& a) { return a->key() == attribute->key(); });
-    if (it == std::end(inheritingClass.propertyDefinitions))
+    const auto [it, inserted] = propertyIndices.emplace(
+      attribute->key(), inheritingClass.propertyDefinitions.size());
+    if (inserted)
     {
       inheritingClass.propertyDefinitions.push_back(attribute);
     }
     else
     {
-      auto mergedAttribute = mergeAttributes(**it, *attribute);
+      auto& existingAttribute = inheritingClass.propertyDefinitions[it->second];
+      auto mergedAttribute = mergeAttributes(*existingAttribute, *attribute);
       if (mergedAttribute != nullptr)
       {
-        *it = mergedAttribute;
+        existingAttribute = mergedAttribute;
       }
     }
   }
@@ -177,6 +188,8 @@ static void inheritAttributes(
  * @param status the parser status to add errors to
  * @param inheritingClass class the class that is currently processed, i.e. the class that
  * induces the inheritance hierarchy that is currently being resolved
+ * @param propertyIndices the positions of the property definitions of the inheriting
+ * class by their keys
  * @param superClass the super class to inherit from
  * @param findClassInfos a function that finds class infos by their names
  * @param visited a set that contains the names of the classes visited so far on the path
@@ -187,6 +200,7 @@ template <typename F>
 static void inheritFromAndRecurse(
   ParserStatus& status,
   EntityDefinitionClassInfo& inheritingClass,
+  std::unordered_map<std::string, size_t>& propertyIndices,
   const EntityDefinitionClassInfo& superClass,
   const F& findClassInfos,
   std::unordered_set<std::string>& visited)
@@ -200,9 +214,9 @@ static void inheritFromAndRecurse(
     return;
   }
 
-  inheritAttributes(inheritingClass, superClass);
+  inheritAttributes(inheritingClass, propertyIndices, superClass);
   findSuperClassesAndInheritFrom(
-    status, inheritingClass, superClass, findClassInfos, visited);
+    status, inheritingClass, propertyIndices, superClass, findClassInfos, visited);
 
   visited.erase(superClass.name);
 }
@@ -238,6 +252,8 @@ static void inheritFromAndRecurse(
  * @param status the parser status to add errors to
  * @param inheritingClass class the class that is currently processed, i.e. the class that
  * induces the inheritance hierarchy that is currently being resolved
+ * @param propertyIndices the positions of the property definitions of the inheriting
+ * class by their keys
  * @param classWithSuperClasses the class that declares the super classes to inherit from
  * @param findClassInfos a function that finds class infos by their names
  * @param visited a set that contains the names of the classes visited so far on the path
@@ -247,6 +263,7 @@ template <typename F>
 static void findSuperClassesAndInheritFrom(
   ParserStatus& status,
   EntityDefinitionClassInfo& inheritingClass,
+  std::unordered_map<std::string, size_t>& propertyIndices,
   const EntityDefinitionClassInfo& classWithSuperClasses,
   const F& findClassInfos,
   std::unordered_set<std::string>& visited)
@@ -297,7 +314,12 @@ static void findSuperClassesAndInheritFrom(
     else
     {
       inheritFromAndRecurse(
-        status, inheritingClass, *nextSuperClass, findClassInfos, visited);
+        status,
+        inheritingClass,
+        propertyIndices,
+        *nextSuperClass,
+        findClassInfos,
+        visited);
     }
   }
 }
@@ -324,9 +346,15 @@ static EntityDefinitionClassInfo resolveInheritance(
   EntityDefinitionClassInfo inheritingClass,
   const F& findClassInfos)
 {
+  auto propertyIndices = std::unordered_map<std::string, size_t>{};
+  for (size_t i = 0; i < inheritingClass.propertyDefinitions.size(); ++i)
+  {
+    propertyIndices.emplace(inheritingClass.propertyDefinitions[i]->key(), i);
+  }
+
   auto visited = std::unordered_set<std::string>();
   findSuperClassesAndInheritFrom(
-    status, inheritingClass, inheritingClass, findClassInfos, visited);
+    status, inheritingClass, propertyIndices, inheritingClass, findClassInfos, visited);
   return inheritingClass;
 }
 
@@ -381,41 +409,57 @@ static std::vector<EntityDefinitionClassInfo> filterRedundantClasses(
  * vector and returns a vector of copies where the inherited attributes are added to the
  * inheriting classes.
  *
+ * The classes are resolved concurrently. The messages for each class are buffered and
+ * added to the given status in the order of the classes.
+ *
  * Exposed for testing.
  */
 std::vector<EntityDefinitionClassInfo> resolveInheritance(
   ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos)
 {
   const auto filteredClassInfos = filterRedundantClasses(status, classInfos);
-  const auto findClassInfos =
-    [&](const auto& name) -> std::vector<const EntityDefinitionClassInfo*> {
-    std::vector<const EntityDefinitionClassInfo*> result;
-    for (const auto& classInfo : filteredClassInfos)
-    {
-      if (classInfo.name == name)
-      {
-        result.push_back(&classInfo);
-      }
-    }
-    return result;
-  };
 
-  std::vector<EntityDefinitionClassInfo> result;
+  auto classInfosByName =
+    std::unordered_map<std::string, std::vector<const EntityDefinitionClassInfo*>>{};
+  auto inheritingClasses = std::vector<const EntityDefinitionClassInfo*>{};
   for (const auto& classInfo : filteredClassInfos)
   {
+    classInfosByName[classInfo.name].push_back(&classInfo);
     if (classInfo.type != EntityDefinitionClassType::BaseClass)
     {
-      result.push_back(resolveInheritance(status, classInfo, findClassInfos));
+      inheritingClasses.push_back(&classInfo);
     }
   }
+
+  const auto noClassInfos = std::vector<const EntityDefinitionClassInfo*>{};
+  const auto findClassInfos =
+    [&](const auto& name) -> const std::vector<const EntityDefinitionClassInfo*>& {
+    const auto it = classInfosByName.find(name);
+    return it != classInfosByName.end() ? it->second : noClassInfos;
+  };
+
+  auto results = kdl::vec_parallel_transform(
+    std::move(inheritingClasses), [&](const EntityDefinitionClassInfo* classInfo) {
+      auto classStatus = std::make_unique<BufferedParserStatus>(status);
+      auto resolvedClass = resolveInheritance(*classStatus, *classInfo, findClassInfos);
+      return std::make_tuple(std::move(resolvedClass), std::move(classStatus));
+    });
+
+  auto result = std::vector<EntityDefinitionClassInfo>{};
+  result.reserve(results.size());
+  for (auto& [resolvedClass, classStatus] : results)
+  {
+    classStatus->flush();
+    result.push_back(std::move(resolvedClass));
+  }
   return result;
 }
 
-std::unique_ptr<Assets::EntityDefinition> EntityDefinitionParser::createDefinition(
-  const EntityDefinitionClassInfo& classInfo) const
+static std::unique_ptr<Assets::EntityDefinition> createEntityDefinition(
+  const EntityDefinitionClassInfo& classInfo, const Color& defaultEntityColor)
 {
   const auto& name = classInfo.name;
-  const auto color = classInfo.color.value_or(m_defaultEntityColor);
+  const auto color = classInfo.color.value_or(defaultEntityColor);
   const auto size = classInfo.size.value_or(DefaultSize);
   auto description = classInfo.description.value_or("");
   auto& attributes = classInfo.propertyDefinitions;
@@ -440,16 +484,14 @@ std::unique_ptr<Assets::EntityDefinition> EntityDefinitionParser::createDefiniti
   };
 }
 
-std::vector<Assets::EntityDefinition*> EntityDefinitionParser::createDefinitions(
-  ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const
+std::vector<Assets::EntityDefinition*> createEntityDefinitions(
+  const std::vector<EntityDefinitionClassInfo>& classInfos,
+  const Color& defaultEntityColor)
 {
-  const auto resolvedClasses =
-    resolveInheritance(status, filterRedundantClasses(status, classInfos));
-
   std::vector<Assets::EntityDefinition*> result;
-  for (const auto& classInfo : resolvedClasses)
+  for (const auto& classInfo : classInfos)
   {
-    if (auto definition = createDefinition(classInfo))
+    if (auto definition = createEntityDefinition(classInfo, defaultEntityColor))
     {
       result.push_back(definition.release());
     }
@@ -461,8 +503,13 @@ std::vector<Assets::EntityDefinition*> EntityDefinitionParser::createDefinitions
 EntityDefinitionParser::EntityDefinitionList EntityDefinitionParser::parseDefinitions(
   ParserStatus& status)
 {
-  auto classInfos = parseClassInfos(status);
-  return createDefinitions(status, std::move(classInfos));
+  return createEntityDefinitions(parseResolvedClassInfos(status), m_defaultEntityColor);
+}
+
+std::vector<EntityDefinitionClassInfo> EntityDefinitionParser::parseResolvedClassInfos(
+  ParserStatus& status)
+{
+  return resolveInheritance(status, parseClassInfos(status));
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -43,6 +43,15 @@ class ParserStatus;
 std::vector<EntityDefinitionClassInfo> resolveInheritance(
   ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos);
 
+/**
+ * Creates entity definitions for the given class infos, which must have their inheritance
+ * resolved already. Base classes are skipped. The caller takes ownership of the returned
+ * definitions.
+ */
+std::vector<Assets::EntityDefinition*> createEntityDefinitions(
+  const std::vector<EntityDefinitionClassInfo>& classInfos,
+  const Color& defaultEntityColor);
+
 class EntityDefinitionParser
 {
 private:
@@ -60,12 +69,16 @@ public:
 
   EntityDefinitionList parseDefinitions(ParserStatus& status);
 
-private:
-  std::unique_ptr<Assets::EntityDefinition> createDefinition(
-    const EntityDefinitionClassInfo& classInfo) const;
-  std::vector<Assets::EntityDefinition*> createDefinitions(
-    ParserStatus& status, const std::vector<EntityDefinitionClassInfo>& classInfos) const;
+  /**
+   * Parses the class infos and resolves their inheritance. The result can be turned into
+   * entity definitions using createEntityDefinitions.
+   */
+  std::vector<EntityDefinitionClassInfo> parseResolvedClassInfos(ParserStatus& status);
 
+protected:
+  const Color& defaultEntityColor() const;
+
+private:
   virtual std::vector<EntityDefinitionClassInfo> parseClassInfos(
     ParserStatus& status) = 0;
 };
@@ -34,6 +34,14 @@ class EntityModel;
 namespace IO
 {
 
+/**
+ * Loads entity models and their frames.
+ *
+ * Models are loaded on worker threads while the main thread loads frames of models that
+ * were loaded before, so a loader must support being called concurrently, as long as the
+ * calls concern different models. Loaders read from a file system, which must therefore
+ * support concurrent reads, too.
+ */
 class EntityModelLoader
 {
 public:
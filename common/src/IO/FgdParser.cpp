@@ -21,6 +21,8 @@
 
 #include "Assets/PropertyDefinition.h"
 #include "EL/ELExceptions.h"
+#include "Exceptions.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/ELParser.h"
 #include "IO/EntityDefinitionClassInfo.h"
@@ -28,6 +30,7 @@
 #include "IO/LegacyModelDefinitionParser.h"
 #include "IO/ParserStatus.h"
 
+#include <kdl/parallel.h>
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
@@ -36,6 +39,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
@@ -146,6 +150,22 @@ FgdTokenizer::Token FgdTokenizer::emitToken()
   return Token{FgdToken::Eof, nullptr, nullptr, length(), line(), column()};
 }
 
+namespace
+{
+std::filesystem::path makeAbsolute(
+  const FileSystem& fs, const std::filesystem::path& path)
+{
+  try
+  {
+    return fs.makeAbsolute(path);
+  }
+  catch (const FileSystemException&)
+  {
+    return path;
+  }
+}
+} // namespace
+
 FgdParser::FgdParser(
   std::string_view str,
   const Color& defaultEntityColor,
@@ -155,18 +175,52 @@ FgdParser::FgdParser(
 {
   if (!path.empty() && path.is_absolute())
   {
-    m_fs = std::make_unique<DiskFileSystem>(path.parent_path());
-    pushIncludePath(path.filename());
+    m_fs = std::make_shared<DiskFileSystem>(path.parent_path());
+    m_paths.push_back(path.filename());
   }
 }
 
 FgdParser::FgdParser(std::string_view str, const Color& defaultEntityColor)
-  : FgdParser{std::move(str), defaultEntityColor, {}}
+  : FgdParser{std::move(str), defaultEntityColor, std::filesystem::path{}}
+{
+}
+
+FgdParser::FgdParser(
+  std::string_view str,
+  const Color& defaultEntityColor,
+  std::shared_ptr<FileSystem> fs,
+  std::vector<std::filesystem::path> paths)
+  : EntityDefinitionParser{defaultEntityColor}
+  , m_paths{std::move(paths)}
+  , m_fs{std::move(fs)}
+  , m_tokenizer{FgdTokenizer{std::move(str)}}
 {
 }
 
 FgdParser::~FgdParser() = default;
 
+const std::vector<EntityDefinitionSourceFile>& FgdParser::includedFiles() const
+{
+  return m_includedFiles;
+}
+
+/**
+ * An include directive whose file has not been parsed yet. The position is the number of
+ * class infos that precede the directive in the including file.
+ */
+struct FgdParser::PendingInclude
+{
+  size_t position;
+  std::filesystem::path path;
+  size_t line;
+};
+
+struct FgdParser::IncludeResult
+{
+  std::vector<EntityDefinitionClassInfo> classInfos;
+  std::vector<EntityDefinitionSourceFile> includedFiles;
+};
+
 FgdParser::TokenNameMap FgdParser::tokenNames() const
 {
   using namespace FgdToken;
@@ -188,33 +242,6 @@ FgdParser::TokenNameMap FgdParser::tokenNames() const
   };
 }
 
-class FgdParser::PushIncludePath
-{
-private:
-  FgdParser* m_parser;
-
-public:
-  PushIncludePath(FgdParser* parser, const std::filesystem::path& path)
-    : m_parser{parser}
-  {
-    m_parser->pushIncludePath(path);
-  }
-
-  ~PushIncludePath() { m_parser->popIncludePath(); }
-};
-
-void FgdParser::pushIncludePath(const std::filesystem::path& path)
-{
-  assert(!isRecursiveInclude(path));
-  m_paths.push_back(path);
-}
-
-void FgdParser::popIncludePath()
-{
-  assert(!m_paths.empty());
-  m_paths.pop_back();
-}
-
 std::filesystem::path FgdParser::currentRoot() const
 {
   if (!m_paths.empty())
@@ -238,17 +265,25 @@ bool FgdParser::isRecursiveInclude(const std::filesystem::path& path) const
 std::vector<EntityDefinitionClassInfo> FgdParser::parseClassInfos(ParserStatus& status)
 {
   auto classInfos = std::vector<EntityDefinitionClassInfo>{};
+  auto includes = std::vector<PendingInclude>{};
   auto token = m_tokenizer.peekToken();
   while (!token.hasType(FgdToken::Eof))
   {
-    parseClassInfoOrInclude(status, classInfos);
+    parseClassInfoOrInclude(status, classInfos, includes);
     token = m_tokenizer.peekToken();
   }
-  return classInfos;
+
+  if (includes.empty())
+  {
+    return classInfos;
+  }
+  return handleIncludes(status, std::move(classInfos), std::move(includes));
 }
 
 void FgdParser::parseClassInfoOrInclude(
-  ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos)
+  ParserStatus& status,
+  std::vector<EntityDefinitionClassInfo>& classInfos,
+  std::vector<PendingInclude>& includes)
 {
   const auto token =
     expect(status, FgdToken::Eof | FgdToken::Word, m_tokenizer.peekToken());
@@ -259,8 +294,7 @@ void FgdParser::parseClassInfoOrInclude(
 
   if (kdl::ci::str_is_equal(token.data(), "@include"))
   {
-    auto includedClassInfos = parseInclude(status);
-    classInfos = kdl::vec_concat(classInfos, std::move(includedClassInfos));
+    includes.push_back(parseInclude(status, classInfos.size()));
   }
   else
   {
@@ -964,49 +998,107 @@ std::string FgdParser::parseString(ParserStatus& status)
   }
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::parseInclude(ParserStatus& status)
+FgdParser::PendingInclude FgdParser::parseInclude(
+  ParserStatus& status, const size_t position)
 {
   auto token = expect(status, FgdToken::Word, m_tokenizer.nextToken());
   assert(kdl::ci::str_is_equal(token.data(), "@include"));
 
   expect(status, FgdToken::String, token = m_tokenizer.nextToken());
-  const auto path = std::filesystem::path(token.data());
-  return handleInclude(status, path);
+  return PendingInclude{position, std::filesystem::path(token.data()), token.line()};
 }
 
-std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
-  ParserStatus& status, const std::filesystem::path& path)
+/**
+ * Parses the given included files concurrently and inserts their class infos into the
+ * given class infos at the positions of the include directives. The messages logged while
+ * parsing an included file are added to the given status in the order of the includes.
+ */
+std::vector<EntityDefinitionClassInfo> FgdParser::handleIncludes(
+  ParserStatus& status,
+  std::vector<EntityDefinitionClassInfo> classInfos,
+  std::vector<PendingInclude> includes)
+{
+  auto includeResults = kdl::vec_parallel_transform(
+    includes, [&](const PendingInclude& include) {
+      auto includeStatus = std::make_unique<BufferedParserStatus>(status);
+      auto includeResult = handleInclude(*includeStatus, include);
+      return std::make_tuple(std::move(includeResult), std::move(includeStatus));
+    });
+
+  auto result = std::vector<EntityDefinitionClassInfo>{};
+  auto classInfoIt = classInfos.begin();
+  for (size_t i = 0; i < includes.size(); ++i)
+  {
+    auto& [includeResult, includeStatus] = includeResults[i];
+    includeStatus->flush();
+
+    const auto position = classInfos.begin() + std::ptrdiff_t(includes[i].position);
+    result.insert(
+      result.end(),
+      std::make_move_iterator(classInfoIt),
+      std::make_move_iterator(position));
+    result.insert(
+      result.end(),
+      std::make_move_iterator(includeResult.classInfos.begin()),
+      std::make_move_iterator(includeResult.classInfos.end()));
+    classInfoIt = position;
+
+    m_includedFiles = kdl::vec_concat(
+      std::move(m_includedFiles), std::move(includeResult.includedFiles));
+  }
+  result.insert(
+    result.end(),
+    std::make_move_iterator(classInfoIt),
+    std::make_move_iterator(classInfos.end()));
+
+  return result;
+}
+
+/**
+ * Parses the given included file using a separate parser. This function is called
+ * concurrently for the includes of a file and must therefore not modify this parser.
+ */
+FgdParser::IncludeResult FgdParser::handleInclude(
+  ParserStatus& status, const PendingInclude& include) const
 {
   if (!m_fs)
   {
     status.error(
-      m_tokenizer.line(),
-      kdl::str_to_string("Cannot include file without host file path"));
+      include.line, kdl::str_to_string("Cannot include file without host file path"));
     return {};
   }
 
-  const auto snapshot = m_tokenizer.snapshotStateAndSource();
-  auto result = std::vector<EntityDefinitionClassInfo>{};
+  const auto& path = include.path;
   try
   {
-    status.debug(m_tokenizer.line(), "Parsing included file '" + path.string() + "'");
+    status.debug(include.line, "Parsing included file '" + path.string() + "'");
     const auto file = m_fs->openFile(currentRoot() / path);
     const auto filePath = file->path();
     status.debug(
-      m_tokenizer.line(),
-      "Resolved '" + path.string() + "' to '" + filePath.string() + "'");
+      include.line, "Resolved '" + path.string() + "' to '" + filePath.string() + "'");
 
     if (!isRecursiveInclude(filePath))
     {
-      const auto pushIncludePath = PushIncludePath{this, filePath};
       auto reader = file->reader().buffer();
-      m_tokenizer.replaceState(reader.stringView());
-      result = parseClassInfos(status);
+      const auto includedFile = EntityDefinitionSourceFile{
+        m_fs->makeAbsolute(filePath), hashEntityDefinitionSource(reader.stringView())};
+
+      auto parser = FgdParser{
+        reader.stringView(),
+        defaultEntityColor(),
+        m_fs,
+        kdl::vec_concat(m_paths, std::vector<std::filesystem::path>{filePath})};
+      auto classInfos = parser.parseClassInfos(status);
+      return IncludeResult{
+        std::move(classInfos),
+        kdl::vec_concat(
+          std::vector<EntityDefinitionSourceFile>{includedFile},
+          std::move(parser.m_includedFiles))};
     }
     else
     {
       status.error(
-        m_tokenizer.line(),
+        include.line,
         kdl::str_to_string(
           "Skipping recursively included file: ", path.string(), " (", filePath, ")"));
     }
@@ -1014,12 +1106,15 @@ std::vector<EntityDefinitionClassInfo> FgdParser::handleInclude(
   catch (const Exception& e)
   {
     status.error(
-      m_tokenizer.line(),
-      kdl::str_to_string("Failed to parse included file: ", e.what()));
+      include.line, kdl::str_to_string("Failed to parse included file: ", e.what()));
+
+    // record the file without a hash so that cached definitions are not used anymore once
+    // the file can be parsed
+    return IncludeResult{
+      {}, {EntityDefinitionSourceFile{makeAbsolute(*m_fs, currentRoot() / path), {}}}};
   }
 
-  m_tokenizer.restoreStateAndSource(snapshot);
-  return result;
+  return {};
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -21,6 +21,7 @@
 
 #include "Color.h"
 #include "FloatType.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/EntityDefinitionParser.h"
 #include "IO/Parser.h"
 #include "IO/Tokenizer.h"
@@ -79,7 +80,8 @@ private:
   using Token = FgdTokenizer::Token;
 
   std::vector<std::filesystem::path> m_paths;
-  std::unique_ptr<FileSystem> m_fs;
+  std::shared_ptr<FileSystem> m_fs;
+  std::vector<EntityDefinitionSourceFile> m_includedFiles;
 
   FgdTokenizer m_tokenizer;
 
@@ -92,10 +94,21 @@ public:
 
   ~FgdParser() override;
 
+  /**
+   * Returns the files that were included, directly or indirectly, by the parsed file.
+   * Included files which could not be read are returned without a hash.
+   */
+  const std::vector<EntityDefinitionSourceFile>& includedFiles() const;
+
 private:
-  class PushIncludePath;
-  void pushIncludePath(const std::filesystem::path& path);
-  void popIncludePath();
+  FgdParser(
+    std::string_view str,
+    const Color& defaultEntityColor,
+    std::shared_ptr<FileSystem> fs,
+    std::vector<std::filesystem::path> paths);
+
+  struct PendingInclude;
+  struct IncludeResult;
 
   std::filesystem::path currentRoot() const;
   bool isRecursiveInclude(const std::filesystem::path& path) const;
@@ -106,7 +119,9 @@ private:
   std::vector<EntityDefinitionClassInfo> parseClassInfos(ParserStatus& status) override;
 
   void parseClassInfoOrInclude(
-    ParserStatus& status, std::vector<EntityDefinitionClassInfo>& classInfos);
+    ParserStatus& status,
+    std::vector<EntityDefinitionClassInfo>& classInfos,
+    std::vector<PendingInclude>& includes);
 
   std::optional<EntityDefinitionClassInfo> parseClassInfo(ParserStatus& status);
   EntityDefinitionClassInfo parseSolidClassInfo(ParserStatus& status);
@@ -157,9 +172,12 @@ private:
   Color parseColor(ParserStatus& status);
   std::string parseString(ParserStatus& status);
 
-  std::vector<EntityDefinitionClassInfo> parseInclude(ParserStatus& status);
-  std::vector<EntityDefinitionClassInfo> handleInclude(
-    ParserStatus& status, const std::filesystem::path& path);
+  PendingInclude parseInclude(ParserStatus& status, size_t position);
+  std::vector<EntityDefinitionClassInfo> handleIncludes(
+    ParserStatus& status,
+    std::vector<EntityDefinitionClassInfo> classInfos,
+    std::vector<PendingInclude> includes);
+  IncludeResult handleInclude(ParserStatus& status, const PendingInclude& include) const;
 };
 } // namespace IO
 } // namespace TrenchBroom
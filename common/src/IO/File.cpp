@@ -22,6 +22,16 @@
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace TrenchBroom
 {
 namespace IO
@@ -112,6 +122,136 @@ std::FILE* CFile::file() const
   return m_file;
 }
 
+namespace
+{
+#ifdef _WIN32
+const char* mapFile(const std::filesystem::path& path, size_t& size)
+{
+  auto* file = CreateFileW(
+    path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw FileSystemException("Cannot open file " + path.string());
+  }
+
+  auto fileSize = LARGE_INTEGER{};
+  if (!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    throw FileSystemException("Cannot get size of file " + path.string());
+  }
+
+  size = static_cast<size_t>(fileSize.QuadPart);
+  if (size == 0)
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+
+  // the view keeps the file and the mapping alive, so both handles can be closed
+  auto* mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    throw FileSystemException("Cannot map file " + path.string());
+  }
+
+  const auto* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (view == nullptr)
+  {
+    throw FileSystemException("Cannot map file " + path.string());
+  }
+
+  return static_cast<const char*>(view);
+}
+
+void unmapFile(const char* begin, size_t)
+{
+  UnmapViewOfFile(begin);
+}
+#else
+const char* mapFile(const std::filesystem::path& path, size_t& size)
+{
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw FileSystemException("Cannot open file " + path.string());
+  }
+
+  struct stat info;
+  if (::fstat(fd, &info) != 0)
+  {
+    ::close(fd);
+    throw FileSystemException("Cannot get size of file " + path.string());
+  }
+
+  size = static_cast<size_t>(info.st_size);
+  if (size == 0)
+  {
+    ::close(fd);
+    return nullptr;
+  }
+
+  // the mapping keeps the file alive, so the descriptor can be closed
+  auto* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED)
+  {
+    throw FileSystemException("Cannot map file " + path.string());
+  }
+
+  return static_cast<const char*>(view);
+}
+
+void unmapFile(const char* begin, const size_t size)
+{
+  ::munmap(const_cast<char*>(begin), size);
+}
+#endif
+} // namespace
+
+MmapFile::MmapFile(std::filesystem::path path)
+  : File{std::move(path)}
+  , m_size{0}
+{
+  m_begin = mapFile(this->path(), m_size);
+}
+
+MmapFile::~MmapFile()
+{
+  if (m_begin)
+  {
+    unmapFile(m_begin, m_size);
+  }
+}
+
+Reader MmapFile::reader() const
+{
+  return Reader::from(begin(), end());
+}
+
+size_t MmapFile::size() const
+{
+  return m_size;
+}
+
+const char* MmapFile::begin() const
+{
+  return m_begin;
+}
+
+const char* MmapFile::end() const
+{
+  return m_begin + m_size;
+}
+
 FileView::FileView(
   std::filesystem::path path,
   std::shared_ptr<File> file,
@@ -148,7 +148,51 @@ public:
 };
 
 /**
- * A file that is backed by a portion of a physical file.
+ * A file that is backed by a physical file on the disk which is mapped into memory. The
+ * file is mapped in the constructor and unmapped in the destructor.
+ *
+ * Readers created for this file read directly from the mapped memory, so the contents of
+ * the file are never copied.
+ *
+ * A mapped file should only be kept open while it is in use. If another program truncates
+ * the file while it is mapped, accessing the mapping crashes the process on POSIX
+ * systems, and on Windows, the file cannot be replaced while it is mapped. Archives are
+ * therefore only mapped while files opened from them are in use, see ImageFileSystem.
+ */
+class MmapFile : public File
+{
+private:
+  const char* m_begin;
+  size_t m_size;
+
+public:
+  /**
+   * Creates a new file with the given path and maps the file into memory.
+   *
+   * @param path the path of the file
+   *
+   * @throw FileSystemException if the file cannot be opened or mapped
+   */
+  explicit MmapFile(std::filesystem::path path);
+  ~MmapFile() override;
+
+  Reader reader() const override;
+  size_t size() const override;
+
+  /**
+   * Returns the beginning of the mapped memory region.
+   */
+  const char* begin() const;
+
+  /**
+   * Returns the end of the mapped memory region (position after the last byte).
+   */
+  const char* end() const;
+};
+
+/**
+ * A file that is backed by a portion of a physical file. If the host file is backed by
+ * memory, e.g. if it is a MmapFile, then reading from this file does not copy any data.
  */
 class FileView : public File
 {
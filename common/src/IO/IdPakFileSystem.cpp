@@ -51,7 +51,8 @@ void IdPakFileSystem::doReadDirectory()
 {
   char magic[PakLayout::HeaderMagicLength];
 
-  auto reader = m_file->reader();
+  const auto file = mapArchive();
+  auto reader = file->reader();
   reader.seekForward(PakLayout::HeaderAddress);
   reader.read(magic, PakLayout::HeaderMagicLength);
 
@@ -68,9 +69,9 @@ void IdPakFileSystem::doReadDirectory()
     const auto entrySize = reader.readSize<int32_t>();
 
     const auto entryPath = std::filesystem::path{kdl::str_to_lower(entryName)};
-    auto entryFile =
-      std::make_shared<FileView>(entryPath, m_file, entryAddress, entrySize);
-    addFile(entryPath, [entryFile = std::move(entryFile)]() { return entryFile; });
+    addFile(entryPath, [this, entryPath, entryAddress, entrySize]() {
+      return openArchiveFile(entryPath, entryAddress, entrySize);
+    });
   }
 }
 } // namespace IO
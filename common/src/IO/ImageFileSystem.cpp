@@ -20,15 +20,19 @@
 #include "ImageFileSystem.h"
 
 #include "Ensure.h"
+#include "Exceptions.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
 #include "IO/PathInfo.h"
 
 #include <kdl/overload.h>
 #include <kdl/path_utils.h>
+#include <kdl/string_format.h>
 
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace TrenchBroom
 {
@@ -52,13 +56,30 @@ bool isDirectory(const ImageEntry& entry)
     entry);
 }
 
-template <typename I>
-auto findEntry(I begin, I end, const std::filesystem::path& name)
+std::string makeIndexKey(const std::filesystem::path& name)
 {
-  const auto nameLc = kdl::path_to_lower(name);
-  return std::find_if(begin, end, [&](const auto& entry) {
-    return kdl::path_to_lower(getName(entry)) == nameLc;
-  });
+  return kdl::str_to_lower(name.u8string());
+}
+
+const ImageEntry* findEntry(
+  const ImageDirectoryEntry& directoryEntry, const std::filesystem::path& name)
+{
+  const auto indexIt = directoryEntry.index.find(makeIndexKey(name));
+  return indexIt != directoryEntry.index.end() ? &directoryEntry.entries[indexIt->second]
+                                               : nullptr;
+}
+
+ImageEntry* findEntry(ImageDirectoryEntry& directoryEntry, const std::filesystem::path& name)
+{
+  return const_cast<ImageEntry*>(
+    findEntry(const_cast<const ImageDirectoryEntry&>(directoryEntry), name));
+}
+
+ImageEntry& addEntry(ImageDirectoryEntry& directoryEntry, ImageEntry entry)
+{
+  directoryEntry.index.emplace(
+    makeIndexKey(getName(entry)), directoryEntry.entries.size());
+  return directoryEntry.entries.emplace_back(std::move(entry));
 }
 
 template <typename F>
@@ -80,16 +101,15 @@ auto withEntry(
     kdl::overload(
       [&](const ImageDirectoryEntry& directoryEntry) {
         const auto name = kdl::path_front(searchPath);
-        const auto entryIt =
-          findEntry(directoryEntry.entries.begin(), directoryEntry.entries.end(), name);
+        const auto* entry = findEntry(directoryEntry, name);
 
-        return entryIt != directoryEntry.entries.end() ? withEntry(
+        return entry ? withEntry(
                  kdl::path_pop_front(searchPath),
-                 *entryIt,
+                 *entry,
                  currentPath / name,
                  f,
                  defaultResult)
-                                                       : defaultResult;
+                     : defaultResult;
       },
       [&](const ImageFileEntry&) { return defaultResult; }),
     currentEntry);
@@ -112,12 +132,9 @@ void withEntry(
       kdl::overload(
         [&](const ImageDirectoryEntry& directoryEntry) {
           const auto name = kdl::path_front(searchPath);
-          const auto entryIt =
-            findEntry(directoryEntry.entries.begin(), directoryEntry.entries.end(), name);
-
-          if (entryIt != directoryEntry.entries.end())
+          if (const auto* entry = findEntry(directoryEntry, name))
           {
-            withEntry(kdl::path_pop_front(searchPath), *entryIt, currentPath / name, f);
+            withEntry(kdl::path_pop_front(searchPath), *entry, currentPath / name, f);
           }
         },
         [&](const ImageFileEntry&) {}),
@@ -144,8 +161,7 @@ ImageDirectoryEntry& findOrCreateDirectory(
   }
 
   auto name = kdl::path_front(path);
-  auto entryIt = findEntry(parent.entries.begin(), parent.entries.end(), name);
-  if (entryIt != parent.entries.end())
+  if (auto* entry = findEntry(parent, name))
   {
     return std::visit(
       kdl::overload(
@@ -153,25 +169,25 @@ ImageDirectoryEntry& findOrCreateDirectory(
           return findOrCreateDirectory(kdl::path_pop_front(path), directoryEntry);
         },
         [&](ImageFileEntry&) -> ImageDirectoryEntry& {
-          *entryIt = ImageDirectoryEntry{std::move(name), {}};
+          *entry = ImageDirectoryEntry{std::move(name), {}, {}};
           return findOrCreateDirectory(
-            kdl::path_pop_front(path), std::get<ImageDirectoryEntry>(*entryIt));
+            kdl::path_pop_front(path), std::get<ImageDirectoryEntry>(*entry));
         }),
-      *entryIt);
+      *entry);
   }
   else
   {
     return findOrCreateDirectory(
       kdl::path_pop_front(path),
       std::get<ImageDirectoryEntry>(
-        parent.entries.emplace_back(ImageDirectoryEntry{std::move(name), {}})));
+        addEntry(parent, ImageDirectoryEntry{std::move(name), {}, {}})));
   }
 }
 } // namespace
 
 ImageFileSystemBase::ImageFileSystemBase(std::filesystem::path path)
   : m_path{std::move(path)}
-  , m_root{ImageDirectoryEntry{{}, {}}}
+  , m_root{ImageDirectoryEntry{{}, {}, {}}}
 {
 }
 
@@ -179,7 +195,7 @@ ImageFileSystemBase::~ImageFileSystemBase() = default;
 
 void ImageFileSystemBase::reload()
 {
-  m_root = ImageDirectoryEntry{{}, {}};
+  m_root = ImageDirectoryEntry{{}, {}, {}};
   initialize();
 }
 
@@ -202,16 +218,13 @@ void ImageFileSystemBase::addFile(const std::filesystem::path& path, GetImageFil
     findOrCreateDirectory(path.parent_path(), std::get<ImageDirectoryEntry>(m_root));
 
   auto name = path.filename();
-  if (const auto entryIt =
-        findEntry(directoryEntry.entries.begin(), directoryEntry.entries.end(), name);
-      entryIt != directoryEntry.entries.end())
+  if (auto* entry = findEntry(directoryEntry, name))
   {
-    *entryIt = ImageFileEntry{std::move(name), std::move(getFile)};
+    *entry = ImageFileEntry{std::move(name), std::move(getFile)};
   }
   else
   {
-    directoryEntry.entries.emplace_back(
-      ImageFileEntry{std::move(name), std::move(getFile)});
+    addEntry(directoryEntry, ImageFileEntry{std::move(name), std::move(getFile)});
   }
 }
 
@@ -272,9 +285,43 @@ std::shared_ptr<File> ImageFileSystemBase::doOpenFile(
 
 ImageFileSystem::ImageFileSystem(std::filesystem::path path)
   : ImageFileSystemBase{std::move(path)}
-  , m_file{std::make_shared<CFile>(m_path)}
 {
   ensure(m_path.is_absolute(), "path must be absolute");
 }
+
+std::shared_ptr<File> ImageFileSystem::mapArchive()
+{
+  auto archive = std::make_shared<MmapFile>(m_path);
+
+  const auto lock = std::lock_guard{m_mappingMutex};
+  m_mapping = archive;
+  m_archiveSize = archive->size();
+  return archive;
+}
+
+std::shared_ptr<File> ImageFileSystem::openArchiveFile(
+  std::filesystem::path path, const size_t offset, const size_t length) const
+{
+  return std::make_shared<FileView>(std::move(path), mappedArchive(), offset, length);
+}
+
+std::shared_ptr<MmapFile> ImageFileSystem::mappedArchive() const
+{
+  const auto lock = std::lock_guard{m_mappingMutex};
+  if (auto archive = m_mapping.lock())
+  {
+    return archive;
+  }
+
+  auto archive = std::make_shared<MmapFile>(m_path);
+  if (archive->size() != m_archiveSize)
+  {
+    throw FileSystemException{
+      "Archive '" + m_path.string() + "' was changed after it was opened"};
+  }
+
+  m_mapping = archive;
+  return archive;
+}
 } // namespace IO
 } // namespace TrenchBroom
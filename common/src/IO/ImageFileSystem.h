@@ -27,14 +27,18 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace TrenchBroom
 {
 namespace IO
 {
-class CFile;
 class File;
+class MmapFile;
 
 using GetImageFile = std::function<std::shared_ptr<File>()>;
 
@@ -51,6 +55,8 @@ struct ImageDirectoryEntry
 {
   std::filesystem::path name;
   std::vector<ImageEntry> entries;
+  // maps the lower case names of the entries to their indices
+  std::unordered_map<std::string, size_t> index;
 };
 
 class ImageFileSystemBase : public FileSystem
@@ -83,13 +89,44 @@ private:
   virtual void doReadDirectory() = 0;
 };
 
+/**
+ * An image file system that is backed by an archive on the disk.
+ *
+ * The archive is mapped into memory while its directory is read and while any file that
+ * was opened from it is in use. Files opened from the archive share the mapping, and it
+ * is released when the last of them is closed. The archive is therefore not mapped while
+ * the file system is only mounted, so other programs can replace it in the meantime.
+ */
 class ImageFileSystem : public ImageFileSystemBase
 {
-protected:
-  std::shared_ptr<CFile> m_file;
+private:
+  mutable std::mutex m_mappingMutex;
+  mutable std::weak_ptr<MmapFile> m_mapping;
+  size_t m_archiveSize = 0;
 
 protected:
   explicit ImageFileSystem(std::filesystem::path path);
+
+  /**
+   * Maps the archive into memory to read its directory. The returned file should not be
+   * kept after the directory was read.
+   *
+   * @throw FileSystemException if the archive cannot be opened or mapped
+   */
+  std::shared_ptr<File> mapArchive();
+
+  /**
+   * Returns a file that is backed by the given portion of the archive. The file keeps the
+   * archive mapped while it is in use.
+   *
+   * @throw FileSystemException if the archive cannot be mapped or if its size changed
+   * since its directory was read
+   */
+  std::shared_ptr<File> openArchiveFile(
+    std::filesystem::path path, size_t offset, size_t length) const;
+
+private:
+  std::shared_ptr<MmapFile> mappedArchive() const;
 };
 } // namespace IO
 } // namespace TrenchBroom
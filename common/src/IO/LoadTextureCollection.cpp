@@ -23,6 +23,7 @@
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "Ensure.h"
+#include "Exceptions.h"
 #include "IO/File.h"
 #include "IO/FileSystem.h"
 #include "IO/FileSystemUtils.h"
@@ -35,6 +36,8 @@
 #include "IO/ReadQuake3ShaderTexture.h"
 #include "IO/ReadWalTexture.h"
 #include "IO/ResourceUtils.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureDecodePipeline.h"
 #include "IO/TextureUtils.h"
 #include "Logger.h"
 #include "Model/GameConfig.h"
@@ -47,6 +50,9 @@
 #include <kdl/string_format.h>
 #include <kdl/vector_utils.h>
 
+#include <exception>
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -83,88 +89,190 @@ kdl::result<Assets::Palette, Assets::LoadPaletteError> loadPalette(
   }
 }
 
-using ReadTextureFunc =
-  std::function<kdl::result<Assets::Texture, ReadTextureError>(const File&)>;
+uint64_t hashPalette(const FileSystem& gameFS, const Model::TextureConfig& textureConfig)
+{
+  try
+  {
+    if (!textureConfig.palette.empty())
+    {
+      const auto file = gameFS.openFile(textureConfig.palette);
+      const auto reader = file->reader().buffer();
+      return hashTextureCacheData(reader.begin(), reader.end());
+    }
+  }
+  catch (const Exception&)
+  {
+    // a missing palette is reported when the textures are decoded
+  }
+  return 0;
+}
+
+using PrepareTextureFunc = std::function<PreparedTexture(std::shared_ptr<File>)>;
+
+PreparedTexture makeDecodeTextureError(ReadTextureError error)
+{
+  return {
+    [error = std::move(error)]() -> kdl::result<Assets::Texture, ReadTextureError> {
+      return error;
+    },
+    0};
+}
+
+template <typename F>
+PreparedTexture makeDecodeTextureFunc(
+  std::shared_ptr<File> file,
+  std::string name,
+  const TextureCache* textureCache,
+  const uint64_t decoderHash,
+  F decode)
+{
+  auto reader = file->reader().buffer();
+  const auto size = reader.size();
+
+  // the file is captured to keep the memory of the reader alive
+  return {
+    [file = std::move(file),
+     name = std::move(name),
+     reader = std::move(reader),
+     textureCache,
+     decoderHash,
+     decode = std::move(decode)]() mutable {
+      return decodeTextureWithCache(
+        textureCache, name, *file, reader, decoderHash, [&](Reader& textureReader) {
+          return decode(name, textureReader);
+        });
+    },
+    size};
+}
 
-kdl::result<Assets::Texture, ReadTextureError> readTexture(
-  const File& file,
+PreparedTexture prepareTexture(
+  std::shared_ptr<File> file,
   const FileSystem& gameFS,
   const size_t prefixLength,
-  const std::optional<Assets::Palette>& palette)
+  const std::optional<Assets::Palette>& palette,
+  const uint64_t paletteHash,
+  const TextureCache* textureCache)
 {
   static const auto imageFileExtensions =
     std::vector<std::string>{".jpg", ".jpeg", ".png", ".tga", ".bmp"};
 
-  const auto extension = kdl::str_to_lower(file.path().extension().string());
+  const auto extension = kdl::str_to_lower(file->path().extension().string());
   if (extension == ".d")
   {
-    auto name = file.path().stem().string();
+    auto name = file->path().stem().string();
     if (!palette)
     {
-      return ReadTextureError{std::move(name), "Could not load texture: missing palette"};
+      return makeDecodeTextureError(
+        ReadTextureError{std::move(name), "Could not load texture: missing palette"});
     }
-    auto reader = file.reader().buffer();
-    return readIdMipTexture(std::move(name), reader, *palette);
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      paletteHash,
+      [palette = *palette](const std::string& textureName, Reader& reader) {
+        return readIdMipTexture(textureName, reader, palette);
+      });
   }
   else if (extension == ".c")
   {
-    auto name = file.path().stem().string();
-    auto reader = file.reader().buffer();
-    return readHlMipTexture(std::move(name), reader);
+    auto name = file->path().stem().string();
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      0,
+      [](const std::string& textureName, Reader& reader) {
+        return readHlMipTexture(textureName, reader);
+      });
   }
   else if (extension == ".wal")
   {
-    auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-    auto reader = file.reader().buffer();
-    return readWalTexture(std::move(name), reader, palette);
+    auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      paletteHash,
+      [palette](const std::string& textureName, Reader& reader) {
+        return readWalTexture(textureName, reader, palette);
+      });
   }
   else if (extension == ".m8")
   {
-    auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-    auto reader = file.reader().buffer();
-    return readM8Texture(std::move(name), reader);
+    auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      0,
+      [](const std::string& textureName, Reader& reader) {
+        return readM8Texture(textureName, reader);
+      });
   }
   else if (extension == ".dds")
   {
-    auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-    auto reader = file.reader().buffer();
-    return readDdsTexture(std::move(name), reader);
+    auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      0,
+      [](const std::string& textureName, Reader& reader) {
+        return readDdsTexture(textureName, reader);
+      });
   }
   else if (extension.empty())
   {
-    auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-    auto reader = file.reader().buffer();
-    return readQuake3ShaderTexture(std::move(name), file, gameFS);
+    auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+    return prepareQuake3ShaderTexture(std::move(name), *file, gameFS, textureCache);
   }
   else if (kdl::vec_contains(imageFileExtensions, extension))
   {
-    auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-    auto reader = file.reader().buffer();
-    return readFreeImageTexture(std::move(name), reader);
+    auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+    return makeDecodeTextureFunc(
+      std::move(file),
+      std::move(name),
+      textureCache,
+      0,
+      [](const std::string& textureName, Reader& reader) {
+        return readFreeImageTexture(textureName, reader);
+      });
   }
 
-  auto name = getTextureNameFromPathSuffix(file.path(), prefixLength);
-  return ReadTextureError{
+  auto name = getTextureNameFromPathSuffix(file->path(), prefixLength);
+  return makeDecodeTextureError(ReadTextureError{
     std::move(name),
-    "Unknown texture file extension: " + file.path().extension().string()};
+    "Unknown texture file extension: " + file->path().extension().string()});
 }
 
-kdl::result<ReadTextureFunc, LoadTextureCollectionError> makeReadTextureFunc(
-  const FileSystem& gameFS, const Model::TextureConfig& textureConfig)
+kdl::result<PrepareTextureFunc, LoadTextureCollectionError> makePrepareTextureFunc(
+  const FileSystem& gameFS,
+  const Model::TextureConfig& textureConfig,
+  const TextureCache* textureCache)
 {
   return loadPalette(gameFS, textureConfig)
     .transform([](auto palette) { return std::optional{std::move(palette)}; })
     .transform_error([](auto) -> std::optional<Assets::Palette> { return std::nullopt; })
     .and_then(
-      [&](auto palette) -> kdl::result<ReadTextureFunc, LoadTextureCollectionError> {
+      [&](auto palette) -> kdl::result<PrepareTextureFunc, LoadTextureCollectionError> {
+        // the palette only needs to be hashed if decoded textures are cached
+        const auto paletteHash =
+          textureCache && palette ? hashPalette(gameFS, textureConfig) : uint64_t(0);
         return [&,
                 palette = std::move(palette),
-                prefixLength = kdl::path_length(textureConfig.root)](const File& file) {
-          return readTexture(file, gameFS, prefixLength, palette);
+                paletteHash,
+                textureCache,
+                prefixLength = kdl::path_length(textureConfig.root)](
+                 std::shared_ptr<File> file) {
+          return prepareTexture(
+            std::move(file), gameFS, prefixLength, palette, paletteHash, textureCache);
         };
       });
 }
 
+constexpr auto MaxInFlightTextureBytes = size_t(64 * 1024 * 1024);
+
 } // namespace
 
 kdl_reflect_impl(LoadTextureCollectionError);
@@ -182,7 +290,8 @@ kdl::result<Assets::TextureCollection, LoadTextureCollectionError> loadTextureCo
   const std::filesystem::path& path,
   const FileSystem& gameFS,
   const Model::TextureConfig& textureConfig,
-  Logger& logger)
+  Logger& logger,
+  const TextureCache* textureCache)
 {
   if (gameFS.pathInfo(path) != PathInfo::Directory)
   {
@@ -190,16 +299,21 @@ kdl::result<Assets::TextureCollection, LoadTextureCollectionError> loadTextureCo
       "Could not load texture collection '" + path.string() + "': not a directory"};
   }
 
-  return makeReadTextureFunc(gameFS, textureConfig)
+  return makePrepareTextureFunc(gameFS, textureConfig, textureCache)
     .and_then(
-      [&](const auto& readTexture)
+      [&](const auto& prepareTexture)
         -> kdl::result<Assets::TextureCollection, LoadTextureCollectionError> {
         const auto pathMatcher = !textureConfig.extensions.empty()
                                    ? makeExtensionPathMatcher(textureConfig.extensions)
                                    : matchAnyPath;
         const auto texturePaths = gameFS.find(path, pathMatcher);
-        auto textures = std::vector<Assets::Texture>{};
-        textures.reserve(texturePaths.size());
+
+        // Files are opened and read on this thread because file systems are not thread
+        // safe, only decoding is done in parallel.
+        auto pipeline = TextureDecodePipeline{MaxInFlightTextureBytes};
+        auto addedPaths = std::vector<std::filesystem::path>{};
+        addedPaths.reserve(texturePaths.size());
+        auto readError = std::optional<std::string>{};
 
         for (const auto& texturePath : texturePaths)
         {
@@ -215,7 +329,31 @@ kdl::result<Assets::TextureCollection, LoadTextureCollectionError> loadTextureCo
               continue;
             }
 
-            readTexture(*file)
+            pipeline.add(prepareTexture(std::move(file)));
+            addedPaths.push_back(texturePath);
+          }
+          catch (const std::exception& e)
+          {
+            readError = e.what();
+            break;
+          }
+        }
+
+        auto results = pipeline.finish();
+        auto textures = std::vector<Assets::Texture>{};
+        textures.reserve(results.size());
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+          const auto& texturePath = addedPaths[i];
+          try
+          {
+            if (results[i].exception)
+            {
+              std::rethrow_exception(results[i].exception);
+            }
+
+            std::move(*results[i].texture)
               .or_else(makeReadTextureErrorHandler(gameFS, logger))
               .transform([&](auto texture) {
                 texture.setAbsolutePath(safeMakeAbsolute(texturePath, [&](const auto& p) {
@@ -232,6 +370,12 @@ kdl::result<Assets::TextureCollection, LoadTextureCollectionError> loadTextureCo
           }
         }
 
+        if (readError)
+        {
+          return LoadTextureCollectionError{
+            "Could not load texture collection '" + path.string() + "': " + *readError};
+        }
+
         return Assets::TextureCollection{path, std::move(textures)};
       });
 }
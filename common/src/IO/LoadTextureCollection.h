@@ -45,6 +45,7 @@ struct TextureConfig;
 namespace TrenchBroom::IO
 {
 class FileSystem;
+class TextureCache;
 
 std::vector<std::filesystem::path> findTextureCollections(
   const FileSystem& gameFS, const Model::TextureConfig& textureConfig);
@@ -60,6 +61,7 @@ kdl::result<Assets::TextureCollection, LoadTextureCollectionError> loadTextureCo
   const std::filesystem::path& path,
   const FileSystem& gameFS,
   const Model::TextureConfig& textureConfig,
-  Logger& logger);
+  Logger& logger,
+  const TextureCache* textureCache = nullptr);
 
 } // namespace TrenchBroom::IO
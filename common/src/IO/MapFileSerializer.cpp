@@ -39,6 +39,7 @@
 
 #include <fmt/format.h>
 
+#include <cassert>
 #include <iterator> // for std::ostreambuf_iterator
 #include <memory>
 #include <sstream>
@@ -276,7 +277,7 @@ private:
   }
 };
 
-std::unique_ptr<NodeSerializer> MapFileSerializer::create(
+std::unique_ptr<MapFileSerializer> MapFileSerializer::create(
   const Model::MapFormat format, std::ostream& stream)
 {
   switch (format)
@@ -303,16 +304,96 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(
   }
 }
 
+namespace
+{
+/**
+ * Copies the given faces for deferred serialization. The copies do not reference their
+ * textures because the textures might be unloaded while the copies are serialized.
+ * Surface attributes that a face inherits from its texture are stored in the copy's
+ * attributes if they are serialized.
+ */
+std::vector<Model::BrushFace> copyFacesForDeferredSerialization(
+  const std::vector<Model::BrushFace>& faces)
+{
+  auto result = faces;
+  for (auto& face : result)
+  {
+    if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor())
+    {
+      auto attributes = face.attributes();
+      attributes.setSurfaceContents(face.resolvedSurfaceContents());
+      attributes.setSurfaceFlags(face.resolvedSurfaceFlags());
+      attributes.setSurfaceValue(face.resolvedSurfaceValue());
+      face.setAttributes(attributes);
+    }
+    face.setTexture(nullptr);
+  }
+  return result;
+}
+
+Model::BezierPatch copyPatchForDeferredSerialization(const Model::BezierPatch& patch)
+{
+  auto result = patch;
+  result.setTexture(nullptr);
+  return result;
+}
+} // namespace
+
 MapFileSerializer::MapFileSerializer(std::ostream& stream)
   : m_line(1)
   , m_stream(stream)
+  , m_deferNodes(false)
 {
 }
 
+void MapFileSerializer::setDeferNodes(const bool deferNodes)
+{
+  m_deferNodes = deferNodes;
+}
+
+std::vector<MapFileSerializer::DeferredNode> MapFileSerializer::takeDeferredNodes()
+{
+  return std::exchange(m_deferredNodes, {});
+}
+
+void MapFileSerializer::writeDeferredNodes(
+  const std::string& text, const std::vector<DeferredNode>& deferredNodes)
+{
+  // serialize the deferred nodes in parallel
+  auto strings = std::vector<std::string>(deferredNodes.size());
+  kdl::parallel_for(deferredNodes.size(), [&](const size_t i) {
+    strings[i] = std::visit(
+      kdl::overload(
+        [&](const std::vector<Model::BrushFace>& faces) {
+          return writeBrushFaces(faces).string;
+        },
+        [&](const Model::BezierPatch& patch) { return writePatch(patch).string; }),
+      deferredNodes[i].contents);
+  });
+
+  auto position = size_t(0);
+  for (size_t i = 0; i < deferredNodes.size(); ++i)
+  {
+    const auto nodePosition = deferredNodes[i].position;
+    assert(nodePosition >= position && nodePosition <= text.size());
+
+    m_stream.write(text.data() + position, std::streamsize(nodePosition - position));
+    m_stream << strings[i];
+    position = nodePosition;
+  }
+  m_stream.write(text.data() + position, std::streamsize(text.size() - position));
+}
+
 void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes)
 {
   ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
 
+  if (m_deferNodes)
+  {
+    // brushes and patches are copied when they are written
+    return;
+  }
+
   // collect nodes
   std::vector<std::variant<const Model::BrushNode*, const Model::PatchNode*>>
     nodesToSerialize;
@@ -343,7 +424,7 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
       return std::visit(
         kdl::overload(
           [&](const Model::BrushNode* brushNode) {
-            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+            return Entry{brushNode, writeBrushFaces(brushNode->brush().faces())};
           },
           [&](const Model::PatchNode* patchNode) {
             return Entry{patchNode, writePatch(patchNode->patch())};
@@ -394,14 +475,23 @@ void MapFileSerializer::doBrush(const Model::BrushNode* brush)
   fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
   ++m_line;
 
-  // write pre-serialized brush faces
-  auto it = m_nodeToPrecomputedString.find(brush);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a brush which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  if (m_deferNodes)
+  {
+    m_deferredNodes.push_back(DeferredNode{
+      static_cast<size_t>(m_stream.tellp()),
+      copyFacesForDeferredSerialization(brush->brush().faces())});
+  }
+  else
+  {
+    // write pre-serialized brush faces
+    auto it = m_nodeToPrecomputedString.find(brush);
+    ensure(
+      it != std::end(m_nodeToPrecomputedString),
+      "attempted to serialize a brush which was not passed to doBeginFile");
+    const PrecomputedString& precomputedString = it->second;
+    m_stream << precomputedString.string;
+    m_line += precomputedString.lineCount;
+  }
 
   fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
   ++m_line;
@@ -422,14 +512,23 @@ void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
   ++m_line;
   m_startLineStack.push_back(m_line);
 
-  // write pre-serialized patch
-  auto it = m_nodeToPrecomputedString.find(patchNode);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a patch which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  if (m_deferNodes)
+  {
+    m_deferredNodes.push_back(DeferredNode{
+      static_cast<size_t>(m_stream.tellp()),
+      copyPatchForDeferredSerialization(patchNode->patch())});
+  }
+  else
+  {
+    // write pre-serialized patch
+    auto it = m_nodeToPrecomputedString.find(patchNode);
+    ensure(
+      it != std::end(m_nodeToPrecomputedString),
+      "attempted to serialize a patch which was not passed to doBeginFile");
+    const PrecomputedString& precomputedString = it->second;
+    m_stream << precomputedString.string;
+    m_line += precomputedString.lineCount;
+  }
 
   setFilePosition(patchNode);
 }
@@ -437,7 +536,10 @@ void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
 void MapFileSerializer::setFilePosition(const Model::Node* node)
 {
   const size_t start = startLine();
-  node->setFilePosition(start, m_line - start);
+  if (!m_deferNodes)
+  {
+    node->setFilePosition(start, m_line - start);
+  }
 }
 
 size_t MapFileSerializer::startLine()
@@ -452,14 +554,14 @@ size_t MapFileSerializer::startLine()
  * Threadsafe
  */
 MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
-  const Model::Brush& brush) const
+  const std::vector<Model::BrushFace>& faces) const
 {
   std::stringstream stream;
-  for (const Model::BrushFace& face : brush.faces())
+  for (const Model::BrushFace& face : faces)
   {
     doWriteBrushFace(stream, face);
   }
-  return PrecomputedString{stream.str(), brush.faces().size()};
+  return PrecomputedString{stream.str(), faces.size()};
 }
 
 MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
@@ -20,20 +20,23 @@
 #pragma once
 
 #include "IO/NodeSerializer.h"
+#include "Model/BezierPatch.h"
+#include "Model/BrushFace.h"
 #include "Model/MapFormat.h"
 
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
 namespace TrenchBroom
 {
 namespace Model
 {
-class BezierPatch;
 class Brush;
 class BrushNode;
-class BrushFace;
 class EntityProperty;
 class Node;
 class PatchNode;
@@ -43,6 +46,20 @@ namespace IO
 {
 class MapFileSerializer : public NodeSerializer
 {
+public:
+  /**
+   * A brush or patch whose serialization was deferred. The contents do not reference any
+   * textures.
+   */
+  struct DeferredNode
+  {
+    /**
+     * The position in the stream at which the serialized node must be inserted.
+     */
+    size_t position;
+    std::variant<std::vector<Model::BrushFace>, Model::BezierPatch> contents;
+  };
+
 private:
   using LineStack = std::vector<size_t>;
   LineStack m_startLineStack;
@@ -56,10 +73,33 @@ private:
   };
   std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
 
+  bool m_deferNodes;
+  std::vector<DeferredNode> m_deferredNodes;
+
 public:
-  static std::unique_ptr<NodeSerializer> create(
+  static std::unique_ptr<MapFileSerializer> create(
     Model::MapFormat format, std::ostream& stream);
 
+  /**
+   * If set, brushes and patches are not serialized. Instead, copies of their contents are
+   * recorded together with the stream positions at which they must be inserted, and no
+   * file positions are set on the serialized nodes.
+   *
+   * The recorded nodes can be taken with takeDeferredNodes and serialized later, possibly
+   * on another thread, by passing them to writeDeferredNodes.
+   */
+  void setDeferNodes(bool deferNodes);
+  std::vector<DeferredNode> takeDeferredNodes();
+
+  /**
+   * Writes the given text, which was written by a serializer for the same map format
+   * that deferred the given nodes, and inserts the serializations of the deferred nodes.
+   *
+   * Does not access any nodes, so it can be called on any thread.
+   */
+  void writeDeferredNodes(
+    const std::string& text, const std::vector<DeferredNode>& deferredNodes);
+
 protected:
   explicit MapFileSerializer(std::ostream& stream);
 
@@ -82,7 +122,7 @@ private:
 private: // threadsafe
   virtual void doWriteBrushFace(
     std::ostream& stream, const Model::BrushFace& face) const = 0;
-  PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
+  PrecomputedString writeBrushFaces(const std::vector<Model::BrushFace>& faces) const;
   PrecomputedString writePatch(const Model::BezierPatch& patch) const;
 };
 } // namespace IO
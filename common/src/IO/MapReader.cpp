@@ -19,6 +19,7 @@
 
 #include "MapReader.h"
 
+#include "IO/BufferedParserStatus.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushError.h"
 #include "Model/BrushFace.h"
@@ -34,6 +35,7 @@
 #include "Model/VisibilityState.h"
 #include "Model/WorldNode.h"
 
+#include <kdl/overload.h>
 #include <kdl/parallel.h>
 #include <kdl/result.h>
 #include <kdl/result_fold.h>
@@ -44,7 +46,11 @@
 #include <vecmath/mat.h>
 #include <vecmath/mat_io.h>
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -62,16 +68,25 @@ MapReader::MapReader(
   const Model::MapFormat targetMapFormat,
   Model::EntityPropertyConfig entityPropertyConfig,
   std::vector<std::string> linkedGroupsToKeep)
-  : StandardMapParser(std::move(str), sourceMapFormat, targetMapFormat)
+  : StandardMapParser(str, sourceMapFormat, targetMapFormat)
+  , m_str{str}
   , m_entityPropertyConfig{std::move(entityPropertyConfig)}
   , m_linkedGroupsToKeep{std::move(linkedGroupsToKeep)}
 {
 }
 
+void MapReader::setParallelParseChunkSize(const size_t parallelParseChunkSize)
+{
+  m_parallelParseChunkSize = parallelParseChunkSize;
+}
+
 void MapReader::readEntities(const vm::bbox3& worldBounds, ParserStatus& status)
 {
   m_worldBounds = worldBounds;
-  parseEntities(status);
+  if (!parseEntitiesInParallel(status))
+  {
+    parseEntities(status);
+  }
   createNodes(status);
 }
 
@@ -190,6 +205,140 @@ void MapReader::onPatch(
 
 // helper methods
 
+namespace
+{
+/**
+ * Parses one chunk of a map file and records the object infos for it.
+ */
+class ChunkReader : public MapReader
+{
+public:
+  ChunkReader(
+    const EntityChunk& chunk,
+    const Model::MapFormat sourceMapFormat,
+    const Model::MapFormat targetMapFormat,
+    Model::EntityPropertyConfig entityPropertyConfig)
+    : MapReader{
+      chunk.str, sourceMapFormat, targetMapFormat, std::move(entityPropertyConfig), {}}
+  {
+    setStartPosition(chunk.line, chunk.column);
+  }
+
+private:
+  // nodes are created by the reader that owns the chunk
+  Model::Node* onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus&) override
+  {
+    return nullptr;
+  }
+  void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus&) override {}
+  void onNode(Model::Node*, std::unique_ptr<Model::Node>, ParserStatus&) override {}
+};
+
+struct ChunkResult
+{
+  std::vector<MapReader::ObjectInfo> objectInfos;
+  std::unique_ptr<BufferedParserStatus> status;
+};
+
+void offsetParentIndex(MapReader::ObjectInfo& objectInfo, const size_t offset)
+{
+  std::visit(
+    kdl::overload(
+      [](MapReader::EntityInfo&) {},
+      [&](auto& brushOrPatchInfo) {
+        if (brushOrPatchInfo.parentIndex)
+        {
+          *brushOrPatchInfo.parentIndex += offset;
+        }
+      }),
+    objectInfo);
+}
+} // namespace
+
+/**
+ * Splits the input into chunks of complete top level entities and parses them
+ * concurrently. The resulting object infos are merged in the order of the chunks and the
+ * messages logged while parsing a chunk are forwarded to the given status in the same
+ * order, so the result is identical to parsing the input on the calling thread.
+ *
+ * Progress is reported to the given status whenever a chunk has been parsed. Since the
+ * chunks are parsed by worker threads, the status is called under a lock from these
+ * threads.
+ *
+ * Returns false if the input is too small to be parsed in parallel, if it cannot be split
+ * into chunks, or if parsing any chunk fails. The input must then be parsed on the
+ * calling thread, which also reports any parser errors in the usual way.
+ */
+bool MapReader::parseEntitiesInParallel(ParserStatus& status)
+{
+  if (m_str.size() < 2 * m_parallelParseChunkSize)
+  {
+    return false;
+  }
+
+  // create a few chunks per thread so that uneven chunks are balanced
+  const auto chunkSize = std::max(
+    m_parallelParseChunkSize,
+    m_str.size() / (kdl::default_thread_pool().concurrency() * 4));
+
+  auto chunks = splitEntityChunks(m_str, chunkSize);
+  if (chunks.size() < 2)
+  {
+    return false;
+  }
+
+  const auto totalSize = std::accumulate(
+    chunks.begin(), chunks.end(), size_t(0), [](const auto size, const auto& chunk) {
+      return size + chunk.str.size();
+    });
+  auto progressMutex = std::mutex{};
+  auto parsedSize = size_t(0);
+
+  auto chunkResults = kdl::vec_parallel_transform(
+    std::move(chunks), [&](const EntityChunk& chunk) -> std::optional<ChunkResult> {
+      auto chunkStatus = std::make_unique<BufferedParserStatus>(status);
+      auto chunkReader =
+        ChunkReader{chunk, m_sourceMapFormat, m_targetMapFormat, m_entityPropertyConfig};
+
+      try
+      {
+        chunkReader.parseEntities(*chunkStatus);
+      }
+      catch (const ParserException&)
+      {
+        return std::nullopt;
+      }
+
+      {
+        const auto lock = std::lock_guard{progressMutex};
+        parsedSize += chunk.str.size();
+        status.progress(double(parsedSize) / double(totalSize));
+      }
+
+      return ChunkResult{std::move(chunkReader.m_objectInfos), std::move(chunkStatus)};
+    });
+
+  if (std::any_of(chunkResults.begin(), chunkResults.end(), [](const auto& chunkResult) {
+        return !chunkResult;
+      }))
+  {
+    return false;
+  }
+
+  for (auto& chunkResult : chunkResults)
+  {
+    const auto offset = m_objectInfos.size();
+    for (auto& objectInfo : chunkResult->objectInfos)
+    {
+      offsetParentIndex(objectInfo, offset);
+      m_objectInfos.push_back(std::move(objectInfo));
+    }
+    chunkResult->status->flush();
+  }
+
+  return true;
+}
+
 namespace
 {
 /** The type of a node's container. */
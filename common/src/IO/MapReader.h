@@ -104,10 +104,19 @@ public: // only public so that helper methods can see these declarations
 
   using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
+public:
+  /**
+   * Maps that are at least twice as large as this are parsed in parallel, see
+   * setParallelParseChunkSize.
+   */
+  static constexpr size_t DefaultParallelParseChunkSize = 1024u * 1024u;
+
 private:
+  std::string_view m_str;
   Model::EntityPropertyConfig m_entityPropertyConfig;
   std::vector<std::string> m_linkedGroupsToKeep;
   vm::bbox3 m_worldBounds;
+  size_t m_parallelParseChunkSize = DefaultParallelParseChunkSize;
 
 private: // data populated in response to MapParser callbacks
   std::vector<ObjectInfo> m_objectInfos;
@@ -132,6 +141,16 @@ protected:
     Model::EntityPropertyConfig entityPropertyConfig,
     std::vector<std::string> linkedGroupsToKeep);
 
+public:
+  /**
+   * Sets the minimum number of bytes that are parsed by one thread when parsing entities
+   * in parallel. When parsing entities, the input is split into chunks of complete top
+   * level entities that are parsed concurrently and merged in their original order.
+   * Inputs that are smaller than twice the chunk size are parsed on the calling thread.
+   */
+  void setParallelParseChunkSize(size_t parallelParseChunkSize);
+
+protected:
   /**
    * Attempts to parse as one or more entities.
    *
@@ -188,6 +207,7 @@ protected: // implement MapParser interface
     ParserStatus& status) override;
 
 private: // helper methods
+  bool parseEntitiesInParallel(ParserStatus& status);
   void createNodes(ParserStatus& status);
 
 private: // subclassing interface - these will be called in the order that nodes should be
@@ -0,0 +1,58 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapSnapshot.h"
+
+#include "IO/IOUtils.h"
+#include "IO/NodeWriter.h"
+#include "Model/WorldNode.h"
+
+#include <sstream>
+#include <utility>
+
+namespace TrenchBroom
+{
+namespace IO
+{
+MapSnapshot::MapSnapshot(const Model::WorldNode& world, const std::string& gameName)
+  : m_format{world.mapFormat()}
+{
+  auto stream = std::stringstream{};
+  writeGameComment(stream, gameName, Model::formatName(m_format));
+
+  auto serializer = MapFileSerializer::create(m_format, stream);
+  serializer->setDeferNodes(true);
+
+  // the writer owns the serializer, but the deferred nodes must be taken before the
+  // writer is destroyed
+  auto& deferringSerializer = *serializer;
+  auto writer = NodeWriter{world, std::move(serializer)};
+  writer.writeMap();
+
+  m_text = stream.str();
+  m_deferredNodes = deferringSerializer.takeDeferredNodes();
+}
+
+void MapSnapshot::write(std::ostream& stream) const
+{
+  auto serializer = MapFileSerializer::create(m_format, stream);
+  serializer->writeDeferredNodes(m_text, m_deferredNodes);
+}
+} // namespace IO
+} // namespace TrenchBroom
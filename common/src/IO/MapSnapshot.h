@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/MapFileSerializer.h"
+#include "Model/MapFormat.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class WorldNode;
+}
+
+namespace IO
+{
+/**
+ * A snapshot of a map that can be written on another thread while the map is edited.
+ *
+ * Taking a snapshot serializes the entities, layers and groups of the map and copies the
+ * contents of its brushes and patches. Serializing the brushes and patches, which is the
+ * expensive part of writing a map, is deferred until the snapshot is written. The
+ * snapshot does not reference any nodes or assets.
+ */
+class MapSnapshot
+{
+private:
+  Model::MapFormat m_format;
+  std::string m_text;
+  std::vector<MapFileSerializer::DeferredNode> m_deferredNodes;
+
+public:
+  /**
+   * Takes a snapshot of the given world. The game name is written to the map file's
+   * header.
+   */
+  MapSnapshot(const Model::WorldNode& world, const std::string& gameName);
+
+  /**
+   * Writes the map to the given stream like NodeWriter does.
+   */
+  void write(std::ostream& stream) const;
+};
+} // namespace IO
+} // namespace TrenchBroom
@@ -28,103 +28,339 @@
 #include "Model/PatchNode.h"
 #include "Model/Polyhedron.h"
 
+#include <kdl/flat_hash_map.h>
 #include <kdl/overload.h>
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/vec.h>
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <type_traits>
 #include <utility>
 
 namespace TrenchBroom
 {
 namespace IO
 {
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex)
+namespace
+{
+/**
+ * Hashes vectors consistently with their equality operator, which considers 0 and -0 to
+ * be equal.
+ */
+struct VecHash
+{
+  template <typename T, std::size_t S>
+  std::size_t operator()(const vm::vec<T, S>& v) const
+  {
+    static_assert(std::is_floating_point_v<T> && sizeof(T) <= sizeof(std::uint64_t));
+
+    auto result = std::uint64_t(0);
+    for (std::size_t i = 0; i < S; ++i)
+    {
+      const auto component = v[i] == T(0) ? T(0) : v[i];
+
+      auto bits = std::uint64_t(0);
+      std::memcpy(&bits, &component, sizeof(T));
+      result = (result ^ bits) * 0x100000001b3u;
+      result ^= result >> 32u;
+    }
+    return std::size_t(result);
+  }
+};
+
+/**
+ * Assigns indices to values in the order in which they are first added. Most objects
+ * only have a few distinct values, so the values are searched linearly until there are
+ * too many of them to do that efficiently.
+ */
+template <typename V>
+class IndexMap
 {
-  str << " " << (vertex.vertex + 1u) << "/" << (vertex.texCoords + 1u) << "/"
-      << (vertex.normal + 1u);
-  return str;
+private:
+  static constexpr auto MaxLinearSearchSize = size_t(32);
+
+  kdl::flat_hash_map<V, size_t, VecHash> m_map;
+  std::vector<V> m_list;
+
+public:
+  const std::vector<V>& list() const { return m_list; }
+
+  void reserve(const size_t count)
+  {
+    m_list.reserve(count);
+    if (count > MaxLinearSearchSize)
+    {
+      m_map.reserve(count);
+    }
+  }
+
+  size_t index(const V& v)
+  {
+    if (m_list.size() <= MaxLinearSearchSize)
+    {
+      const auto it = std::find(m_list.begin(), m_list.end(), v);
+      if (it != m_list.end())
+      {
+        return size_t(std::distance(m_list.begin(), it));
+      }
+
+      m_list.push_back(v);
+      if (m_list.size() > MaxLinearSearchSize)
+      {
+        for (size_t i = 0u; i < m_list.size(); ++i)
+        {
+          m_map.try_emplace(m_list[i], i);
+        }
+      }
+      return m_list.size() - 1u;
+    }
+
+    const auto [it, inserted] = m_map.try_emplace(v, m_list.size());
+    if (inserted)
+    {
+      m_list.push_back(v);
+    }
+    return it->second;
+  }
+};
+
+/**
+ * The indices of a vertex's position, texture coordinates and normal in the lists of
+ * its object.
+ */
+struct IndexedVertex
+{
+  size_t position;
+  size_t texCoords;
+  size_t normal;
+};
+
+/**
+ * A brush face or all quads of a patch. The polygons of a surface share one material and
+ * have the same number of vertices.
+ */
+struct Surface
+{
+  std::string textureName;
+  const Assets::Texture* texture;
+  size_t verticesPerPolygon;
+  std::vector<IndexedVertex> vertices;
+};
+
+/**
+ * The geometry of a brush or patch. The positions, texture coordinates and normals are
+ * deduplicated within the object only.
+ */
+struct Object
+{
+  std::string name;
+  IndexMap<vm::vec3> positions;
+  IndexMap<vm::vec2f> texCoords;
+  IndexMap<vm::vec3> normals;
+  std::vector<Surface> surfaces;
+};
+
+Object makeBrushObject(
+  const Model::BrushNode& brushNode, const size_t entityNo, const size_t brushNo)
+{
+  const auto& brush = brushNode.brush();
+
+  auto object =
+    Object{fmt::format("entity{}_brush{}", entityNo, brushNo), {}, {}, {}, {}};
+  object.surfaces.reserve(brush.faceCount());
+
+  for (const auto& face : brush.faces())
+  {
+    const auto normalIndex = object.normals.index(face.boundary().normal);
+
+    auto surface = Surface{
+      face.attributes().textureName(), face.texture(), face.vertexCount(), {}};
+    surface.vertices.reserve(face.vertexCount());
+
+    for (const auto* vertex : face.vertices())
+    {
+      const auto& position = vertex->position();
+      surface.vertices.push_back(IndexedVertex{
+        object.positions.index(position),
+        object.texCoords.index(face.textureCoords(position)),
+        normalIndex});
+    }
+
+    object.surfaces.push_back(std::move(surface));
+  }
+
+  return object;
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object)
+Object makePatchObject(
+  const Model::PatchNode& patchNode, const size_t entityNo, const size_t patchNo)
 {
-  str << "o entity" << object.entityNo << "_brush" << object.brushNo << "\n";
-  for (const auto& face : object.faces)
+  const auto& patch = patchNode.patch();
+  const auto& patchGrid = patchNode.grid();
+
+  auto object =
+    Object{fmt::format("entity{}_patch{}", entityNo, patchNo), {}, {}, {}, {}};
+
+  const auto pointCount = patchGrid.points.size();
+  object.positions.reserve(pointCount);
+  object.texCoords.reserve(pointCount);
+  object.normals.reserve(pointCount);
+
+  auto surface = Surface{patch.textureName(), patch.texture(), 4u, {}};
+  surface.vertices.reserve(4u * patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+  const auto addVertex = [&](const auto& p) {
+    surface.vertices.push_back(IndexedVertex{
+      object.positions.index(p.position),
+      object.texCoords.index(vm::vec2f{p.texCoords}),
+      object.normals.index(p.normal)});
+  };
+
+  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
   {
-    str << "usemtl " << face.textureName << "\n";
-    str << "f";
-    for (const auto& vertex : face.verts)
+    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
     {
-      str << " " << vertex;
+      // counter clockwise order
+      addVertex(patchGrid.point(row, col));
+      addVertex(patchGrid.point(row + 1u, col));
+      addVertex(patchGrid.point(row + 1u, col + 1u));
+      addVertex(patchGrid.point(row, col + 1u));
     }
-    str << "\n";
   }
-  return str;
+
+  object.surfaces.push_back(std::move(surface));
+  return object;
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object)
+/**
+ * Maps the indices of an object's lists to the indices of the lists in the OBJ file.
+ */
+struct ObjectIndices
+{
+  size_t positionOffset;
+  std::vector<size_t> texCoords;
+  std::vector<size_t> normals;
+};
+
+/**
+ * Calls the given function to format the given number of items in parallel and writes
+ * the formatted items to the given stream in order. The items are formatted in batches
+ * so that only one batch is held in memory.
+ */
+template <typename F>
+void writeParallel(std::ostream& str, const size_t count, const F& format)
 {
-  str << "o entity" << object.entityNo << "_patch" << object.patchNo << "\n";
-  str << "usemtl " << object.textureName << "\n";
-  for (const auto& quad : object.quads)
+  constexpr auto BatchSize = size_t(4096);
+
+  auto buffers = std::vector<fmt::memory_buffer>(std::min(count, BatchSize));
+  for (size_t first = 0u; first < count; first += BatchSize)
   {
-    str << "f";
-    for (const auto& vertex : quad.verts)
+    const auto batchSize = std::min(count - first, BatchSize);
+    kdl::parallel_for(batchSize, [&](const size_t i) {
+      buffers[i].clear();
+      format(buffers[i], first + i);
+    });
+
+    for (size_t i = 0u; i < batchSize; ++i)
     {
-      str << " " << vertex;
+      str.write(buffers[i].data(), std::streamsize(buffers[i].size()));
     }
-    str << "\n";
   }
-  return str;
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object)
+/**
+ * Formats the given values in parallel in chunks of lines.
+ */
+template <typename V, typename F>
+void writeLinesParallel(std::ostream& str, const std::vector<V>& values, const F& format)
 {
-  std::visit(
-    kdl::overload(
-      [&](const ObjSerializer::BrushObject& brushObject) { str << brushObject; },
-      [&](const ObjSerializer::PatchObject& patchObject) { str << patchObject; }),
-    object);
-  return str;
+  constexpr auto ChunkSize = size_t(1024);
+
+  const auto chunkCount = (values.size() + ChunkSize - 1u) / ChunkSize;
+  writeParallel(str, chunkCount, [&](auto& buffer, const size_t chunk) {
+    const auto last = std::min((chunk + 1u) * ChunkSize, values.size());
+    for (size_t i = chunk * ChunkSize; i < last; ++i)
+    {
+      format(buffer, values[i]);
+    }
+  });
 }
 
-ObjSerializer::ObjSerializer(
-  std::ostream& objStream,
-  std::ostream& mtlStream,
-  std::string mtlFilename,
-  IO::ObjExportOptions options)
-  : m_objStream{objStream}
-  , m_mtlStream{mtlStream}
-  , m_mtlFilename{std::move(mtlFilename)}
-  , m_options{std::move(options)}
+void formatVertex(fmt::memory_buffer& buffer, const vm::vec3& position)
 {
-  ensure(m_objStream.good(), "obj stream is good");
-  ensure(m_mtlStream.good(), "mtl stream is good");
+  // no idea why I have to switch Y and Z
+  fmt::format_to(
+    std::back_inserter(buffer),
+    "v {} {} {}\n",
+    position.x(),
+    position.z(),
+    -position.y());
 }
 
-void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
+void formatTexCoords(fmt::memory_buffer& buffer, const vm::vec2f& texCoords)
+{
+  // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
+  // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
+  fmt::format_to(std::back_inserter(buffer), "vt {} {}\n", texCoords.x(), -texCoords.y());
+}
+
+void formatNormal(fmt::memory_buffer& buffer, const vm::vec3& normal)
+{
+  // no idea why I have to switch Y and Z
+  fmt::format_to(
+    std::back_inserter(buffer), "vn {} {} {}\n", normal.x(), normal.z(), -normal.y());
+}
 
-static void writeMtlFile(
+void formatObject(
+  fmt::memory_buffer& buffer, const Object& object, const ObjectIndices& indices)
+{
+  auto out = std::back_inserter(buffer);
+  fmt::format_to(out, "o {}\n", object.name);
+  for (const auto& surface : object.surfaces)
+  {
+    fmt::format_to(out, "usemtl {}\n", surface.textureName);
+    for (size_t first = 0u; first < surface.vertices.size();
+         first += surface.verticesPerPolygon)
+    {
+      fmt::format_to(out, "f");
+      for (size_t i = first; i < first + surface.verticesPerPolygon; ++i)
+      {
+        const auto& vertex = surface.vertices[i];
+        fmt::format_to(
+          out,
+          "  {}/{}/{}",
+          indices.positionOffset + vertex.position + 1u,
+          indices.texCoords[vertex.texCoords] + 1u,
+          indices.normals[vertex.normal] + 1u);
+      }
+      fmt::format_to(out, "\n");
+    }
+  }
+  fmt::format_to(out, "\n");
+}
+
+void writeMtlFile(
   std::ostream& str,
-  const std::vector<ObjSerializer::Object>& objects,
+  const std::vector<Object>& objects,
   const IO::ObjExportOptions& options)
 {
   auto usedTextures = std::map<std::string, const Assets::Texture*>{};
 
   for (const auto& object : objects)
   {
-    std::visit(
-      kdl::overload(
-        [&](const ObjSerializer::BrushObject& brushObject) {
-          for (const auto& face : brushObject.faces)
-          {
-            usedTextures[face.textureName] = face.texture;
-          }
-        },
-        [&](const ObjSerializer::PatchObject& patchObject) {
-          usedTextures[patchObject.textureName] = patchObject.texture;
-        }),
-      object);
+    for (const auto& surface : object.surfaces)
+    {
+      usedTextures[surface.textureName] = surface.texture;
+    }
   }
 
   const auto basePath = options.exportPath.parent_path();
@@ -152,78 +388,92 @@ static void writeMtlFile(
   }
 }
 
-static void writeVertices(std::ostream& str, const std::vector<vm::vec3>& vertices)
+void writeObjFile(
+  std::ostream& str, const std::string& mtlFilename, const std::vector<Object>& objects)
 {
-  str << "# vertices\n";
-  for (const vm::vec3& elem : vertices)
-  {
-    // no idea why I have to switch Y and Z
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
-  }
-}
+  // Positions are only shared within an object, but texture coordinates and normals are
+  // shared by all objects. Their indices are assigned in the order in which they are
+  // first used.
+  auto texCoords = IndexMap<vm::vec2f>{};
+  auto normals = IndexMap<vm::vec3>{};
 
-static void writeTexCoords(std::ostream& str, const std::vector<vm::vec2f>& texCoords)
-{
-  str << "# texture coordinates\n";
-  for (const vm::vec2f& elem : texCoords)
-  {
-    // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
-    // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "vt {} {}\n", elem.x(), -elem.y());
-  }
-}
+  auto positionOffset = size_t(0);
+  auto indices = std::vector<ObjectIndices>{};
+  indices.reserve(objects.size());
 
-static void writeNormals(std::ostream& str, const std::vector<vm::vec3>& normals)
-{
-  str << "# normals\n";
-  for (const vm::vec3& elem : normals)
+  for (const auto& object : objects)
   {
-    // no idea why I have to switch Y and Z
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(str),
-      "vn {} {} {}\n",
-      elem.x(),
-      elem.z(),
-      -elem.y());
+    indices.push_back(ObjectIndices{
+      positionOffset,
+      kdl::vec_transform(
+        object.texCoords.list(), [&](const auto& t) { return texCoords.index(t); }),
+      kdl::vec_transform(
+        object.normals.list(), [&](const auto& n) { return normals.index(n); })});
+    positionOffset += object.positions.list().size();
   }
-}
-
-static void writeObjFile(
-  std::ostream& str,
-  const std::string mtlFilename,
-  const std::vector<vm::vec3>& vertices,
-  const std::vector<vm::vec2f>& texCoords,
-  const std::vector<vm::vec3>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
-{
 
   str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
+
+  str << "# vertices\n";
+  writeParallel(str, objects.size(), [&](auto& buffer, const size_t i) {
+    for (const auto& position : objects[i].positions.list())
+    {
+      formatVertex(buffer, position);
+    }
+  });
   str << "\n";
-  writeTexCoords(str, texCoords);
+
+  str << "# texture coordinates\n";
+  writeLinesParallel(str, texCoords.list(), formatTexCoords);
   str << "\n";
-  writeNormals(str, normals);
+
+  str << "# normals\n";
+  writeLinesParallel(str, normals.list(), formatNormal);
   str << "\n";
 
-  for (const auto& object : objects)
-  {
-    str << object;
-    str << "\n";
-  }
+  writeParallel(str, objects.size(), [&](auto& buffer, const size_t i) {
+    formatObject(buffer, objects[i], indices[i]);
+  });
+}
+} // namespace
+
+ObjSerializer::ObjSerializer(
+  std::ostream& objStream,
+  std::ostream& mtlStream,
+  std::string mtlFilename,
+  IO::ObjExportOptions options)
+  : m_objStream{objStream}
+  , m_mtlStream{mtlStream}
+  , m_mtlFilename{std::move(mtlFilename)}
+  , m_options{std::move(options)}
+{
+  ensure(m_objStream.good(), "obj stream is good");
+  ensure(m_mtlStream.good(), "mtl stream is good");
 }
 
+void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
+
 void ObjSerializer::doEndFile()
 {
-  writeMtlFile(m_mtlStream, m_objects, m_options);
-  writeObjFile(
-    m_objStream,
-    m_mtlFilename,
-    m_vertices.list(),
-    m_texCoords.list(),
-    m_normals.list(),
-    m_objects);
+  const auto makeObject = [](const ExportedNode& exportedNode) {
+    const auto entityNo = exportedNode.entityNo;
+    const auto brushNo = exportedNode.brushNo;
+    return std::visit(
+      kdl::overload(
+        [&](const Model::BrushNode* brushNode) {
+          return makeBrushObject(*brushNode, entityNo, brushNo);
+        },
+        [&](const Model::PatchNode* patchNode) {
+          return makePatchObject(*patchNode, entityNo, brushNo);
+        }),
+      exportedNode.node);
+  };
+
+  // computing the geometry is the expensive part of the export
+  const auto objects = kdl::vec_parallel_transform(std::move(m_nodes), makeObject);
+
+  writeMtlFile(m_mtlStream, objects, m_options);
+  writeObjFile(m_objStream, m_mtlFilename, objects);
 }
 
 void ObjSerializer::doBeginEntity(const Model::Node* /* node */) {}
@@ -232,79 +482,17 @@ void ObjSerializer::doEntityProperty(const Model::EntityProperty& /* property */
 
 void ObjSerializer::doBrush(const Model::BrushNode* brush)
 {
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  for (const Model::BrushFace& face : brush->brush().faces())
-  {
-    doBrushFace(face);
-  }
-
-  m_objects.push_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
+  m_nodes.push_back(ExportedNode{brush, entityNo(), brushNo()});
 }
 
-void ObjSerializer::doBrushFace(const Model::BrushFace& face)
+void ObjSerializer::doBrushFace(const Model::BrushFace& /* face */)
 {
-  const vm::vec3& normal = face.boundary().normal;
-  const size_t normalIndex = m_normals.index(normal);
-
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
-
-  for (const Model::BrushVertex* vertex : face.vertices())
-  {
-    const vm::vec3& position = vertex->position();
-    const vm::vec2f texCoords = face.textureCoords(position);
-
-    const size_t vertexIndex = m_vertices.index(position);
-    const size_t texCoordsIndex = m_texCoords.index(texCoords);
-
-    indexedVertices.push_back(IndexedVertex{vertexIndex, texCoordsIndex, normalIndex});
-  }
-
-  m_currentBrush->faces.push_back(BrushFace{
-    std::move(indexedVertices), face.attributes().textureName(), face.texture()});
+  // faces are exported with their brushes
 }
 
 void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
 {
-  const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.textureName(), patch.texture()};
-
-  const auto& patchGrid = patchNode->grid();
-  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  const auto makeIndexedVertex = [&](const auto& p) {
-    const size_t positionIndex = m_vertices.index(p.position);
-    const size_t texCoordsIndex = m_texCoords.index(vm::vec2f{p.texCoords});
-    const size_t normalIndex = m_normals.index(p.normal);
-
-    return IndexedVertex{positionIndex, texCoordsIndex, normalIndex};
-  };
-
-  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
-  {
-    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
-    {
-      // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
-        makeIndexedVertex(patchGrid.point(row, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-        makeIndexedVertex(patchGrid.point(row, col + 1u)),
-      }});
-    }
-  }
-
-  m_objects.push_back(std::move(patchObject));
+  m_nodes.push_back(ExportedNode{patchNode, entityNo(), brushNo()});
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -19,124 +19,51 @@
 
 #pragma once
 
-#include "FloatType.h"
 #include "IO/ExportOptions.h"
 #include "IO/NodeSerializer.h"
 
-#include <vecmath/forward.h>
-
-#include <array>
 #include <iosfwd>
-#include <map>
-#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
 namespace TrenchBroom
 {
-namespace Assets
-{
-class Texture;
-}
-
 namespace Model
 {
 class BrushNode;
 class BrushFace;
 class EntityProperty;
 class Node;
+class PatchNode;
 } // namespace Model
 
 namespace IO
 {
+/**
+ * Exports the brushes and patches of a map to an OBJ file and their materials to an MTL
+ * file.
+ *
+ * The brushes and patches are only collected while the map is traversed. When the file
+ * ends, their geometry is computed and formatted in parallel, and the OBJ file is written
+ * in batches.
+ */
 class ObjSerializer : public NodeSerializer
 {
-public:
-  template <typename V>
-  class IndexMap
-  {
-  private:
-    std::map<V, size_t> m_map;
-    std::vector<V> m_list;
-
-  public:
-    const std::vector<V>& list() const { return m_list; }
-
-    size_t index(const V& v)
-    {
-      const auto it = m_map.emplace(v, m_list.size()).first;
-      const size_t index = it->second;
-      if (index == m_list.size())
-      {
-        m_list.push_back(v);
-      }
-      return index;
-    }
-
-    /**
-     * Values inserted after this is called will not reuse indices from before this
-     * is called.
-     */
-    void clearIndices() { m_map.clear(); }
-  };
-
-  struct IndexedVertex
-  {
-    size_t vertex;
-    size_t texCoords;
-    size_t normal;
-  };
-
-  struct BrushFace
-  {
-    std::vector<IndexedVertex> verts;
-    std::string textureName;
-    const Assets::Texture* texture;
-  };
-
-  struct BrushObject
-  {
-    size_t entityNo;
-    size_t brushNo;
-    std::vector<BrushFace> faces;
-  };
-
-  struct PatchQuad
-  {
-    std::array<IndexedVertex, 4u> verts;
-  };
-
-  struct PatchObject
+private:
+  struct ExportedNode
   {
-    size_t entityNo;
-    size_t patchNo;
-    std::vector<PatchQuad> quads;
-    std::string textureName;
-    const Assets::Texture* texture;
+    std::variant<const Model::BrushNode*, const Model::PatchNode*> node;
+    ObjectNo entityNo;
+    ObjectNo brushNo;
   };
 
-  using Object = std::variant<BrushObject, PatchObject>;
-
-  friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
-  friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
-  friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const PatchQuad& quad);
-  friend std::ostream& operator<<(std::ostream& str, const PatchObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const Object& object);
-
-private:
   std::ostream& m_objStream;
   std::ostream& m_mtlStream;
   std::string m_mtlFilename;
   ObjExportOptions m_options;
 
-  IndexMap<vm::vec3> m_vertices;
-  IndexMap<vm::vec2f> m_texCoords;
-  IndexMap<vm::vec3> m_normals;
-
-  std::optional<BrushObject> m_currentBrush;
-  std::vector<Object> m_objects;
+  std::vector<ExportedNode> m_nodes;
 
 public:
   ObjSerializer(
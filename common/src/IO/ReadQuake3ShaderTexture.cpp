@@ -25,6 +25,7 @@
 #include "IO/FileSystem.h"
 #include "IO/PathInfo.h"
 #include "IO/ReadFreeImageTexture.h"
+#include "IO/TextureCache.h"
 
 #include <kdl/functional.h>
 #include <kdl/result.h>
@@ -100,77 +101,111 @@ std::optional<std::filesystem::path> findImagePath(
   return std::nullopt;
 }
 
-kdl::result<Assets::Texture, ReadTextureError> loadTextureImage(
-  std::string shaderName, const std::filesystem::path& imagePath, const FileSystem& fs)
+PreparedTexture makeDecodeTextureError(std::string shaderName, std::string msg)
 {
-  auto imageName = imagePath.filename();
-  if (fs.pathInfo(imagePath) != PathInfo::File)
+  return {
+    [error = ReadTextureError{std::move(shaderName), std::move(msg)}]()
+      -> kdl::result<Assets::Texture, ReadTextureError> { return error; },
+    0};
+}
+
+void applyShader(Assets::Texture& texture, const Assets::Quake3Shader& shader)
+{
+  texture.setSurfaceParms(shader.surfaceParms);
+  texture.setOpaque();
+
+  // Note that Quake 3 has a different understanding of front and back, so we need to
+  // invert them.
+  switch (shader.culling)
   {
-    return ReadTextureError{
-      std::move(shaderName), "Image file '" + imagePath.string() + "' does not exist"};
+  case Assets::Quake3Shader::Culling::Front:
+    texture.setCulling(Assets::TextureCulling::Back);
+    break;
+  case Assets::Quake3Shader::Culling::Back:
+    texture.setCulling(Assets::TextureCulling::Front);
+    break;
+  case Assets::Quake3Shader::Culling::None:
+    texture.setCulling(Assets::TextureCulling::None);
+    break;
   }
 
-  const auto file = fs.openFile(imagePath);
-  auto reader = file->reader().buffer();
-  return readFreeImageTexture(std::move(shaderName), reader);
+  if (!shader.stages.empty())
+  {
+    const auto& stage = shader.stages.front();
+    if (stage.blendFunc.enable())
+    {
+      texture.setBlendFunc(
+        glGetEnum(stage.blendFunc.srcFactor), glGetEnum(stage.blendFunc.destFactor));
+    }
+    else
+    {
+      texture.disableBlend();
+    }
+  }
 }
 
 } // namespace
 
-kdl::result<Assets::Texture, ReadTextureError> readQuake3ShaderTexture(
-  std::string shaderName, const File& file, const FileSystem& fs)
+PreparedTexture prepareQuake3ShaderTexture(
+  std::string shaderName,
+  const File& file,
+  const FileSystem& fs,
+  const TextureCache* textureCache)
 {
   const auto* shaderFile = dynamic_cast<const ObjectFile<Assets::Quake3Shader>*>(&file);
   if (!shaderFile)
   {
-    return ReadTextureError{std::move(shaderName), "Shader not found: " + shaderName};
+    auto msg = "Shader not found: " + shaderName;
+    return makeDecodeTextureError(std::move(shaderName), std::move(msg));
   }
 
   const auto& shader = shaderFile->object();
   const auto imagePath = findImagePath(shader, fs);
   if (!imagePath)
   {
-    return ReadTextureError{
+    return makeDecodeTextureError(
       std::move(shaderName),
-      "Could not find texture path for shader '" + shader.shaderPath.string() + "'"};
+      "Could not find texture path for shader '" + shader.shaderPath.string() + "'");
+  }
+
+  if (fs.pathInfo(*imagePath) != PathInfo::File)
+  {
+    return makeDecodeTextureError(
+      std::move(shaderName), "Image file '" + imagePath->string() + "' does not exist");
   }
 
-  return loadTextureImage(std::move(shaderName), *imagePath, fs)
-    .and_then([&](Assets::Texture&& texture) {
-      texture.setSurfaceParms(shader.surfaceParms);
-      texture.setOpaque();
-
-      // Note that Quake 3 has a different understanding of front and back, so we need to
-      // invert them.
-      switch (shader.culling)
-      {
-      case Assets::Quake3Shader::Culling::Front:
-        texture.setCulling(Assets::TextureCulling::Back);
-        break;
-      case Assets::Quake3Shader::Culling::Back:
-        texture.setCulling(Assets::TextureCulling::Front);
-        break;
-      case Assets::Quake3Shader::Culling::None:
-        texture.setCulling(Assets::TextureCulling::None);
-        break;
-      }
-
-      if (!shader.stages.empty())
-      {
-        const auto& stage = shader.stages.front();
-        if (stage.blendFunc.enable())
-        {
-          texture.setBlendFunc(
-            glGetEnum(stage.blendFunc.srcFactor), glGetEnum(stage.blendFunc.destFactor));
-        }
-        else
-        {
-          texture.disableBlend();
-        }
-      }
-
-      return kdl::result<Assets::Texture>{std::move(texture)};
-    });
+  // the image file is captured to keep the memory of the reader alive
+  auto imageFile = fs.openFile(*imagePath);
+  auto reader = imageFile->reader().buffer();
+  const auto size = reader.size();
+  return {
+    [shaderName = std::move(shaderName),
+     shader,
+     imageFile = std::move(imageFile),
+     reader = std::move(reader),
+     textureCache]() mutable {
+      // only the decoded image is cached, the shader is applied afterwards
+      return decodeTextureWithCache(
+               textureCache,
+               shaderName,
+               *imageFile,
+               reader,
+               0,
+               [&](Reader& imageReader) {
+                 return readFreeImageTexture(shaderName, imageReader);
+               })
+        .and_then([&](Assets::Texture&& texture) {
+          applyShader(texture, shader);
+          return kdl::result<Assets::Texture>{std::move(texture)};
+        });
+    },
+    size};
+}
+
+kdl::result<Assets::Texture, ReadTextureError> readQuake3ShaderTexture(
+  std::string shaderName, const File& file, const FileSystem& fs)
+{
+  return prepareQuake3ShaderTexture(std::move(shaderName), file, fs).decode();
 }
 
 } // namespace TrenchBroom::IO
@@ -29,6 +29,7 @@ namespace TrenchBroom::IO
 {
 class File;
 class FileSystem;
+class TextureCache;
 
 /**
  * Loads a texture that represents a Quake 3 shader from the file system. Uses a given
@@ -38,4 +39,18 @@ class FileSystem;
 kdl::result<Assets::Texture, ReadTextureError> readQuake3ShaderTexture(
   std::string shaderName, const File& file, const FileSystem& fs);
 
+/**
+ * Locates and reads the editor image for a Quake 3 shader like readQuake3ShaderTexture,
+ * but defers decoding the image. All file system accesses happen in this function, so
+ * the returned decode function may be called on any thread. The size of the returned
+ * texture is the size of the editor image data that was read.
+ *
+ * If a texture cache is given, the decoded editor image is loaded from and stored in it.
+ */
+PreparedTexture prepareQuake3ShaderTexture(
+  std::string shaderName,
+  const File& file,
+  const FileSystem& fs,
+  const TextureCache* textureCache = nullptr);
+
 } // namespace TrenchBroom::IO
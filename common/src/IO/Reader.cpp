@@ -21,9 +21,11 @@
 
 #include "IO/IOUtils.h"
 #include "IO/ReaderException.h"
+#include "Macros.h"
 
 #include <cassert>
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <functional>
 #include <string>
@@ -176,10 +178,44 @@ public:
   }
 };
 
+/**
+ * Locks a C file while it exists so that seeking and reading the file is not interleaved
+ * with other threads reading from the same file.
+ */
+class FileLock
+{
+private:
+  std::FILE* m_file;
+
+public:
+  explicit FileLock(std::FILE* file)
+    : m_file{file}
+  {
+#ifdef _WIN32
+    _lock_file(m_file);
+#else
+    flockfile(m_file);
+#endif
+  }
+
+  ~FileLock()
+  {
+#ifdef _WIN32
+    _unlock_file(m_file);
+#else
+    funlockfile(m_file);
+#endif
+  }
+
+  deleteCopyAndMove(FileLock);
+};
+
 /**
  * A reader source that reads directly from a file. Note that the seek position of the
  * underlying C file is kept in sync with this file source's position automatically,
  * that is, two readers can read from the same underlying file without causing problems.
+ * The readers may also be used on different threads, e.g. when an archive is read by a
+ * background task.
  */
 class FileReaderSource : public ReaderSource
 {
@@ -211,6 +247,8 @@ public:
 
   void read(char* val, const size_t position, const size_t size) override
   {
+    const auto lock = FileLock{m_file};
+
     const auto pos = std::ftell(m_file);
     if (pos < 0)
     {
@@ -237,6 +275,7 @@ public:
 
   std::shared_ptr<BufferReaderSource> buffer() const override
   {
+    const auto lock = FileLock{m_file};
     std::fseek(m_file, long(m_offset), SEEK_SET);
 
 #if defined __APPLE__
@@ -36,6 +36,231 @@ namespace TrenchBroom
 {
 namespace IO
 {
+namespace
+{
+bool isWhitespace(const char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Scans a map file using the same lexical rules as QuakeMapTokenizer, but only
+ * distinguishes between braces, quoted strings, comments and everything else.
+ */
+class EntityChunkScanner
+{
+private:
+  const char* m_begin;
+  const char* m_end;
+  const char* m_cur;
+  size_t m_line = 1;
+
+public:
+  explicit EntityChunkScanner(const std::string_view str)
+    : m_begin{str.data()}
+    , m_end{str.data() + str.size()}
+    , m_cur{m_begin}
+  {
+  }
+
+  std::vector<EntityChunk> split(const size_t minChunkSize)
+  {
+    auto result = std::vector<EntityChunk>{};
+
+    auto depth = size_t(0);
+    auto chunk = EntityChunk{{}, 1, 1};
+    const auto* chunkBegin = m_cur;
+
+    while (m_cur < m_end)
+    {
+      switch (*m_cur)
+      {
+      case '/':
+        if (lookAhead(1) == '/')
+        {
+          if (lookAhead(2) == '/' && lookAhead(3) == ' ')
+          {
+            // a comment token, the remainder of the line is tokenized
+            m_cur += 3;
+          }
+          else
+          {
+            skipLine();
+          }
+        }
+        else
+        {
+          ++m_cur;
+        }
+        break;
+      case ';':
+        skipLine();
+        break;
+      case '"':
+        if (!skipQuotedString())
+        {
+          return {};
+        }
+        break;
+      case '(':
+      case ')':
+      case '[':
+      case ']':
+        ++m_cur;
+        break;
+      case '{':
+        if (!isBraceToken())
+        {
+          skipWord();
+          break;
+        }
+        ++m_cur;
+        ++depth;
+        break;
+      case '}':
+        if (!isBraceToken())
+        {
+          skipWord();
+          break;
+        }
+        if (depth == 0)
+        {
+          return {};
+        }
+        ++m_cur;
+        if (--depth == 0 && size_t(m_cur - chunkBegin) >= minChunkSize)
+        {
+          chunk.str = std::string_view{chunkBegin, size_t(m_cur - chunkBegin)};
+          result.push_back(chunk);
+
+          chunkBegin = m_cur;
+          chunk = EntityChunk{{}, m_line, column()};
+        }
+        break;
+      case '\n':
+        ++m_line;
+        ++m_cur;
+        break;
+      case '\r':
+        if (lookAhead(1) != '\n')
+        {
+          ++m_line;
+        }
+        ++m_cur;
+        break;
+      case ' ':
+      case '\t':
+        ++m_cur;
+        break;
+      default:
+        skipWord();
+        break;
+      }
+    }
+
+    if (depth != 0)
+    {
+      return {};
+    }
+
+    if (chunkBegin < m_end)
+    {
+      chunk.str = std::string_view{chunkBegin, size_t(m_end - chunkBegin)};
+      result.push_back(chunk);
+    }
+
+    return result;
+  }
+
+private:
+  char charAt(const char* c) const { return c < m_end ? *c : 0; }
+
+  char lookAhead(const size_t offset) const { return charAt(m_cur + offset); }
+
+  size_t column() const
+  {
+    // QuakeMapTokenizer counts the carriage return of a CRLF sequence as a column
+    const auto* c = m_cur;
+    while (c > m_begin && *(c - 1) != '\n' && !(*(c - 1) == '\r' && charAt(c) != '\n'))
+    {
+      --c;
+    }
+    return size_t(m_cur - c) + 1;
+  }
+
+  /**
+   * QuakeMapTokenizer parses texture names as words which are delimited by whitespace
+   * only, so a brace is only considered a token if it is followed by whitespace.
+   */
+  bool isBraceToken() const
+  {
+    return m_cur + 1 == m_end || isWhitespace(*(m_cur + 1));
+  }
+
+  void skipLine()
+  {
+    while (m_cur < m_end && *m_cur != '\n' && *m_cur != '\r')
+    {
+      ++m_cur;
+    }
+  }
+
+  void skipWord()
+  {
+    while (m_cur < m_end && !isWhitespace(*m_cur))
+    {
+      ++m_cur;
+    }
+  }
+
+  /**
+   * Mirrors Tokenizer::readQuotedString including the handling of escaped quotation marks
+   * and trailing backslashes.
+   */
+  bool skipQuotedString()
+  {
+    ++m_cur;
+
+    auto escaped = false;
+    while (m_cur < m_end && (*m_cur != '"' || escaped))
+    {
+      if (*m_cur == '"' && escaped && (lookAhead(1) == '\n' || lookAhead(1) == '}'))
+      {
+        break;
+      }
+
+      if (*m_cur == '\\')
+      {
+        escaped = !escaped;
+      }
+      else
+      {
+        if (*m_cur == '\n' || (*m_cur == '\r' && lookAhead(1) != '\n'))
+        {
+          ++m_line;
+        }
+        escaped = false;
+      }
+      ++m_cur;
+    }
+
+    if (m_cur == m_end)
+    {
+      return false;
+    }
+
+    ++m_cur;
+    return true;
+  }
+};
+} // namespace
+
+std::vector<EntityChunk> splitEntityChunks(
+  const std::string_view str, const size_t minChunkSize)
+{
+  return EntityChunkScanner{str}.split(minChunkSize);
+}
+
 const std::string& QuakeMapTokenizer::NumberDelim()
 {
   static const std::string numberDelim(Whitespace() + ")");
@@ -171,6 +396,11 @@ StandardMapParser::StandardMapParser(
 
 StandardMapParser::~StandardMapParser() = default;
 
+void StandardMapParser::setStartPosition(const size_t line, const size_t column)
+{
+  m_tokenizer.adoptState({m_tokenizer.snapshot().cur, line, column, false});
+}
+
 void StandardMapParser::parseEntities(ParserStatus& status)
 {
   auto token = m_tokenizer.peekToken();
@@ -57,6 +57,32 @@ static const Type Eol = 1 << 11;         // end of line
 static const Type Number = Integer | Decimal;
 } // namespace QuakeMapToken
 
+/**
+ * A part of a map file that consists of one or more complete top level entities. The line
+ * and column refer to the start of the chunk within the entire file.
+ */
+struct EntityChunk
+{
+  std::string_view str;
+  size_t line;
+  size_t column;
+};
+
+/**
+ * Splits the given map file into chunks of complete top level entities such that every
+ * chunk except for the last one is at least the given number of bytes long.
+ *
+ * This only performs a quick lexical scan which tracks the brace depth while skipping
+ * quoted strings and comments. Returns an empty vector if the structure of the file
+ * cannot be determined, e.g. because the braces are unbalanced or a quoted string is not
+ * terminated.
+ *
+ * @param str the map file
+ * @param minChunkSize the minimum size of each chunk in bytes
+ * @return the chunks, in the order in which they occur in the given file
+ */
+std::vector<EntityChunk> splitEntityChunks(std::string_view str, size_t minChunkSize);
+
 class QuakeMapTokenizer : public Tokenizer<QuakeMapToken::Type>
 {
 private:
@@ -104,6 +130,13 @@ public:
   ~StandardMapParser() override;
 
 protected:
+  /**
+   * Sets the position of the first character of the string passed to the constructor.
+   * Use this if that string is part of a larger file so that the reported line numbers
+   * refer to that file.
+   */
+  void setStartPosition(size_t line, size_t column);
+
   void parseEntities(ParserStatus& status);
   void parseBrushesOrPatches(ParserStatus& status);
   void parseBrushFaces(ParserStatus& status);
@@ -0,0 +1,532 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Exceptions.h"
+#include "IO/File.h"
+#include "IO/IOUtils.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <kdl/overload.h>
+#include <kdl/reflection_impl.h>
+#include <kdl/result.h>
+
+#include <vecmath/vec.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+const auto EntryMagic = std::string{"TBTC"};
+const auto EntryExtension = std::string{".tbtc"};
+
+void hashCombine(uint64_t& hash, const uint64_t value)
+{
+  constexpr auto Prime = uint64_t(1099511628211ull);
+  hash = (hash ^ value) * Prime;
+  hash ^= hash >> 32;
+}
+
+uint64_t hashKey(const TextureCacheKey& key)
+{
+  const auto sourcePath = key.sourcePath.u8string();
+
+  auto hash = hashTextureCacheData(
+    key.textureName.data(), key.textureName.data() + key.textureName.size());
+  hashCombine(
+    hash,
+    hashTextureCacheData(sourcePath.data(), sourcePath.data() + sourcePath.size()));
+  hashCombine(hash, key.sourceSize);
+  hashCombine(hash, key.sourceHash);
+  hashCombine(hash, key.decoderHash);
+  return hash;
+}
+
+class EntryWriter
+{
+private:
+  std::string m_data;
+
+public:
+  template <typename T>
+  void write(const T value)
+  {
+    m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void write(const std::string& str)
+  {
+    write(uint32_t(str.size()));
+    m_data.append(str);
+  }
+
+  void write(const char* begin, const size_t size) { m_data.append(begin, size); }
+
+  const std::string& data() const { return m_data; }
+};
+
+std::string readString(Reader& reader)
+{
+  const auto size = reader.readSize<uint32_t>();
+  if (!reader.canRead(size))
+  {
+    throw ReaderException{"String exceeds the cache entry"};
+  }
+
+  auto result = std::string(size, '\0');
+  reader.read(result.data(), size);
+  return result;
+}
+
+std::string serialize(const TextureCacheKey& key, const Assets::Texture& texture)
+{
+  auto writer = EntryWriter{};
+  writer.write(EntryMagic.data(), EntryMagic.size());
+  writer.write(TextureCache::FormatVersion);
+
+  writer.write(key.textureName);
+  writer.write(key.sourcePath.u8string());
+  writer.write(key.sourceSize);
+  writer.write(key.sourceHash);
+  writer.write(key.decoderHash);
+
+  writer.write(texture.name());
+  writer.write(uint64_t(texture.width()));
+  writer.write(uint64_t(texture.height()));
+  writer.write(texture.averageColor().r());
+  writer.write(texture.averageColor().g());
+  writer.write(texture.averageColor().b());
+  writer.write(texture.averageColor().a());
+  writer.write(uint32_t(texture.format()));
+  writer.write(uint8_t(texture.type()));
+
+  std::visit(
+    kdl::overload(
+      [&](const std::monostate&) { writer.write(uint8_t(0)); },
+      [&](const Assets::Q2Data& q2Data) {
+        writer.write(uint8_t(1));
+        writer.write(int32_t(q2Data.flags));
+        writer.write(int32_t(q2Data.contents));
+        writer.write(int32_t(q2Data.value));
+      }),
+    texture.gameData());
+
+  const auto& buffers = texture.buffersIfUnprepared();
+  writer.write(uint32_t(buffers.size()));
+  for (const auto& buffer : buffers)
+  {
+    writer.write(uint64_t(buffer.size()));
+    writer.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+  }
+
+  return writer.data();
+}
+
+/**
+ * Returns the number of bytes of the given mip level of a texture with the given format
+ * and size, or std::nullopt if the format is unknown or if the mip level is larger than
+ * the given maximum size.
+ */
+std::optional<size_t> mipLevelSize(
+  const GLenum format,
+  const size_t width,
+  const size_t height,
+  const size_t level,
+  const size_t maxSize)
+{
+  const auto compressed = Assets::isCompressedFormat(format);
+
+  auto unitSize = size_t(0);
+  if (compressed)
+  {
+    unitSize = Assets::blockSizeForFormat(format);
+  }
+  else
+  {
+    switch (format)
+    {
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGBA:
+    case GL_BGRA:
+      unitSize = Assets::bytesPerPixelForFormat(format);
+      break;
+    default:
+      return std::nullopt;
+    }
+  }
+
+  const auto mipSize = Assets::sizeAtMipLevel(width, height, level);
+  const auto columns = compressed ? std::max(size_t(1), mipSize.x() / 4) : mipSize.x();
+  const auto rows = compressed ? std::max(size_t(1), mipSize.y() / 4) : mipSize.y();
+
+  // avoid overflowing when multiplying the dimensions of a corrupt entry
+  if (rows > maxSize / unitSize || columns > maxSize / unitSize / rows)
+  {
+    return std::nullopt;
+  }
+  return unitSize * columns * rows;
+}
+
+/**
+ * Returns the texture stored in the given reader if the entry has the current format
+ * version, matches the given key and contains buffers of the expected sizes.
+ *
+ * @throw ReaderException if the entry is truncated
+ */
+std::optional<Assets::Texture> deserialize(Reader& reader, const TextureCacheKey& key)
+{
+  auto magic = std::string(EntryMagic.size(), '\0');
+  reader.read(magic.data(), magic.size());
+  if (
+    magic != EntryMagic
+    || reader.readUnsignedInt<uint32_t>() != TextureCache::FormatVersion)
+  {
+    return std::nullopt;
+  }
+
+  auto entryKey = TextureCacheKey{};
+  entryKey.textureName = readString(reader);
+  entryKey.sourcePath = std::filesystem::u8path(readString(reader));
+  entryKey.sourceSize = reader.read<uint64_t, uint64_t>();
+  entryKey.sourceHash = reader.read<uint64_t, uint64_t>();
+  entryKey.decoderHash = reader.read<uint64_t, uint64_t>();
+  if (entryKey != key)
+  {
+    return std::nullopt;
+  }
+
+  auto name = readString(reader);
+  const auto width = reader.readSize<uint64_t>();
+  const auto height = reader.readSize<uint64_t>();
+  const auto r = reader.readFloat<float>();
+  const auto g = reader.readFloat<float>();
+  const auto b = reader.readFloat<float>();
+  const auto a = reader.readFloat<float>();
+  const auto format = reader.read<uint32_t, GLenum>();
+  const auto type = Assets::TextureType(reader.read<uint8_t, uint8_t>());
+
+  auto gameData = Assets::GameData{};
+  if (reader.read<uint8_t, uint8_t>() == 1)
+  {
+    const auto flags = reader.readInt<int32_t>();
+    const auto contents = reader.readInt<int32_t>();
+    const auto value = reader.readInt<int32_t>();
+    gameData = Assets::Q2Data{flags, contents, value};
+  }
+
+  if (width == 0 || height == 0)
+  {
+    return std::nullopt;
+  }
+
+  // validate all sizes read from the entry before allocating memory for them
+  const auto bufferCount = reader.readSize<uint32_t>();
+  if (bufferCount > (reader.size() - reader.position()) / sizeof(uint64_t))
+  {
+    return std::nullopt;
+  }
+
+  auto buffers = Assets::TextureBufferList{};
+  buffers.reserve(bufferCount);
+  for (size_t i = 0; i < bufferCount; ++i)
+  {
+    const auto size = reader.readSize<uint64_t>();
+    const auto remaining = reader.size() - reader.position();
+    const auto expectedSize = mipLevelSize(format, width, height, i, remaining);
+    if (size > remaining || !expectedSize || size < *expectedSize)
+    {
+      return std::nullopt;
+    }
+
+    auto& buffer = buffers.emplace_back(size);
+    reader.read(buffer.data(), size);
+  }
+
+  return Assets::Texture{
+    std::move(name),
+    width,
+    height,
+    Color{r, g, b, a},
+    std::move(buffers),
+    format,
+    type,
+    std::move(gameData)};
+}
+
+uint64_t makeProcessToken()
+{
+  auto device = std::random_device{};
+  return uint64_t(device()) << 32 | uint64_t(device());
+}
+
+/**
+ * Returns a path next to the given one that is unique among all processes using the same
+ * cache directory. The random token distinguishes processes and the counter distinguishes
+ * the threads of this process.
+ */
+std::filesystem::path makeTemporaryPath(const std::filesystem::path& path)
+{
+  static const auto processToken = makeProcessToken();
+  static auto counter = std::atomic<uint64_t>{0};
+  auto result = path;
+  result += fmt::format(".{:016x}.{}.tmp", processToken, counter++);
+  return result;
+}
+
+} // namespace
+
+kdl_reflect_impl(TextureCacheKey);
+
+uint64_t hashTextureCacheData(const char* begin, const char* end)
+{
+  // FNV-1a over 64 bit words with an additional mixing step, followed by the remaining
+  // bytes
+  auto hash = uint64_t(14695981039346656037ull);
+  while (end - begin >= 8)
+  {
+    auto word = uint64_t(0);
+    std::memcpy(&word, begin, sizeof(word));
+    hashCombine(hash, word);
+    begin += 8;
+  }
+  while (begin != end)
+  {
+    hashCombine(hash, uint64_t(static_cast<unsigned char>(*begin++)));
+  }
+  return hash;
+}
+
+TextureCacheKey makeTextureCacheKey(
+  std::string textureName,
+  std::filesystem::path sourcePath,
+  const char* begin,
+  const char* end,
+  const uint64_t decoderHash)
+{
+  return TextureCacheKey{
+    std::move(textureName),
+    std::move(sourcePath),
+    uint64_t(end - begin),
+    hashTextureCacheData(begin, end),
+    decoderHash};
+}
+
+const uint32_t TextureCache::FormatVersion = 1;
+
+TextureCache::TextureCache(std::filesystem::path directory, const uint64_t maxSize)
+  : m_directory{std::move(directory)}
+  , m_maxSize{maxSize}
+{
+  auto error = std::error_code{};
+  std::filesystem::create_directories(m_directory, error);
+}
+
+const std::filesystem::path& TextureCache::directory() const
+{
+  return m_directory;
+}
+
+uint64_t TextureCache::maxSize() const
+{
+  return m_maxSize;
+}
+
+std::optional<Assets::Texture> TextureCache::load(const TextureCacheKey& key) const
+{
+  const auto path = entryPath(key);
+
+  auto error = std::error_code{};
+  if (!std::filesystem::is_regular_file(path, error))
+  {
+    return std::nullopt;
+  }
+
+  try
+  {
+    auto result = std::optional<Assets::Texture>{};
+    {
+      const auto file = MmapFile{path};
+      auto reader = file.reader();
+      result = deserialize(reader, key);
+    }
+
+    if (result)
+    {
+      // the modification time is used to find the least recently used entries
+      std::filesystem::last_write_time(
+        path, std::filesystem::file_time_type::clock::now(), error);
+      return result;
+    }
+  }
+  catch (const std::exception&)
+  {
+    // treat a broken entry like an outdated one
+  }
+
+  std::filesystem::remove(path, error);
+  return std::nullopt;
+}
+
+void TextureCache::store(const TextureCacheKey& key, const Assets::Texture& texture) const
+{
+  const auto path = entryPath(key);
+  const auto temporaryPath = makeTemporaryPath(path);
+  const auto data = serialize(key, texture);
+
+  {
+    auto stream = openPathAsOutputStream(temporaryPath, std::ios::out | std::ios::binary);
+    if (!stream)
+    {
+      return;
+    }
+    stream.write(data.data(), std::streamsize(data.size()));
+    if (!stream)
+    {
+      stream.close();
+      auto error = std::error_code{};
+      std::filesystem::remove(temporaryPath, error);
+      return;
+    }
+  }
+
+  // renaming is atomic, so other threads and processes never see a partial entry
+  auto error = std::error_code{};
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error)
+  {
+    std::filesystem::remove(temporaryPath, error);
+  }
+}
+
+void TextureCache::trim() const
+{
+  struct Entry
+  {
+    std::filesystem::path path;
+    uint64_t size;
+    std::filesystem::file_time_type lastUsed;
+  };
+
+  auto entries = std::vector<Entry>{};
+  auto totalSize = uint64_t(0);
+
+  auto error = std::error_code{};
+  for (auto it = std::filesystem::directory_iterator{m_directory, error};
+       !error && it != std::filesystem::directory_iterator{};
+       it.increment(error))
+  {
+    if (it->path().extension() == EntryExtension && it->is_regular_file(error))
+    {
+      const auto size = uint64_t(it->file_size(error));
+      const auto lastUsed = it->last_write_time(error);
+      if (!error)
+      {
+        entries.push_back(Entry{it->path(), size, lastUsed});
+        totalSize += size;
+      }
+    }
+  }
+
+  if (totalSize <= m_maxSize)
+  {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.lastUsed < rhs.lastUsed;
+  });
+
+  for (const auto& entry : entries)
+  {
+    if (totalSize <= m_maxSize)
+    {
+      break;
+    }
+    if (std::filesystem::remove(entry.path, error))
+    {
+      totalSize -= entry.size;
+    }
+  }
+}
+
+void TextureCache::clear() const
+{
+  auto error = std::error_code{};
+  for (auto it = std::filesystem::directory_iterator{m_directory, error};
+       !error && it != std::filesystem::directory_iterator{};
+       it.increment(error))
+  {
+    if (it->path().extension() == EntryExtension)
+    {
+      auto removeError = std::error_code{};
+      std::filesystem::remove(it->path(), removeError);
+    }
+  }
+}
+
+std::filesystem::path TextureCache::entryPath(const TextureCacheKey& key) const
+{
+  return m_directory / fmt::format("{:016x}{}", hashKey(key), EntryExtension);
+}
+
+kdl::result<Assets::Texture, ReadTextureError> decodeTextureWithCache(
+  const TextureCache* cache,
+  const std::string& textureName,
+  const File& file,
+  BufferedReader& reader,
+  const uint64_t decoderHash,
+  const std::function<kdl::result<Assets::Texture, ReadTextureError>(Reader&)>& decode)
+{
+  if (!cache)
+  {
+    return decode(reader);
+  }
+
+  const auto key = makeTextureCacheKey(
+    textureName, file.path(), reader.begin(), reader.end(), decoderHash);
+  if (auto texture = cache->load(key))
+  {
+    return std::move(*texture);
+  }
+
+  auto result = decode(reader);
+  if (result.is_success())
+  {
+    cache->store(key, result.value());
+  }
+  return result;
+}
+
+} // namespace TrenchBroom::IO
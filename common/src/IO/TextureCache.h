@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/TextureUtils.h"
+
+#include <kdl/reflection_decl.h>
+#include <kdl/result_forward.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+
+namespace TrenchBroom::Assets
+{
+class Texture;
+}
+
+namespace TrenchBroom::IO
+{
+class BufferedReader;
+class File;
+class Reader;
+
+/**
+ * Identifies a decoded texture in the texture cache.
+ */
+struct TextureCacheKey
+{
+  std::string textureName;
+  std::filesystem::path sourcePath;
+  uint64_t sourceSize;
+  uint64_t sourceHash;
+  // hash of any additional data that the decoder depends on, e.g. a palette
+  uint64_t decoderHash;
+
+  kdl_reflect_decl(
+    TextureCacheKey, textureName, sourcePath, sourceSize, sourceHash, decoderHash);
+};
+
+/**
+ * Computes a hash of the given data for use in a texture cache key. This is not a
+ * cryptographic hash.
+ */
+uint64_t hashTextureCacheData(const char* begin, const char* end);
+
+/**
+ * Creates a key for a texture that is decoded from the given source data.
+ */
+TextureCacheKey makeTextureCacheKey(
+  std::string textureName,
+  std::filesystem::path sourcePath,
+  const char* begin,
+  const char* end,
+  uint64_t decoderHash = 0);
+
+/**
+ * Stores decoded textures in a directory on the disk so that they need not be decoded
+ * again when they are loaded the next time.
+ *
+ * Every texture is stored in its own file, named after a hash of its key. The file
+ * contains the full key, which is checked when the texture is loaded. An entry is
+ * removed if its key does not match or if it was written by a different version of the
+ * cache format. Since the key contains a hash of the source data, changing a texture
+ * file invalidates its entries.
+ *
+ * The total size of the cache is limited. When the cache is trimmed, the least recently
+ * used entries are removed until the limit is met.
+ *
+ * Loading and storing textures is thread safe. Errors when accessing the cache
+ * directory are ignored, a failed load is reported as a cache miss.
+ */
+class TextureCache
+{
+public:
+  static const uint32_t FormatVersion;
+
+private:
+  std::filesystem::path m_directory;
+  uint64_t m_maxSize;
+
+public:
+  /**
+   * Creates a texture cache that stores its entries in the given directory, which is
+   * created if it does not exist.
+   *
+   * @param directory the cache directory
+   * @param maxSize the maximum total size of all entries in bytes
+   */
+  TextureCache(std::filesystem::path directory, uint64_t maxSize);
+
+  const std::filesystem::path& directory() const;
+  uint64_t maxSize() const;
+
+  /**
+   * Loads the texture with the given key from the cache.
+   *
+   * @return the texture or std::nullopt if the cache does not contain a valid entry for
+   * the given key
+   */
+  std::optional<Assets::Texture> load(const TextureCacheKey& key) const;
+
+  /**
+   * Stores the given texture in the cache, replacing any entry with the same key. The
+   * texture must not have been prepared yet.
+   */
+  void store(const TextureCacheKey& key, const Assets::Texture& texture) const;
+
+  /**
+   * Removes the least recently used entries until the total size of the cache does not
+   * exceed its maximum size anymore.
+   */
+  void trim() const;
+
+  /**
+   * Removes all entries from the cache.
+   */
+  void clear() const;
+
+private:
+  std::filesystem::path entryPath(const TextureCacheKey& key) const;
+};
+
+/**
+ * Decodes a texture from the given reader using the given function. If a cache is given,
+ * the texture is loaded from the cache if possible, and stored in the cache after it has
+ * been decoded otherwise.
+ *
+ * @param cache the cache or nullptr
+ * @param textureName the name of the texture
+ * @param file the file that contains the texture data
+ * @param reader a reader for the texture data
+ * @param decoderHash a hash of any additional data that the decoder depends on
+ * @param decode the function that decodes the texture
+ */
+kdl::result<Assets::Texture, ReadTextureError> decodeTextureWithCache(
+  const TextureCache* cache,
+  const std::string& textureName,
+  const File& file,
+  BufferedReader& reader,
+  uint64_t decoderHash,
+  const std::function<kdl::result<Assets::Texture, ReadTextureError>(Reader&)>& decode);
+
+} // namespace TrenchBroom::IO
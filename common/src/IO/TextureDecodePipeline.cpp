@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureDecodePipeline.h"
+
+#include <kdl/thread_pool.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace TrenchBroom::IO
+{
+
+namespace
+{
+struct PendingTexture
+{
+  size_t index;
+  PreparedTexture texture;
+};
+} // namespace
+
+struct TextureDecodePipeline::State
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<PendingTexture> queue;
+  std::vector<Result> results;
+  size_t inFlightBytes = 0;
+  size_t inFlightTextures = 0;
+
+  bool decodeNext(std::unique_lock<std::mutex>& lock)
+  {
+    if (queue.empty())
+    {
+      return false;
+    }
+
+    auto pending = std::move(queue.front());
+    queue.pop_front();
+    lock.unlock();
+
+    auto result = Result{};
+    try
+    {
+      result.texture = pending.texture.decode();
+    }
+    catch (...)
+    {
+      result.exception = std::current_exception();
+    }
+    // release the texture data before taking the lock
+    pending.texture.decode = nullptr;
+
+    lock.lock();
+    results[pending.index] = std::move(result);
+    inFlightBytes -= pending.texture.size;
+    --inFlightTextures;
+    condition.notify_all();
+    return true;
+  }
+};
+
+TextureDecodePipeline::TextureDecodePipeline(const size_t maxInFlightBytes)
+  : m_state{std::make_shared<State>()}
+  , m_maxInFlightBytes{maxInFlightBytes}
+{
+}
+
+void TextureDecodePipeline::add(PreparedTexture texture)
+{
+  auto lock = std::unique_lock{m_state->mutex};
+  while (m_state->inFlightTextures > 0
+         && m_state->inFlightBytes + texture.size > m_maxInFlightBytes)
+  {
+    if (!m_state->decodeNext(lock))
+    {
+      m_state->condition.wait(lock);
+    }
+  }
+
+  const auto size = texture.size;
+  m_state->queue.push_back(PendingTexture{m_state->results.size(), std::move(texture)});
+  m_state->results.emplace_back();
+  m_state->inFlightBytes += size;
+  ++m_state->inFlightTextures;
+  lock.unlock();
+
+  kdl::default_thread_pool().submit([state = m_state]() {
+    auto workerLock = std::unique_lock{state->mutex};
+    state->decodeNext(workerLock);
+  });
+}
+
+std::vector<TextureDecodePipeline::Result> TextureDecodePipeline::finish()
+{
+  auto lock = std::unique_lock{m_state->mutex};
+  while (m_state->inFlightTextures > 0)
+  {
+    if (!m_state->decodeNext(lock))
+    {
+      m_state->condition.wait(lock);
+    }
+  }
+  return std::move(m_state->results);
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/Texture.h"
+#include "IO/TextureUtils.h"
+
+#include <kdl/result.h>
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace TrenchBroom::IO
+{
+
+/**
+ * Decodes prepared textures on the default thread pool while the calling thread prepares
+ * more textures. The results are returned in the order in which the textures were added.
+ *
+ * The total size of the textures that have been prepared but not decoded yet is limited.
+ * When adding a texture would exceed the limit, the calling thread decodes pending
+ * textures itself until enough memory is released. A single texture that exceeds the
+ * limit on its own is only added once no other texture is pending.
+ */
+class TextureDecodePipeline
+{
+public:
+  struct Result
+  {
+    std::optional<kdl::result<Assets::Texture, ReadTextureError>> texture;
+    std::exception_ptr exception;
+  };
+
+private:
+  struct State;
+
+  std::shared_ptr<State> m_state;
+  size_t m_maxInFlightBytes;
+
+public:
+  explicit TextureDecodePipeline(size_t maxInFlightBytes);
+
+  void add(PreparedTexture texture);
+  std::vector<Result> finish();
+};
+
+} // namespace TrenchBroom::IO
@@ -59,6 +59,22 @@ struct ReadTextureError
   kdl_reflect_decl(ReadTextureError, textureName, msg);
 };
 
+/**
+ * Decodes a texture from data that was read before. Such a function does not access any
+ * file system and can therefore be called on any thread.
+ */
+using DecodeTextureFunc = std::function<kdl::result<Assets::Texture, ReadTextureError>()>;
+
+/**
+ * A texture whose data has been read, but not decoded yet. The size is the number of
+ * bytes of texture data that the decode function keeps in memory until it is called.
+ */
+struct PreparedTexture
+{
+  DecodeTextureFunc decode;
+  size_t size = 0;
+};
+
 std::function<kdl::result<Assets::Texture>(ReadTextureError)> makeReadTextureErrorHandler(
   const FileSystem& fs, Logger& logger);
 
@@ -62,7 +62,8 @@ WadFileSystem::WadFileSystem(std::filesystem::path path)
 
 void WadFileSystem::doReadDirectory()
 {
-  auto reader = m_file->reader();
+  const auto file = mapArchive();
+  auto reader = file->reader();
   if (reader.size() < WadLayout::MinFileSize)
   {
     throw FileSystemException{"File does not contain a directory."};
@@ -86,7 +87,7 @@ void WadFileSystem::doReadDirectory()
   reader.seekFromBegin(WadLayout::DirOffsetAddress);
   const auto directoryOffset = reader.readSize<int32_t>();
 
-  if (m_file->size() < directoryOffset + entryCount * WadLayout::DirEntrySize)
+  if (file->size() < directoryOffset + entryCount * WadLayout::DirEntrySize)
   {
     throw FileSystemException{"File directory is out of bounds."};
   }
@@ -97,7 +98,7 @@ void WadFileSystem::doReadDirectory()
     const auto entryAddress = reader.readSize<int32_t>();
     const auto entrySize = reader.readSize<int32_t>();
 
-    if (m_file->size() < entryAddress + entrySize)
+    if (file->size() < entryAddress + entrySize)
     {
       throw FileSystemException{
         kdl::str_to_string("File entry at address ", entryAddress, " is out of bounds")};
@@ -113,8 +114,9 @@ void WadFileSystem::doReadDirectory()
     }
 
     const auto path = std::filesystem::path{entryName + "." + entryType};
-    auto file = std::make_shared<FileView>(path, m_file, entryAddress, entrySize);
-    addFile(path, [file = std::move(file)]() { return file; });
+    addFile(path, [this, path, entryAddress, entrySize]() {
+      return openArchiveFile(path, entryAddress, entrySize);
+    });
   }
 }
 } // namespace IO
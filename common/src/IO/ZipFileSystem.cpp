@@ -23,6 +23,7 @@
 #include "IO/File.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace TrenchBroom
@@ -33,6 +34,7 @@ namespace IO
 
 ZipFileSystem::ZipFileSystem(std::filesystem::path path)
   : ImageFileSystem{std::move(path)}
+  , m_file{std::make_unique<CFile>(m_path)}
 {
   initialize();
 }
@@ -58,6 +60,8 @@ void ZipFileSystem::doReadDirectory()
     {
       const auto path = std::filesystem::path{filename(i)};
       addFile(path, [=]() -> std::shared_ptr<File> {
+        const auto lock = std::lock_guard{m_archiveMutex};
+
         auto stat = mz_zip_archive_file_stat{};
         if (!mz_zip_reader_file_stat(&m_archive, i, &stat))
         {
@@ -25,16 +25,28 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom
 {
 namespace IO
 {
 
+class CFile;
+
+/**
+ * Zip archives are read through a CFile instead of being mapped into memory because
+ * miniz needs access to the archive for as long as the file system exists, and because
+ * the compressed entries are extracted into buffers anyway.
+ */
 class ZipFileSystem : public ImageFileSystem
 {
 private:
+  std::unique_ptr<CFile> m_file;
   mz_zip_archive m_archive;
+  // files may be opened from several threads, but the archive must not be read
+  // concurrently
+  std::mutex m_archiveMutex;
 
 public:
   explicit ZipFileSystem(std::filesystem::path path);
@@ -21,6 +21,8 @@
 
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 class QString;
 
@@ -94,4 +96,21 @@ private:
   void doLog(LogLevel level, const std::string& message) override;
   void doLog(LogLevel level, const QString& message) override;
 };
+
+/**
+ * Records the messages logged on a background thread so that they can be passed on to
+ * another logger on the main thread.
+ */
+class DeferredLogger : public Logger
+{
+private:
+  std::vector<std::pair<LogLevel, std::string>> m_messages;
+
+public:
+  void logTo(Logger& logger) const;
+
+private:
+  void doLog(LogLevel level, const std::string& message) override;
+  void doLog(LogLevel level, const QString& message) override;
+};
 } // namespace TrenchBroom
@@ -53,7 +53,7 @@ BezierPatch::BezierPatch(
   , m_pointColumnCount{pointColumnCount}
   , m_controlPoints{std::move(controlPoints)}
   , m_bounds(computeBounds(m_controlPoints))
-  , m_textureName{std::move(textureName)}
+  , m_textureName{textureName}
 {
   ensure(
     m_pointRowCount > 2 && m_pointColumnCount > 2,
@@ -131,13 +131,18 @@ const vm::bbox3& BezierPatch::bounds() const
 }
 
 const std::string& BezierPatch::textureName() const
+{
+  return m_textureName.str();
+}
+
+const kdl::interned_string& BezierPatch::internedTextureName() const
 {
   return m_textureName;
 }
 
-void BezierPatch::setTextureName(std::string textureName)
+void BezierPatch::setTextureName(const std::string& textureName)
 {
-  m_textureName = std::move(textureName);
+  m_textureName = kdl::interned_string{textureName};
 }
 
 const Assets::Texture* BezierPatch::texture() const
@@ -22,6 +22,7 @@
 #include "Assets/AssetReference.h"
 #include "FloatType.h"
 
+#include <kdl/interned_string.h>
 #include <kdl/reflection_decl.h>
 
 #include <vecmath/bbox.h>
@@ -51,7 +52,7 @@ private:
   std::vector<Point> m_controlPoints;
   vm::bbox3 m_bounds;
 
-  std::string m_textureName;
+  kdl::interned_string m_textureName;
   Assets::AssetReference<Assets::Texture> m_textureReference;
 
 public:
@@ -84,7 +85,8 @@ public:
   const vm::bbox3& bounds() const;
 
   const std::string& textureName() const;
-  void setTextureName(std::string textureName);
+  const kdl::interned_string& internedTextureName() const;
+  void setTextureName(const std::string& textureName);
 
   const Assets::Texture* texture() const;
   bool setTexture(Assets::Texture* texture);
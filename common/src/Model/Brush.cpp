@@ -693,30 +693,7 @@ bool Brush::canMoveEdges(
   const std::vector<vm::segment3>& edgePositions,
   const vm::vec3& delta) const
 {
-  ensure(m_geometry != nullptr, "geometry is null");
-  ensure(!edgePositions.empty(), "no edge positions");
-
-  std::vector<vm::vec3> vertexPositions;
-  vm::segment3::get_vertices(
-    std::begin(edgePositions),
-    std::end(edgePositions),
-    std::back_inserter(vertexPositions));
-  const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
-
-  if (!result.success)
-  {
-    return false;
-  }
-
-  for (const auto& edge : edgePositions)
-  {
-    if (!result.geometry->hasEdge(edge.start() + delta, edge.end() + delta))
-    {
-      return false;
-    }
-  }
-
-  return true;
+  return doCanMoveEdges(worldBounds, edgePositions, delta).success;
 }
 
 kdl::result<void, BrushError> Brush::moveEdges(
@@ -740,46 +717,91 @@ bool Brush::canMoveFaces(
   const std::vector<vm::polygon3>& facePositions,
   const vm::vec3& delta) const
 {
-  ensure(m_geometry != nullptr, "geometry is null");
-  ensure(!facePositions.empty(), "no face positions");
+  return doCanMoveFaces(worldBounds, facePositions, delta).success;
+}
+
+kdl::result<void, BrushError> Brush::moveFaces(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::polygon3>& facePositions,
+  const vm::vec3& delta,
+  const bool uvLock)
+{
+  assert(canMoveFaces(worldBounds, facePositions, delta));
 
   std::vector<vm::vec3> vertexPositions;
   vm::polygon3::get_vertices(
     std::begin(facePositions),
     std::end(facePositions),
     std::back_inserter(vertexPositions));
-  const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
+  return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
+}
 
-  if (!result.success)
-  {
-    return false;
-  }
+Brush::PreparedVertexMove::PreparedVertexMove(
+  const BrushGeometry& oldGeometry,
+  std::unique_ptr<BrushGeometry> newGeometry,
+  std::unique_ptr<PolyhedronMatcher<BrushGeometry>> matcher)
+  : m_oldGeometry{&oldGeometry}
+  , m_newGeometry{std::move(newGeometry)}
+  , m_matcher{std::move(matcher)}
+{
+}
 
-  for (const auto& face : facePositions)
-  {
-    if (!result.geometry->hasFace(face.vertices() + delta))
-    {
-      return false;
-    }
-  }
+Brush::PreparedVertexMove::PreparedVertexMove(PreparedVertexMove&& other) noexcept =
+  default;
 
-  return true;
+Brush::PreparedVertexMove& Brush::PreparedVertexMove::operator=(
+  PreparedVertexMove&& other) noexcept = default;
+
+Brush::PreparedVertexMove::~PreparedVertexMove() = default;
+
+std::optional<Brush::PreparedVertexMove> Brush::prepareMoveVertices(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::vec3>& vertexPositions,
+  const vm::vec3& delta) const
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+  ensure(!vertexPositions.empty(), "no vertex positions");
+
+  return prepareVertexMove(
+    doCanMoveVertices(worldBounds, vertexPositions, delta, true), vertexPositions, delta);
 }
 
-kdl::result<void, BrushError> Brush::moveFaces(
+std::optional<Brush::PreparedVertexMove> Brush::prepareMoveEdges(
   const vm::bbox3& worldBounds,
-  const std::vector<vm::polygon3>& facePositions,
-  const vm::vec3& delta,
-  const bool uvLock)
+  const std::vector<vm::segment3>& edgePositions,
+  const vm::vec3& delta) const
 {
-  assert(canMoveFaces(worldBounds, facePositions, delta));
+  std::vector<vm::vec3> vertexPositions;
+  vm::segment3::get_vertices(
+    std::begin(edgePositions),
+    std::end(edgePositions),
+    std::back_inserter(vertexPositions));
+  return prepareVertexMove(
+    doCanMoveEdges(worldBounds, edgePositions, delta), vertexPositions, delta);
+}
 
+std::optional<Brush::PreparedVertexMove> Brush::prepareMoveFaces(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::polygon3>& facePositions,
+  const vm::vec3& delta) const
+{
   std::vector<vm::vec3> vertexPositions;
   vm::polygon3::get_vertices(
     std::begin(facePositions),
     std::end(facePositions),
     std::back_inserter(vertexPositions));
-  return doMoveVertices(worldBounds, vertexPositions, delta, uvLock);
+  return prepareVertexMove(
+    doCanMoveFaces(worldBounds, facePositions, delta), vertexPositions, delta);
+}
+
+kdl::result<void, BrushError> Brush::applyVertexMove(
+  const vm::bbox3& worldBounds, PreparedVertexMove move, const bool uvLock)
+{
+  ensure(
+    move.m_oldGeometry == m_geometry.get(), "move was prepared for this brush geometry");
+
+  return updateFacesFromGeometry(
+    worldBounds, *move.m_matcher, *move.m_newGeometry, uvLock);
 }
 
 Brush::CanMoveVerticesResult::CanMoveVerticesResult(const bool s, BrushGeometry&& g)
@@ -949,6 +971,110 @@ Brush::CanMoveVerticesResult Brush::doCanMoveVertices(
   return CanMoveVerticesResult::acceptVertexMove(std::move(result));
 }
 
+Brush::CanMoveVerticesResult Brush::doCanMoveEdges(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::segment3>& edgePositions,
+  const vm::vec3& delta) const
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+  ensure(!edgePositions.empty(), "no edge positions");
+
+  std::vector<vm::vec3> vertexPositions;
+  vm::segment3::get_vertices(
+    std::begin(edgePositions),
+    std::end(edgePositions),
+    std::back_inserter(vertexPositions));
+  auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
+
+  if (!result.success)
+  {
+    return result;
+  }
+
+  for (const auto& edge : edgePositions)
+  {
+    if (!result.geometry->hasEdge(edge.start() + delta, edge.end() + delta))
+    {
+      return CanMoveVerticesResult::rejectVertexMove();
+    }
+  }
+
+  return result;
+}
+
+Brush::CanMoveVerticesResult Brush::doCanMoveFaces(
+  const vm::bbox3& worldBounds,
+  const std::vector<vm::polygon3>& facePositions,
+  const vm::vec3& delta) const
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+  ensure(!facePositions.empty(), "no face positions");
+
+  std::vector<vm::vec3> vertexPositions;
+  vm::polygon3::get_vertices(
+    std::begin(facePositions),
+    std::end(facePositions),
+    std::back_inserter(vertexPositions));
+  auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
+
+  if (!result.success)
+  {
+    return result;
+  }
+
+  for (const auto& face : facePositions)
+  {
+    if (!result.geometry->hasFace(face.vertices() + delta))
+    {
+      return CanMoveVerticesResult::rejectVertexMove();
+    }
+  }
+
+  return result;
+}
+
+static std::map<vm::vec3, vm::vec3> buildMovedVertexMapping(
+  const BrushGeometry& oldGeometry,
+  const BrushGeometry& newGeometry,
+  const std::vector<vm::vec3>& vertexPositions,
+  const vm::vec3& delta,
+  const FloatType epsilon)
+{
+  std::map<vm::vec3, vm::vec3> vertexMapping;
+  for (auto* oldVertex : oldGeometry.vertices())
+  {
+    const auto& oldPosition = oldVertex->position();
+    const auto moved = kdl::vec_contains(vertexPositions, oldPosition);
+    const auto newPosition = moved ? oldPosition + delta : oldPosition;
+    const auto* newVertex = newGeometry.findClosestVertex(newPosition, epsilon);
+    if (newVertex != nullptr)
+    {
+      vertexMapping.insert(std::make_pair(oldPosition, newVertex->position()));
+    }
+  }
+  return vertexMapping;
+}
+
+std::optional<Brush::PreparedVertexMove> Brush::prepareVertexMove(
+  CanMoveVerticesResult canMoveResult,
+  const std::vector<vm::vec3>& vertexPositions,
+  const vm::vec3& delta) const
+{
+  if (!canMoveResult.success)
+  {
+    return std::nullopt;
+  }
+
+  // the geometry computed by the check is the geometry that the move results in
+  auto newGeometry = std::move(canMoveResult.geometry);
+  const auto vertexMapping = buildMovedVertexMapping(
+    *m_geometry, *newGeometry, vertexPositions, delta, CloseVertexEpsilon);
+  auto matcher = std::make_unique<PolyhedronMatcher<BrushGeometry>>(
+    *m_geometry, *newGeometry, vertexMapping);
+
+  return PreparedVertexMove{*m_geometry, std::move(newGeometry), std::move(matcher)};
+}
+
 kdl::result<void, BrushError> Brush::doMoveVertices(
   const vm::bbox3& worldBounds,
   const std::vector<vm::vec3>& vertexPositions,
@@ -977,21 +1103,8 @@ kdl::result<void, BrushError> Brush::doMoveVertices(
 
   BrushGeometry newGeometry(newVertices);
 
-  using VecMap = std::map<vm::vec3, vm::vec3>;
-  VecMap vertexMapping;
-  for (auto* oldVertex : m_geometry->vertices())
-  {
-    const auto& oldPosition = oldVertex->position();
-    const auto moved = kdl::vec_contains(vertexPositions, oldPosition);
-    const auto newPosition = moved ? oldPosition + delta : oldPosition;
-    const auto* newVertex =
-      newGeometry.findClosestVertex(newPosition, CloseVertexEpsilon);
-    if (newVertex != nullptr)
-    {
-      vertexMapping.insert(std::make_pair(oldPosition, newVertex->position()));
-    }
-  }
-
+  const auto vertexMapping = buildMovedVertexMapping(
+    *m_geometry, newGeometry, vertexPositions, delta, CloseVertexEpsilon);
   const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry, vertexMapping);
   return updateFacesFromGeometry(worldBounds, matcher, newGeometry, uvLock);
 }
@@ -1155,8 +1268,15 @@ std::vector<kdl::result<Brush, BrushError>> Brush::subtract(
   {
     auto nextResults = std::vector<BrushGeometry>{};
 
-    for (const BrushGeometry& fragment : result)
+    for (BrushGeometry& fragment : result)
     {
+      if (!fragment.bounds().intersects(subtrahend->bounds()))
+      {
+        // the subtrahend cannot affect this fragment, skip copying and clipping it
+        nextResults.push_back(std::move(fragment));
+        continue;
+      }
+
       auto subFragments = fragment.subtract(*subtrahend->m_geometry);
       nextResults = kdl::vec_concat(std::move(nextResults), std::move(subFragments));
     }
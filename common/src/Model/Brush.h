@@ -214,6 +214,67 @@ public:
     const vm::vec3& delta,
     bool uvLock = false);
 
+  /**
+   * A vertex, edge or face move that was validated against a brush. It holds the geometry
+   * that results from the move and the matcher that relates it to the brush's current
+   * geometry, so that applying the move need not compute them again.
+   *
+   * A prepared move can only be applied to the brush that prepared it, and only as long
+   * as that brush is not modified in between.
+   */
+  class PreparedVertexMove
+  {
+  private:
+    const BrushGeometry* m_oldGeometry;
+    std::unique_ptr<BrushGeometry> m_newGeometry;
+    std::unique_ptr<PolyhedronMatcher<BrushGeometry>> m_matcher;
+
+    PreparedVertexMove(
+      const BrushGeometry& oldGeometry,
+      std::unique_ptr<BrushGeometry> newGeometry,
+      std::unique_ptr<PolyhedronMatcher<BrushGeometry>> matcher);
+
+  public:
+    PreparedVertexMove(PreparedVertexMove&& other) noexcept;
+    PreparedVertexMove& operator=(PreparedVertexMove&& other) noexcept;
+    ~PreparedVertexMove();
+
+    friend class Brush;
+  };
+
+  /**
+   * Checks whether the given vertices can be moved by the given delta like
+   * canMoveVertices does. If so, returns a prepared move which can be passed to
+   * applyVertexMove, otherwise returns std::nullopt.
+   */
+  std::optional<PreparedVertexMove> prepareMoveVertices(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::vec3>& vertexPositions,
+    const vm::vec3& delta) const;
+
+  /**
+   * Like prepareMoveVertices, but validates the move like canMoveEdges does.
+   */
+  std::optional<PreparedVertexMove> prepareMoveEdges(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::segment3>& edgePositions,
+    const vm::vec3& delta) const;
+
+  /**
+   * Like prepareMoveVertices, but validates the move like canMoveFaces does.
+   */
+  std::optional<PreparedVertexMove> prepareMoveFaces(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::polygon3>& facePositions,
+    const vm::vec3& delta) const;
+
+  /**
+   * Applies a move that was prepared by this brush. This has the same effect as calling
+   * the corresponding move function with the parameters that the move was prepared with.
+   */
+  kdl::result<void, BrushError> applyVertexMove(
+    const vm::bbox3& worldBounds, PreparedVertexMove move, bool uvLock = false);
+
 private:
   struct CanMoveVerticesResult
   {
@@ -234,6 +295,18 @@ private:
     const std::vector<vm::vec3>& vertexPositions,
     vm::vec3 delta,
     bool allowVertexRemoval) const;
+  CanMoveVerticesResult doCanMoveEdges(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::segment3>& edgePositions,
+    const vm::vec3& delta) const;
+  CanMoveVerticesResult doCanMoveFaces(
+    const vm::bbox3& worldBounds,
+    const std::vector<vm::polygon3>& facePositions,
+    const vm::vec3& delta) const;
+  std::optional<PreparedVertexMove> prepareVertexMove(
+    CanMoveVerticesResult canMoveResult,
+    const std::vector<vm::vec3>& vertexPositions,
+    const vm::vec3& delta) const;
   kdl::result<void, BrushError> doMoveVertices(
     const vm::bbox3& worldBounds,
     const std::vector<vm::vec3>& vertexPositions,
@@ -35,7 +35,7 @@ namespace Model
 const std::string BrushFaceAttributes::NoTextureName = "__TB_empty";
 
 BrushFaceAttributes::BrushFaceAttributes(std::string_view textureName)
-  : m_textureName(textureName)
+  : m_textureName{textureName}
   , m_offset(vm::vec2f::zero())
   , m_scale(vm::vec2f(1.0f, 1.0f))
   , m_rotation(0.0f)
@@ -56,7 +56,7 @@ BrushFaceAttributes::BrushFaceAttributes(const BrushFaceAttributes& other)
 
 BrushFaceAttributes::BrushFaceAttributes(
   std::string_view textureName, const BrushFaceAttributes& other)
-  : m_textureName(textureName)
+  : m_textureName{textureName}
   , m_offset(other.m_offset)
   , m_scale(other.m_scale)
   , m_rotation(other.m_rotation)
@@ -90,6 +90,11 @@ void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs)
 }
 
 const std::string& BrushFaceAttributes::textureName() const
+{
+  return m_textureName.str();
+}
+
+const kdl::interned_string& BrushFaceAttributes::internedTextureName() const
 {
   return m_textureName;
 }
@@ -179,7 +184,7 @@ bool BrushFaceAttributes::setTextureName(const std::string& textureName)
   }
   else
   {
-    m_textureName = textureName;
+    m_textureName = kdl::interned_string{textureName};
     return true;
   }
 }
@@ -21,6 +21,7 @@
 
 #include "Color.h"
 
+#include <kdl/interned_string.h>
 #include <kdl/reflection_decl.h>
 
 #include <vecmath/forward.h>
@@ -45,7 +46,8 @@ public:
   static const std::string NoTextureName;
 
 private:
-  std::string m_textureName;
+  // interned because many faces share the same texture name, see kdl::interned_string
+  kdl::interned_string m_textureName;
 
   vm::vec2f m_offset;
   vm::vec2f m_scale;
@@ -78,6 +80,7 @@ public:
   friend void swap(BrushFaceAttributes& lhs, BrushFaceAttributes& rhs);
 
   const std::string& textureName() const;
+  const kdl::interned_string& internedTextureName() const;
 
   const vm::vec2f& offset() const;
   float xOffset() const;
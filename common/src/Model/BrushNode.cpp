@@ -27,6 +27,7 @@
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceHandle.h"
 #include "Model/BrushGeometry.h"
+#include "Model/BrushPickCache.h"
 #include "Model/EditorContext.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
@@ -120,9 +121,10 @@ Brush BrushNode::setBrush(Brush brush)
 
   using std::swap;
   swap(m_brush, brush);
+  m_pickCache.reset();
 
   updateSelectedFaceCount();
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Geometry);
   invalidateVertexCache();
 
   return brush;
@@ -154,7 +156,7 @@ void BrushNode::setFaceTexture(const size_t faceIndex, Assets::Texture* texture)
 {
   m_brush.face(faceIndex).setTexture(texture);
 
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Geometry);
   invalidateVertexCache();
 }
 
@@ -389,15 +391,11 @@ std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(
 {
   if (!vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds())))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
+    if (!m_pickCache)
     {
-      const auto& face = m_brush.face(i);
-      const auto distance = face.intersectWithRay(ray);
-      if (!vm::is_nan(distance))
-      {
-        return std::make_tuple(distance, i);
-      }
+      m_pickCache = std::make_unique<BrushPickCache>(m_brush);
     }
+    return m_pickCache->findFaceHit(m_brush, ray);
   }
   return std::nullopt;
 }
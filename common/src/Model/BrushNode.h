@@ -52,6 +52,7 @@ class BrushRendererBrushCache;
 namespace Model
 {
 class BrushFace;
+class BrushPickCache;
 class GroupNode;
 class LayerNode;
 
@@ -71,6 +72,7 @@ private:
     m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
   Brush m_brush;               // must be destroyed before the brush renderer cache
   size_t m_selectedFaceCount = 0u;
+  mutable std::unique_ptr<BrushPickCache> m_pickCache; // created when first picked
 
 public:
   explicit BrushNode(Brush brush);
@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushPickCache.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/constants.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+constexpr auto Epsilon = vm::constants<FloatType>::almost_zero();
+
+/*
+ * BrushFace::intersectWithRay only hits a face if the cosine of the angle between the
+ * ray direction and the face normal is less than -Epsilon and if the hit distance is not
+ * less than -Epsilon. The point in polygon check only succeeds if the hit point is within
+ * Epsilon of the bounds of the face polygon. The packed test uses larger tolerances so
+ * that differences in rounding cannot lead to a face being rejected wrongly.
+ */
+constexpr auto MaxCos = -Epsilon / FloatType(2);
+constexpr auto MinDistance = -FloatType(2) * Epsilon;
+constexpr auto BoundsMargin = FloatType(2) * Epsilon;
+
+constexpr auto Infinity = std::numeric_limits<FloatType>::infinity();
+
+// number of faces that are tested in one pass
+constexpr auto BlockSize = size_t(64);
+} // namespace
+
+BrushPickCache::BrushPickCache(const Brush& brush)
+{
+  const auto faceCount = brush.faceCount();
+  for (auto* v :
+       {&m_normalX,
+        &m_normalY,
+        &m_normalZ,
+        &m_distance,
+        &m_minX,
+        &m_minY,
+        &m_minZ,
+        &m_maxX,
+        &m_maxY,
+        &m_maxZ})
+  {
+    v->reserve(faceCount);
+  }
+
+  for (size_t i = 0; i < faceCount; ++i)
+  {
+    const auto& face = brush.face(i);
+    const auto& plane = face.boundary();
+
+    m_normalX.push_back(plane.normal.x());
+    m_normalY.push_back(plane.normal.y());
+    m_normalZ.push_back(plane.normal.z());
+    m_distance.push_back(plane.distance);
+
+    const auto vertices = face.vertexPositions();
+    auto min = vm::vec3::fill(Infinity);
+    auto max = vm::vec3::fill(-Infinity);
+    for (const auto& vertex : vertices)
+    {
+      min = vm::min(min, vertex);
+      max = vm::max(max, vertex);
+    }
+    min = min - vm::vec3::fill(BoundsMargin);
+    max = max + vm::vec3::fill(BoundsMargin);
+
+    // The point in polygon check ignores the axis along which the face normal is
+    // largest.
+    const auto axis = vm::find_abs_max_component(plane.normal);
+    min[axis] = -Infinity;
+    max[axis] = Infinity;
+
+    // The point in polygon check casts a ray along the first axis of the plane it
+    // projects the polygon onto. Its result for points which are on the negative side of
+    // the polygon's bounds along that axis depends on rounding, so these points are not
+    // rejected here.
+    min[(axis + 1u) % 3u] = -Infinity;
+
+    m_minX.push_back(min.x());
+    m_minY.push_back(min.y());
+    m_minZ.push_back(min.z());
+    m_maxX.push_back(max.x());
+    m_maxY.push_back(max.y());
+    m_maxZ.push_back(max.z());
+  }
+}
+
+std::optional<std::tuple<FloatType, size_t>> BrushPickCache::findFaceHit(
+  const Brush& brush, const vm::ray3& ray) const
+{
+  const auto ox = ray.origin.x();
+  const auto oy = ray.origin.y();
+  const auto oz = ray.origin.z();
+  const auto dx = ray.direction.x();
+  const auto dy = ray.direction.y();
+  const auto dz = ray.direction.z();
+
+  const auto faceCount = m_normalX.size();
+  uint8_t candidates[BlockSize];
+
+  for (size_t first = 0; first < faceCount; first += BlockSize)
+  {
+    const auto count = std::min(BlockSize, faceCount - first);
+
+    // This loop has no branches so that it can be vectorized.
+    for (size_t j = 0; j < count; ++j)
+    {
+      const auto i = first + j;
+      const auto nx = m_normalX[i];
+      const auto ny = m_normalY[i];
+      const auto nz = m_normalZ[i];
+
+      const auto cos = nx * dx + ny * dy + nz * dz;
+      const auto distance = (m_distance[i] - (nx * ox + ny * oy + nz * oz)) / cos;
+      const auto px = ox + dx * distance;
+      const auto py = oy + dy * distance;
+      const auto pz = oz + dz * distance;
+
+      candidates[j] = uint8_t(
+        (cos < MaxCos) & (distance >= MinDistance) & (px >= m_minX[i])
+        & (px <= m_maxX[i]) & (py >= m_minY[i]) & (py <= m_maxY[i])
+        & (pz >= m_minZ[i]) & (pz <= m_maxZ[i]));
+    }
+
+    for (size_t j = 0; j < count; ++j)
+    {
+      if (candidates[j])
+      {
+        const auto i = first + j;
+        const auto distance = brush.face(i).intersectWithRay(ray);
+        if (!vm::is_nan(distance))
+        {
+          return std::make_tuple(distance, i);
+        }
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+} // namespace Model
+} // namespace TrenchBroom
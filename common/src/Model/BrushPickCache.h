@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <vecmath/forward.h>
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class Brush;
+
+/**
+ * Stores the face planes and the bounds of the face polygons of a brush in packed arrays
+ * so that a ray can be tested against all faces of the brush in a single pass that the
+ * compiler can vectorize.
+ *
+ * The packed test is conservative: It only rejects faces which would certainly not be hit
+ * by BrushFace::intersectWithRay. The remaining faces are tested with
+ * BrushFace::intersectWithRay, so the results are identical to testing every face.
+ *
+ * The cache must be rebuilt whenever the geometry of the brush changes.
+ */
+class BrushPickCache
+{
+private:
+  // face planes
+  std::vector<FloatType> m_normalX;
+  std::vector<FloatType> m_normalY;
+  std::vector<FloatType> m_normalZ;
+  std::vector<FloatType> m_distance;
+
+  // bounds of the face polygons, unbounded along the axes that are not checked
+  std::vector<FloatType> m_minX;
+  std::vector<FloatType> m_minY;
+  std::vector<FloatType> m_minZ;
+  std::vector<FloatType> m_maxX;
+  std::vector<FloatType> m_maxY;
+  std::vector<FloatType> m_maxZ;
+
+public:
+  explicit BrushPickCache(const Brush& brush);
+
+  /**
+   * Finds the first face of the given brush that is hit by the given ray. The given brush
+   * must be the brush for which this cache was built.
+   *
+   * @return the distance of the hit and the index of the face that was hit, or
+   * std::nullopt if no face was hit
+   */
+  std::optional<std::tuple<FloatType, size_t>> findFaceHit(
+    const Brush& brush, const vm::ray3& ray) const;
+};
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CompactNodeContents.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushError.h"
+#include "Model/NodeContents.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+
+#include <kdl/overload.h>
+#include <kdl/result.h>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+using CompactContents =
+  std::variant<Layer, Group, Entity, std::vector<BrushFace>, BezierPatch>;
+
+CompactContents compactContents(NodeContents contents)
+{
+  return std::visit(
+    kdl::overload(
+      [](Brush brush) -> CompactContents {
+        auto faces = std::move(brush.faces());
+        for (auto& face : faces)
+        {
+          // the geometry is destroyed together with the brush
+          face.setGeometry(nullptr);
+        }
+        return faces;
+      },
+      [](auto otherContents) -> CompactContents { return otherContents; }),
+    std::move(contents.get()));
+}
+
+size_t computeMemoryUsage(const TexCoordSystem& texCoordSystem)
+{
+  return dynamic_cast<const ParallelTexCoordSystem*>(&texCoordSystem)
+           ? sizeof(ParallelTexCoordSystem)
+           : sizeof(ParaxialTexCoordSystem);
+}
+
+size_t computeMemoryUsage(const CompactContents& contents)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) { return sizeof(Layer); },
+      [](const Group&) { return sizeof(Group); },
+      [](const Entity& entity) {
+        auto result = sizeof(Entity);
+        for (const auto& property : entity.properties())
+        {
+          result += sizeof(EntityProperty) + property.key().capacity()
+                    + property.value().capacity();
+        }
+        return result;
+      },
+      [](const std::vector<BrushFace>& faces) {
+        // texture names are interned and shared, so they are not counted here
+        auto result = faces.capacity() * sizeof(BrushFace);
+        for (const auto& face : faces)
+        {
+          result += computeMemoryUsage(face.texCoordSystem());
+        }
+        return result;
+      },
+      [](const BezierPatch& patch) {
+        return sizeof(BezierPatch)
+               + patch.controlPoints().capacity() * sizeof(BezierPatch::Point);
+      }),
+    contents);
+}
+} // namespace
+
+CompactNodeContents::CompactNodeContents(NodeContents contents)
+  : m_contents{compactContents(std::move(contents))}
+  , m_memoryUsage{computeMemoryUsage(m_contents)}
+{
+}
+
+size_t CompactNodeContents::memoryUsage() const
+{
+  return m_memoryUsage;
+}
+
+kdl::result<NodeContents, BrushError> CompactNodeContents::restore(
+  const vm::bbox3& worldBounds) const
+{
+  return std::visit(
+    kdl::overload(
+      [&](const std::vector<BrushFace>& faces) -> kdl::result<NodeContents, BrushError> {
+        return Brush::create(worldBounds, faces).transform([](auto brush) {
+          return NodeContents{std::move(brush)};
+        });
+      },
+      [](const auto& contents) -> kdl::result<NodeContents, BrushError> {
+        return NodeContents{contents};
+      }),
+    m_contents);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Model/BezierPatch.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+
+#include <kdl/result_forward.h>
+
+#include <vecmath/forward.h>
+
+#include <variant>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+enum class BrushError;
+class NodeContents;
+
+/**
+ * Stores node contents in a compact form while they are kept for undo.
+ *
+ * A brush is stored as its faces only. Its geometry is discarded and rebuilt from the
+ * faces when the contents are restored. This yields the same geometry because the
+ * geometry of a brush is always built from its faces.
+ */
+class CompactNodeContents
+{
+private:
+  std::variant<Layer, Group, Entity, std::vector<BrushFace>, BezierPatch> m_contents;
+  size_t m_memoryUsage;
+
+public:
+  explicit CompactNodeContents(NodeContents contents);
+
+  /**
+   * Returns an estimate of the number of bytes used by these contents.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Restores the node contents. Brush geometry is rebuilt using the given world bounds,
+   * which must be the world bounds that the brush was created with.
+   */
+  kdl::result<NodeContents, BrushError> restore(const vm::bbox3& worldBounds) const;
+};
+} // namespace Model
+} // namespace TrenchBroom
@@ -40,7 +40,10 @@ static const auto Type = freeIssueType();
 } // namespace
 
 EmptyBrushEntityValidator::EmptyBrushEntityValidator()
-  : Validator{Type, "Empty brush entity"}
+  : Validator{
+      Type,
+      "Empty brush entity",
+      IssueDependency::Properties | IssueDependency::Hierarchy}
 {
   addQuickFix(makeDeleteNodesQuickFix());
 }
@@ -38,7 +38,7 @@ static const auto Type = freeIssueType();
 } // namespace
 
 EmptyPropertyKeyValidator::EmptyPropertyKeyValidator()
-  : Validator{Type, "Empty property name"}
+  : Validator{Type, "Empty property name", IssueDependency::Properties}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
 }
@@ -39,7 +39,7 @@ static const auto Type = freeIssueType();
 } // namespace
 
 EmptyPropertyValueValidator::EmptyPropertyValueValidator()
-  : Validator{Type, "Empty property value"}
+  : Validator{Type, "Empty property value", IssueDependency::Properties}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
 }
@@ -74,8 +74,10 @@ const vm::bbox3& EntityNode::modelBounds() const
 
 void EntityNode::setModelFrame(const Assets::EntityModelFrame* modelFrame)
 {
+  const auto oldPhysicalBounds = physicalBounds();
   m_entity.setModel(entityPropertyConfig(), modelFrame);
   nodePhysicalBoundsDidChange();
+  invalidateIssuesIfBoundsChanged(oldPhysicalBounds);
 }
 
 const vm::bbox3& EntityNode::doGetLogicalBounds() const
@@ -160,6 +162,7 @@ void EntityNode::doChildPhysicalBoundsDidChange()
 {
   invalidateBounds();
   nodePhysicalBoundsDidChange();
+  invalidateIssues(IssueDependency::Geometry);
 }
 
 bool EntityNode::doSelectable() const
@@ -246,9 +249,10 @@ std::vector<Node*> EntityNode::nodesRequiredForViewSelection()
   }
 }
 
-void EntityNode::doPropertiesDidChange(const vm::bbox3& /* oldBounds */)
+void EntityNode::doPropertiesDidChange(const vm::bbox3& oldBounds)
 {
   nodePhysicalBoundsDidChange();
+  invalidateIssuesIfBoundsChanged(oldBounds);
 }
 
 vm::vec3 EntityNode::doGetLinkSourceAnchor() const
@@ -281,6 +285,14 @@ void EntityNode::invalidateBounds()
   m_cachedBounds = std::nullopt;
 }
 
+void EntityNode::invalidateIssuesIfBoundsChanged(const vm::bbox3& oldPhysicalBounds)
+{
+  if (physicalBounds() != oldPhysicalBounds)
+  {
+    invalidateIssues(IssueDependency::Geometry);
+  }
+}
+
 void EntityNode::validateBounds() const
 {
   if (m_cachedBounds.has_value())
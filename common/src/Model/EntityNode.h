@@ -119,6 +119,7 @@ private: // implement Object interface
 private:
   void invalidateBounds();
   void validateBounds() const;
+  void invalidateIssuesIfBoundsChanged(const vm::bbox3& oldPhysicalBounds);
 
 private: // implement Taggable interface
   void doAcceptTagVisitor(TagVisitor& visitor) override;
@@ -165,6 +165,7 @@ void EntityNodeBase::propertiesWillChange() {}
 void EntityNodeBase::propertiesDidChange(const vm::bbox3& oldPhysicalBounds)
 {
   doPropertiesDidChange(oldPhysicalBounds);
+  invalidateIssues(IssueDependency::Properties);
 }
 
 void EntityNodeBase::updateIndexAndLinks(const std::vector<EntityProperty>& newProperties)
@@ -561,7 +562,7 @@ void EntityNodeBase::addLinkTargets(const std::vector<EntityNodeBase*>& targets)
     target->addLinkSource(this);
     m_linkTargets.push_back(target);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addKillTargets(const std::vector<EntityNodeBase*>& targets)
@@ -572,7 +573,7 @@ void EntityNodeBase::addKillTargets(const std::vector<EntityNodeBase*>& targets)
     target->addKillSource(this);
     m_killTargets.push_back(target);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addLinkSources(const std::vector<EntityNodeBase*>& sources)
@@ -583,7 +584,7 @@ void EntityNodeBase::addLinkSources(const std::vector<EntityNodeBase*>& sources)
     linkSource->addLinkTarget(this);
     m_linkSources.push_back(linkSource);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addKillSources(const std::vector<EntityNodeBase*>& sources)
@@ -594,7 +595,7 @@ void EntityNodeBase::addKillSources(const std::vector<EntityNodeBase*>& sources)
     killSource->addKillTarget(this);
     m_killSources.push_back(killSource);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeAllLinkSources()
@@ -602,7 +603,7 @@ void EntityNodeBase::removeAllLinkSources()
   for (EntityNodeBase* linkSource : m_linkSources)
     linkSource->removeLinkTarget(this);
   m_linkSources.clear();
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeAllLinkTargets()
@@ -610,7 +611,7 @@ void EntityNodeBase::removeAllLinkTargets()
   for (EntityNodeBase* linkTarget : m_linkTargets)
     linkTarget->removeLinkSource(this);
   m_linkTargets.clear();
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeAllKillSources()
@@ -618,7 +619,7 @@ void EntityNodeBase::removeAllKillSources()
   for (EntityNodeBase* killSource : m_killSources)
     killSource->removeKillTarget(this);
   m_killSources.clear();
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeAllKillTargets()
@@ -626,7 +627,7 @@ void EntityNodeBase::removeAllKillTargets()
   for (EntityNodeBase* killTarget : m_killTargets)
     killTarget->removeKillSource(this);
   m_killTargets.clear();
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeAllLinks()
@@ -666,49 +667,49 @@ void EntityNodeBase::addLinkSource(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_linkSources.push_back(node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addLinkTarget(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_linkTargets.push_back(node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addKillSource(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_killSources.push_back(node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::addKillTarget(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_killTargets.push_back(node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeLinkSource(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_linkSources = kdl::vec_erase(std::move(m_linkSources), node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeLinkTarget(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_linkTargets = kdl::vec_erase(std::move(m_linkTargets), node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 void EntityNodeBase::removeKillSource(EntityNodeBase* node)
 {
   ensure(node != nullptr, "node is null");
   m_killSources = kdl::vec_erase(std::move(m_killSources), node);
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Links);
 }
 
 EntityNodeBase::EntityNodeBase()
@@ -29,11 +29,13 @@
 #include "IO/AssimpParser.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/Bsp29Parser.h"
+#include "IO/BufferedParserStatus.h"
 #include "IO/DefParser.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
 #include "IO/DkmParser.h"
 #include "IO/EntParser.h"
+#include "IO/EntityDefinitionClassInfo.h"
 #include "IO/ExportOptions.h"
 #include "IO/FgdParser.h"
 #include "IO/File.h"
@@ -65,6 +67,7 @@
 #include "Model/LayerNode.h"
 #include "Model/WorldNode.h"
 
+#include <kdl/invoke.h>
 #include <kdl/overload.h>
 #include <kdl/path_utils.h>
 #include <kdl/result.h>
@@ -375,29 +378,53 @@ std::vector<Assets::EntityDefinition*> GameImpl::doLoadEntityDefinitions(
   const auto extension = path.extension().string();
   const auto& defaultColor = m_config.entityConfig.defaultColor;
 
+  if (
+    !kdl::ci::str_is_equal(".fgd", extension) && !kdl::ci::str_is_equal(".def", extension)
+    && !kdl::ci::str_is_equal(".ent", extension))
+  {
+    throw GameException{"Unknown entity definition format: '" + path.string() + "'"};
+  }
+
+  auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+  if (const auto* classInfos = m_entityDefinitionCache.classInfos(file->path(), status))
+  {
+    status.debug("Using cached entity definitions for '" + path.string() + "'");
+    return IO::createEntityDefinitions(*classInfos, defaultColor);
+  }
+
+  auto reader = file->reader().buffer();
+  auto sourceFiles = std::vector<IO::EntityDefinitionSourceFile>{
+    {file->path(), IO::hashEntityDefinitionSource(reader.stringView())}};
+  auto classInfos = std::vector<IO::EntityDefinitionClassInfo>{};
+
+  // record the messages so that they can be cached along with the class infos
+  auto parserStatus = IO::BufferedParserStatus{status};
+  const auto flushMessages = kdl::invoke_later{[&]() { parserStatus.flush(); }};
+
   if (kdl::ci::str_is_equal(".fgd", extension))
   {
-    auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-    auto reader = file->reader().buffer();
     auto parser = IO::FgdParser{reader.stringView(), defaultColor, file->path()};
-    return parser.parseDefinitions(status);
+    classInfos = parser.parseResolvedClassInfos(parserStatus);
+    sourceFiles = kdl::vec_concat(std::move(sourceFiles), parser.includedFiles());
   }
-  if (kdl::ci::str_is_equal(".def", extension))
+  else if (kdl::ci::str_is_equal(".def", extension))
   {
-    auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-    auto reader = file->reader().buffer();
     auto parser = IO::DefParser{reader.stringView(), defaultColor};
-    return parser.parseDefinitions(status);
+    classInfos = parser.parseResolvedClassInfos(parserStatus);
   }
-  if (kdl::ci::str_is_equal(".ent", extension))
+  else
   {
-    auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
-    auto reader = file->reader().buffer();
     auto parser = IO::EntParser{reader.stringView(), defaultColor};
-    return parser.parseDefinitions(status);
+    classInfos = parser.parseResolvedClassInfos(parserStatus);
   }
 
-  throw GameException{"Unknown entity definition format: '" + path.string() + "'"};
+  auto definitions = IO::createEntityDefinitions(classInfos, defaultColor);
+  m_entityDefinitionCache.setClassInfos(
+    file->path(),
+    std::move(sourceFiles),
+    std::move(classInfos),
+    parserStatus.messages());
+  return definitions;
 }
 
 std::vector<Assets::EntityDefinitionFileSpec> GameImpl::doAllEntityDefinitionFiles() const
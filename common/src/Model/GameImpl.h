@@ -20,6 +20,7 @@
 #pragma once
 
 #include "FloatType.h"
+#include "IO/EntityDefinitionCache.h"
 #include "Model/Game.h"
 #include "Model/GameFileSystem.h"
 
@@ -49,6 +50,7 @@ private:
   GameFileSystem m_fs;
   std::filesystem::path m_gamePath;
   std::vector<std::filesystem::path> m_additionalSearchPaths;
+  mutable IO::EntityDefinitionCache m_entityDefinitionCache;
 
 public:
   GameImpl(GameConfig& config, std::filesystem::path gamePath, Logger& logger);
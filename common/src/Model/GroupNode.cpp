@@ -44,9 +44,13 @@
 
 #include <vecmath/ray.h>
 
+#include <algorithm>
 #include <functional>
+#include <optional>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -78,6 +82,45 @@ static std::vector<const Node*> collectNodesToCloneAndTransform(const Node& node
   return result;
 }
 
+/**
+ * Returns a copy of the contents of the given node, transformed by the given
+ * transformation.
+ */
+static kdl::result<NodeContents, BrushError> transformNodeContents(
+  const Node& node, const vm::bbox3& worldBounds, const vm::mat4x4& transformation)
+{
+  using TransformResult = kdl::result<NodeContents, BrushError>;
+
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> TransformResult {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> TransformResult {
+      ensure(false, "Linked group structure is valid");
+    },
+    [&](const GroupNode* groupNode) -> TransformResult {
+      auto group = groupNode->group();
+      group.transform(transformation);
+      return NodeContents{std::move(group)};
+    },
+    [&](const EntityNode* entityNode) -> TransformResult {
+      auto entity = entityNode->entity();
+      entity.transform(entityNode->entityPropertyConfig(), transformation);
+      return NodeContents{std::move(entity)};
+    },
+    [&](const BrushNode* brushNode) -> TransformResult {
+      auto brush = brushNode->brush();
+      return brush.transform(worldBounds, transformation, true).and_then([&]() {
+        return TransformResult{NodeContents{std::move(brush)}};
+      });
+    },
+    [&](const PatchNode* patchNode) -> TransformResult {
+      auto patch = patchNode->patch();
+      patch.transform(transformation);
+      return NodeContents{std::move(patch)};
+    }));
+}
+
 static kdl::result<std::unique_ptr<Node>, UpdateLinkedGroupsError>
 cloneAndTransformRecursive(
   const Node* nodeToClone,
@@ -149,35 +192,10 @@ cloneAndTransformChildren(
   // `nodesToClone`
   auto transformResults =
     kdl::vec_parallel_transform(nodesToClone, [&](const Node* nodeToTransform) {
-      return nodeToTransform->accept(kdl::overload(
-        [](const WorldNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [](const LayerNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [&](const GroupNode* groupNode) -> TransformResult {
-          auto group = groupNode->group();
-          group.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(group)});
-        },
-        [&](const EntityNode* entityNode) -> TransformResult {
-          auto entity = entityNode->entity();
-          entity.transform(entityNode->entityPropertyConfig(), transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
-        },
-        [&](const BrushNode* brushNode) -> TransformResult {
-          auto brush = brushNode->brush();
-          return brush.transform(worldBounds, transformation, true)
-            .and_then([&]() -> TransformResult {
-              return std::make_pair(nodeToTransform, NodeContents{std::move(brush)});
-            });
-        },
-        [&](const PatchNode* patchNode) -> TransformResult {
-          auto patch = patchNode->patch();
-          patch.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(patch)});
-        }));
+      return transformNodeContents(*nodeToTransform, worldBounds, transformation)
+        .and_then([&](NodeContents contents) -> TransformResult {
+          return std::make_pair(nodeToTransform, std::move(contents));
+        });
     });
 
   return kdl::fold_results(std::move(transformResults))
@@ -241,24 +259,15 @@ static void preserveGroupNames(
 }
 
 static void preserveEntityProperties(
-  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+  Entity& clonedEntity,
+  const Entity& correspondingEntity,
+  const EntityPropertyConfig& entityPropertyConfig)
 {
-  if (
-    clonedEntityNode.entity().protectedProperties().empty()
-    && correspondingEntityNode.entity().protectedProperties().empty())
-  {
-    return;
-  }
-
-  auto clonedEntity = clonedEntityNode.entity();
-  const auto& correspondingEntity = correspondingEntityNode.entity();
-
   const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
     clonedEntity.protectedProperties(), correspondingEntity.protectedProperties()));
 
   clonedEntity.setProtectedProperties(correspondingEntity.protectedProperties());
 
-  const auto entityPropertyConfig = clonedEntityNode.entityPropertyConfig();
   for (const auto& propertyKey : allProtectedProperties)
   {
     // this can change the order of properties
@@ -268,7 +277,23 @@ static void preserveEntityProperties(
       clonedEntity.addOrUpdateProperty(entityPropertyConfig, propertyKey, *propertyValue);
     }
   }
+}
+
+static void preserveEntityProperties(
+  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+{
+  if (
+    clonedEntityNode.entity().protectedProperties().empty()
+    && correspondingEntityNode.entity().protectedProperties().empty())
+  {
+    return;
+  }
 
+  auto clonedEntity = clonedEntityNode.entity();
+  preserveEntityProperties(
+    clonedEntity,
+    correspondingEntityNode.entity(),
+    clonedEntityNode.entityPropertyConfig());
   clonedEntityNode.setEntity(std::move(clonedEntity));
 }
 
@@ -342,6 +367,201 @@ kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError> updateLinkedGroup
   });
 }
 
+/**
+ * Returns the position of the given node in the hierarchy below the given ancestor, i.e.,
+ * the index of each node on the path from the ancestor to the given node among the
+ * children of its parent.
+ */
+static std::vector<size_t> findChildIndexPath(const Node& ancestor, const Node& node)
+{
+  auto result = std::vector<size_t>{};
+  for (const auto* currentNode = &node; currentNode != &ancestor;
+       currentNode = currentNode->parent())
+  {
+    const auto& siblings = currentNode->parent()->children();
+    const auto it = std::find(std::begin(siblings), std::end(siblings), currentNode);
+    result.push_back(size_t(std::distance(std::begin(siblings), it)));
+  }
+  std::reverse(std::begin(result), std::end(result));
+  return result;
+}
+
+static bool haveSameChildStructure(const Node& sourceNode, const Node& targetNode)
+{
+  const auto& sourceChildren = sourceNode.children();
+  const auto& targetChildren = targetNode.children();
+  return std::equal(
+    std::begin(sourceChildren),
+    std::end(sourceChildren),
+    std::begin(targetChildren),
+    std::end(targetChildren),
+    [](const auto* sourceChild, const auto* targetChild) {
+      return typeid(*sourceChild) == typeid(*targetChild);
+    });
+}
+
+/**
+ * Returns the nodes at the given positions in the hierarchy below the given target group,
+ * or std::nullopt if the target group's hierarchy differs from the source group's along
+ * any of the given paths, i.e., if any node on a path has a different number of children
+ * or children of different types than the corresponding node below the source group.
+ */
+static std::optional<std::vector<Node*>> findCorrespondingNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<std::vector<size_t>>& childIndexPaths,
+  const GroupNode& targetGroupNode)
+{
+  // paths share their prefixes, so check the children of every source node only once
+  auto checkedSourceNodes = std::unordered_set<const Node*>{};
+
+  auto result = std::vector<Node*>{};
+  result.reserve(childIndexPaths.size());
+  for (const auto& childIndexPath : childIndexPaths)
+  {
+    const Node* sourceNode = &sourceGroupNode;
+    const Node* targetNode = &targetGroupNode;
+    for (const auto childIndex : childIndexPath)
+    {
+      if (
+        checkedSourceNodes.insert(sourceNode).second
+        && !haveSameChildStructure(*sourceNode, *targetNode))
+      {
+        return std::nullopt;
+      }
+      sourceNode = sourceNode->children()[childIndex];
+      targetNode = targetNode->children()[childIndex];
+    }
+    result.push_back(const_cast<Node*>(targetNode));
+  }
+  return result;
+}
+
+static std::vector<std::vector<size_t>> findChildIndexPaths(
+  const GroupNode& sourceGroupNode, const std::vector<Node*>& changedNodes)
+{
+  return kdl::vec_transform(changedNodes, [&](const auto* node) {
+    return findChildIndexPath(sourceGroupNode, *node);
+  });
+}
+
+/**
+ * Transforms the contents of the given source node into the given corresponding node of
+ * a linked group.
+ *
+ * Like updateLinkedGroups, this preserves the name of the corresponding group and the
+ * protected properties of the corresponding entity.
+ */
+static kdl::result<std::pair<Node*, NodeContents>, UpdateLinkedGroupsError>
+transformIntoCorrespondingNode(
+  const Node& sourceNode,
+  Node& correspondingNode,
+  const vm::bbox3& worldBounds,
+  const vm::mat4x4& transformation)
+{
+  using UpdateResult =
+    kdl::result<std::pair<Node*, NodeContents>, UpdateLinkedGroupsError>;
+
+  return transformNodeContents(sourceNode, worldBounds, transformation)
+    .or_else([](const auto&) -> kdl::result<NodeContents, UpdateLinkedGroupsError> {
+      return UpdateLinkedGroupsError::TransformFailed;
+    })
+    .and_then([&](NodeContents contents) -> UpdateResult {
+      const auto logicalBounds = std::visit(
+        kdl::overload(
+          [](const Layer&) -> std::optional<vm::bbox3> { return std::nullopt; },
+          [&](Group& group) -> std::optional<vm::bbox3> {
+            const auto& correspondingGroupNode =
+              static_cast<const GroupNode&>(correspondingNode);
+            group.setName(correspondingGroupNode.group().name());
+            return std::nullopt;
+          },
+          [&](Entity& entity) -> std::optional<vm::bbox3> {
+            const auto& correspondingEntityNode =
+              static_cast<const EntityNode&>(correspondingNode);
+            preserveEntityProperties(
+              entity,
+              correspondingEntityNode.entity(),
+              correspondingEntityNode.entityPropertyConfig());
+            return EntityNode{entity}.logicalBounds();
+          },
+          [](const Brush& brush) -> std::optional<vm::bbox3> { return brush.bounds(); },
+          [](const BezierPatch& patch) -> std::optional<vm::bbox3> {
+            return patch.bounds();
+          }),
+        contents.get());
+
+      if (logicalBounds && !worldBounds.contains(*logicalBounds))
+      {
+        return UpdateLinkedGroupsError::UpdateExceedsWorldBounds;
+      }
+
+      return std::make_pair(&correspondingNode, std::move(contents));
+    });
+}
+
+kdl::result<UpdateLinkedGroupNodesResult, UpdateLinkedGroupsError> updateLinkedGroupNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<Node*>& changedNodes,
+  const std::vector<Model::GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds)
+{
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto [success, invertedSourceTransformation] =
+    vm::invert(sourceGroup.transformation());
+  if (!success)
+  {
+    return UpdateLinkedGroupsError::TransformIsNotInvertible;
+  }
+
+  const auto changedNodePaths = findChildIndexPaths(sourceGroupNode, changedNodes);
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+
+  return kdl::fold_results(
+           targetGroupNodesToUpdate,
+           [&, invertedSourceTransformation = invertedSourceTransformation](
+             auto* targetGroupNode)
+             -> kdl::result<UpdateLinkedGroupNodesResult, UpdateLinkedGroupsError> {
+             const auto transformation =
+               targetGroupNode->group().transformation() * invertedSourceTransformation;
+
+             const auto correspondingNodes = findCorrespondingNodes(
+               sourceGroupNode, changedNodePaths, *targetGroupNode);
+             if (!correspondingNodes)
+             {
+               return UpdateLinkedGroupsError::UpdateIsInconsistent;
+             }
+
+             auto nodesToUpdate = std::vector<std::pair<const Node*, Node*>>{};
+             nodesToUpdate.reserve(changedNodes.size());
+             for (size_t i = 0; i < changedNodes.size(); ++i)
+             {
+               nodesToUpdate.emplace_back(changedNodes[i], (*correspondingNodes)[i]);
+             }
+
+             return kdl::fold_results(kdl::vec_parallel_transform(
+               std::move(nodesToUpdate), [&](const auto& nodePair) {
+                 return transformIntoCorrespondingNode(
+                   *nodePair.first, *nodePair.second, worldBounds, transformation);
+               }));
+           })
+    .transform([](auto nestedUpdateLists) {
+      return kdl::vec_flatten(std::move(nestedUpdateLists));
+    });
+}
+
+bool canUpdateLinkedGroupNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<Node*>& changedNodes,
+  const GroupNode& targetGroupNode)
+{
+  return findCorrespondingNodes(
+           sourceGroupNode,
+           findChildIndexPaths(sourceGroupNode, changedNodes),
+           targetGroupNode)
+    .has_value();
+}
+
 GroupNode::GroupNode(Group group)
   : m_group{std::move(group)}
   , m_editState{EditState::Closed}
@@ -414,6 +634,26 @@ bool GroupNode::hasPendingChanges() const
 void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
 {
   m_hasPendingChanges = hasPendingChanges;
+  m_nodesWithPendingContentChanges.clear();
+}
+
+void GroupNode::addPendingContentChanges(const std::vector<Node*>& changedNodes)
+{
+  if (!m_hasPendingChanges)
+  {
+    m_hasPendingChanges = !changedNodes.empty();
+    m_nodesWithPendingContentChanges = changedNodes;
+  }
+  else if (!m_nodesWithPendingContentChanges.empty())
+  {
+    m_nodesWithPendingContentChanges =
+      kdl::vec_concat(std::move(m_nodesWithPendingContentChanges), changedNodes);
+  }
+}
+
+const std::vector<Node*>& GroupNode::nodesWithPendingContentChanges() const
+{
+  return m_nodesWithPendingContentChanges;
 }
 
 void GroupNode::setEditState(const EditState editState)
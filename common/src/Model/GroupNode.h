@@ -40,6 +40,7 @@ namespace TrenchBroom
 {
 namespace Model
 {
+class NodeContents;
 enum class UpdateLinkedGroupsError;
 using UpdateLinkedGroupsResult =
   std::vector<std::pair<Node*, std::vector<std::unique_ptr<Node>>>>;
@@ -76,6 +77,52 @@ kdl::result<UpdateLinkedGroupsResult, UpdateLinkedGroupsError> updateLinkedGroup
   const std::vector<Model::GroupNode*>& targetGroupNodes,
   const vm::bbox3& worldBounds);
 
+using UpdateLinkedGroupNodesResult = std::vector<std::pair<Node*, NodeContents>>;
+
+/**
+ * Updates only the nodes of the given target group nodes which correspond to the given
+ * changed nodes of the given source group node. Use this instead of `updateLinkedGroups`
+ * if the contents of some nodes in the source group have changed, but no nodes were added
+ * or removed.
+ *
+ * The corresponding node of a changed node is the node at the same position in the
+ * hierarchy of a target group. This relies on the children of linked groups being in the
+ * same order, which is why commands that remove nodes restore them at their original
+ * positions when they are undone. Since linked groups loaded from a map file may still
+ * differ in order, use `canUpdateLinkedGroupNodes` to check each target group first and
+ * update the other target groups with `updateLinkedGroups`.
+ *
+ * The contents of each changed node are transformed in the same way and subject to the
+ * same rules regarding group names and protected entity properties as in
+ * `updateLinkedGroups`.
+ *
+ * In addition to the conditions listed for `updateLinkedGroups`, this operation fails if
+ * `canUpdateLinkedGroupNodes` returns false for any target group.
+ *
+ * If this operation succeeds, a vector of pairs is returned where each pair consists of a
+ * node of a target group, and the new contents that should replace the node's contents.
+ */
+kdl::result<UpdateLinkedGroupNodesResult, UpdateLinkedGroupsError> updateLinkedGroupNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<Node*>& changedNodes,
+  const std::vector<Model::GroupNode*>& targetGroupNodes,
+  const vm::bbox3& worldBounds);
+
+/**
+ * Indicates whether the given target group node has the same structure as the given
+ * source group node along the paths to the given changed nodes, i.e., whether every node
+ * on these paths has the same number of children with the same types as its
+ * corresponding node in the source group.
+ *
+ * If this returns false, then the nodes corresponding to the changed nodes cannot be
+ * determined by their positions and the target group must be updated with
+ * `updateLinkedGroups`.
+ */
+bool canUpdateLinkedGroupNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<Node*>& changedNodes,
+  const GroupNode& targetGroupNode);
+
 /**
  * A group of nodes that can be edited as one.
  *
@@ -108,6 +155,12 @@ private:
 
   bool m_hasPendingChanges;
 
+  /**
+   * If the pending changes of this group only changed the contents of some of its
+   * descendants, then this contains these descendants. Otherwise, it is empty.
+   */
+  std::vector<Node*> m_nodesWithPendingContentChanges;
+
 public:
   explicit GroupNode(Group group);
 
@@ -127,6 +180,20 @@ public:
   bool hasPendingChanges() const;
   void setHasPendingChanges(bool hasPendingChanges);
 
+  /**
+   * Records that the contents of the given descendants of this group have changed, but
+   * not the structure of this group. If this group already has pending changes that may
+   * have changed its structure, then this has no effect.
+   */
+  void addPendingContentChanges(const std::vector<Node*>& changedNodes);
+
+  /**
+   * Returns the descendants of this group whose contents have changed if the pending
+   * changes of this group did not change its structure. Otherwise, returns an empty
+   * vector.
+   */
+  const std::vector<Node*>& nodesWithPendingContentChanges() const;
+
 private:
   void setEditState(EditState editState);
   void setAncestorEditState(EditState editState);
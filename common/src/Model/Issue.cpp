@@ -32,6 +32,7 @@
 #include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 
+#include <atomic>
 #include <string>
 
 namespace TrenchBroom
@@ -53,6 +54,11 @@ size_t Issue::seqId() const
   return m_seqId;
 }
 
+void Issue::resetSeqId()
+{
+  m_seqId = nextSeqId();
+}
+
 size_t Issue::lineNumber() const
 {
   return doGetLineNumber();
@@ -107,7 +113,7 @@ bool Issue::hidden() const
 
 size_t Issue::nextSeqId()
 {
-  static size_t seqId = 0;
+  static auto seqId = std::atomic<size_t>{0};
   return seqId++;
 }
 
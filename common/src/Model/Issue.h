@@ -46,6 +46,13 @@ public:
   virtual ~Issue();
 
   size_t seqId() const;
+
+  /**
+   * Assigns a new sequence number to this issue. Issues which were created concurrently
+   * are renumbered in a fixed order so that their order does not depend on scheduling.
+   */
+  void resetSeqId();
+
   size_t lineNumber() const;
   const std::string& description() const;
 
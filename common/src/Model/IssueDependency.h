@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+namespace TrenchBroom
+{
+namespace Model
+{
+/**
+ * A set of aspects of a node that the issues found by a validator can depend on. When an
+ * aspect of a node changes, only the validators that depend on it have to validate the
+ * node again.
+ */
+using IssueDependencies = unsigned int;
+
+namespace IssueDependency
+{
+/**
+ * The properties and the entity definition of an entity node.
+ */
+constexpr IssueDependencies Properties = 1u << 0;
+
+/**
+ * The geometry and the face attributes of a brush or patch node, and the bounds of an
+ * entity node, which also change when its model is loaded or its children change.
+ */
+constexpr IssueDependencies Geometry = 1u << 1;
+
+/**
+ * The ancestors and the descendants of a node.
+ */
+constexpr IssueDependencies Hierarchy = 1u << 2;
+
+/**
+ * The link and kill sources and targets of an entity node.
+ */
+constexpr IssueDependencies Links = 1u << 3;
+
+constexpr IssueDependencies None = 0u;
+constexpr IssueDependencies All = Properties | Geometry | Hierarchy | Links;
+} // namespace IssueDependency
+
+} // namespace Model
+} // namespace TrenchBroom
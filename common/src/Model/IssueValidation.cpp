@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IssueValidation.h"
+
+#include "Model/Issue.h"
+#include "Model/Node.h"
+
+#include <kdl/parallel.h>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+
+std::vector<const Issue*> validateIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators)
+{
+  auto newIssues = std::vector<std::vector<Issue*>>(nodes.size());
+  kdl::parallel_for(nodes.size(), [&](const auto i) {
+    newIssues[i] = nodes[i]->validateIssues(validators);
+  });
+
+  for (const auto& nodeIssues : newIssues)
+  {
+    for (auto* issue : nodeIssues)
+    {
+      issue->resetSeqId();
+    }
+  }
+
+  auto result = std::vector<const Issue*>{};
+  for (auto* node : nodes)
+  {
+    const auto nodeIssues = node->issues(validators);
+    result.insert(result.end(), nodeIssues.begin(), nodeIssues.end());
+  }
+  return result;
+}
+
+} // namespace Model
+} // namespace TrenchBroom
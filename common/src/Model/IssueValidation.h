@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class Issue;
+class Node;
+class Validator;
+
+/**
+ * Validates the given nodes with the given validators and returns the issues of all of
+ * the given nodes, in the order of the nodes.
+ *
+ * Only the validators that depend on an aspect of a node which has changed since it was
+ * last validated are run on that node, and the nodes are validated in parallel. The new
+ * issues are renumbered in the order of the given nodes afterwards, so the result is the
+ * same as if the nodes had been validated one after another.
+ */
+std::vector<const Issue*> validateIssues(
+  const std::vector<Node*>& nodes, const std::vector<const Validator*>& validators);
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -39,7 +39,10 @@ static const auto Type = freeIssueType();
 } // namespace
 
 LinkSourceValidator::LinkSourceValidator()
-  : Validator{Type, "Missing entity link source"}
+  : Validator{
+      Type,
+      "Missing entity link source",
+      IssueDependency::Properties | IssueDependency::Links}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
 }
@@ -56,7 +56,10 @@ void validateInternal(
 } // namespace
 
 LinkTargetValidator::LinkTargetValidator()
-  : Validator{Type, "Missing entity link target"}
+  : Validator{
+      Type,
+      "Missing entity link target",
+      IssueDependency::Properties | IssueDependency::Links}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
 }
@@ -39,7 +39,7 @@ static const auto Type = freeIssueType();
 } // namespace
 
 LongPropertyKeyValidator::LongPropertyKeyValidator(const size_t maxLength)
-  : Validator{Type, "Long entity property keys"}
+  : Validator{Type, "Long entity property keys", IssueDependency::Properties}
   , m_maxLength{maxLength}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
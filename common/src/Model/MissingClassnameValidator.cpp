@@ -39,7 +39,7 @@ static const auto Type = freeIssueType();
 } // namespace
 
 MissingClassnameValidator::MissingClassnameValidator()
-  : Validator{Type, "Missing entity classname"}
+  : Validator{Type, "Missing entity classname", IssueDependency::Properties}
 {
   addQuickFix(makeDeleteNodesQuickFix());
 }
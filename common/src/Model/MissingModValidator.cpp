@@ -91,7 +91,7 @@ IssueQuickFix makeRemoveModsQuickFix()
 } // namespace
 
 MissingModValidator::MissingModValidator(std::weak_ptr<Game> game)
-  : Validator{Type, "Missing mod directory"}
+  : Validator{Type, "Missing mod directory", IssueDependency::Properties}
   , m_game{std::move(game)}
 {
   addQuickFix(makeRemoveModsQuickFix());
@@ -111,13 +111,7 @@ void MissingModValidator::doValidate(
   }
 
   auto game = kdl::mem_lock(m_game);
-  auto mods = game->extractEnabledMods(entityNode.entity());
-
-  if (mods == m_lastMods)
-  {
-    return;
-  }
-
+  const auto mods = game->extractEnabledMods(entityNode.entity());
   const auto additionalSearchPaths =
     kdl::vec_transform(mods, [](const auto& mod) { return std::filesystem::path{mod}; });
   const auto errors = game->checkAdditionalSearchPaths(additionalSearchPaths);
@@ -128,8 +122,6 @@ void MissingModValidator::doValidate(
     issues.push_back(std::make_unique<MissingModIssue>(
       entityNode, mod, "Mod '" + mod + "' could not be used: " + message));
   }
-
-  m_lastMods = std::move(mods);
 }
 } // namespace Model
 } // namespace TrenchBroom
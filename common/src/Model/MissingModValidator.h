@@ -22,7 +22,6 @@
 #include "Model/Validator.h"
 
 #include <memory>
-#include <string>
 #include <vector>
 
 namespace TrenchBroom
@@ -34,7 +33,6 @@ class Game;
 class MissingModValidator : public Validator
 {
   std::weak_ptr<Game> m_game;
-  mutable std::vector<std::string> m_lastMods;
 
 public:
   explicit MissingModValidator(std::weak_ptr<Game> game);
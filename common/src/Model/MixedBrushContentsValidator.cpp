@@ -37,7 +37,7 @@ static const auto Type = freeIssueType();
 } // namespace
 
 MixedBrushContentsValidator::MixedBrushContentsValidator()
-  : Validator{Type, "Mixed brush content flags"}
+  : Validator{Type, "Mixed brush content flags", IssueDependency::Geometry}
 {
 }
 
@@ -31,10 +31,16 @@
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "Polyhedron.h"
+#include "octree.h"
 
 #include <kdl/overload.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -359,6 +365,37 @@ std::vector<Node*> collectNodes(const std::vector<Node*>& nodes)
   return allNodes;
 }
 
+using CandidateBrushes = std::unordered_map<const Node*, std::vector<const BrushNode*>>;
+
+/**
+ * Uses the spatial index of the given world to find the nodes that might match one of the
+ * given brushes. Returns a map of each such node to the brushes whose bounds intersect
+ * the node's bounds.
+ */
+static CandidateBrushes findCandidateBrushes(
+  const WorldNode& world, const std::vector<BrushNode*>& brushes)
+{
+  auto result = CandidateBrushes{};
+  auto overlaps = std::vector<Node*>{};
+
+  for (const auto* brush : brushes)
+  {
+    const auto& bounds = brush->logicalBounds();
+
+    overlaps.clear();
+    world.nodeTree().find_overlaps(bounds, std::back_inserter(overlaps));
+    for (const auto* node : overlaps)
+    {
+      if (bounds.intersects(node->logicalBounds()))
+      {
+        result[node].push_back(brush);
+      }
+    }
+  }
+
+  return result;
+}
+
 /**
  * Recursively collect brushes and entities from the given vector of node trees such that
  * the returned nodes match the given predicate. A matching brush is only returned if it
@@ -367,6 +404,9 @@ std::vector<Node*> collectNodes(const std::vector<Node*>& nodes)
  * pair of node and brush.
  *
  * The given predicate must be a function that maps a node and a brush to true or false.
+ * It must only return true if the bounds of the node and the brush intersect, this allows
+ * the spatial index of a world to be used to avoid testing every node against every
+ * brush.
  */
 template <typename P>
 static std::vector<Node*> collectMatchingNodes(
@@ -375,23 +415,40 @@ static std::vector<Node*> collectMatchingNodes(
   const P& predicate)
 {
   auto result = std::vector<Model::Node*>{};
+  auto candidates = std::optional<CandidateBrushes>{};
+  const auto queryBrushes =
+    std::unordered_set<const BrushNode*>{brushes.begin(), brushes.end()};
+
+  const auto matchesAny = [&](const auto* node, const auto& brushesToTest) {
+    return std::any_of(
+      brushesToTest.begin(), brushesToTest.end(), [&](const auto* brush) {
+        return predicate(node, brush);
+      });
+  };
 
   const auto collectIfMatching = [&](auto* node) {
-    for (const auto* brush : brushes)
+    if (candidates)
     {
-      if (predicate(node, brush))
+      const auto iCandidate = candidates->find(node);
+      if (iCandidate != candidates->end() && matchesAny(node, iCandidate->second))
       {
         result.push_back(node);
-        return;
       }
     }
+    else if (matchesAny(node, brushes))
+    {
+      result.push_back(node);
+    }
   };
 
   for (auto* node : nodes)
   {
     node->accept(kdl::overload(
-      [](
-        auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+      [&](auto&& thisLambda, Model::WorldNode* world) {
+        candidates = findCandidateBrushes(*world, brushes);
+        world->visitChildren(thisLambda);
+        candidates = std::nullopt;
+      },
       [](
         auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
       [&](auto&& thisLambda, Model::GroupNode* group) {
@@ -399,9 +456,10 @@ static std::vector<Node*> collectMatchingNodes(
         {
           group->visitChildren(thisLambda);
         }
-        else
+        else if (matchesAny(group, brushes))
         {
-          collectIfMatching(group);
+          // groups are not part of the spatial index
+          result.push_back(group);
         }
       },
       [&](auto&& thisLambda, Model::EntityNode* entity) {
@@ -416,7 +474,7 @@ static std::vector<Node*> collectMatchingNodes(
       },
       [&](Model::BrushNode* brush) {
         // if `brush` is one of the search query nodes, don't count it as touching
-        if (!kdl::vec_contains(brushes, brush))
+        if (queryBrushes.count(brush) == 0)
         {
           collectIfMatching(brush);
         }
@@ -32,6 +32,7 @@
 
 #include <vecmath/bbox.h>
 
+#include <algorithm>
 #include <cassert>
 #include <iterator>
 #include <ostream>
@@ -56,7 +57,7 @@ Node::Node()
   , m_lockedByOtherSelection{false}
   , m_lineNumber{0}
   , m_lineCount{0}
-  , m_issuesValid{false}
+  , m_invalidIssueDependencies{IssueDependency::All}
   , m_hiddenIssues{0}
 {
 }
@@ -267,6 +268,22 @@ Node& Node::addChild(Node* child)
   return *child;
 }
 
+void Node::insertChildren(std::vector<std::pair<size_t, Node*>> children)
+{
+  children = kdl::vec_sort(std::move(children), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+
+  m_children.reserve(m_children.size() + children.size());
+  size_t descendantCountDelta = 0;
+  for (const auto& [index, child] : children)
+  {
+    doAddChild(child, index);
+    descendantCountDelta += child->descendantCount() + 1;
+  }
+  incDescendantCount(descendantCountDelta);
+}
+
 std::vector<std::unique_ptr<Node>> Node::replaceChildren(
   std::vector<std::unique_ptr<Node>> newChildren)
 {
@@ -324,6 +341,11 @@ bool Node::canRemoveChild(const Node* child) const
 }
 
 void Node::doAddChild(Node* child)
+{
+  doAddChild(child, m_children.size());
+}
+
+void Node::doAddChild(Node* child, const size_t index)
 {
   ensure(child != nullptr, "child is null");
   assert(!kdl::vec_contains(m_children, child));
@@ -332,7 +354,8 @@ void Node::doAddChild(Node* child)
 
   childWillBeAdded(child);
   // nodeWillChange();
-  m_children.push_back(child);
+  const auto position = std::min(index, m_children.size());
+  m_children.insert(std::next(std::begin(m_children), std::ptrdiff_t(position)), child);
   child->setParent(this);
   childWasAdded(child);
   // nodeDidChange();
@@ -397,7 +420,7 @@ void Node::descendantWasAdded(Node* node, const size_t depth)
   {
     m_parent->descendantWasAdded(node, depth + 1);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::descendantWillBeRemoved(Node* node, const size_t depth)
@@ -416,7 +439,7 @@ void Node::descendantWasRemoved(Node* oldParent, Node* node, const size_t depth)
   {
     m_parent->descendantWasRemoved(oldParent, node, depth + 1);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::incDescendantCount(const size_t delta)
@@ -479,7 +502,7 @@ void Node::ancestorWillChange()
   {
     child->ancestorWillChange();
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::ancestorDidChange()
@@ -489,7 +512,7 @@ void Node::ancestorDidChange()
   {
     child->ancestorDidChange();
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::nodeWillChange()
@@ -498,7 +521,6 @@ void Node::nodeWillChange()
   {
     m_parent->childWillChange(this);
   }
-  invalidateIssues();
 }
 
 void Node::nodeDidChange()
@@ -507,7 +529,6 @@ void Node::nodeDidChange()
   {
     m_parent->childDidChange(this);
   }
-  invalidateIssues();
 }
 
 Node::NotifyNodeChange::NotifyNodeChange(Node& node)
@@ -559,7 +580,7 @@ void Node::descendantWillChange(Node* node)
   {
     m_parent->descendantWillChange(node);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::descendantDidChange(Node* node)
@@ -569,7 +590,7 @@ void Node::descendantDidChange(Node* node)
   {
     m_parent->descendantDidChange(node);
   }
-  invalidateIssues();
+  invalidateIssues(IssueDependency::Hierarchy);
 }
 
 void Node::childPhysicalBoundsDidChange(Node* node)
@@ -874,22 +895,51 @@ void Node::setIssueHidden(const IssueType type, const bool hidden)
   }
 }
 
-void Node::validateIssues(const std::vector<const Validator*>& validators)
+std::vector<Issue*> Node::validateIssues(const std::vector<const Validator*>& validators)
 {
-  if (!m_issuesValid)
+  if (m_invalidIssueDependencies == IssueDependency::None)
   {
-    for (const auto* validator : validators)
-    {
-      validator->validate(*this, m_issues);
-    }
-    m_issuesValid = true;
+    return {};
+  }
+
+  auto invalidValidators = kdl::vec_filter(validators, [&](const auto* validator) {
+    return (validator->dependencies() & m_invalidIssueDependencies) != 0;
+  });
+
+  auto invalidTypes = IssueType{0};
+  for (const auto* validator : invalidValidators)
+  {
+    invalidTypes |= validator->type();
+  }
+
+  m_issues = kdl::vec_erase_if(std::move(m_issues), [&](const auto& issue) {
+    return (issue->type() & invalidTypes) != 0;
+  });
+
+  const auto firstNewIssue = m_issues.size();
+  for (const auto* validator : invalidValidators)
+  {
+    validator->validate(*this, m_issues);
+  }
+  m_invalidIssueDependencies = IssueDependency::None;
+
+  auto result = std::vector<Issue*>{};
+  result.reserve(m_issues.size() - firstNewIssue);
+  for (auto i = firstNewIssue; i < m_issues.size(); ++i)
+  {
+    result.push_back(m_issues[i].get());
   }
+  return result;
 }
 
-void Node::invalidateIssues() const
+void Node::invalidateIssues(const IssueDependencies dependencies) const
 {
-  m_issues.clear();
-  m_issuesValid = false;
+  if (dependencies == IssueDependency::All)
+  {
+    // the validators may have changed, so no issue can be kept
+    m_issues.clear();
+  }
+  m_invalidIssueDependencies |= dependencies;
 }
 
 const EntityPropertyConfig& Node::entityPropertyConfig() const
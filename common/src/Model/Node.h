@@ -20,6 +20,7 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Model/IssueDependency.h"
 #include "Model/IssueType.h"
 #include "Model/NodeVisitor.h"
 #include "Model/Tag.h"
@@ -32,6 +33,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -75,7 +77,7 @@ private:
   mutable size_t m_lineCount;
 
   mutable std::vector<std::unique_ptr<Issue>> m_issues;
-  mutable bool m_issuesValid;
+  mutable IssueDependencies m_invalidIssueDependencies;
   IssueType m_hiddenIssues;
 
 protected:
@@ -201,6 +203,14 @@ public:
 
   Node& addChild(Node* child);
 
+  /**
+   * Adds each of the given children at the given index among this node's children. The
+   * children are added in order of ascending index, so every index refers to the position
+   * of its child after all children with a lower index have been added. An index greater
+   * than the number of children adds the child at the end.
+   */
+  void insertChildren(std::vector<std::pair<size_t, Node*>> children);
+
   std::vector<std::unique_ptr<Node>> replaceChildren(
     std::vector<std::unique_ptr<Node>> newChildren);
 
@@ -247,6 +257,7 @@ public:
 
 private:
   void doAddChild(Node* child);
+  void doAddChild(Node* child, size_t index);
   void doRemoveChild(Node* child);
   void clearChildren();
 
@@ -281,6 +292,8 @@ protected: // notification for parents
   };
 
   // call these methods via the NotifyNodeChange class, it's much safer
+  // they don't invalidate the issues of the changed node, because only the caller knows
+  // which aspects of the node it changes
   void nodeWillChange();
   void nodeDidChange();
 
@@ -378,11 +391,24 @@ public: // issue management
   bool issueHidden(IssueType type) const;
   void setIssueHidden(IssueType type, bool hidden);
 
-public: // should only be called from this and from the world
-  void invalidateIssues() const;
+  /**
+   * Runs the given validators on this node if the aspects of this node that they depend
+   * on have changed since the node was last validated. The issues of the other validators
+   * are kept.
+   *
+   * Expects to be called with the same validators every time, and the issues must be
+   * invalidated entirely when the validators change.
+   *
+   * @return the issues which were found by this call
+   */
+  std::vector<Issue*> validateIssues(const std::vector<const Validator*>& validators);
 
-private:
-  void validateIssues(const std::vector<const Validator*>& validators);
+public: // should only be called from this and from the world
+  /**
+   * Marks the issues of the validators that depend on the given aspects of this node as
+   * invalid.
+   */
+  void invalidateIssues(IssueDependencies dependencies = IssueDependency::All) const;
 
 public: // visitors
   /**
@@ -339,6 +339,7 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
   m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  invalidateIssues(IssueDependency::Geometry);
   return previousPatch;
 }
 
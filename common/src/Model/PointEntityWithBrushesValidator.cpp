@@ -66,7 +66,10 @@ IssueQuickFix makeMoveBrushesToWorldQuickFix()
 } // namespace
 
 PointEntityWithBrushesValidator::PointEntityWithBrushesValidator()
-  : Validator{Type, "Point entity with brushes"}
+  : Validator{
+      Type,
+      "Point entity with brushes",
+      IssueDependency::Properties | IssueDependency::Hierarchy}
 {
   addQuickFix(makeMoveBrushesToWorldQuickFix());
 }
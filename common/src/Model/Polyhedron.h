@@ -30,6 +30,7 @@
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
 
+#include <cstddef>
 #include <initializer_list>
 #include <limits>
 #include <optional>
@@ -113,6 +114,12 @@ private:
   explicit Polyhedron_Vertex(const vm::vec<T, 3>& position);
 
 public:
+  /**
+   * Vertices are allocated from a kdl::object_pool.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the position of this vertex.
    */
@@ -260,6 +267,12 @@ private:
   Polyhedron_Edge(HalfEdge* first, HalfEdge* second = nullptr);
 
 public:
+  /**
+   * Edges are allocated from a kdl::object_pool.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin of the first half edge.
    */
@@ -577,6 +590,12 @@ private:
   Polyhedron_HalfEdge(Vertex* origin);
 
 public:
+  /**
+   * Half edges are allocated from a kdl::object_pool.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the origin vertex of this half edge.
    */
@@ -803,6 +822,12 @@ private:
   explicit Polyhedron_Face(HalfEdgeList&& boundary, const vm::plane<T, 3>& plane);
 
 public:
+  /**
+   * Faces are allocated from a kdl::object_pool.
+   */
+  static void* operator new(std::size_t size);
+  static void operator delete(void* ptr) noexcept;
+
   /**
    * Returns the circular list of half edges that make up the boundary of this face.
    */
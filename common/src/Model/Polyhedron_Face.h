@@ -22,6 +22,8 @@
 #include "Macros.h"
 #include "Polyhedron.h"
 
+#include <kdl/block_pool.h>
+
 #include <vecmath/constants.h>
 #include <vecmath/intersection.h>
 #include <vecmath/plane.h>
@@ -30,6 +32,8 @@
 #include <vecmath/util.h>
 #include <vecmath/vec.h>
 
+#include <cassert>
+#include <cstddef>
 #include <unordered_set>
 
 namespace TrenchBroom
@@ -76,6 +80,20 @@ Polyhedron_Face<T, FP, VP>::Polyhedron_Face(
   countAndSetFace(m_boundary.front(), m_boundary.back(), this);
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Face<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_Face));
+  unused(size);
+  return kdl::object_pool<Polyhedron_Face>::allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Face<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::object_pool<Polyhedron_Face>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 const typename Polyhedron_Face<T, FP, VP>::HalfEdgeList& Polyhedron_Face<T, FP, VP>::
   boundary() const
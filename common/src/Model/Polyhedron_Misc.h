@@ -21,6 +21,7 @@
 
 #include "Polyhedron.h"
 
+#include <kdl/block_pool.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
@@ -31,6 +32,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <functional>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -259,10 +261,18 @@ template <typename T, typename FP, typename VP>
 class Polyhedron<T, FP, VP>::Copy
 {
 private:
-  using VertexMap = std::unordered_map<const Vertex*, Vertex*>;
+  template <typename K, typename V>
+  using PointerMap = std::unordered_map<
+    K,
+    V,
+    std::hash<K>,
+    std::equal_to<K>,
+    kdl::pool_allocator<std::pair<const K, V>>>;
+
+  using VertexMap = PointerMap<const Vertex*, Vertex*>;
   using VertexMapEntry = typename VertexMap::value_type;
 
-  using HalfEdgeMap = std::unordered_map<const HalfEdge*, HalfEdge*>;
+  using HalfEdgeMap = PointerMap<const HalfEdge*, HalfEdge*>;
   using HalfEdgeMapEntry = typename HalfEdgeMap::value_type;
 
   /**
@@ -315,6 +325,9 @@ public:
     const CopyCallback& callback)
     : m_destination(destination)
   {
+    m_vertexMap.reserve(originalVertices.size());
+    m_halfEdgeMap.reserve(2u * originalEdges.size());
+
     copyVertices(originalVertices, callback);
     copyFaces(originalFaces, callback);
     copyEdges(originalEdges);
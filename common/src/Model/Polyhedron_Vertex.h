@@ -19,10 +19,15 @@
 
 #pragma once
 
+#include "Macros.h"
 #include "Polyhedron.h"
 
+#include <kdl/block_pool.h>
 #include <kdl/intrusive_circular_list.h>
 
+#include <cassert>
+#include <cstddef>
+
 namespace TrenchBroom
 {
 namespace Model
@@ -65,6 +70,20 @@ Polyhedron_Vertex<T, FP, VP>::Polyhedron_Vertex(const vm::vec<T, 3>& position)
 {
 }
 
+template <typename T, typename FP, typename VP>
+void* Polyhedron_Vertex<T, FP, VP>::operator new(const std::size_t size)
+{
+  assert(size == sizeof(Polyhedron_Vertex));
+  unused(size);
+  return kdl::object_pool<Polyhedron_Vertex>::allocate();
+}
+
+template <typename T, typename FP, typename VP>
+void Polyhedron_Vertex<T, FP, VP>::operator delete(void* ptr) noexcept
+{
+  kdl::object_pool<Polyhedron_Vertex>::deallocate(ptr);
+}
+
 template <typename T, typename FP, typename VP>
 const vm::vec<T, 3>& Polyhedron_Vertex<T, FP, VP>::position() const
 {
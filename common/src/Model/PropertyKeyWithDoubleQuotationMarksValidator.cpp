@@ -41,7 +41,7 @@ static const auto Type = freeIssueType();
 
 PropertyKeyWithDoubleQuotationMarksValidator::
   PropertyKeyWithDoubleQuotationMarksValidator()
-  : Validator{Type, "Invalid entity property keys"}
+  : Validator{Type, "Invalid entity property keys", IssueDependency::Properties}
 {
   addQuickFix(makeRemoveEntityPropertiesQuickFix(Type));
   addQuickFix(makeTransformEntityPropertiesQuickFix(
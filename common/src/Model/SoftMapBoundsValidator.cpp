@@ -59,7 +59,10 @@ void validateInternal(
 
 SoftMapBoundsValidator::SoftMapBoundsValidator(
   std::weak_ptr<Game> game, const WorldNode& world)
-  : Validator(Type, "Objects out of soft map bounds")
+  : Validator(
+      Type,
+      "Objects out of soft map bounds",
+      IssueDependency::Properties | IssueDependency::Geometry)
   , m_game{game}
   , m_world{world}
 {
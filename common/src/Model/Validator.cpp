@@ -46,6 +46,11 @@ const std::string& Validator::description() const
   return m_description;
 }
 
+IssueDependencies Validator::dependencies() const
+{
+  return m_dependencies;
+}
+
 std::vector<const IssueQuickFix*> Validator::quickFixes() const
 {
   return kdl::vec_transform(m_quickFixes, [](const auto& quickFix) {
@@ -64,9 +69,13 @@ void Validator::validate(Node& node, std::vector<std::unique_ptr<Issue>>& issues
     [&](PatchNode* patchNode) { doValidate(*patchNode, issues); }));
 }
 
-Validator::Validator(const IssueType type, const std::string& description)
+Validator::Validator(
+  const IssueType type,
+  const std::string& description,
+  const IssueDependencies dependencies)
   : m_type{type}
   , m_description{description}
+  , m_dependencies{dependencies}
 {
 }
 
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Model/IssueDependency.h"
 #include "Model/IssueQuickFix.h"
 #include "Model/IssueType.h"
 
@@ -45,6 +46,7 @@ class Validator
 private:
   IssueType m_type;
   std::string m_description;
+  IssueDependencies m_dependencies;
   std::vector<IssueQuickFix> m_quickFixes;
 
 public:
@@ -52,12 +54,24 @@ public:
 
   IssueType type() const;
   const std::string& description() const;
+
+  /**
+   * Returns the aspects of a node that the issues found by this validator depend on.
+   */
+  IssueDependencies dependencies() const;
   std::vector<const IssueQuickFix*> quickFixes() const;
 
+  /**
+   * Validates the given node and appends the issues found to the given vector.
+   *
+   * Different nodes may be validated concurrently, so implementations must not modify
+   * any state that is shared between nodes.
+   */
   void validate(Node& node, std::vector<std::unique_ptr<Issue>>& issues) const;
 
 protected:
-  Validator(IssueType type, const std::string& description);
+  Validator(
+    IssueType type, const std::string& description, IssueDependencies dependencies);
   void addQuickFix(IssueQuickFix quickFix);
 
 private:
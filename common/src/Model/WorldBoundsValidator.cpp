@@ -48,7 +48,10 @@ void validateInternal(
 } // namespace
 
 WorldBoundsValidator::WorldBoundsValidator(const vm::bbox3& bounds)
-  : Validator{Type, "Objects out of world bounds"}
+  : Validator{
+      Type,
+      "Objects out of world bounds",
+      IssueDependency::Properties | IssueDependency::Geometry}
   , m_bounds{bounds}
 {
   addQuickFix(makeDeleteNodesQuickFix());
@@ -24,13 +24,99 @@
 #include <kdl/set_temp.h>
 #include <kdl/tuple_utils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <set>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
 {
+/**
+ * Collects the notifications of a notifier while a batch is open and merges them into a
+ * single notification. See Notifier::setBatch.
+ *
+ * @tparam A the types of the parameters passed to the observer callbacks.
+ */
+template <typename... A>
+class NotifierBatch
+{
+public:
+  virtual ~NotifierBatch() = default;
+
+  /**
+   * Adds the arguments of a notification to this batch.
+   */
+  virtual void add(A... a) = 0;
+
+  /**
+   * Calls the given function with the merged arguments of the collected notifications
+   * and clears this batch. Does nothing if no notifications were collected.
+   */
+  virtual void flush(const std::function<void(A...)>& notify) = 0;
+};
+
+/**
+ * Merges notifications which pass a vector of values into a single notification. Every
+ * value is passed once, in the order in which the values were first passed.
+ *
+ * @tparam T the type of the values, must be less than comparable
+ */
+template <typename T>
+class VectorNotifierBatch : public NotifierBatch<const std::vector<T>&>
+{
+private:
+  std::vector<T> m_values;
+  std::set<T> m_contained;
+
+public:
+  void add(const std::vector<T>& values) override
+  {
+    for (const auto& value : values)
+    {
+      if (m_contained.insert(value).second)
+      {
+        m_values.push_back(value);
+      }
+    }
+  }
+
+  void flush(const std::function<void(const std::vector<T>&)>& notify) override
+  {
+    auto values = std::exchange(m_values, {});
+    m_contained.clear();
+
+    if (!values.empty())
+    {
+      notify(values);
+    }
+  }
+
+  /**
+   * Removes the collected values for which the given predicate returns true, e.g.
+   * because they must not be passed to the observers anymore.
+   */
+  template <typename P>
+  void discard(const P& predicate)
+  {
+    const auto it =
+      std::remove_if(m_values.begin(), m_values.end(), [&](const auto& value) {
+        if (predicate(value))
+        {
+          m_contained.erase(value);
+          return true;
+        }
+        return false;
+      });
+    m_values.erase(it, m_values.end());
+  }
+
+  const std::vector<T>& values() const { return m_values; }
+};
+
 /**
  * Base class for notifier state. This is only necessary so that NotifierConnection is
  * independent of the Notifier type.
@@ -63,11 +149,13 @@ private:
   {
     Callback callback;
     size_t id;
+    bool immediate;
     bool pendingRemove;
 
-    Observer(Callback i_callback, const size_t i_id)
+    Observer(Callback i_callback, const size_t i_id, const bool i_immediate)
       : callback{std::move(i_callback)}
       , id{i_id}
+      , immediate{i_immediate}
       , pendingRemove{false}
     {
     }
@@ -81,19 +169,22 @@ private:
     std::vector<Observer> m_toAdd;
     bool m_notifying{false};
 
+    std::unique_ptr<NotifierBatch<A...>> m_batch;
+    size_t m_batchDepth{0};
+
   public:
     ~NotifierState() override = default;
 
-    size_t connect(Callback callback)
+    size_t connect(Callback callback, const bool immediate)
     {
       const auto id = m_nextId++;
       if (m_notifying)
       {
-        m_toAdd.emplace_back(std::move(callback), id);
+        m_toAdd.emplace_back(std::move(callback), id, immediate);
       }
       else
       {
-        m_observers.emplace_back(std::move(callback), id);
+        m_observers.emplace_back(std::move(callback), id, immediate);
       }
       return id;
     }
@@ -104,11 +195,11 @@ private:
       auto callback = [&](auto&&... a) { notifier(std::forward<decltype(a)>(a)...); };
       if (m_notifying)
       {
-        m_toAdd.emplace_back(std::move(callback), id);
+        m_toAdd.emplace_back(std::move(callback), id, false);
       }
       else
       {
-        m_observers.emplace_back(std::move(callback), id);
+        m_observers.emplace_back(std::move(callback), id, false);
       }
       return id;
     }
@@ -119,13 +210,64 @@ private:
       processPendingObservers();
 
       const kdl::set_temp notifying(m_notifying);
+      const auto batching = m_batch && m_batchDepth > 0;
+      const auto notifies = [&](const auto& observer) {
+        return !observer.pendingRemove && (!batching || observer.immediate);
+      };
+
+      // the arguments may only be forwarded to their last recipient, which is the batch
+      // if one is open
+      const auto lastIt =
+        std::find_if(m_observers.rbegin(), m_observers.rend(), notifies);
+      const auto* last = !batching && lastIt != m_observers.rend() ? &*lastIt : nullptr;
+
       for (const auto& observer : m_observers)
       {
-        if (!observer.pendingRemove)
+        if (notifies(observer))
         {
-          observer.callback(std::forward<NA>(a)...);
+          if (&observer == last)
+          {
+            observer.callback(std::forward<NA>(a)...);
+          }
+          else
+          {
+            observer.callback(passOn<A>(a)...);
+          }
         }
       }
+
+      if (batching)
+      {
+        m_batch->add(std::forward<NA>(a)...);
+      }
+    }
+
+    void setBatch(std::unique_ptr<NotifierBatch<A...>> batch)
+    {
+      assert(m_batchDepth == 0);
+      m_batch = std::move(batch);
+    }
+
+    void beginBatch() { ++m_batchDepth; }
+
+    void endBatch()
+    {
+      assert(m_batchDepth > 0);
+      if (--m_batchDepth == 0 && m_batch)
+      {
+        m_batch->flush([&](A... a) {
+          processPendingObservers();
+
+          const kdl::set_temp notifying(m_notifying);
+          for (const auto& observer : m_observers)
+          {
+            if (!observer.pendingRemove && !observer.immediate)
+            {
+              observer.callback(passOn<A>(a)...);
+            }
+          }
+        });
+      }
     }
 
     void disconnect(const size_t id) override
@@ -150,6 +292,24 @@ private:
     }
 
   private:
+    /**
+     * Passes an argument to an observer that is not its last recipient. Unless the
+     * notifier takes the argument by rvalue reference, it is passed as an lvalue so that
+     * the remaining recipients do not receive a moved from object.
+     */
+    template <typename T, typename U>
+    static decltype(auto) passOn(U& u)
+    {
+      if constexpr (std::is_rvalue_reference_v<T>)
+      {
+        return std::move(u);
+      }
+      else
+      {
+        return (u);
+      }
+    }
+
     typename std::vector<Observer>::iterator findObserver(
       std::vector<Observer>& observers, const size_t id)
     {
@@ -208,7 +368,7 @@ public:
    */
   [[nodiscard]] NotifierConnection connect(Callback callback)
   {
-    const auto id = m_state->connect(std::move(callback));
+    const auto id = m_state->connect(std::move(callback), false);
     return NotifierConnection{m_state, id};
   }
 
@@ -228,6 +388,33 @@ public:
     });
   }
 
+  /**
+   * Adds the given observer callback to this notifier. Unlike the callbacks added with
+   * connect, the callback is always notified immediately, even while a batch is open.
+   *
+   * This is for observers which must see every notification when it happens, e.g.
+   * because they must update their state before the next change is made.
+   */
+  [[nodiscard]] NotifierConnection connectImmediately(Callback callback)
+  {
+    const auto id = m_state->connect(std::move(callback), true);
+    return NotifierConnection{m_state, id};
+  }
+
+  /**
+   * Adds the given member function observer callback to this notifier. The callback is
+   * always notified immediately, see above.
+   */
+  template <typename R, typename MemberCallback>
+  [[nodiscard]] NotifierConnection connectImmediately(
+    R* receiver, MemberCallback callback)
+  {
+    return connectImmediately(
+      [receiver = receiver, callback = std::move(callback)](auto&&... args) {
+        std::invoke(callback, receiver, std::forward<decltype(args)>(args)...);
+      });
+  }
+
   /**
    * Adds the given observer callback to this notifier.
    *
@@ -243,6 +430,38 @@ public:
     return NotifierConnection{m_state, id};
   }
 
+  /**
+   * Sets the batch that collects the notifications of this notifier while a batch is
+   * open, and returns a reference to it. Without a batch, all observers are notified
+   * immediately.
+   *
+   * Must not be called while a batch is open.
+   */
+  template <typename B, typename... BA>
+  B& setBatch(BA&&... args)
+  {
+    auto batch = std::make_unique<B>(std::forward<BA>(args)...);
+    auto& result = *batch;
+    m_state->setBatch(std::move(batch));
+    return result;
+  }
+
+  /**
+   * Opens a batch. While a batch is open, only the observers which were connected with
+   * connectImmediately are notified, and the notifications are collected by the batch of
+   * this notifier. When the outermost batch is closed, the other observers are notified
+   * once with the merged arguments of all collected notifications.
+   *
+   * Batches can be nested, and every call to this function must be matched by a call to
+   * endBatch.
+   */
+  void beginBatch() { m_state->beginBatch(); }
+
+  /**
+   * Closes a batch opened by beginBatch.
+   */
+  void endBatch() { m_state->endBatch(); }
+
   /**
    * Notifies all observers of this notifier with the given arguments.
    *
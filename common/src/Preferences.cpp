@@ -187,9 +187,14 @@ Preference<Color> GridColor2D("Rendere/Grid/Color2D", Color(0.8f, 0.8f, 0.8f, 0.
 Preference<int> TextureMinFilter("Renderer/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("Renderer/Texture mode mag filter", 0x2600);
 Preference<bool> EnableMSAA("Renderer/Enable multisampling", true);
+Preference<bool> EnableTextureCache("Renderer/Enable texture cache", false);
+// in MiB
+Preference<int> TextureCacheSize("Renderer/Texture cache size", 1024);
 
 Preference<bool> TextureLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
+// in MiB, 0 means unlimited
+Preference<int> UndoMemoryBudget("Editor/Undo memory budget", 1024);
 
 Preference<std::filesystem::path>& RendererFontPath()
 {
@@ -382,8 +387,11 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &GridColor2D,
     &TextureMinFilter,
     &TextureMagFilter,
+    &EnableTextureCache,
+    &TextureCacheSize,
     &TextureLock,
     &UVLock,
+    &UndoMemoryBudget,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
@@ -128,9 +128,12 @@ extern Preference<Color> GridColor2D;
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
 extern Preference<bool> EnableMSAA;
+extern Preference<bool> EnableTextureCache;
+extern Preference<int> TextureCacheSize;
 
 extern Preference<bool> TextureLock;
 extern Preference<bool> UVLock;
+extern Preference<int> UndoMemoryBudget;
 
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
@@ -29,10 +29,14 @@
 #include "Preferences.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/RenderContext.h"
 
+#include <kdl/parallel.h>
+
 #include <cassert>
 #include <cstring>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
@@ -167,6 +171,9 @@ void BrushRenderer::invalidate()
   assert(m_brushInfo.empty());
   assert(m_transparentFaces->empty());
   assert(m_opaqueFaces->empty());
+
+  m_visibleOpaqueFaces->clear();
+  m_visibleTransparentFaces->clear();
 }
 
 void BrushRenderer::invalidateBrush(const Model::BrushNode* brushNode)
@@ -200,6 +207,8 @@ void BrushRenderer::clear()
   m_edgeIndices = std::make_shared<BrushIndexArray>();
   m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
   m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
+  m_visibleOpaqueFaces = std::make_shared<FaceRenderer::TextureToIndexRangesMap>();
+  m_visibleTransparentFaces = std::make_shared<FaceRenderer::TextureToIndexRangesMap>();
 
   m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
   m_transparentFaceRenderer =
@@ -290,6 +299,7 @@ void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& rend
     }
     if (renderContext.showFaces())
     {
+      m_opaqueFaceRenderer.setIndexRanges(findVisibleFaces(renderContext, false));
       renderOpaqueFaces(renderBatch);
     }
     if (renderContext.showEdges() || m_showEdges)
@@ -310,11 +320,73 @@ void BrushRenderer::renderTransparent(
     }
     if (renderContext.showFaces())
     {
+      m_transparentFaceRenderer.setIndexRanges(findVisibleFaces(renderContext, true));
       renderTransparentFaces(renderBatch);
     }
   }
 }
 
+std::shared_ptr<const FaceRenderer::TextureToIndexRangesMap> BrushRenderer::
+  findVisibleFaces(const RenderContext& renderContext, const bool transparent)
+{
+  const auto* visibleNodes = renderContext.visibleNodes();
+  if (!visibleNodes)
+  {
+    return nullptr;
+  }
+
+  auto& visibleFaces = transparent ? *m_visibleTransparentFaces : *m_visibleOpaqueFaces;
+  for (auto& [texture, ranges] : visibleFaces)
+  {
+    ranges.clear();
+  }
+
+  auto visibleBrushCount = size_t(0);
+  const auto addBrush = [&](const BrushInfo& brushInfo) {
+    const auto& keys = transparent ? brushInfo.transparentFaceIndicesKeys
+                                   : brushInfo.opaqueFaceIndicesKeys;
+    for (const auto& [texture, key] : keys)
+    {
+      visibleFaces[texture].push_back({key->pos, key->size});
+    }
+    ++visibleBrushCount;
+  };
+
+  // iterate over the brushes of this renderer or the visible brushes, whichever is fewer
+  if (m_brushInfo.size() <= visibleNodes->brushNodes.size())
+  {
+    for (const auto& [brushNode, brushInfo] : m_brushInfo)
+    {
+      if (visibleNodes->frustum.intersects(brushNode->physicalBounds()))
+      {
+        addBrush(brushInfo);
+      }
+    }
+  }
+  else
+  {
+    for (const auto* brushNode : visibleNodes->brushNodes)
+    {
+      if (const auto it = m_brushInfo.find(brushNode); it != m_brushInfo.end())
+      {
+        addBrush(it->second);
+      }
+    }
+  }
+
+  if (visibleBrushCount == m_brushInfo.size())
+  {
+    return nullptr;
+  }
+
+  for (auto& [texture, ranges] : visibleFaces)
+  {
+    mergeIndexRanges(ranges);
+  }
+
+  return transparent ? m_visibleTransparentFaces : m_visibleOpaqueFaces;
+}
+
 void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch)
 {
   m_opaqueFaceRenderer.setGrayscale(m_grayscale);
@@ -377,9 +449,36 @@ void BrushRenderer::validate()
 {
   assert(!valid());
 
+  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+
+  // evaluate filter. only evaluate the filter once per brush.
+  auto brushesToRender =
+    std::vector<std::tuple<const Model::BrushNode*, Filter::RenderSettings>>{};
+  brushesToRender.reserve(m_invalidBrushes.size());
   for (auto* brushNode : m_invalidBrushes)
   {
-    validateBrush(*brushNode);
+    const auto settings = wrapper.markFaces(*brushNode);
+    const auto [facePolicy, edgePolicy] = settings;
+    if (
+      facePolicy != Filter::FaceRenderPolicy::RenderNone
+      || edgePolicy != Filter::EdgeRenderPolicy::RenderNone)
+    {
+      brushesToRender.emplace_back(brushNode, settings);
+    }
+  }
+
+  // Building the vertex caches is the expensive part of validating a brush. Every brush
+  // node owns its cache, so the caches can be built in parallel. Only the brushes'
+  // caches and their geometries' vertex payloads are modified.
+  kdl::parallel_for(brushesToRender.size(), [&](const size_t i) {
+    const auto* brushNode = std::get<0>(brushesToRender[i]);
+    brushNode->brushRendererBrushCache().validateVertexCache(*brushNode);
+  });
+
+  // copying the cached data into the vertex and index arrays must be done serially
+  for (const auto& [brushNode, settings] : brushesToRender)
+  {
+    validateBrush(*brushNode, settings);
   }
   m_invalidBrushes.clear();
   assert(valid());
@@ -503,25 +602,17 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(
   return false;
 }
 
-void BrushRenderer::validateBrush(const Model::BrushNode& brushNode)
+void BrushRenderer::validateBrush(
+  const Model::BrushNode& brushNode, const Filter::RenderSettings& settings)
 {
   assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
   assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
   assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
 
-  const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
-
-  // evaluate filter. only evaluate the filter once per brush.
-  const auto settings = wrapper.markFaces(brushNode);
   const auto [facePolicy, edgePolicy] = settings;
-
-  if (
-    facePolicy == Filter::FaceRenderPolicy::RenderNone
-    && edgePolicy == Filter::EdgeRenderPolicy::RenderNone)
-  {
-    // NOTE: this skips inserting the brush into m_brushInfo
-    return;
-  }
+  assert(
+    facePolicy != Filter::FaceRenderPolicy::RenderNone
+    || edgePolicy != Filter::EdgeRenderPolicy::RenderNone);
 
   BrushInfo& info = m_brushInfo[&brushNode];
 
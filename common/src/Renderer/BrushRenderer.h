@@ -26,10 +26,12 @@
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 
+#include <kdl/flat_hash_map.h>
+#include <kdl/flat_hash_set.h>
+
 #include <memory>
 #include <tuple>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -135,8 +137,12 @@ private:
   /**
    * Tracks all brushes that are stored in the VBO, with the information necessary to
    * remove them from the VBO later.
+   *
+   * This and the following containers are updated for every changed brush, so they use
+   * flat hash containers which don't allocate a node per entry. Their iterators and
+   * references are invalidated by every insertion and erasure.
    */
-  std::unordered_map<const Model::BrushNode*, BrushInfo> m_brushInfo;
+  kdl::flat_hash_map<const Model::BrushNode*, BrushInfo> m_brushInfo;
 
   /**
    * If a brush is in the VBO, it's always valid.
@@ -144,8 +150,8 @@ private:
    *
    * Do not attempt to use vector_set here, it turns out to be slower.
    */
-  std::unordered_set<const Model::BrushNode*> m_allBrushes;
-  std::unordered_set<const Model::BrushNode*> m_invalidBrushes;
+  kdl::flat_hash_set<const Model::BrushNode*> m_allBrushes;
+  kdl::flat_hash_set<const Model::BrushNode*> m_invalidBrushes;
 
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<BrushIndexArray> m_edgeIndices;
@@ -155,6 +161,13 @@ private:
   std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
   std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
 
+  /**
+   * The index ranges of the faces of the brushes that intersect with the view frustum,
+   * rebuilt whenever the renderer is asked to render with a culled render context.
+   */
+  std::shared_ptr<FaceRenderer::TextureToIndexRangesMap> m_visibleOpaqueFaces;
+  std::shared_ptr<FaceRenderer::TextureToIndexRangesMap> m_visibleTransparentFaces;
+
   FaceRenderer m_opaqueFaceRenderer;
   FaceRenderer m_transparentFaceRenderer;
   IndexedEdgeRenderer m_edgeRenderer;
@@ -285,6 +298,16 @@ public: // rendering
   void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
 
 private:
+  /**
+   * Collects the index ranges of the opaque or transparent faces of the brushes which
+   * intersect with the view frustum of the given render context.
+   *
+   * Returns null if the render context was not culled or if every brush is visible, in
+   * which case all faces should be rendered.
+   */
+  std::shared_ptr<const FaceRenderer::TextureToIndexRangesMap> findVisibleFaces(
+    const RenderContext& renderContext, bool transparent);
+
   void renderOpaqueFaces(RenderBatch& renderBatch);
   void renderTransparentFaces(RenderBatch& renderBatch);
   void renderEdges(RenderBatch& renderBatch);
@@ -298,7 +321,12 @@ public:
 private:
   bool shouldDrawFaceInTransparentPass(
     const Model::BrushNode& brushNode, const Model::BrushFace& face) const;
-  void validateBrush(const Model::BrushNode& brushNode);
+  /**
+   * Copies the cached vertices and indices of the given brush into the vertex and index
+   * arrays. The brush must not be filtered out completely by the given settings.
+   */
+  void validateBrush(
+    const Model::BrushNode& brushNode, const Filter::RenderSettings& settings);
 
 public:
   /**
@@ -170,6 +170,17 @@ void BrushIndexArray::render(const PrimType primType) const
   m_indexHolder.render(primType, 0, m_indexHolder.size());
 }
 
+void BrushIndexArray::render(
+  const PrimType primType, const std::vector<IndexRange>& ranges) const
+{
+  assert(m_indexHolder.prepared());
+  for (const auto& range : ranges)
+  {
+    assert(range.offset + range.count <= m_indexHolder.size());
+    m_indexHolder.render(primType, range.offset, range.count);
+  }
+}
+
 bool BrushIndexArray::prepared() const
 {
   return m_indexHolder.prepared();
@@ -191,6 +202,16 @@ void BrushIndexArray::cleanupIndices()
   m_indexHolder.unbindBlock();
 }
 
+const std::vector<GLuint>& BrushIndexArray::indices() const
+{
+  return m_indexHolder.elements();
+}
+
+const AllocationTracker& BrushIndexArray::allocationTracker() const
+{
+  return m_allocationTracker;
+}
+
 // BrushVertexArray
 
 BrushVertexArray::BrushVertexArray()
@@ -253,5 +274,15 @@ void BrushVertexArray::prepare(VboManager& vboManager)
   m_vertexHolder.prepare(vboManager);
   assert(m_vertexHolder.prepared());
 }
+
+const std::vector<BrushVertexArray::Vertex>& BrushVertexArray::vertices() const
+{
+  return m_vertexHolder.elements();
+}
+
+const AllocationTracker& BrushVertexArray::allocationTracker() const
+{
+  return m_allocationTracker;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -21,6 +21,7 @@
 
 #include "Ensure.h"
 #include "Renderer/AllocationTracker.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/GL.h"
 #include "Renderer/GLVertexType.h"
 #include "Renderer/PrimType.h"
@@ -224,6 +225,7 @@ public:
   bool empty() const { return m_snapshot.empty(); }
 
   size_t size() const { return m_snapshot.size(); }
+  const std::vector<T>& elements() const { return m_snapshot; }
 
   void bindBlock() { m_vbo->bind(); }
 
@@ -284,11 +286,21 @@ public:
   void zeroElementsWithKey(AllocationTracker::Block* key);
 
   void render(const PrimType primType) const;
+
+  /**
+   * Renders only the given ranges of indices, which must be sorted and must not overlap.
+   */
+  void render(const PrimType primType, const std::vector<IndexRange>& ranges) const;
   bool prepared() const;
   void prepare(VboManager& vboManager);
 
   void setupIndices();
   void cleanupIndices();
+
+  // Testing / debugging
+
+  const std::vector<GLuint>& indices() const;
+  const AllocationTracker& allocationTracker() const;
 };
 
 class VertexArrayInterface
@@ -381,6 +393,11 @@ public:
   // uploading the VBO
   bool prepared() const;
   void prepare(VboManager& vboManager);
+
+  // Testing / debugging
+
+  const std::vector<Vertex>& vertices() const;
+  const AllocationTracker& allocationTracker() const;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -42,6 +42,8 @@
 #include <vecmath/scalar.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace TrenchBroom
@@ -98,6 +100,12 @@ void EntityRenderer::invalidate()
 void EntityRenderer::clear()
 {
   m_entities.clear();
+  m_invalidEntities.clear();
+  m_pointEntityWireframeVertices = BoundsVertexArray<WireframeVertex>{};
+  m_brushEntityWireframeVertices = BoundsVertexArray<WireframeVertex>{};
+  m_solidVertices = BoundsVertexArray<SolidVertex>{};
+  m_boundsValid = false;
+
   m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
   m_solidBoundsRenderer = TriangleRenderer();
@@ -106,15 +114,19 @@ void EntityRenderer::clear()
 
 void EntityRenderer::reloadModels()
 {
-  m_modelRenderer.updateEntities(std::begin(m_entities), std::end(m_entities));
+  for (const auto& [entityNode, info] : m_entities)
+  {
+    m_modelRenderer.updateEntity(entityNode);
+  }
 }
 
 void EntityRenderer::addEntity(const Model::EntityNode* entity)
 {
-  if (m_entities.insert(entity).second)
+  if (m_entities.try_emplace(entity).second)
   {
     m_modelRenderer.addEntity(entity);
-    invalidateBounds();
+    m_invalidEntities.insert(entity);
+    m_boundsValid = false;
   }
 }
 
@@ -122,16 +134,22 @@ void EntityRenderer::removeEntity(const Model::EntityNode* entity)
 {
   if (auto it = m_entities.find(entity); it != std::end(m_entities))
   {
-    m_entities.erase(it);
+    removeEntityBounds(it->second);
+    m_entities.erase(entity);
+    m_invalidEntities.erase(entity);
     m_modelRenderer.removeEntity(entity);
-    invalidateBounds();
+    m_boundsValid = false;
   }
 }
 
 void EntityRenderer::invalidateEntity(const Model::EntityNode* entity)
 {
   m_modelRenderer.updateEntity(entity);
-  invalidateBounds();
+  if (m_entities.find(entity) != std::end(m_entities))
+  {
+    m_invalidEntities.insert(entity);
+    m_boundsValid = false;
+  }
 }
 
 void EntityRenderer::setShowOverlays(const bool showOverlays)
@@ -166,12 +184,22 @@ void EntityRenderer::setTintColor(const Color& tintColor)
 
 void EntityRenderer::setOverrideBoundsColor(const bool overrideBoundsColor)
 {
-  m_overrideBoundsColor = overrideBoundsColor;
+  if (overrideBoundsColor != m_overrideBoundsColor)
+  {
+    // determines which bounds are rendered for each entity
+    m_overrideBoundsColor = overrideBoundsColor;
+    invalidateBounds();
+  }
 }
 
 void EntityRenderer::setBoundsColor(const Color& boundsColor)
 {
-  m_boundsColor = boundsColor;
+  if (boundsColor != m_boundsColor)
+  {
+    // entities without a definition use the bounds color
+    m_boundsColor = boundsColor;
+    invalidateBounds();
+  }
 }
 
 void EntityRenderer::setShowOccludedBounds(const bool showOccludedBounds)
@@ -279,7 +307,7 @@ void EntityRenderer::renderClassnames(
     renderService.setForegroundColor(m_overlayTextColor);
     renderService.setBackgroundColor(m_overlayBackgroundColor);
 
-    for (const Model::EntityNode* entity : m_entities)
+    for (const auto& [entity, info] : m_entities)
     {
       if (m_showHiddenEntities || m_editorContext.visible(entity))
       {
@@ -313,7 +341,7 @@ void EntityRenderer::renderAngles(RenderContext& renderContext, RenderBatch& ren
   renderService.setForegroundColor(m_angleColor);
 
   std::vector<vm::vec3f> vertices(3);
-  for (const auto* entityNode : m_entities)
+  for (const auto& [entityNode, info] : m_entities)
   {
     if (!m_showHiddenEntities && !m_editorContext.visible(entityNode))
     {
@@ -367,19 +395,16 @@ std::vector<vm::vec3f> EntityRenderer::arrowHead(
   return result;
 }
 
-struct EntityRenderer::BuildColoredSolidBoundsVertices
+namespace
 {
-  using Vertex = GLVertexTypes::P3NC4::Vertex;
+constexpr auto VerticesPerSlot = size_t(24);
+} // namespace
 
-  std::vector<Vertex>& vertices;
+struct EntityRenderer::BuildColoredSolidBoundsVertices
+{
+  SolidVertex* vertices;
   Color color;
 
-  BuildColoredSolidBoundsVertices(std::vector<Vertex>& i_vertices, const Color& i_color)
-    : vertices(i_vertices)
-    , color(i_color)
-  {
-  }
-
   void operator()(
     const vm::vec3& v1,
     const vm::vec3& v2,
@@ -387,152 +412,155 @@ struct EntityRenderer::BuildColoredSolidBoundsVertices
     const vm::vec3& v4,
     const vm::vec3& n)
   {
-    vertices.emplace_back(vm::vec3f(v1), vm::vec3f(n), color);
-    vertices.emplace_back(vm::vec3f(v2), vm::vec3f(n), color);
-    vertices.emplace_back(vm::vec3f(v3), vm::vec3f(n), color);
-    vertices.emplace_back(vm::vec3f(v4), vm::vec3f(n), color);
+    *vertices++ = SolidVertex{vm::vec3f(v1), vm::vec3f(n), color};
+    *vertices++ = SolidVertex{vm::vec3f(v2), vm::vec3f(n), color};
+    *vertices++ = SolidVertex{vm::vec3f(v3), vm::vec3f(n), color};
+    *vertices++ = SolidVertex{vm::vec3f(v4), vm::vec3f(n), color};
   }
 };
 
 struct EntityRenderer::BuildColoredWireframeBoundsVertices
 {
-  using Vertex = GLVertexTypes::P3C4::Vertex;
-
-  std::vector<Vertex>& vertices;
+  WireframeVertex* vertices;
   Color color;
 
-  BuildColoredWireframeBoundsVertices(
-    std::vector<Vertex>& i_vertices, const Color& i_color)
-    : vertices(i_vertices)
-    , color(i_color)
-  {
-  }
-
   void operator()(const vm::vec3& v1, const vm::vec3& v2)
   {
-    vertices.emplace_back(vm::vec3f(v1), color);
-    vertices.emplace_back(vm::vec3f(v2), color);
+    *vertices++ = WireframeVertex{vm::vec3f(v1), color};
+    *vertices++ = WireframeVertex{vm::vec3f(v2), color};
   }
 };
 
-struct EntityRenderer::BuildWireframeBoundsVertices
+void EntityRenderer::invalidateBounds()
 {
-  std::vector<GLVertexTypes::P3::Vertex>& vertices;
+  m_pointEntityWireframeVertices = BoundsVertexArray<WireframeVertex>{};
+  m_brushEntityWireframeVertices = BoundsVertexArray<WireframeVertex>{};
+  m_solidVertices = BoundsVertexArray<SolidVertex>{};
 
-  explicit BuildWireframeBoundsVertices(
-    std::vector<GLVertexTypes::P3::Vertex>& i_vertices)
-    : vertices(i_vertices)
+  for (auto& [entityNode, info] : m_entities)
   {
+    info = EntityInfo{};
+    m_invalidEntities.insert(entityNode);
   }
+  m_boundsValid = false;
+}
 
-  void operator()(const vm::vec3& v1, const vm::vec3& v2)
+void EntityRenderer::validateBounds()
+{
+  for (const auto* entityNode : m_invalidEntities)
   {
-    vertices.emplace_back(vm::vec3f(v1));
-    vertices.emplace_back(vm::vec3f(v2));
+    auto it = m_entities.find(entityNode);
+    assert(it != std::end(m_entities));
+    validateEntityBounds(entityNode, it->second);
   }
-};
+  m_invalidEntities.clear();
 
-void EntityRenderer::invalidateBounds()
-{
-  m_boundsValid = false;
+  // the renderers reference the vertex arrays and must be recreated when they change
+  m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    VertexArray::ref(m_pointEntityWireframeVertices.vertices), PrimType::Lines);
+  m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
+    VertexArray::ref(m_brushEntityWireframeVertices.vertices), PrimType::Lines);
+  m_solidBoundsRenderer =
+    TriangleRenderer(VertexArray::ref(m_solidVertices.vertices), PrimType::Quads);
+  m_boundsValid = true;
 }
 
-void EntityRenderer::validateBounds()
+void EntityRenderer::validateEntityBounds(
+  const Model::EntityNode* entityNode, EntityInfo& info)
 {
-  std::vector<GLVertexTypes::P3NC4::Vertex> solidVertices;
-  solidVertices.reserve(36 * m_entities.size());
+  removeEntityBounds(info);
 
-  if (m_overrideBoundsColor)
+  if (!m_editorContext.visible(entityNode))
   {
-    using Vertex = GLVertexTypes::P3::Vertex;
-    std::vector<Vertex> pointEntityWireframeVertices;
-    std::vector<Vertex> brushEntityWireframeVertices;
+    return;
+  }
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+  const auto& bounds = entityNode->logicalBounds();
+  const auto& color = boundsColor(entityNode);
+  const auto pointEntity = !entityNode->hasChildren();
+  const auto solid = pointEntity && entityNode->entity().model() == nullptr;
 
-    BuildWireframeBoundsVertices pointEntityWireframeBoundsBuilder(
-      pointEntityWireframeVertices);
-    BuildWireframeBoundsVertices brushEntityWireframeBoundsBuilder(
-      brushEntityWireframeVertices);
+  if (solid)
+  {
+    bounds.for_each_face(BuildColoredSolidBoundsVertices{
+      allocateSlot(m_solidVertices, &EntityInfo::solidSlot, entityNode, info), color});
+  }
 
-    for (const Model::EntityNode* entityNode : m_entities)
-    {
-      if (m_editorContext.visible(entityNode))
-      {
-        const bool pointEntity = !entityNode->hasChildren();
-        if (pointEntity)
-        {
-          entityNode->logicalBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-        }
-        else
-        {
-          entityNode->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-        }
+  // if the bounds color is overridden, all entities are rendered with wireframe bounds
+  if (!solid || m_overrideBoundsColor)
+  {
+    auto* vertices =
+      pointEntity ? allocateSlot(
+        m_pointEntityWireframeVertices,
+        &EntityInfo::pointEntityWireframeSlot,
+        entityNode,
+        info)
+                  : allocateSlot(
+                    m_brushEntityWireframeVertices,
+                    &EntityInfo::brushEntityWireframeSlot,
+                    entityNode,
+                    info);
+    bounds.for_each_edge(BuildColoredWireframeBoundsVertices{vertices, color});
+  }
+}
 
-        if (pointEntity && entityNode->entity().model() == nullptr)
-        {
-          BuildColoredSolidBoundsVertices solidBoundsBuilder(
-            solidVertices, boundsColor(entityNode));
-          entityNode->logicalBounds().for_each_face(solidBoundsBuilder);
-        }
-      }
-    }
+void EntityRenderer::removeEntityBounds(EntityInfo& info)
+{
+  freeSlot(
+    m_pointEntityWireframeVertices, &EntityInfo::pointEntityWireframeSlot, info);
+  freeSlot(
+    m_brushEntityWireframeVertices, &EntityInfo::brushEntityWireframeSlot, info);
+  freeSlot(m_solidVertices, &EntityInfo::solidSlot, info);
+}
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
-  }
-  else
-  {
-    using Vertex = GLVertexTypes::P3C4::Vertex;
-    std::vector<Vertex> pointEntityWireframeVertices;
-    std::vector<Vertex> brushEntityWireframeVertices;
+template <typename Vertex>
+Vertex* EntityRenderer::allocateSlot(
+  BoundsVertexArray<Vertex>& array,
+  std::optional<size_t> EntityInfo::*slot,
+  const Model::EntityNode* entityNode,
+  EntityInfo& info)
+{
+  assert(!(info.*slot));
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+  const auto index = array.entities.size();
+  array.entities.push_back(entityNode);
+  array.vertices.resize(array.vertices.size() + VerticesPerSlot);
+  info.*slot = index;
 
-    for (const Model::EntityNode* entityNode : m_entities)
-    {
-      if (m_editorContext.visible(entityNode))
-      {
-        const bool pointEntity = !entityNode->hasChildren();
+  return array.vertices.data() + index * VerticesPerSlot;
+}
 
-        if (pointEntity && entityNode->entity().model() == nullptr)
-        {
-          BuildColoredSolidBoundsVertices solidBoundsBuilder(
-            solidVertices, boundsColor(entityNode));
-          entityNode->logicalBounds().for_each_face(solidBoundsBuilder);
-        }
-        else
-        {
-          BuildColoredWireframeBoundsVertices pointEntityWireframeBoundsBuilder(
-            pointEntityWireframeVertices, boundsColor(entityNode));
-          BuildColoredWireframeBoundsVertices brushEntityWireframeBoundsBuilder(
-            brushEntityWireframeVertices, boundsColor(entityNode));
-
-          if (pointEntity)
-          {
-            entityNode->logicalBounds().for_each_edge(pointEntityWireframeBoundsBuilder);
-          }
-          else
-          {
-            entityNode->logicalBounds().for_each_edge(brushEntityWireframeBoundsBuilder);
-          }
-        }
-      }
-    }
+template <typename Vertex>
+void EntityRenderer::freeSlot(
+  BoundsVertexArray<Vertex>& array,
+  std::optional<size_t> EntityInfo::*slot,
+  EntityInfo& info)
+{
+  if (!(info.*slot))
+  {
+    return;
+  }
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
+  const auto index = *(info.*slot);
+  const auto lastIndex = array.entities.size() - 1u;
+  if (index != lastIndex)
+  {
+    // move the last slot into the freed slot
+    const auto* movedEntity = array.entities[lastIndex];
+    std::copy_n(
+      array.vertices.begin() + std::ptrdiff_t(lastIndex * VerticesPerSlot),
+      VerticesPerSlot,
+      array.vertices.begin() + std::ptrdiff_t(index * VerticesPerSlot));
+    array.entities[index] = movedEntity;
+
+    auto it = m_entities.find(movedEntity);
+    assert(it != std::end(m_entities));
+    it->second.*slot = index;
   }
 
-  m_solidBoundsRenderer =
-    TriangleRenderer(VertexArray::move(std::move(solidVertices)), PrimType::Quads);
-  m_boundsValid = true;
+  array.entities.pop_back();
+  array.vertices.resize(lastIndex * VerticesPerSlot);
+  info.*slot = std::nullopt;
 }
 
 AttrString EntityRenderer::entityString(const Model::EntityNode* entityNode) const
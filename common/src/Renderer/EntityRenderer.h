@@ -22,13 +22,16 @@
 #include "Color.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/EntityModelRenderer.h"
+#include "Renderer/GLVertexType.h"
 #include "Renderer/Renderable.h"
 #include "Renderer/TriangleRenderer.h"
 
-#include <kdl/vector_set.h>
+#include <kdl/flat_hash_map.h>
+#include <kdl/flat_hash_set.h>
 
 #include <vecmath/forward.h>
 
+#include <optional>
 #include <vector>
 
 namespace TrenchBroom
@@ -50,14 +53,54 @@ namespace Renderer
 {
 class AttrString;
 
+/**
+ * Renders the bounds, models, classnames and angles of entities.
+ *
+ * The bounds of every entity occupy their own slots of the bounds vertex arrays, so that
+ * adding, removing or invalidating an entity only rebuilds the slots of that entity.
+ */
 class EntityRenderer
 {
 private:
+  // gives tests and benchmarks access to the bounds vertex arrays
+  friend class EntityRendererTestAccess;
+
   class EntityClassnameAnchor;
 
+  using WireframeVertex = GLVertexTypes::P3C4::Vertex;
+  using SolidVertex = GLVertexTypes::P3NC4::Vertex;
+
+  /**
+   * Stores the bounds vertices of entities in consecutive slots of equal size, together
+   * with the entity that occupies each slot. Freeing a slot moves the last slot into its
+   * place, so the vertices never contain gaps.
+   */
+  template <typename Vertex>
+  struct BoundsVertexArray
+  {
+    std::vector<Vertex> vertices;
+    std::vector<const Model::EntityNode*> entities;
+  };
+
+  /**
+   * The slots of an entity in the bounds vertex arrays. Invalid entities and entities
+   * that are not visible don't occupy any slots.
+   */
+  struct EntityInfo
+  {
+    std::optional<size_t> pointEntityWireframeSlot;
+    std::optional<size_t> brushEntityWireframeSlot;
+    std::optional<size_t> solidSlot;
+  };
+
   Assets::EntityModelManager& m_entityModelManager;
   const Model::EditorContext& m_editorContext;
-  kdl::vector_set<const Model::EntityNode*> m_entities;
+  kdl::flat_hash_map<const Model::EntityNode*, EntityInfo> m_entities;
+  kdl::flat_hash_set<const Model::EntityNode*> m_invalidEntities;
+
+  BoundsVertexArray<WireframeVertex> m_pointEntityWireframeVertices;
+  BoundsVertexArray<WireframeVertex> m_brushEntityWireframeVertices;
+  BoundsVertexArray<SolidVertex> m_solidVertices;
 
   DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
   DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
@@ -145,10 +188,23 @@ private:
 
   struct BuildColoredSolidBoundsVertices;
   struct BuildColoredWireframeBoundsVertices;
-  struct BuildWireframeBoundsVertices;
 
   void invalidateBounds();
   void validateBounds();
+  void validateEntityBounds(const Model::EntityNode* entityNode, EntityInfo& info);
+  void removeEntityBounds(EntityInfo& info);
+
+  template <typename Vertex>
+  Vertex* allocateSlot(
+    BoundsVertexArray<Vertex>& array,
+    std::optional<size_t> EntityInfo::*slot,
+    const Model::EntityNode* entityNode,
+    EntityInfo& info);
+  template <typename Vertex>
+  void freeSlot(
+    BoundsVertexArray<Vertex>& array,
+    std::optional<size_t> EntityInfo::*slot,
+    EntityInfo& info);
 
   AttrString entityString(const Model::EntityNode* entityNode) const;
   const Color& boundsColor(const Model::EntityNode* entityNode) const;
@@ -98,6 +98,7 @@ FaceRenderer::FaceRenderer(const FaceRenderer& other)
   : IndexedRenderable(other)
   , m_vertexArray(other.m_vertexArray)
   , m_indexArrayMap(other.m_indexArrayMap)
+  , m_indexRanges(other.m_indexRanges)
   , m_faceColor(other.m_faceColor)
   , m_grayscale(other.m_grayscale)
   , m_tint(other.m_tint)
@@ -118,6 +119,7 @@ void swap(FaceRenderer& left, FaceRenderer& right)
   using std::swap;
   swap(left.m_vertexArray, right.m_vertexArray);
   swap(left.m_indexArrayMap, right.m_indexArrayMap);
+  swap(left.m_indexRanges, right.m_indexRanges);
   swap(left.m_faceColor, right.m_faceColor);
   swap(left.m_grayscale, right.m_grayscale);
   swap(left.m_tint, right.m_tint);
@@ -145,6 +147,12 @@ void FaceRenderer::setAlpha(const float alpha)
   m_alpha = alpha;
 }
 
+void FaceRenderer::setIndexRanges(
+  std::shared_ptr<const TextureToIndexRangesMap> indexRanges)
+{
+  m_indexRanges = std::move(indexRanges);
+}
+
 void FaceRenderer::render(RenderBatch& renderBatch)
 {
   renderBatch.add(this);
@@ -215,6 +223,17 @@ void FaceRenderer::doRender(RenderContext& context)
         continue;
       }
 
+      const std::vector<IndexRange>* ranges = nullptr;
+      if (m_indexRanges)
+      {
+        const auto it = m_indexRanges->find(texture);
+        if (it == m_indexRanges->end() || it->second.empty())
+        {
+          continue;
+        }
+        ranges = &it->second;
+      }
+
       const bool enableMasked = texture != nullptr && texture->masked();
 
       // set any per-texture uniforms
@@ -223,7 +242,14 @@ void FaceRenderer::doRender(RenderContext& context)
 
       func.before(texture);
       brushIndexHolderPtr->setupIndices();
-      brushIndexHolderPtr->render(PrimType::Triangles);
+      if (ranges)
+      {
+        brushIndexHolderPtr->render(PrimType::Triangles, *ranges);
+      }
+      else
+      {
+        brushIndexHolderPtr->render(PrimType::Triangles);
+      }
       brushIndexHolderPtr->cleanupIndices();
       func.after(texture);
     }
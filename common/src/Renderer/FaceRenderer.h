@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Color.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/Renderable.h"
 
 #include <vecmath/forward.h>
@@ -27,6 +28,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -43,6 +45,10 @@ class RenderBatch;
 
 class FaceRenderer : public IndexedRenderable
 {
+public:
+  using TextureToIndexRangesMap =
+    std::unordered_map<const Assets::Texture*, std::vector<IndexRange>>;
+
 private:
   struct RenderFunc;
 
@@ -51,6 +57,7 @@ private:
 
   std::shared_ptr<BrushVertexArray> m_vertexArray;
   std::shared_ptr<TextureToBrushIndicesMap> m_indexArrayMap;
+  std::shared_ptr<const TextureToIndexRangesMap> m_indexRanges;
   Color m_faceColor;
   bool m_grayscale;
   bool m_tint;
@@ -73,6 +80,13 @@ public:
   void setTintColor(const Color& color);
   void setAlpha(float alpha);
 
+  /**
+   * Restricts rendering to the given ranges of the index arrays. Textures without an
+   * entry in the given map are not rendered at all. If the given map is null, all indices
+   * are rendered.
+   */
+  void setIndexRanges(std::shared_ptr<const TextureToIndexRangesMap> indexRanges);
+
   void render(RenderBatch& renderBatch);
 
 private:
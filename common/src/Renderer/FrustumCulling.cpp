@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FrustumCulling.h"
+
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+#include "Renderer/Camera.h"
+#include "octree.h"
+
+#include <kdl/overload.h>
+#include <kdl/reflection_impl.h>
+
+#include <algorithm>
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+
+ViewFrustum::ViewFrustum(std::vector<vm::plane3> planes)
+  : m_planes{std::move(planes)}
+{
+}
+
+ViewFrustum ViewFrustum::fromCamera(const Camera& camera)
+{
+  auto top = vm::plane3f{};
+  auto right = vm::plane3f{};
+  auto bottom = vm::plane3f{};
+  auto left = vm::plane3f{};
+  camera.frustumPlanes(top, right, bottom, left);
+
+  const auto& position = camera.position();
+  const auto& direction = camera.direction();
+  const auto nearPlane =
+    vm::plane3f{position + camera.nearPlane() * direction, -direction};
+  const auto farPlane = vm::plane3f{position + camera.farPlane() * direction, direction};
+
+  return ViewFrustum{{
+    vm::plane3{top},
+    vm::plane3{right},
+    vm::plane3{bottom},
+    vm::plane3{left},
+    vm::plane3{nearPlane},
+    vm::plane3{farPlane},
+  }};
+}
+
+const std::vector<vm::plane3>& ViewFrustum::planes() const
+{
+  return m_planes;
+}
+
+bool ViewFrustum::intersects(const vm::bbox3& bounds) const
+{
+  return std::none_of(m_planes.begin(), m_planes.end(), [&](const auto& plane) {
+    // the corner of the box that is furthest below the plane
+    auto corner = vm::vec3{};
+    for (size_t i = 0; i < 3; ++i)
+    {
+      corner[i] = plane.normal[i] >= 0.0 ? bounds.min[i] : bounds.max[i];
+    }
+    return plane.point_distance(corner) > 0.0;
+  });
+}
+
+VisibleNodes findVisibleNodes(
+  const Model::WorldNode& worldNode, const ViewFrustum& frustum)
+{
+  auto result = VisibleNodes{frustum, {}, {}, {}};
+
+  const auto candidates = worldNode.nodeTree().find_in_convex_volume(frustum.planes());
+  for (const auto* node : candidates)
+  {
+    if (frustum.intersects(node->physicalBounds()))
+    {
+      node->accept(kdl::overload(
+        [](const Model::WorldNode*) {},
+        [](const Model::LayerNode*) {},
+        [](const Model::GroupNode*) {},
+        [&](const Model::EntityNode* entityNode) {
+          result.entityNodes.push_back(entityNode);
+        },
+        [&](const Model::BrushNode* brushNode) {
+          result.brushNodes.push_back(brushNode);
+        },
+        [&](const Model::PatchNode* patchNode) {
+          result.patchNodes.push_back(patchNode);
+        }));
+    }
+  }
+
+  return result;
+}
+
+kdl_reflect_impl(IndexRange);
+
+void mergeIndexRanges(std::vector<IndexRange>& ranges)
+{
+  if (ranges.empty())
+  {
+    return;
+  }
+
+  std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.offset < rhs.offset;
+  });
+
+  auto last = ranges.begin();
+  for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it)
+  {
+    const auto lastEnd = last->offset + last->count;
+    if (it->offset <= lastEnd)
+    {
+      last->count = std::max(lastEnd, it->offset + it->count) - last->offset;
+    }
+    else
+    {
+      *++last = *it;
+    }
+  }
+  ranges.erase(std::next(last), ranges.end());
+}
+
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "FloatType.h"
+
+#include <kdl/reflection_decl.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Model
+{
+class BrushNode;
+class EntityNode;
+class PatchNode;
+class WorldNode;
+} // namespace Model
+
+namespace Renderer
+{
+class Camera;
+
+/**
+ * A convex volume bounded by planes whose normals point out of the volume. Everything
+ * that a camera can see is inside of its view frustum.
+ */
+class ViewFrustum
+{
+private:
+  std::vector<vm::plane3> m_planes;
+
+public:
+  explicit ViewFrustum(std::vector<vm::plane3> planes);
+
+  /**
+   * Returns the view frustum of the given camera, which is bounded by the camera's
+   * frustum planes and its near and far planes.
+   */
+  static ViewFrustum fromCamera(const Camera& camera);
+
+  const std::vector<vm::plane3>& planes() const;
+
+  /**
+   * Checks whether the given bounding box may intersect with this frustum.
+   *
+   * The test is conservative: a bounding box that is not entirely above any of the planes
+   * of this frustum is considered to intersect with it, even if it doesn't.
+   */
+  bool intersects(const vm::bbox3& bounds) const;
+};
+
+/**
+ * The nodes of a world whose physical bounds intersect with a view frustum.
+ */
+struct VisibleNodes
+{
+  ViewFrustum frustum;
+  std::vector<const Model::EntityNode*> entityNodes;
+  std::vector<const Model::BrushNode*> brushNodes;
+  std::vector<const Model::PatchNode*> patchNodes;
+};
+
+/**
+ * Finds the entity, brush and patch nodes of the given world whose physical bounds
+ * intersect with the given view frustum. The world's spatial index is used to skip
+ * the nodes that are far away from the frustum.
+ */
+VisibleNodes findVisibleNodes(
+  const Model::WorldNode& worldNode, const ViewFrustum& frustum);
+
+/**
+ * A range of indices in an index array.
+ */
+struct IndexRange
+{
+  size_t offset;
+  size_t count;
+
+  kdl_reflect_decl(IndexRange, offset, count);
+};
+
+/**
+ * Sorts the given ranges by their offsets and merges ranges which are adjacent or which
+ * overlap, so that they can be rendered with as few draw calls as possible.
+ */
+void mergeIndexRanges(std::vector<IndexRange>& ranges);
+
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -34,6 +34,7 @@
 #include "Preferences.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/FrustumCulling.h"
 #include "Renderer/GroupLinkRenderer.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
@@ -47,6 +48,7 @@
 #include <kdl/path_utils.h>
 #include <kdl/vector_set.h>
 
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -229,6 +231,20 @@ void MapRenderer::restoreSelectionColors()
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
   commitPendingChanges();
+
+  // Only the 3D view is culled, the 2D views show everything along their view axis.
+  auto visibleNodes = std::optional<VisibleNodes>{};
+  if (renderContext.render3D())
+  {
+    auto document = kdl::mem_lock(m_document);
+    if (const auto* world = document->world())
+    {
+      visibleNodes =
+        findVisibleNodes(*world, ViewFrustum::fromCamera(renderContext.camera()));
+      renderContext.setVisibleNodes(&*visibleNodes);
+    }
+  }
+
   setupGL(renderBatch);
   renderDefaultOpaque(renderContext, renderBatch);
   renderLockedOpaque(renderContext, renderBatch);
@@ -240,6 +256,9 @@ void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 
   renderEntityLinks(renderContext, renderBatch);
   renderGroupLinks(renderContext, renderBatch);
+
+  // the visible nodes must not be used by the renderers of the tools
+  renderContext.setVisibleNodes(nullptr);
 }
 
 void MapRenderer::commitPendingChanges()
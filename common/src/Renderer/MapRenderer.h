@@ -22,9 +22,10 @@
 #include "Macros.h"
 #include "NotifierConnection.h"
 
+#include <kdl/flat_hash_map.h>
+
 #include <filesystem>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -74,7 +75,7 @@ private:
     All = Default | Selection | Locked
   };
 
-  std::unordered_map<Model::Node*, int> m_trackedNodes;
+  kdl::flat_hash_map<Model::Node*, int> m_trackedNodes;
 
   NotifierConnection m_notifierConnection;
 
@@ -19,30 +19,21 @@
 
 #include "PatchRenderer.h"
 
-#include "Assets/Texture.h"
+#include "Macros.h"
 #include "Model/EditorContext.h"
 #include "Model/PatchNode.h"
-#include "PreferenceManager.h"
-#include "Preferences.h"
-#include "Renderer/ActiveShader.h"
-#include "Renderer/Camera.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/GLVertexType.h"
-#include "Renderer/IndexRangeMapBuilder.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
-#include "Renderer/RenderUtils.h"
-#include "Renderer/Shader.h"
-#include "Renderer/ShaderManager.h"
-#include "Renderer/Shaders.h"
-#include "Renderer/TexturedIndexArrayMapBuilder.h"
-#include "Renderer/TexturedIndexArrayRenderer.h"
-#include "Renderer/VertexArray.h"
-
-#include <kdl/vector_utils.h>
 
 #include <vecmath/forward.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -53,6 +44,7 @@ PatchRenderer::PatchRenderer(const Model::EditorContext& editorContext)
   , m_tint{false}
   , m_alpha{1.0f}
 {
+  clear();
 }
 
 void PatchRenderer::setDefaultColor(const Color& faceColor)
@@ -102,47 +94,82 @@ void PatchRenderer::setOccludedEdgeColor(const Color& occludedEdgeColor)
 
 void PatchRenderer::invalidate()
 {
-  m_valid = false;
+  for (const auto* patchNode : m_allPatches)
+  {
+    removePatchFromVbo(*patchNode);
+  }
+  m_invalidPatches = m_allPatches;
+
+  assert(m_patchInfo.empty());
+  assert(m_faces->empty());
 }
 
 void PatchRenderer::clear()
 {
-  m_patchNodes.clear();
-  invalidate();
+  m_patchInfo.clear();
+  m_allPatches.clear();
+  m_invalidPatches.clear();
+
+  m_vertexArray = std::make_shared<BrushVertexArray>();
+  m_edgeIndices = std::make_shared<BrushIndexArray>();
+  m_faces = std::make_shared<TextureToBrushIndicesMap>();
+
+  m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_defaultColor};
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
 }
 
 void PatchRenderer::addPatch(const Model::PatchNode* patchNode)
 {
-  if (m_patchNodes.insert(patchNode).second)
+  if (m_allPatches.insert(patchNode).second)
   {
-    invalidate();
+    assert(m_patchInfo.find(patchNode) == m_patchInfo.end());
+    assertResult(m_invalidPatches.insert(patchNode).second);
   }
 }
 
 void PatchRenderer::removePatch(const Model::PatchNode* patchNode)
 {
-  if (auto it = m_patchNodes.find(patchNode); it != std::end(m_patchNodes))
+  if (m_allPatches.erase(patchNode) == 0u)
+  {
+    return;
+  }
+
+  if (m_invalidPatches.erase(patchNode) > 0u)
   {
-    m_patchNodes.erase(it);
-    invalidate();
+    // invalid patches are not in the VBO
+    assert(m_patchInfo.find(patchNode) == m_patchInfo.end());
+    return;
   }
+
+  removePatchFromVbo(*patchNode);
 }
 
-void PatchRenderer::invalidatePatch(const Model::PatchNode*)
+void PatchRenderer::invalidatePatch(const Model::PatchNode* patchNode)
 {
-  invalidate();
+  if (m_allPatches.find(patchNode) == m_allPatches.end())
+  {
+    return;
+  }
+
+  if (m_invalidPatches.insert(patchNode).second)
+  {
+    removePatchFromVbo(*patchNode);
+  }
 }
 
 void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_valid)
+  if (!valid())
   {
     validate();
   }
 
   if (renderContext.showFaces())
   {
-    renderBatch.add(this);
+    m_faceRenderer.setGrayscale(m_grayscale);
+    m_faceRenderer.setTint(m_tint);
+    m_faceRenderer.setTintColor(m_tintColor);
+    m_faceRenderer.render(renderBatch);
   }
 
   if (renderContext.showEdges())
@@ -155,265 +182,157 @@ void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
   }
 }
 
-static TexturedIndexArrayRenderer buildMeshRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+bool PatchRenderer::valid() const
 {
-  size_t vertexCount = 0u;
-  auto indexArrayMapSize = TexturedIndexArrayMap::Size{};
-
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount += patchNode->grid().pointRowCount * patchNode->grid().pointColumnCount;
-
-      const auto* texture = patchNode->patch().texture();
-      const auto quadCount =
-        patchNode->grid().quadRowCount() * patchNode->grid().quadColumnCount();
-      indexArrayMapSize.inc(texture, PrimType::Triangles, 6u * quadCount);
-    }
-  }
-
-  using Vertex = GLVertexTypes::P3NT2::Vertex;
-  auto vertices = std::vector<Vertex>{};
-  vertices.reserve(vertexCount);
+  return m_invalidPatches.empty();
+}
 
-  auto indexArrayMapBuilder = TexturedIndexArrayMapBuilder{indexArrayMapSize};
-  using Index = TexturedIndexArrayMapBuilder::Index;
+void PatchRenderer::validate()
+{
+  assert(!valid());
 
-  for (const auto* patchNode : patchNodes)
+  for (const auto* patchNode : m_invalidPatches)
   {
-    if (editorContext.visible(patchNode))
+    if (m_editorContext.visible(patchNode))
     {
-      const auto vertexOffset = vertices.size();
-
-      const auto& grid = patchNode->grid();
-      auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) {
-        return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}};
-      });
-      vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
-
-      const auto* texture = patchNode->patch().texture();
-
-      const auto pointsPerRow = grid.pointColumnCount;
-      for (size_t row = 0u; row < grid.quadRowCount(); ++row)
-      {
-        for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
-        {
-          const auto i0 = vertexOffset + row * pointsPerRow + col;
-          const auto i1 = vertexOffset + row * pointsPerRow + col + 1u;
-          const auto i2 = vertexOffset + (row + 1u) * pointsPerRow + col + 1u;
-          const auto i3 = vertexOffset + (row + 1u) * pointsPerRow + col;
-
-          indexArrayMapBuilder.addTriangle(
-            texture,
-            static_cast<Index>(i0),
-            static_cast<Index>(i1),
-            static_cast<Index>(i2));
-          indexArrayMapBuilder.addTriangle(
-            texture,
-            static_cast<Index>(i2),
-            static_cast<Index>(i3),
-            static_cast<Index>(i0));
-        }
-      }
+      validatePatch(*patchNode);
     }
   }
+  m_invalidPatches.clear();
 
-  auto vertexArray = VertexArray::move(std::move(vertices));
-  auto indexArray = IndexArray::move(std::move(indexArrayMapBuilder.indices()));
-  return TexturedIndexArrayRenderer{
-    std::move(vertexArray),
-    std::move(indexArray),
-    std::move(indexArrayMapBuilder.ranges())};
+  m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_defaultColor};
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
 }
 
-static DirectEdgeRenderer buildEdgeRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+void PatchRenderer::validatePatch(const Model::PatchNode& patchNode)
 {
-  size_t vertexCount = 0u;
-  auto indexRangeMapSize = IndexRangeMap::Size{};
+  assert(m_patchInfo.find(&patchNode) == m_patchInfo.end());
 
-  for (const auto* patchNode : patchNodes)
+  using Vertex = GLVertexTypes::P3NT2::Vertex;
+
+  // the patch node caches its tessellated grid, so we only need to copy it
+  const auto& grid = patchNode.grid();
+  auto& info = m_patchInfo[&patchNode];
+
+  auto [vertexKey, vertexDest] =
+    m_vertexArray->getPointerToInsertVerticesAt(grid.points.size());
+  std::transform(grid.points.begin(), grid.points.end(), vertexDest, [](const auto& p) {
+    return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}};
+  });
+  info.vertexKey = vertexKey;
+
+  const auto vertexOffset = vertexKey->pos;
+  const auto index = [&](const size_t row, const size_t col) {
+    return static_cast<GLuint>(vertexOffset + row * grid.pointColumnCount + col);
+  };
+
+  // insert face indices, two triangles per quad
+  const auto quadCount = grid.quadRowCount() * grid.quadColumnCount();
+  if (quadCount > 0u)
   {
-    if (editorContext.visible(patchNode))
+    const auto* texture = patchNode.patch().texture();
+    auto& faceIndices = (*m_faces)[texture];
+    if (faceIndices == nullptr)
     {
-      vertexCount +=
-        (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
-      indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
+      faceIndices = std::make_shared<BrushIndexArray>();
     }
-  }
 
-  auto indexRangeMapBuilder =
-    IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
+    auto [faceIndicesKey, faceDest] =
+      faceIndices->getPointerToInsertElementsAt(6u * quadCount);
+    info.texture = texture;
+    info.faceIndicesKey = faceIndicesKey;
 
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
+    for (size_t row = 0u; row < grid.quadRowCount(); ++row)
     {
-      const auto& grid = patchNode->grid();
-
-      auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
-      edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
-
-      // walk around the patch to collect the edge vertices
-      // for each side, collect the first vertex up to but not including the last vertex
-
-      const auto t = 0u;
-      const auto b = grid.pointRowCount - 1u;
-      const auto l = 0u;
-      const auto r = grid.pointColumnCount - 1u;
-
-      size_t row = t;
-      size_t col = l;
-
-      while (col < r)
+      for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
       {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col++).position});
+        const auto i0 = index(row, col);
+        const auto i1 = index(row, col + 1u);
+        const auto i2 = index(row + 1u, col + 1u);
+        const auto i3 = index(row + 1u, col);
+
+        *(faceDest++) = i0;
+        *(faceDest++) = i1;
+        *(faceDest++) = i2;
+        *(faceDest++) = i2;
+        *(faceDest++) = i3;
+        *(faceDest++) = i0;
       }
-      assert(row == t && col == r);
+    }
+  }
 
-      while (row < b)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row++, col).position});
-      }
-      assert(row == b && col == r);
+  // walk around the patch to collect the edge loop
+  // for each side, collect the first vertex up to but not including the last vertex
+  const auto t = size_t(0);
+  const auto b = grid.pointRowCount - 1u;
+  const auto l = size_t(0);
+  const auto r = grid.pointColumnCount - 1u;
 
-      while (col > l)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col--).position});
-      }
-      assert(row == b && col == l);
+  auto edgeLoop = std::vector<GLuint>{};
+  edgeLoop.reserve((b + r) * 2u);
 
-      while (row > t)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row--, col).position});
-      }
-      assert(row == t && col == l);
+  size_t row = t;
+  size_t col = l;
 
-      indexRangeMapBuilder.addLineLoop(edgeLoopVertices);
-    }
+  while (col < r)
+  {
+    edgeLoop.push_back(index(row, col++));
   }
-
-  auto vertexArray = VertexArray::move(std::move(indexRangeMapBuilder.vertices()));
-  auto indexRangeMap = std::move(indexRangeMapBuilder.indices());
-  return DirectEdgeRenderer{std::move(vertexArray), std::move(indexRangeMap)};
-}
-
-void PatchRenderer::validate()
-{
-  if (!m_valid)
+  while (row < b)
   {
-    m_patchMeshRenderer = buildMeshRenderer(m_patchNodes.get_data(), m_editorContext);
-    m_edgeRenderer = buildEdgeRenderer(m_patchNodes.get_data(), m_editorContext);
-
-    m_valid = true;
+    edgeLoop.push_back(index(row++, col));
   }
-}
-
-void PatchRenderer::prepareVerticesAndIndices(VboManager& vboManager)
-{
-  m_patchMeshRenderer.prepare(vboManager);
-}
-
-namespace
-{
-struct RenderFunc : public TextureRenderFunc
-{
-  ActiveShader& shader;
-  bool applyTexture;
-  const Color& defaultColor;
-
-  RenderFunc(
-    ActiveShader& i_shader, const bool i_applyTexture, const Color& i_defaultColor)
-    : shader{i_shader}
-    , applyTexture{i_applyTexture}
-    , defaultColor{i_defaultColor}
+  while (col > l)
   {
+    edgeLoop.push_back(index(row, col--));
   }
-
-  void before(const Assets::Texture* texture) override
+  while (row > t)
   {
-    shader.set("GridColor", gridColorForTexture(texture));
-    if (texture != nullptr)
-    {
-      texture->activate();
-      shader.set("ApplyTexture", applyTexture);
-      shader.set("Color", texture->averageColor());
-    }
-    else
-    {
-      shader.set("ApplyTexture", false);
-      shader.set("Color", defaultColor);
-    }
+    edgeLoop.push_back(index(row--, col));
   }
+  assert(row == t && col == l);
 
-  void after(const Assets::Texture* texture) override
+  if (!edgeLoop.empty())
   {
-    if (texture != nullptr)
+    auto [edgeIndicesKey, edgeDest] =
+      m_edgeIndices->getPointerToInsertElementsAt(2u * edgeLoop.size());
+    info.edgeIndicesKey = edgeIndicesKey;
+
+    for (size_t i = 0u; i < edgeLoop.size(); ++i)
     {
-      texture->deactivate();
+      *(edgeDest++) = edgeLoop[i];
+      *(edgeDest++) = edgeLoop[(i + 1u) % edgeLoop.size()];
     }
   }
-};
-} // namespace
+}
 
-void PatchRenderer::doRender(RenderContext& context)
+void PatchRenderer::removePatchFromVbo(const Model::PatchNode& patchNode)
 {
-  auto& shaderManager = context.shaderManager();
-  auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
-  auto& prefs = PreferenceManager::instance();
-
-  const bool applyTexture = context.showTextures();
-  const bool shadeFaces = context.shadeFaces();
-  const bool showFog = context.showFog();
-
-  glAssert(glEnable(GL_TEXTURE_2D));
-  glAssert(glActiveTexture(GL_TEXTURE0));
-  shader.set("Brightness", prefs.get(Preferences::Brightness));
-  shader.set("RenderGrid", context.showGrid());
-  shader.set("GridSize", static_cast<float>(context.gridSize()));
-  shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-  shader.set("ApplyTexture", applyTexture);
-  shader.set("Texture", 0);
-  shader.set("ApplyTinting", m_tint);
-  if (m_tint)
+  const auto it = m_patchInfo.find(&patchNode);
+  if (it == m_patchInfo.end())
   {
-    shader.set("TintColor", m_tintColor);
+    // the patch was hidden when it was validated
+    return;
   }
-  shader.set("GrayScale", m_grayscale);
-  shader.set("CameraPosition", context.camera().position());
-  shader.set("ShadeFaces", shadeFaces);
-  shader.set("ShowFog", showFog);
-  shader.set("Alpha", 1.0);
-  shader.set("EnableMasked", false);
-  shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
-  shader.set("SoftMapBoundsMin", context.softMapBounds().min);
-  shader.set("SoftMapBoundsMax", context.softMapBounds().max);
-  shader.set(
-    "SoftMapBoundsColor",
-    vm::vec4f{
-      prefs.get(Preferences::SoftMapBoundsColor).r(),
-      prefs.get(Preferences::SoftMapBoundsColor).g(),
-      prefs.get(Preferences::SoftMapBoundsColor).b(),
-      0.1f});
-
-  auto func = RenderFunc{shader, applyTexture, m_defaultColor};
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_FALSE));
-  }
-  */
 
-  m_patchMeshRenderer.render(func);
+  const auto info = it->second;
+  m_patchInfo.erase(it);
 
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_TRUE));
+  m_vertexArray->deleteVerticesWithKey(info.vertexKey);
+  if (info.edgeIndicesKey != nullptr)
+  {
+    m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+  }
+  if (info.faceIndicesKey != nullptr)
+  {
+    const auto faceIndices = m_faces->at(info.texture);
+    faceIndices->zeroElementsWithKey(info.faceIndicesKey);
+    if (!faceIndices->hasValidIndices())
+    {
+      // don't keep the texture pointer around, the texture might be deleted
+      m_faces->erase(info.texture);
+    }
   }
-  */
 }
 } // namespace Renderer
 } // namespace TrenchBroom
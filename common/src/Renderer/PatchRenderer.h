@@ -20,16 +20,23 @@
 #pragma once
 
 #include "Color.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
-#include "Renderer/Renderable.h"
-#include "Renderer/TexturedIndexArrayRenderer.h"
+#include "Renderer/FaceRenderer.h"
 
-#include <kdl/vector_set.h>
+#include <kdl/flat_hash_map.h>
+#include <kdl/flat_hash_set.h>
 
-#include <vector>
+#include <memory>
+#include <unordered_map>
 
 namespace TrenchBroom
 {
+namespace Assets
+{
+class Texture;
+}
+
 namespace Model
 {
 class EditorContext;
@@ -38,20 +45,50 @@ class PatchNode;
 
 namespace Renderer
 {
+class BrushIndexArray;
+class BrushVertexArray;
 class RenderBatch;
 class RenderContext;
-class VboManager;
 
-class PatchRenderer : public IndexedRenderable
+/**
+ * Renders patches from a shared vertex array and per texture index arrays, like
+ * BrushRenderer does for brushes. Every patch occupies its own ranges of these arrays, so
+ * that adding, removing or invalidating a patch only rebuilds the ranges of that patch.
+ */
+class PatchRenderer
 {
 private:
+  // gives tests access to the arrays and the allocations of the patches
+  friend class PatchRendererTestAccess;
+
   const Model::EditorContext& m_editorContext;
 
-  bool m_valid = true;
-  kdl::vector_set<const Model::PatchNode*> m_patchNodes;
+  struct PatchInfo
+  {
+    AllocationTracker::Block* vertexKey = nullptr;
+    AllocationTracker::Block* edgeIndicesKey = nullptr;
+    const Assets::Texture* texture = nullptr;
+    AllocationTracker::Block* faceIndicesKey = nullptr;
+  };
+
+  /**
+   * Tracks the patches that are stored in the arrays, with the information necessary to
+   * remove them from the arrays later. Patches that are hidden are not stored.
+   */
+  kdl::flat_hash_map<const Model::PatchNode*, PatchInfo> m_patchInfo;
+
+  kdl::flat_hash_set<const Model::PatchNode*> m_allPatches;
+  kdl::flat_hash_set<const Model::PatchNode*> m_invalidPatches;
 
-  TexturedIndexArrayRenderer m_patchMeshRenderer;
-  DirectEdgeRenderer m_edgeRenderer;
+  using TextureToBrushIndicesMap =
+    std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+  std::shared_ptr<BrushVertexArray> m_vertexArray;
+  std::shared_ptr<BrushIndexArray> m_edgeIndices;
+  std::shared_ptr<TextureToBrushIndicesMap> m_faces;
+
+  FaceRenderer m_faceRenderer;
+  IndexedEdgeRenderer m_edgeRenderer;
 
   Color m_defaultColor;
   bool m_grayscale;
@@ -119,12 +156,16 @@ public:
 
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
-private:
+  bool valid() const;
+
+  /**
+   * Only exposed for benchmarking.
+   */
   void validate();
 
-private: // implement IndexedRenderable interface
-  void prepareVerticesAndIndices(VboManager& vboManager) override;
-  void doRender(RenderContext& renderContext) override;
+private:
+  void validatePatch(const Model::PatchNode& patchNode);
+  void removePatchFromVbo(const Model::PatchNode& patchNode);
 };
 } // namespace Renderer
 } // namespace TrenchBroom
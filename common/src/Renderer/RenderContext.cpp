@@ -51,6 +51,7 @@ RenderContext::RenderContext(
   , m_hideSelection(false)
   , m_tintSelection(true)
   , m_showSelectionGuide(ShowSelectionGuide::Hide)
+  , m_visibleNodes(nullptr)
 {
 }
 
@@ -270,6 +271,16 @@ void RenderContext::setForceHideSelectionGuide()
   setShowSelectionGuide(ShowSelectionGuide::ForceHide);
 }
 
+const VisibleNodes* RenderContext::visibleNodes() const
+{
+  return m_visibleNodes;
+}
+
+void RenderContext::setVisibleNodes(const VisibleNodes* visibleNodes)
+{
+  m_visibleNodes = visibleNodes;
+}
+
 void RenderContext::setShowSelectionGuide(const ShowSelectionGuide showSelectionGuide)
 {
   switch (showSelectionGuide)
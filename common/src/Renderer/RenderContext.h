@@ -31,6 +31,7 @@ namespace Renderer
 class Camera;
 class FontManager;
 class ShaderManager;
+struct VisibleNodes;
 
 enum class RenderMode
 {
@@ -81,6 +82,8 @@ private:
   ShowSelectionGuide m_showSelectionGuide;
   vm::bbox3f m_sofMapBounds;
 
+  const VisibleNodes* m_visibleNodes;
+
 public:
   RenderContext(
     RenderMode renderMode,
@@ -150,6 +153,13 @@ public:
   void setForceShowSelectionGuide();
   void setForceHideSelectionGuide();
 
+  /**
+   * Returns the nodes of the world that intersect with the view frustum of the camera, or
+   * nullptr if the nodes to render have not been culled against the view frustum.
+   */
+  const VisibleNodes* visibleNodes() const;
+  void setVisibleNodes(const VisibleNodes* visibleNodes);
+
 private:
   void setShowSelectionGuide(ShowSelectionGuide showSelectionGuide);
 
@@ -112,7 +112,7 @@ void AddRemoveNodesCommand::doAction(MapDocumentCommandFacade* document)
     document->performAddNodes(m_nodesToAdd);
     break;
   case Action::Remove:
-    document->performRemoveNodes(m_nodesToRemove);
+    m_removedChildIndices = document->performRemoveNodes(m_nodesToRemove);
     break;
   }
 
@@ -128,7 +128,9 @@ void AddRemoveNodesCommand::undoAction(MapDocumentCommandFacade* document)
     document->performRemoveNodes(m_nodesToRemove);
     break;
   case Action::Remove:
-    document->performAddNodes(m_nodesToAdd);
+    // restore the nodes at their original positions so that linked groups still
+    // correspond to each other (see Model::updateLinkedGroupNodes)
+    document->performAddNodes(m_nodesToAdd, m_removedChildIndices);
     break;
   }
 
@@ -47,6 +47,7 @@ private:
   Action m_action;
   std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToAdd;
   std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToRemove;
+  std::map<Model::Node*, std::vector<size_t>> m_removedChildIndices;
 
 public:
   static std::unique_ptr<AddRemoveNodesCommand> add(
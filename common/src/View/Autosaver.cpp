@@ -22,7 +22,10 @@
 #include "Exceptions.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/DiskIO.h"
+#include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
 #include "IO/PathInfo.h"
+#include "Logger.h"
 #include "View/MapDocument.h"
 
 #include <kdl/memory_utils.h>
@@ -30,11 +33,15 @@
 #include <kdl/string_compare.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
+#include <kdl/thread_pool.h>
 
 #include <algorithm> // for std::sort
 #include <cassert>
+#include <condition_variable>
+#include <exception>
 #include <limits>
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom
 {
@@ -56,6 +63,31 @@ IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename)
   };
 }
 
+IO::PathMatcher makeBackupTempPathMatcher(std::filesystem::path mapBasename)
+{
+  return [matchBackupPath = makeBackupPathMatcher(std::move(mapBasename))](
+           const std::filesystem::path& path, const IO::GetPathInfo& getPathInfo) {
+    // the backup itself need not exist, only its name must match
+    const auto backupExists = [](const auto&) { return IO::PathInfo::File; };
+
+    return getPathInfo(path) == IO::PathInfo::File
+           && kdl::ci::str_is_equal(path.extension().string(), ".tmp")
+           && matchBackupPath(kdl::path_remove_extension(path), backupExists);
+  };
+}
+
+/**
+ * The state shared between the autosaver and the task which writes a backup in the
+ * background.
+ */
+struct Autosaver::BackgroundAutosave
+{
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool done = false;
+  DeferredLogger logger;
+};
+
 Autosaver::Autosaver(
   std::weak_ptr<MapDocument> document,
   const std::chrono::milliseconds saveInterval,
@@ -68,8 +100,20 @@ Autosaver::Autosaver(
 {
 }
 
+Autosaver::~Autosaver()
+{
+  auto logger = NullLogger{};
+  finishBackgroundAutosave(logger, true);
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  if (!finishBackgroundAutosave(logger, false))
+  {
+    // only one backup is written at a time
+    return;
+  }
+
   if (!kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
@@ -82,17 +126,80 @@ void Autosaver::triggerAutosave(Logger& logger)
   }
 }
 
+void Autosaver::waitForAutosave(Logger& logger)
+{
+  finishBackgroundAutosave(logger, true);
+}
+
+bool Autosaver::finishBackgroundAutosave(Logger& logger, const bool wait)
+{
+  if (!m_backgroundAutosave)
+  {
+    return true;
+  }
+
+  {
+    auto lock = std::unique_lock{m_backgroundAutosave->mutex};
+    if (wait)
+    {
+      m_backgroundAutosave->condition.wait(
+        lock, [&]() { return m_backgroundAutosave->done; });
+    }
+    else if (!m_backgroundAutosave->done)
+    {
+      return false;
+    }
+  }
+
+  m_backgroundAutosave->logger.logTo(logger);
+  m_backgroundAutosave = nullptr;
+  return true;
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
-  const auto& mapPath = document->path();
+  const auto mapPath = document->path();
   assert(IO::Disk::pathInfo(mapPath) == IO::PathInfo::File);
 
-  const auto mapFilename = mapPath.filename();
+  m_lastSaveTime = Clock::now();
+  m_lastModificationCount = document->modificationCount();
+
+  // the snapshot is taken here, but serialized and written in the background
+  auto snapshot = std::make_shared<IO::MapSnapshot>(document->snapshotDocument());
+  logger.debug() << "Writing autosave backup of " << mapPath;
+
+  auto backgroundAutosave = std::make_shared<BackgroundAutosave>();
+  m_backgroundAutosave = backgroundAutosave;
+
+  // the destructor waits for the task, so it may access this autosaver
+  kdl::default_thread_pool().submit([this, backgroundAutosave, snapshot, mapPath]() {
+    try
+    {
+      writeBackup(backgroundAutosave->logger, *snapshot, mapPath);
+    }
+    catch (const std::exception& e)
+    {
+      backgroundAutosave->logger.error() << "Aborting autosave: " << e.what();
+    }
+
+    const auto lock = std::lock_guard{backgroundAutosave->mutex};
+    backgroundAutosave->done = true;
+    backgroundAutosave->condition.notify_all();
+  });
+}
+
+void Autosaver::writeBackup(
+  Logger& logger,
+  const IO::MapSnapshot& snapshot,
+  const std::filesystem::path& mapPath) const
+{
   const auto mapBasename = mapPath.stem();
 
   try
   {
     auto fs = createBackupFileSystem(logger, mapPath);
+    deleteTempFiles(logger, fs, mapBasename);
+
     auto backups = collectBackups(fs, mapBasename);
 
     thinBackups(logger, fs, backups);
@@ -101,11 +208,46 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
     assert(backups.size() < m_maxBackups);
     const auto backupNo = backups.size() + 1;
 
-    const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
+    const auto backupName = makeBackupName(mapBasename, backupNo);
+    const auto backupFilePath = fs.makeAbsolute(backupName);
+
+    // write to a temporary file which is renamed when it is complete, so that a backup
+    // is never partially written
+    const auto tempName = kdl::path_add_extension(backupName, ".tmp");
+    const auto tempFilePath = fs.makeAbsolute(tempName);
+    try
+    {
+      {
+        auto file = IO::openPathAsOutputStream(tempFilePath);
+        if (!file)
+        {
+          throw FileSystemException{"Cannot open file: " + tempFilePath.string()};
+        }
 
-    m_lastSaveTime = Clock::now();
-    m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
+        snapshot.write(file);
+        file.close();
+        if (!file)
+        {
+          throw FileSystemException{"Cannot write file: " + tempFilePath.string()};
+        }
+      }
+      fs.moveFile(tempName, backupName, false);
+    }
+    catch (...)
+    {
+      if (fs.pathInfo(tempName) == IO::PathInfo::File)
+      {
+        try
+        {
+          fs.deleteFile(tempName);
+        }
+        catch (const FileSystemException&)
+        {
+          logger.warn() << "Cannot delete temporary file " << tempFilePath;
+        }
+      }
+      throw;
+    }
 
     logger.info() << "Created autosave backup at " << backupFilePath;
   }
@@ -133,6 +275,27 @@ IO::WritableDiskFileSystem Autosaver::createBackupFileSystem(
   }
 }
 
+void Autosaver::deleteTempFiles(
+  Logger& logger,
+  IO::WritableDiskFileSystem& fs,
+  const std::filesystem::path& mapBasename) const
+{
+  // only one backup is written at a time, so any temporary file was left behind by an
+  // autosave that was interrupted, e.g. by a crash
+  for (const auto& tempName : fs.find({}, makeBackupTempPathMatcher(mapBasename)))
+  {
+    try
+    {
+      fs.deleteFile(tempName);
+      logger.debug() << "Deleted stale autosave file " << tempName;
+    }
+    catch (const FileSystemException&)
+    {
+      logger.warn() << "Cannot delete stale autosave file " << tempName;
+    }
+  }
+}
+
 namespace
 {
 size_t extractBackupNo(const std::filesystem::path& path)
@@ -32,6 +32,7 @@ class Logger;
 namespace IO
 {
 class FileSystem;
+class MapSnapshot;
 class WritableDiskFileSystem;
 } // namespace IO
 
@@ -42,11 +43,33 @@ class MapDocument;
 
 IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
 
+/**
+ * Matches the temporary files that backups of the map with the given basename are written
+ * to before they are renamed.
+ */
+IO::PathMatcher makeBackupTempPathMatcher(std::filesystem::path mapBasename);
+
+/**
+ * Periodically writes backups of a document's map to an autosave directory next to the
+ * map file.
+ *
+ * A backup is written from a snapshot of the map which is taken on the calling thread.
+ * Serializing and writing the snapshot and managing the existing backups happens on a
+ * background thread so that the editor is not blocked. Only one backup is written at a
+ * time. Messages logged while a backup is written are passed on to the logger given to
+ * the next call to triggerAutosave or waitForAutosave.
+ *
+ * A backup is first written to a temporary file which is removed if the backup cannot be
+ * completed. Temporary files left behind by an earlier session are removed before a
+ * backup is written.
+ */
 class Autosaver
 {
 private:
   using Clock = std::chrono::system_clock;
 
+  struct BackgroundAutosave;
+
   std::weak_ptr<MapDocument> m_document;
 
   /**
@@ -70,18 +93,49 @@ private:
    */
   size_t m_lastModificationCount;
 
+  /**
+   * The backup that is being written in the background, if any.
+   */
+  std::shared_ptr<BackgroundAutosave> m_backgroundAutosave;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
     size_t maxBackups = 50);
 
+  /**
+   * Waits until a backup that is being written in the background is finished.
+   */
+  ~Autosaver();
+
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Waits until a backup that is being written in the background is finished and passes
+   * the messages logged while writing it on to the given logger.
+   */
+  void waitForAutosave(Logger& logger);
+
 private:
+  /**
+   * Passes the messages of a finished background autosave on to the given logger. If
+   * wait is true, waits for a pending background autosave to finish first.
+   *
+   * Returns true if no background autosave is pending anymore.
+   */
+  bool finishBackgroundAutosave(Logger& logger, bool wait);
   void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
+  void writeBackup(
+    Logger& logger,
+    const IO::MapSnapshot& snapshot,
+    const std::filesystem::path& mapPath) const;
   IO::WritableDiskFileSystem createBackupFileSystem(
     Logger& logger, const std::filesystem::path& mapPath) const;
+  void deleteTempFiles(
+    Logger& logger,
+    IO::WritableDiskFileSystem& fs,
+    const std::filesystem::path& mapBasename) const;
   std::vector<std::filesystem::path> collectBackups(
     const IO::FileSystem& fs, const std::filesystem::path& mapBasename) const;
   void thinBackups(
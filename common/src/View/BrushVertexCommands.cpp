@@ -47,11 +47,10 @@ std::unique_ptr<CommandResult> BrushVertexCommandBase::createCommandResult(
   return swapResult;
 }
 
-static auto collectBrushNodes(
-  const std::vector<std::pair<Model::Node*, Model::NodeContents>> nodes)
+static auto collectBrushNodes(const std::vector<Model::Node*>& nodes)
 {
   auto result = std::vector<Model::BrushNode*>{};
-  for (const auto& [node, contents] : nodes)
+  for (auto* node : nodes)
   {
     if (auto* brushNode = dynamic_cast<Model::BrushNode*>(node))
     {
@@ -1152,10 +1152,12 @@ void ClipTool::connectObservers()
     document->selectionDidChangeNotifier.connect(this, &ClipTool::selectionDidChange);
   m_notifierConnection +=
     document->nodesWillChangeNotifier.connect(this, &ClipTool::nodesWillChange);
+  // must be notified immediately because notifications are ignored while the clip tool
+  // is changing the document
   m_notifierConnection +=
-    document->nodesDidChangeNotifier.connect(this, &ClipTool::nodesDidChange);
-  m_notifierConnection +=
-    document->brushFacesDidChangeNotifier.connect(this, &ClipTool::brushFacesDidChange);
+    document->nodesDidChangeNotifier.connectImmediately(this, &ClipTool::nodesDidChange);
+  m_notifierConnection += document->brushFacesDidChangeNotifier.connectImmediately(
+    this, &ClipTool::brushFacesDidChange);
 }
 
 void ClipTool::selectionDidChange(const Selection&)
@@ -157,6 +157,17 @@ private:
 
     return false;
   }
+
+public:
+  size_t memoryUsage() const override
+  {
+    auto result = size_t(0);
+    for (const auto& command : m_commands)
+    {
+      result += command->memoryUsage();
+    }
+    return result;
+  }
 };
 
 CommandProcessor::CommandProcessor(
@@ -203,6 +214,12 @@ const std::string& CommandProcessor::redoCommandName() const
   }
 }
 
+void CommandProcessor::setUndoMemoryBudget(const std::optional<size_t> undoMemoryBudget)
+{
+  m_undoMemoryBudget = undoMemoryBudget;
+  trimUndoStack();
+}
+
 void CommandProcessor::startTransaction(std::string name, const TransactionScope scope)
 {
   m_transactionStack.emplace_back(std::move(name), scope);
@@ -445,11 +462,13 @@ bool CommandProcessor::pushToUndoStack(
     auto& lastCommand = m_undoStack.back();
     if (lastCommand->collateWith(*command))
     {
+      trimUndoStack();
       return false;
     }
   }
 
   m_undoStack.push_back(std::move(command));
+  trimUndoStack();
   return true;
 }
 
@@ -461,6 +480,26 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack()
   return kdl::vec_pop_back(m_undoStack);
 }
 
+void CommandProcessor::trimUndoStack()
+{
+  if (!m_undoMemoryBudget)
+  {
+    return;
+  }
+
+  auto memoryUsage = size_t(0);
+  for (auto it = m_undoStack.rbegin(), end = m_undoStack.rend(); it != end; ++it)
+  {
+    memoryUsage += (*it)->memoryUsage();
+    if (memoryUsage > *m_undoMemoryBudget && it != m_undoStack.rbegin())
+    {
+      // remove this command and all older commands
+      m_undoStack.erase(m_undoStack.begin(), it.base());
+      return;
+    }
+  }
+}
+
 bool CommandProcessor::collatable(
   const bool collate, const std::chrono::system_clock::time_point timestamp) const
 {
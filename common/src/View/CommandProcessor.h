@@ -23,6 +23,7 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -67,6 +68,13 @@ private:
    */
   std::chrono::milliseconds m_collationInterval;
 
+  /**
+   * Limits the estimated memory used by the commands on the undo stack, see
+   * UndoableCommand::memoryUsage. If the limit is exceeded, the oldest commands are
+   * removed from the undo stack. The most recently executed command is always kept.
+   */
+  std::optional<size_t> m_undoMemoryBudget;
+
   /**
    * Holds the commands that were executed so far, with the most recently executed command
    * at the end of the vector.
@@ -168,6 +176,15 @@ public:
    */
   const std::string& redoCommandName() const;
 
+  /**
+   * Sets the number of bytes that the commands on the undo stack may use. If the given
+   * budget is std::nullopt, the undo stack is not limited. If the undo stack exceeds the
+   * given budget, its oldest commands are removed immediately.
+   *
+   * @param undoMemoryBudget the memory budget in bytes
+   */
+  void setUndoMemoryBudget(std::optional<size_t> undoMemoryBudget);
+
   /**
    * Starts a new transaction. If a transaction is currently executing, then the newly
    * started transaction becomes a nested transaction and will be added as a command to
@@ -374,6 +391,12 @@ private:
    */
   std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+  /**
+   * Removes the oldest commands from the undo stack until the remaining commands don't
+   * exceed the undo memory budget anymore. The topmost command is never removed.
+   */
+  void trimUndoStack();
+
   bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
   /**
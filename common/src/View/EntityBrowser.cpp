@@ -160,6 +160,8 @@ void EntityBrowser::connectObservers()
     document->modsDidChangeNotifier.connect(this, &EntityBrowser::modsDidChange);
   m_notifierConnection += document->entityDefinitionsDidChangeNotifier.connect(
     this, &EntityBrowser::entityDefinitionsDidChange);
+  m_notifierConnection += document->entityModelsWereLoadedNotifier.connect(
+    this, &EntityBrowser::entityModelsWereLoaded);
   m_notifierConnection +=
     document->nodesDidChangeNotifier.connect(this, &EntityBrowser::nodesDidChange);
 
@@ -194,6 +196,12 @@ void EntityBrowser::entityDefinitionsDidChange()
   reload();
 }
 
+void EntityBrowser::entityModelsWereLoaded()
+{
+  // the cell sizes depend on the model bounds
+  reload();
+}
+
 void EntityBrowser::preferenceDidChange(const std::filesystem::path& path)
 {
   auto document = kdl::mem_lock(m_document);
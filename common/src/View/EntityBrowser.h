@@ -78,6 +78,7 @@ private:
   void modsDidChange();
   void nodesDidChange(const std::vector<Model::Node*>& nodes);
   void entityDefinitionsDidChange();
+  void entityModelsWereLoaded();
   void preferenceDidChange(const std::filesystem::path& path);
 };
 } // namespace View
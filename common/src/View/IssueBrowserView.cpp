@@ -31,6 +31,7 @@
 #include "Model/GroupNode.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
+#include "Model/IssueValidation.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
@@ -137,38 +138,32 @@ void IssueBrowserView::updateIssues()
   {
     const auto validators = document->world()->registeredValidators();
 
-    auto issues = std::vector<const Model::Issue*>{};
-    const auto collectIssues = [&](auto* node) {
-      for (auto* issue : node->issues(validators))
-      {
-        if (
-          m_showHiddenIssues
-          || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-        {
-          issues.push_back(issue);
-        }
-      }
-    };
-
+    auto nodes = std::vector<Model::Node*>{};
     document->world()->accept(kdl::overload(
       [&](auto&& thisLambda, Model::WorldNode* world) {
-        collectIssues(world);
+        nodes.push_back(world);
         world->visitChildren(thisLambda);
       },
       [&](auto&& thisLambda, Model::LayerNode* layer) {
-        collectIssues(layer);
+        nodes.push_back(layer);
         layer->visitChildren(thisLambda);
       },
       [&](auto&& thisLambda, Model::GroupNode* group) {
-        collectIssues(group);
+        nodes.push_back(group);
         group->visitChildren(thisLambda);
       },
       [&](auto&& thisLambda, Model::EntityNode* entity) {
-        collectIssues(entity);
+        nodes.push_back(entity);
         entity->visitChildren(thisLambda);
       },
-      [&](Model::BrushNode* brush) { collectIssues(brush); },
-      [&](Model::PatchNode* patch) { collectIssues(patch); }));
+      [&](Model::BrushNode* brush) { nodes.push_back(brush); },
+      [&](Model::PatchNode* patch) { nodes.push_back(patch); }));
+
+    auto issues = kdl::vec_filter(
+      Model::validateIssues(nodes, validators), [&](const auto* issue) {
+        return m_showHiddenIssues
+               || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0);
+      });
 
     issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
       return lhs->seqId() > rhs->seqId();
@@ -34,9 +34,11 @@
 #include "IO/ExportOptions.h"
 #include "IO/GameConfigParser.h"
 #include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
 #include "IO/PathInfo.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "Model/BezierPatch.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
@@ -105,7 +107,9 @@
 #include "View/UpdateLinkedGroupsHelper.h"
 #include "View/ViewEffectsService.h"
 
+#include <kdl/block_pool.h>
 #include <kdl/collection_utils.h>
+#include <kdl/invoke.h>
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
 #include <kdl/overload.h>
@@ -130,6 +134,7 @@
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom
@@ -380,6 +385,12 @@ MapDocument::MapDocument()
   , m_viewEffectsService(nullptr)
   , m_repeatStack(std::make_unique<RepeatStack>())
 {
+  // the notifiers are declared after the batches, so they must be set up here
+  m_nodesDidChangeBatch =
+    &nodesDidChangeNotifier.setBatch<VectorNotifierBatch<Model::Node*>>();
+  m_brushFacesDidChangeBatch =
+    &brushFacesDidChangeNotifier.setBatch<VectorNotifierBatch<Model::BrushFaceHandle>>();
+
   connectObservers();
 }
 
@@ -623,6 +634,13 @@ void MapDocument::saveDocumentTo(const std::filesystem::path& path)
   m_game->writeMap(*m_world, path);
 }
 
+IO::MapSnapshot MapDocument::snapshotDocument() const
+{
+  ensure(m_game.get() != nullptr, "game is null");
+  ensure(m_world, "world is null");
+  return IO::MapSnapshot{*m_world, m_game->gameName()};
+}
+
 void MapDocument::exportDocumentAs(const IO::ExportOptions& options)
 {
   m_game->exportMap(*m_world, options);
@@ -2324,6 +2342,19 @@ void MapDocument::setHasPendingChanges(
   }
 }
 
+void MapDocument::addPendingContentChanges(
+  const std::vector<Model::GroupNode*>& groupNodes,
+  const std::vector<Model::Node*>& changedNodes)
+{
+  for (auto* groupNode : groupNodes)
+  {
+    groupNode->addPendingContentChanges(
+      kdl::vec_filter(changedNodes, [&](const auto* changedNode) {
+        return changedNode->isDescendantOf(groupNode);
+      }));
+  }
+}
+
 static std::vector<Model::GroupNode*> collectLinkedGroupsWithPendingChanges(
   Model::Node& node)
 {
@@ -2354,6 +2385,35 @@ static std::vector<Model::GroupNode*> collectLinkedGroupsWithPendingChanges(
   return result;
 }
 
+/**
+ * Returns the nodes whose contents have changed in the given linked groups if only the
+ * contents of nodes have changed in every given group and if none of the given groups
+ * contains another. Otherwise, an empty vector is returned, and the given groups must be
+ * updated entirely.
+ */
+static std::vector<Model::Node*> collectPendingContentChanges(
+  const std::vector<Model::GroupNode*>& changedLinkedGroups)
+{
+  auto result = std::vector<Model::Node*>{};
+  for (const auto* groupNode : changedLinkedGroups)
+  {
+    if (
+      groupNode->nodesWithPendingContentChanges().empty()
+      || std::any_of(
+        changedLinkedGroups.begin(),
+        changedLinkedGroups.end(),
+        [&](const auto* otherGroupNode) {
+          return groupNode->isAncestorOf(otherGroupNode);
+        }))
+    {
+      return {};
+    }
+    result =
+      kdl::vec_concat(std::move(result), groupNode->nodesWithPendingContentChanges());
+  }
+  return kdl::vec_sort_and_remove_duplicates(std::move(result));
+}
+
 bool MapDocument::updateLinkedGroups()
 {
   if (isCurrentDocumentStateObservable())
@@ -2362,9 +2422,11 @@ bool MapDocument::updateLinkedGroups()
           collectLinkedGroupsWithPendingChanges(*m_world);
         !allChangedLinkedGroups.empty())
     {
+      auto changedNodes = collectPendingContentChanges(allChangedLinkedGroups);
       setHasPendingChanges(allChangedLinkedGroups, false);
 
-      auto command = std::make_unique<UpdateLinkedGroupsCommand>(allChangedLinkedGroups);
+      auto command = std::make_unique<UpdateLinkedGroupsCommand>(
+        allChangedLinkedGroups, std::move(changedNodes));
       const auto result = executeAndStore(std::move(command));
       return result->success();
     }
@@ -2835,6 +2897,9 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
+  const auto changedNodes =
+    kdl::vec_transform(nodesToSwap, [](const auto& p) { return p.first; });
+
   auto transaction = Transaction{*this};
   const auto result = executeAndStore(
     std::make_unique<SwapNodeContentsCommand>(commandName, std::move(nodesToSwap)));
@@ -2845,7 +2910,7 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
-  setHasPendingChanges(changedLinkedGroups, true);
+  addPendingContentChanges(changedLinkedGroups, changedNodes);
   return transaction.commit();
 }
 
@@ -3843,13 +3908,14 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
           return true;
         }
 
-        if (!brush.canMoveVertices(m_worldBounds, verticesToMove, delta))
+        auto move = brush.prepareMoveVertices(m_worldBounds, verticesToMove, delta);
+        if (!move)
         {
           return false;
         }
 
         return brush
-          .moveVertices(m_worldBounds, verticesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, std::move(*move), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestVertexPositions(verticesToMove + delta);
             newVertexPositions =
@@ -3870,8 +3936,9 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       kdl::str_plural(vertexPositions.size(), "Move Brush Vertex", "Move Brush Vertices");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -3885,7 +3952,7 @@ MapDocument::MoveVerticesResult MapDocument::moveVertices(
       return MoveVerticesResult{false, false};
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingContentChanges(changedLinkedGroups, changedNodes);
 
     if (!transaction.commit())
     {
@@ -3923,13 +3990,14 @@ bool MapDocument::moveEdges(
           return true;
         }
 
-        if (!brush.canMoveEdges(m_worldBounds, edgesToMove, delta))
+        auto move = brush.prepareMoveEdges(m_worldBounds, edgesToMove, delta);
+        if (!move)
         {
           return false;
         }
 
         return brush
-          .moveEdges(m_worldBounds, edgesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, std::move(*move), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestEdgePositions(kdl::vec_transform(
               edgesToMove, [&](const auto& edge) { return edge.translate(delta); }));
@@ -3951,8 +4019,9 @@ bool MapDocument::moveEdges(
       kdl::str_plural(edgePositions.size(), "Move Brush Edge", "Move Brush Edges");
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushEdgeCommand>(
       commandName,
@@ -3966,7 +4035,7 @@ bool MapDocument::moveEdges(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingContentChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -3991,13 +4060,14 @@ bool MapDocument::moveFaces(
           return true;
         }
 
-        if (!brush.canMoveFaces(m_worldBounds, facesToMove, delta))
+        auto move = brush.prepareMoveFaces(m_worldBounds, facesToMove, delta);
+        if (!move)
         {
           return false;
         }
 
         return brush
-          .moveFaces(m_worldBounds, facesToMove, delta, pref(Preferences::UVLock))
+          .applyVertexMove(m_worldBounds, std::move(*move), pref(Preferences::UVLock))
           .transform([&]() {
             auto newPositions = brush.findClosestFacePositions(kdl::vec_transform(
               facesToMove, [&](const auto& face) { return face.translate(delta); }));
@@ -4019,8 +4089,9 @@ bool MapDocument::moveFaces(
       kdl::str_plural(facePositions.size(), "Move Brush Face", "Move Brush Faces");
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushFaceCommand>(
       commandName,
@@ -4034,7 +4105,7 @@ bool MapDocument::moveFaces(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingContentChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4068,8 +4139,9 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
     const auto commandName = "Add Brush Vertex";
     auto transaction = Transaction{*this, commandName};
 
-    const auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4083,7 +4155,7 @@ bool MapDocument::addVertex(const vm::vec3& vertexPosition)
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingContentChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4124,8 +4196,9 @@ bool MapDocument::removeVertices(
   {
     auto transaction = Transaction{*this, commandName};
 
-    auto changedLinkedGroups = findContainingLinkedGroups(
-      *m_world, kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; }));
+    const auto changedNodes =
+      kdl::vec_transform(*newNodes, [](const auto& p) { return p.first; });
+    const auto changedLinkedGroups = findContainingLinkedGroups(*m_world, changedNodes);
 
     const auto result = executeAndStore(std::make_unique<BrushVertexCommand>(
       commandName,
@@ -4139,7 +4212,7 @@ bool MapDocument::removeVertices(
       return false;
     }
 
-    setHasPendingChanges(changedLinkedGroups, true);
+    addPendingContentChanges(changedLinkedGroups, changedNodes);
     return transaction.commit();
   }
 
@@ -4229,7 +4302,11 @@ const std::string& MapDocument::redoCommandName() const
 
 void MapDocument::undoCommand()
 {
-  doUndoCommand();
+  beginNotifierBatch();
+  {
+    const auto endBatch = kdl::invoke_later{[&]() { endNotifierBatch(); }};
+    doUndoCommand();
+  }
   // Undo/redo in the repeat system is not supported for now, so just clear the repeat
   // stack
   m_repeatStack->clear();
@@ -4237,7 +4314,11 @@ void MapDocument::undoCommand()
 
 void MapDocument::redoCommand()
 {
-  doRedoCommand();
+  beginNotifierBatch();
+  {
+    const auto endBatch = kdl::invoke_later{[&]() { endNotifierBatch(); }};
+    doRedoCommand();
+  }
   m_repeatStack->clear();
 }
 
@@ -4259,7 +4340,25 @@ void MapDocument::clearRepeatableCommands()
 void MapDocument::startTransaction(std::string name, const TransactionScope scope)
 {
   debug("Starting transaction '" + name + "'");
-  doStartTransaction(std::move(name), scope);
+
+  // Long running transactions span many user interactions, such as a mouse drag, and the
+  // observers must see the changes made during the transaction immediately.
+  const auto batch = scope == TransactionScope::Oneshot;
+  m_transactionBatches.push_back(batch);
+  if (batch)
+  {
+    beginNotifierBatch();
+  }
+
+  try
+  {
+    doStartTransaction(std::move(name), scope);
+  }
+  catch (...)
+  {
+    endTransactionBatch();
+    throw;
+  }
   m_repeatStack->startTransaction();
 }
 
@@ -4273,6 +4372,7 @@ void MapDocument::rollbackTransaction()
 bool MapDocument::commitTransaction()
 {
   debug("Committing transaction");
+  const auto endBatch = kdl::invoke_later{[&]() { endTransactionBatch(); }};
 
   if (!updateLinkedGroups())
   {
@@ -4288,12 +4388,71 @@ bool MapDocument::commitTransaction()
 void MapDocument::cancelTransaction()
 {
   debug("Cancelling transaction");
+  const auto endBatch = kdl::invoke_later{[&]() { endTransactionBatch(); }};
+
   doRollbackTransaction();
   m_repeatStack->rollbackTransaction();
   doCommitTransaction();
   m_repeatStack->commitTransaction();
 }
 
+void MapDocument::endTransactionBatch()
+{
+  assert(!m_transactionBatches.empty());
+  const auto batch = m_transactionBatches.back();
+  m_transactionBatches.pop_back();
+  if (batch)
+  {
+    endNotifierBatch();
+  }
+}
+
+void MapDocument::beginNotifierBatch()
+{
+  nodesDidChangeNotifier.beginBatch();
+  brushFacesDidChangeNotifier.beginBatch();
+}
+
+void MapDocument::endNotifierBatch()
+{
+  // the faces of a brush may have been replaced after they were reported as changed
+  m_brushFacesDidChangeBatch->discard([](const auto& handle) {
+    return handle.faceIndex() >= handle.node()->brush().faceCount();
+  });
+
+  nodesDidChangeNotifier.endBatch();
+  brushFacesDidChangeNotifier.endBatch();
+}
+
+void MapDocument::discardRemovedNodeChanges(const std::vector<Model::Node*>& nodes)
+{
+  // Removed nodes may be deleted before the batches are flushed, so they must not be
+  // passed to the observers. This also applies to the descendants of removed nodes.
+  if (
+    m_nodesDidChangeBatch->values().empty()
+    && m_brushFacesDidChangeBatch->values().empty())
+  {
+    return;
+  }
+
+  const auto removedNodes =
+    std::unordered_set<const Model::Node*>{nodes.begin(), nodes.end()};
+  const auto isRemoved = [&](const Model::Node* node) {
+    for (; node; node = node->parent())
+    {
+      if (removedNodes.count(node) > 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  m_nodesDidChangeBatch->discard(isRemoved);
+  m_brushFacesDidChangeBatch->discard(
+    [&](const auto& handle) { return isRemoved(handle.node()); });
+}
+
 std::unique_ptr<CommandResult> MapDocument::execute(std::unique_ptr<Command>&& command)
 {
   return doExecute(std::move(command));
@@ -4361,6 +4520,9 @@ void MapDocument::clearWorld()
 {
   m_world.reset();
   m_currentLayer = nullptr;
+
+  // release the memory of the world's polyhedra
+  kdl::trim_block_pools();
 }
 
 Assets::EntityDefinitionFileSpec MapDocument::entityDefinitionFile() const
@@ -4424,6 +4586,57 @@ void MapDocument::reloadEntityDefinitions()
   info("Reloading entity definitions");
 }
 
+static std::vector<Model::Node*> collectEntityNodesWithModels(
+  Logger& logger,
+  Model::WorldNode& worldNode,
+  const kdl::vector_set<std::filesystem::path>& modelPaths)
+{
+  auto result = std::vector<Model::Node*>{};
+
+  worldNode.accept(kdl::overload(
+    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+    [&](Model::EntityNode* entityNode) {
+      const auto modelSpec = Assets::safeGetModelSpecification(
+        logger, entityNode->entity().classname(), [&]() {
+          return entityNode->entity().modelSpecification();
+        });
+      if (modelPaths.count(modelSpec.path) > 0)
+      {
+        result.push_back(entityNode);
+      }
+    },
+    [](Model::BrushNode*) {},
+    [](Model::PatchNode*) {}));
+
+  return result;
+}
+
+void MapDocument::processLoadedEntityModels()
+{
+  const auto loadedModelPaths =
+    kdl::vector_set<std::filesystem::path>(m_entityModelManager->processLoadedModels());
+  if (loadedModelPaths.empty())
+  {
+    return;
+  }
+
+  if (m_world)
+  {
+    const auto entityNodes =
+      collectEntityNodesWithModels(*this, *m_world, loadedModelPaths);
+    if (!entityNodes.empty())
+    {
+      NotifyBeforeAndAfter notifyNodes(
+        nodesWillChangeNotifier, nodesDidChangeNotifier, entityNodes);
+      setEntityModels(entityNodes);
+    }
+  }
+
+  entityModelsWereLoadedNotifier();
+}
+
 void MapDocument::loadAssets()
 {
   loadEntityDefinitions();
@@ -4489,6 +4702,7 @@ void MapDocument::unloadEntityModels()
 void MapDocument::reloadTextures()
 {
   unloadTextures();
+  m_entityModelManager->waitForPendingModels();
   m_game->reloadShaders();
   loadTextures();
 }
@@ -4502,8 +4716,16 @@ void MapDocument::loadTextures()
       const auto wadPaths = kdl::vec_transform(
         kdl::str_split(*wadStr, ";"),
         [](const auto& str) { return std::filesystem::path{str}; });
+      m_entityModelManager->waitForPendingModels();
       m_game->reloadWads(path(), wadPaths, logger());
     }
+
+    m_textureManager->setTextureCache(
+      pref(Preferences::EnableTextureCache)
+        ? std::make_shared<IO::TextureCache>(
+          IO::SystemPaths::userDataDirectory() / "TextureCache",
+          uint64_t(std::max(0, pref(Preferences::TextureCacheSize))) * 1024u * 1024u)
+        : nullptr);
     m_game->loadTextureCollections(*m_textureManager);
   }
   catch (const Exception& e)
@@ -4532,12 +4754,13 @@ static auto makeSetTexturesVisitor(Assets::TextureManager& manager)
       for (size_t i = 0u; i < brush.faceCount(); ++i)
       {
         const Model::BrushFace& face = brush.face(i);
-        Assets::Texture* texture = manager.texture(face.attributes().textureName());
+        Assets::Texture* texture =
+          manager.texture(face.attributes().internedTextureName());
         brushNode->setFaceTexture(i, texture);
       }
     },
     [&](Model::PatchNode* patchNode) {
-      auto* texture = manager.texture(patchNode->patch().textureName());
+      auto* texture = manager.texture(patchNode->patch().internedTextureName());
       patchNode->setTexture(texture);
     });
 }
@@ -4579,7 +4802,8 @@ void MapDocument::setTextures(const std::vector<Model::BrushFaceHandle>& faceHan
   {
     Model::BrushNode* node = faceHandle.node();
     const Model::BrushFace& face = faceHandle.face();
-    Assets::Texture* texture = m_textureManager->texture(face.attributes().textureName());
+    Assets::Texture* texture =
+      m_textureManager->texture(face.attributes().internedTextureName());
     node->setFaceTexture(faceHandle.faceIndex(), texture);
   }
   textureUsageCountsDidChangeNotifier();
@@ -4737,6 +4961,7 @@ std::vector<std::filesystem::path> MapDocument::externalSearchPaths() const
 
 void MapDocument::updateGameSearchPaths()
 {
+  m_entityModelManager->waitForPendingModels();
   m_game->setAdditionalSearchPaths(
     kdl::vec_transform(
       mods(), [](const auto& mod) { return std::filesystem::path{mod}; }),
@@ -5067,9 +5292,11 @@ void MapDocument::connectObservers()
   m_notifierConnection +=
     nodesWillBeRemovedNotifier.connect(this, &MapDocument::clearNodeTags);
   m_notifierConnection +=
-    nodesDidChangeNotifier.connect(this, &MapDocument::updateNodeTags);
+    nodesWereRemovedNotifier.connect(this, &MapDocument::discardRemovedNodeChanges);
+  m_notifierConnection +=
+    nodesDidChangeNotifier.connectImmediately(this, &MapDocument::updateNodeTags);
   m_notifierConnection +=
-    brushFacesDidChangeNotifier.connect(this, &MapDocument::updateFaceTags);
+    brushFacesDidChangeNotifier.connectImmediately(this, &MapDocument::updateFaceTags);
   m_notifierConnection +=
     modsDidChangeNotifier.connect(this, &MapDocument::updateAllFaceTags);
   m_notifierConnection +=
@@ -5120,6 +5347,7 @@ void MapDocument::preferenceDidChange(const std::filesystem::path& path)
   {
     const Model::GameFactory& gameFactory = Model::GameFactory::instance();
     const std::filesystem::path newGamePath = gameFactory.gamePath(m_game->gameName());
+    m_entityModelManager->waitForPendingModels();
     m_game->setGamePath(newGamePath, logger());
 
     clearEntityModels();
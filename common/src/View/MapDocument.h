@@ -55,6 +55,11 @@ class Texture;
 class TextureManager;
 } // namespace Assets
 
+namespace IO
+{
+class MapSnapshot;
+} // namespace IO
+
 namespace Model
 {
 class Brush;
@@ -147,6 +152,18 @@ protected:
    */
   std::unique_ptr<RepeatStack> m_repeatStack;
 
+  /*
+   * While a oneshot transaction, an undo or a redo is running, the notifications about
+   * changed nodes and brush faces are collected by these batches and passed to the
+   * observers once at the end, see beginNotifierBatch. The batches are owned by their
+   * notifiers.
+   */
+  VectorNotifierBatch<Model::Node*>* m_nodesDidChangeBatch;
+  VectorNotifierBatch<Model::BrushFaceHandle>* m_brushFacesDidChangeBatch;
+
+  // for every running transaction, whether it opened a notifier batch
+  std::vector<bool> m_transactionBatches;
+
 public: // notification
   Notifier<Command&> commandDoNotifier;
   Notifier<Command&> commandDoneNotifier;
@@ -193,6 +210,8 @@ public: // notification
   Notifier<> entityDefinitionsWillChangeNotifier;
   Notifier<> entityDefinitionsDidChangeNotifier;
 
+  Notifier<> entityModelsWereLoadedNotifier;
+
   Notifier<> modsWillChangeNotifier;
   Notifier<> modsDidChangeNotifier;
 
@@ -299,6 +318,11 @@ public: // new, load, save document
   void saveDocument();
   void saveDocumentAs(const std::filesystem::path& path);
   void saveDocumentTo(const std::filesystem::path& path);
+  /**
+   * Takes a snapshot of the document's map which can be written on another thread while
+   * the document is edited.
+   */
+  IO::MapSnapshot snapshotDocument() const;
   void exportDocumentAs(const IO::ExportOptions& options);
 
 private:
@@ -492,6 +516,9 @@ public:
 protected:
   void setHasPendingChanges(
     const std::vector<Model::GroupNode*>& groupNodes, bool hasPendingChanges);
+  void addPendingContentChanges(
+    const std::vector<Model::GroupNode*>& groupNodes,
+    const std::vector<Model::Node*>& changedNodes);
   bool updateLinkedGroups();
 
 private:
@@ -648,6 +675,11 @@ public: // transactions
   virtual bool isCurrentDocumentStateObservable() const = 0;
 
 private:
+  void endTransactionBatch();
+  void beginNotifierBatch();
+  void endNotifierBatch();
+  void discardRemovedNodeChanges(const std::vector<Model::Node*>& nodes);
+
   std::unique_ptr<CommandResult> execute(std::unique_ptr<Command>&& command);
   std::unique_ptr<CommandResult> executeAndStore(
     std::unique_ptr<UndoableCommand>&& command);
@@ -699,6 +731,12 @@ public: // asset management
   void reloadTextureCollections();
   void reloadEntityDefinitions();
 
+  /**
+   * Sets the entity models which have finished loading in the background on the entity
+   * nodes that use them. Must be called on the main thread.
+   */
+  void processLoadedEntityModels();
+
 private:
   void loadAssets();
   void unloadAssets();
@@ -54,9 +54,12 @@
 #include <vecmath/polygon.h>
 #include <vecmath/segment.h>
 
+#include <cassert>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -73,6 +76,7 @@ MapDocumentCommandFacade::MapDocumentCommandFacade()
   : m_commandProcessor(std::make_unique<CommandProcessor>(this))
 {
   connectObservers();
+  updateUndoMemoryBudget();
 }
 
 MapDocumentCommandFacade::~MapDocumentCommandFacade() = default;
@@ -263,7 +267,8 @@ void MapDocumentCommandFacade::performDeselectAll()
 }
 
 void MapDocumentCommandFacade::performAddNodes(
-  const std::map<Model::Node*, std::vector<Model::Node*>>& nodes)
+  const std::map<Model::Node*, std::vector<Model::Node*>>& nodes,
+  const std::map<Model::Node*, std::vector<size_t>>& childIndices)
 {
   const std::vector<Model::Node*> parents = collectParents(nodes);
   NotifyBeforeAndAfter notifyParents(
@@ -272,7 +277,23 @@ void MapDocumentCommandFacade::performAddNodes(
   std::vector<Model::Node*> addedNodes;
   for (const auto& [parent, children] : nodes)
   {
-    parent->addChildren(children);
+    if (const auto it = childIndices.find(parent); it != std::end(childIndices))
+    {
+      const auto& indices = it->second;
+      assert(indices.size() == children.size());
+
+      auto indexedChildren = std::vector<std::pair<size_t, Model::Node*>>{};
+      indexedChildren.reserve(children.size());
+      for (size_t i = 0; i < children.size(); ++i)
+      {
+        indexedChildren.emplace_back(indices[i], children[i]);
+      }
+      parent->insertChildren(std::move(indexedChildren));
+    }
+    else
+    {
+      parent->addChildren(children);
+    }
     addedNodes = kdl::vec_concat(std::move(addedNodes), children);
   }
 
@@ -284,7 +305,7 @@ void MapDocumentCommandFacade::performAddNodes(
   nodesWereAddedNotifier(addedNodes);
 }
 
-void MapDocumentCommandFacade::performRemoveNodes(
+std::map<Model::Node*, std::vector<size_t>> MapDocumentCommandFacade::performRemoveNodes(
   const std::map<Model::Node*, std::vector<Model::Node*>>& nodes)
 {
   const std::vector<Model::Node*> parents = collectParents(nodes);
@@ -295,6 +316,15 @@ void MapDocumentCommandFacade::performRemoveNodes(
   NotifyBeforeAndAfter notifyChildren(
     nodesWillBeRemovedNotifier, nodesWereRemovedNotifier, allChildren);
 
+  auto childIndices = std::map<Model::Node*, std::vector<size_t>>{};
+  for (const auto& [parent, children] : nodes)
+  {
+    const auto& siblings = parent->children();
+    childIndices[parent] = kdl::vec_transform(children, [&](const auto* child) {
+      return *kdl::vec_index_of(siblings, child);
+    });
+  }
+
   for (const auto& [parent, children] : nodes)
   {
     unsetEntityModels(children);
@@ -304,6 +334,8 @@ void MapDocumentCommandFacade::performRemoveNodes(
   }
 
   invalidateSelectionBounds();
+
+  return childIndices;
 }
 
 static std::vector<Model::Node*> collectOldChildren(
@@ -403,6 +435,11 @@ static auto notifySpecialWorldProperties(
 void MapDocumentCommandFacade::performSwapNodeContents(
   std::vector<std::pair<Model::Node*, Model::NodeContents>>& nodesToSwap)
 {
+  if (nodesToSwap.empty())
+  {
+    return;
+  }
+
   const auto nodes =
     kdl::vec_transform(nodesToSwap, [](const auto& pair) { return pair.first; });
   const auto parents = collectParents(nodes);
@@ -622,6 +659,28 @@ void MapDocumentCommandFacade::connectObservers()
     m_commandProcessor->transactionDoneNotifier.connect(transactionDoneNotifier);
   m_notifierConnection +=
     m_commandProcessor->transactionUndoneNotifier.connect(transactionUndoneNotifier);
+
+  auto& prefs = PreferenceManager::instance();
+  m_notifierConnection += prefs.preferenceDidChangeNotifier.connect(
+    this, &MapDocumentCommandFacade::preferenceDidChange);
+}
+
+void MapDocumentCommandFacade::preferenceDidChange(const std::filesystem::path& path)
+{
+  if (path == Preferences::UndoMemoryBudget.path())
+  {
+    updateUndoMemoryBudget();
+  }
+}
+
+void MapDocumentCommandFacade::updateUndoMemoryBudget()
+{
+  // the budget is given in MiB, and 0 means that the undo stack is not limited
+  const auto undoMemoryBudget = pref(Preferences::UndoMemoryBudget);
+  m_commandProcessor->setUndoMemoryBudget(
+    undoMemoryBudget > 0
+      ? std::optional<size_t>{size_t(undoMemoryBudget) * 1024u * 1024u}
+      : std::nullopt);
 }
 
 bool MapDocumentCommandFacade::isCurrentDocumentStateObservable() const
@@ -26,6 +26,7 @@
 
 #include <vecmath/forward.h>
 
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <string>
@@ -78,8 +79,22 @@ public: // selection modification
   void performDeselectAll();
 
 public: // adding and removing nodes
-  void performAddNodes(const std::map<Model::Node*, std::vector<Model::Node*>>& nodes);
-  void performRemoveNodes(const std::map<Model::Node*, std::vector<Model::Node*>>& nodes);
+  /**
+   * Adds the given nodes to their parents. If child indices are given for a parent, then
+   * its nodes are added at these indices (see Model::Node::insertChildren), otherwise
+   * they are added after the parent's existing children.
+   */
+  void performAddNodes(
+    const std::map<Model::Node*, std::vector<Model::Node*>>& nodes,
+    const std::map<Model::Node*, std::vector<size_t>>& childIndices = {});
+
+  /**
+   * Removes the given nodes from their parents and returns the index each node had among
+   * its parent's children, in the order in which the nodes are given. Passing the result
+   * to performAddNodes restores the nodes at their original positions.
+   */
+  std::map<Model::Node*, std::vector<size_t>> performRemoveNodes(
+    const std::map<Model::Node*, std::vector<Model::Node*>>& nodes);
 
   std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>
   performReplaceChildren(
@@ -117,6 +132,8 @@ public: // modification count
 
 private: // notification
   void connectObservers();
+  void preferenceDidChange(const std::filesystem::path& path);
+  void updateUndoMemoryBudget();
   void documentWasNewed(MapDocument* document);
   void documentWasLoaded(MapDocument* document);
 
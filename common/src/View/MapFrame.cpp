@@ -19,6 +19,7 @@
 
 #include "MapFrame.h"
 
+#include "Assets/EntityModelManager.h"
 #include "Console.h"
 #include "Exceptions.h"
 #include "FileLogger.h"
@@ -157,6 +158,12 @@ MapFrame::MapFrame(FrameManager* frameManager, std::shared_ptr<MapDocument> docu
   m_document->setParentLogger(m_console);
   m_document->setViewEffectsService(m_mapView);
 
+  // entity models are loaded in the background, process them on the main thread
+  m_document->entityModelManager().setModelLoadedCallback([this]() {
+    QMetaObject::invokeMethod(
+      this, [this]() { m_document->processLoadedEntityModels(); }, Qt::QueuedConnection);
+  });
+
   m_autosaveTimer = new QTimer(this);
   m_autosaveTimer->start(1000);
 
@@ -181,6 +188,7 @@ MapFrame::~MapFrame()
   // is about to be destroyed (DestroyChildren()). Clear the pointer
   // so we don't try to log to a dangling pointer (#1885).
   m_document->setParentLogger(nullptr);
+  m_document->entityModelManager().setModelLoadedCallback(nullptr);
 
   m_mapView->deactivateTool();
 
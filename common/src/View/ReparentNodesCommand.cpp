@@ -46,7 +46,7 @@ ReparentNodesCommand::ReparentNodesCommand(
 std::unique_ptr<CommandResult> ReparentNodesCommand::doPerformDo(
   MapDocumentCommandFacade* document)
 {
-  document->performRemoveNodes(m_nodesToRemove);
+  m_removedChildIndices = document->performRemoveNodes(m_nodesToRemove);
   document->performAddNodes(m_nodesToAdd);
   return std::make_unique<CommandResult>(true);
 }
@@ -55,7 +55,7 @@ std::unique_ptr<CommandResult> ReparentNodesCommand::doPerformUndo(
   MapDocumentCommandFacade* document)
 {
   document->performRemoveNodes(m_nodesToAdd);
-  document->performAddNodes(m_nodesToRemove);
+  document->performAddNodes(m_nodesToRemove, m_removedChildIndices);
   return std::make_unique<CommandResult>(true);
 }
 } // namespace View
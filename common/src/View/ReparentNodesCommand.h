@@ -41,6 +41,7 @@ class ReparentNodesCommand : public UpdateLinkedGroupsCommandBase
 private:
   std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToAdd;
   std::map<Model::Node*, std::vector<Model::Node*>> m_nodesToRemove;
+  std::map<Model::Node*, std::vector<size_t>> m_removedChildIndices;
 
 public:
   static std::unique_ptr<ReparentNodesCommand> reparent(
@@ -20,11 +20,14 @@
 #include "SwapNodeContentsCommand.h"
 
 #include "Model/Brush.h"
+#include "Model/BrushError.h"
 #include "Model/Entity.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
+#include <kdl/parallel.h>
 #include <kdl/result.h>
+#include <kdl/result_fold.h>
 #include <kdl/vector_utils.h>
 
 namespace TrenchBroom
@@ -35,7 +38,10 @@ SwapNodeContentsCommand::SwapNodeContentsCommand(
   const std::string& name,
   std::vector<std::pair<Model::Node*, Model::NodeContents>> nodes)
   : UpdateLinkedGroupsCommandBase(name, true)
-  , m_nodes(std::move(nodes))
+  , m_nodes(kdl::vec_transform(nodes, [](const auto& pair) { return pair.first; }))
+  , m_newContents(kdl::vec_transform(
+      std::move(nodes), [](auto pair) { return std::move(pair.second); }))
+  , m_memoryUsage(0u)
 {
 }
 
@@ -44,25 +50,21 @@ SwapNodeContentsCommand::~SwapNodeContentsCommand() = default;
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformDo(
   MapDocumentCommandFacade* document)
 {
-  document->performSwapNodeContents(m_nodes);
-  return std::make_unique<CommandResult>(true);
+  return std::make_unique<CommandResult>(swapNodeContents(document));
 }
 
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformUndo(
   MapDocumentCommandFacade* document)
 {
-  document->performSwapNodeContents(m_nodes);
-  return std::make_unique<CommandResult>(true);
+  return std::make_unique<CommandResult>(swapNodeContents(document));
 }
 
 bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
 {
   if (auto* other = dynamic_cast<SwapNodeContentsCommand*>(&command))
   {
-    auto myNodes =
-      kdl::vec_transform(m_nodes, [](const auto& pair) { return pair.first; });
-    auto theirNodes =
-      kdl::vec_transform(other->m_nodes, [](const auto& pair) { return pair.first; });
+    auto myNodes = m_nodes;
+    auto theirNodes = other->m_nodes;
 
     kdl::vec_sort(myNodes);
     kdl::vec_sort(theirNodes);
@@ -72,5 +74,55 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
 
   return false;
 }
+
+size_t SwapNodeContentsCommand::memoryUsage() const
+{
+  return m_memoryUsage;
+}
+
+bool SwapNodeContentsCommand::swapNodeContents(MapDocumentCommandFacade* document)
+{
+  auto contents = std::vector<Model::NodeContents>{};
+  if (!m_newContents.empty())
+  {
+    contents = std::move(m_newContents);
+    m_newContents.clear();
+  }
+  else
+  {
+    // rebuilding the brush geometry is expensive, so restore the contents in parallel
+    const auto& worldBounds = document->worldBounds();
+    auto storedContents = kdl::vec_transform(
+      m_storedContents, [](const auto& compactContents) { return &compactContents; });
+    auto restoredContents = kdl::fold_results(kdl::vec_parallel_transform(
+      std::move(storedContents), [&](const auto* compactContents) {
+        return compactContents->restore(worldBounds);
+      }));
+    if (restoredContents.is_error())
+    {
+      return false;
+    }
+    contents = std::move(restoredContents).value();
+  }
+
+  auto nodesToSwap = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+  nodesToSwap.reserve(m_nodes.size());
+  for (size_t i = 0; i < m_nodes.size(); ++i)
+  {
+    nodesToSwap.emplace_back(m_nodes[i], std::move(contents[i]));
+  }
+
+  document->performSwapNodeContents(nodesToSwap);
+
+  m_storedContents = kdl::vec_parallel_transform(std::move(nodesToSwap), [](auto pair) {
+    return Model::CompactNodeContents{std::move(pair.second)};
+  });
+  m_memoryUsage = 0u;
+  for (const auto& storedContents : m_storedContents)
+  {
+    m_memoryUsage += storedContents.memoryUsage();
+  }
+  return true;
+}
 } // namespace View
 } // namespace TrenchBroom
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Macros.h"
+#include "Model/CompactNodeContents.h"
 #include "Model/NodeContents.h"
 #include "View/UpdateLinkedGroupsCommandBase.h"
 
@@ -39,10 +40,28 @@ class Node;
 
 namespace View
 {
+/**
+ * Swaps the contents of the given nodes with the given contents.
+ *
+ * The contents that are swapped out of the nodes are stored in compact form, see
+ * Model::CompactNodeContents, and restored when they are swapped back in.
+ */
 class SwapNodeContentsCommand : public UpdateLinkedGroupsCommandBase
 {
 protected:
-  std::vector<std::pair<Model::Node*, Model::NodeContents>> m_nodes;
+  std::vector<Model::Node*> m_nodes;
+
+private:
+  /**
+   * The contents to swap into the nodes when this command is executed for the first time.
+   */
+  std::vector<Model::NodeContents> m_newContents;
+
+  /**
+   * The contents to swap into the nodes when this command is undone or redone.
+   */
+  std::vector<Model::CompactNodeContents> m_storedContents;
+  size_t m_memoryUsage;
 
 public:
   SwapNodeContentsCommand(
@@ -56,6 +75,11 @@ public:
 
   bool doCollateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
+private:
+  bool swapNodeContents(MapDocumentCommandFacade* document);
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 } // namespace View
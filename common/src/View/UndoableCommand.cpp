@@ -75,6 +75,11 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UndoableCommand::memoryUsage() const
+{
+  return 0u;
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
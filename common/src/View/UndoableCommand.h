@@ -47,6 +47,12 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Returns an estimate of the number of bytes of memory used by the data that this
+   * command stores to be undone and redone. The default implementation returns 0.
+   */
+  virtual size_t memoryUsage() const;
+
 protected:
   virtual std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade* document) = 0;
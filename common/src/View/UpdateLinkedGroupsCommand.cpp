@@ -26,9 +26,13 @@ namespace TrenchBroom
 namespace View
 {
 UpdateLinkedGroupsCommand::UpdateLinkedGroupsCommand(
-  std::vector<Model::GroupNode*> changedLinkedGroups)
+  std::vector<Model::GroupNode*> changedLinkedGroups,
+  std::vector<Model::Node*> changedNodes)
   : UpdateLinkedGroupsCommandBase{
-    "Update Linked Groups", true, std::move(changedLinkedGroups)}
+    "Update Linked Groups",
+    true,
+    std::move(changedLinkedGroups),
+    std::move(changedNodes)}
 {
 }
 
@@ -39,7 +39,9 @@ namespace View
 class UpdateLinkedGroupsCommand : public UpdateLinkedGroupsCommandBase
 {
 public:
-  UpdateLinkedGroupsCommand(std::vector<Model::GroupNode*> changedLinkedGroups);
+  UpdateLinkedGroupsCommand(
+    std::vector<Model::GroupNode*> changedLinkedGroups,
+    std::vector<Model::Node*> changedNodes = {});
   ~UpdateLinkedGroupsCommand();
 
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
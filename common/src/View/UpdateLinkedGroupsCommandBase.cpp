@@ -35,9 +35,10 @@ namespace View
 UpdateLinkedGroupsCommandBase::UpdateLinkedGroupsCommandBase(
   std::string name,
   const bool updateModificationCount,
-  std::vector<Model::GroupNode*> changedLinkedGroups)
+  std::vector<Model::GroupNode*> changedLinkedGroups,
+  std::vector<Model::Node*> changedNodes)
   : UndoableCommand{std::move(name), updateModificationCount}
-  , m_updateLinkedGroupsHelper{std::move(changedLinkedGroups)}
+  , m_updateLinkedGroupsHelper{std::move(changedLinkedGroups), std::move(changedNodes)}
 {
 }
 
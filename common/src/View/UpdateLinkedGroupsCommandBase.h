@@ -41,7 +41,8 @@ protected:
   UpdateLinkedGroupsCommandBase(
     std::string name,
     bool updateModificationCount,
-    std::vector<Model::GroupNode*> changedLinkedGroups = {});
+    std::vector<Model::GroupNode*> changedLinkedGroups = {},
+    std::vector<Model::Node*> changedNodes = {});
 
 public:
   virtual ~UpdateLinkedGroupsCommandBase();
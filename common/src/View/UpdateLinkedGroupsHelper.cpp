@@ -57,8 +57,9 @@ const auto compareByAncestry = [](const auto* lhs, const auto* rhs) {
 };
 
 UpdateLinkedGroupsHelper::UpdateLinkedGroupsHelper(
-  ChangedLinkedGroups changedLinkedGroups)
+  ChangedLinkedGroups changedLinkedGroups, std::vector<Model::Node*> changedNodes)
   : m_state{kdl::vec_sort(std::move(changedLinkedGroups), compareByAncestry)}
+  , m_changedNodes{std::move(changedNodes)}
 {
 }
 
@@ -68,18 +69,18 @@ kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::
   applyLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
   return computeLinkedGroupUpdates(document).transform(
-    [&]() { doApplyOrUndoLinkedGroupUpdates(document); });
+    [&]() { doApplyLinkedGroupUpdates(document); });
 }
 
 void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
-  doApplyOrUndoLinkedGroupUpdates(document);
+  doUndoLinkedGroupUpdates(document);
 }
 
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
 {
   // Both helpers have already applied their changes at this point, so in both helpers,
-  // m_linkedGroups contains pairs p where
+  // childrenToReplace contains pairs p where
   // - p.first is the group node to update
   // - p.second is a vector containing the group node's original children
   //
@@ -90,9 +91,37 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // is not an update for a linked group node that was updated by this helper, then we
   // will add p_o to our updates and remove it from the other helper's updates to prevent
   // the replaced node to be deleted with the other helper.
+  //
+  // The same applies to the nodes in contentsToSwap and their original contents. In
+  // addition, the other helper's content updates for nodes whose ancestors' children
+  // were replaced by this helper are discarded because undoing the replacement of the
+  // ancestors' children already restores the original nodes.
+
+  auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state).childrenToReplace;
+  auto& theirLinkedGroupUpdates =
+    std::get<LinkedGroupUpdates>(other.m_state).childrenToReplace;
+  auto& myContentUpdates = std::get<LinkedGroupUpdates>(m_state).contentsToSwap;
+  auto& theirContentUpdates = std::get<LinkedGroupUpdates>(other.m_state).contentsToSwap;
 
-  auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
-  auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
+  for (auto& [theirNodeToUpdate, theirOldContents] : theirContentUpdates)
+  {
+    const auto isUpdatedByMe = std::any_of(
+      std::begin(myContentUpdates),
+      std::end(myContentUpdates),
+      [theirNodeToUpdate = theirNodeToUpdate](const auto& p) {
+        return p.first == theirNodeToUpdate;
+      });
+    const auto isReplacedByMe = std::any_of(
+      std::begin(myLinkedGroupUpdates),
+      std::end(myLinkedGroupUpdates),
+      [theirNodeToUpdate = theirNodeToUpdate](const auto& p) {
+        return theirNodeToUpdate->isDescendantOf(p.first);
+      });
+    if (!isUpdatedByMe && !isReplacedByMe)
+    {
+      myContentUpdates.emplace_back(theirNodeToUpdate, std::move(theirOldContents));
+    }
+  }
 
   for (auto& [theirGroupNodeToUpdate, theirOldChildren] : theirLinkedGroupUpdates)
   {
@@ -116,7 +145,7 @@ kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::
   return std::visit(
     kdl::overload(
       [&](const ChangedLinkedGroups& changedLinkedGroups) {
-        return computeLinkedGroupUpdates(changedLinkedGroups, document)
+        return computeLinkedGroupUpdates(changedLinkedGroups, m_changedNodes, document)
           .transform([&](auto&& linkedGroupUpdates) {
             m_state = std::forward<decltype(linkedGroupUpdates)>(linkedGroupUpdates);
           });
@@ -129,7 +158,9 @@ kdl::result<void, Model::UpdateLinkedGroupsError> UpdateLinkedGroupsHelper::
 
 kdl::result<UpdateLinkedGroupsHelper::LinkedGroupUpdates, Model::UpdateLinkedGroupsError>
 UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
-  const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
+  const ChangedLinkedGroups& changedLinkedGroups,
+  const std::vector<Model::Node*>& changedNodes,
+  MapDocumentCommandFacade& document)
 {
   if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
   {
@@ -137,6 +168,66 @@ UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
   }
 
   const auto& worldBounds = document.worldBounds();
+  if (!changedNodes.empty())
+  {
+    return kdl::fold_results(
+             changedLinkedGroups,
+             [&](const auto* groupNode) {
+               const auto groupNodesToUpdate = kdl::vec_erase(
+                 Model::findLinkedGroups(
+                   *document.world(), *groupNode->group().linkedGroupId()),
+                 groupNode);
+               const auto changedNodesInGroup =
+                 kdl::vec_filter(changedNodes, [&](const auto* node) {
+                   return node->isDescendantOf(groupNode);
+                 });
+
+               // groups whose structure differs from the changed group's are replaced
+               // entirely because their corresponding nodes cannot be determined
+               auto groupNodesToPatch = std::vector<Model::GroupNode*>{};
+               auto groupNodesToReplace = std::vector<Model::GroupNode*>{};
+               for (auto* groupNodeToUpdate : groupNodesToUpdate)
+               {
+                 if (Model::canUpdateLinkedGroupNodes(
+                       *groupNode, changedNodesInGroup, *groupNodeToUpdate))
+                 {
+                   groupNodesToPatch.push_back(groupNodeToUpdate);
+                 }
+                 else
+                 {
+                   groupNodesToReplace.push_back(groupNodeToUpdate);
+                 }
+               }
+
+               return Model::updateLinkedGroupNodes(
+                        *groupNode, changedNodesInGroup, groupNodesToPatch, worldBounds)
+                 .and_then([&](auto&& contentsToSwap) {
+                   return Model::updateLinkedGroups(
+                            *groupNode, groupNodesToReplace, worldBounds)
+                     .transform([&](auto&& childrenToReplace) {
+                       return LinkedGroupUpdates{
+                         std::forward<decltype(childrenToReplace)>(childrenToReplace),
+                         std::forward<decltype(contentsToSwap)>(contentsToSwap)};
+                     });
+                 });
+             })
+      .transform([](auto&& nestedUpdateLists) {
+        auto result = LinkedGroupUpdates{};
+        for (auto& updates : nestedUpdateLists)
+        {
+          result.childrenToReplace.insert(
+            std::end(result.childrenToReplace),
+            std::make_move_iterator(std::begin(updates.childrenToReplace)),
+            std::make_move_iterator(std::end(updates.childrenToReplace)));
+          result.contentsToSwap.insert(
+            std::end(result.contentsToSwap),
+            std::make_move_iterator(std::begin(updates.contentsToSwap)),
+            std::make_move_iterator(std::end(updates.contentsToSwap)));
+        }
+        return result;
+      });
+  }
+
   return kdl::fold_results(
            changedLinkedGroups,
            [&](const auto* groupNode) {
@@ -151,20 +242,32 @@ UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
     .and_then(
       [&](auto&& nestedUpdateLists)
         -> kdl::result<LinkedGroupUpdates, Model::UpdateLinkedGroupsError> {
-        return kdl::vec_flatten(std::move(nestedUpdateLists));
+        return LinkedGroupUpdates{kdl::vec_flatten(std::move(nestedUpdateLists)), {}};
       });
 }
 
-void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
+void UpdateLinkedGroupsHelper::doApplyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
-  std::visit(
-    kdl::overload(
-      [](const ChangedLinkedGroups&) {},
-      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
-      }),
-    std::move(m_state));
+  if (auto* linkedGroupUpdates = std::get_if<LinkedGroupUpdates>(&m_state))
+  {
+    document.performSwapNodeContents(linkedGroupUpdates->contentsToSwap);
+    linkedGroupUpdates->childrenToReplace =
+      document.performReplaceChildren(std::move(linkedGroupUpdates->childrenToReplace));
+  }
+}
+
+void UpdateLinkedGroupsHelper::doUndoLinkedGroupUpdates(
+  MapDocumentCommandFacade& document)
+{
+  // undo in reverse order because collated content updates may refer to nodes that were
+  // replaced afterwards
+  if (auto* linkedGroupUpdates = std::get_if<LinkedGroupUpdates>(&m_state))
+  {
+    linkedGroupUpdates->childrenToReplace =
+      document.performReplaceChildren(std::move(linkedGroupUpdates->childrenToReplace));
+    document.performSwapNodeContents(linkedGroupUpdates->contentsToSwap);
+  }
 }
 } // namespace View
 } // namespace TrenchBroom
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "FloatType.h"
+#include "Model/NodeContents.h"
 
 #include <kdl/result_forward.h>
 
@@ -58,17 +59,29 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
  * updated, and these linked groups are replaced with their replacements. Calling
  * applyLinkedGroupUpdates replaces the replacement nodes with their original
  * corresponding groups again, effectively undoing the change.
+ *
+ * If the helper is additionally initialized with the nodes whose contents have changed,
+ * then only the contents of the corresponding nodes in the linked groups are updated (see
+ * Model::updateLinkedGroupNodes) instead of replacing all of their children. In that
+ * case, the given nodes must be descendants of the given groups, and none of the given
+ * groups may contain another.
  */
 class UpdateLinkedGroupsHelper
 {
 private:
   using ChangedLinkedGroups = std::vector<Model::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>;
+  struct LinkedGroupUpdates
+  {
+    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>
+      childrenToReplace;
+    std::vector<std::pair<Model::Node*, Model::NodeContents>> contentsToSwap;
+  };
   std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
+  std::vector<Model::Node*> m_changedNodes;
 
 public:
-  explicit UpdateLinkedGroupsHelper(ChangedLinkedGroups changedLinkedGroups);
+  explicit UpdateLinkedGroupsHelper(
+    ChangedLinkedGroups changedLinkedGroups, std::vector<Model::Node*> changedNodes = {});
   ~UpdateLinkedGroupsHelper();
 
   kdl::result<void, Model::UpdateLinkedGroupsError> applyLinkedGroupUpdates(
@@ -81,9 +94,12 @@ private:
     MapDocumentCommandFacade& document);
   static kdl::result<LinkedGroupUpdates, Model::UpdateLinkedGroupsError>
   computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
+    const ChangedLinkedGroups& changedLinkedGroups,
+    const std::vector<Model::Node*>& changedNodes,
+    MapDocumentCommandFacade& document);
 
-  void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doApplyLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
 };
 } // namespace View
 } // namespace TrenchBroom
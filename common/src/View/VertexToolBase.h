@@ -521,8 +521,9 @@ private: // Observers and state management
       this, &VertexToolBase::selectionDidChange);
     m_notifierConnection +=
       document->nodesWillChangeNotifier.connect(this, &VertexToolBase::nodesWillChange);
-    m_notifierConnection +=
-      document->nodesDidChangeNotifier.connect(this, &VertexToolBase::nodesDidChange);
+    // the handles removed in nodesWillChange must be added again immediately
+    m_notifierConnection += document->nodesDidChangeNotifier.connectImmediately(
+      this, &VertexToolBase::nodesDidChange);
     m_notifierConnection +=
       document->commandDoNotifier.connect(this, &VertexToolBase::commandDo);
     m_notifierConnection +=
@@ -30,6 +30,7 @@
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
 #include <vecmath/intersection.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/scalar.h>
 
@@ -587,9 +588,113 @@ public:
     }
   }
 
+  /**
+   * Finds every data item in this tree whose bounding box may intersect with the given
+   * bounding box and returns a list of those items.
+   *
+   * The result may contain items whose bounding boxes do not intersect with the given
+   * bounding box, but it contains every item whose bounding box does.
+   *
+   * @param bounds the bounding box to test
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_overlaps(const vm::bbox<T, 3>& bounds) const
+  {
+    auto result = std::vector<U>{};
+    find_overlaps(bounds, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box may intersect with the given
+   * bounding box and appends it to the given output iterator.
+   *
+   * @tparam O the output iterator type
+   * @param bounds the bounding box to test
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_overlaps(const vm::bbox<T, 3>& bounds, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          return get_address(node).to_bounds(m_min_size).intersects(bounds);
+        });
+    }
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box may intersect with the convex
+   * volume bounded by the given planes and returns a list of those items. The normals of
+   * the planes must point out of the volume.
+   *
+   * The result may contain items whose bounding boxes do not intersect with the volume,
+   * but it contains every item whose bounding box does.
+   *
+   * @param planes the planes that bound the volume
+   * @return a list containing all found data items
+   */
+  std::vector<U> find_in_convex_volume(const std::vector<vm::plane<T, 3>>& planes) const
+  {
+    auto result = std::vector<U>{};
+    find_in_convex_volume(planes, std::back_inserter(result));
+    return result;
+  }
+
+  /**
+   * Finds every data item in this tree whose bounding box may intersect with the convex
+   * volume bounded by the given planes and appends it to the given output iterator. The
+   * normals of the planes must point out of the volume.
+   *
+   * @tparam O the output iterator type
+   * @param planes the planes that bound the volume
+   * @param out the output iterator to append to
+   */
+  template <typename O>
+  void find_in_convex_volume(const std::vector<vm::plane<T, 3>>& planes, O out) const
+  {
+    if (m_root)
+    {
+      visit_node_if(
+        *m_root,
+        [&](const auto& node) {
+          const auto& data = get_data(node);
+          std::copy(data.begin(), data.end(), out);
+        },
+        [&](const auto& node) {
+          const auto bounds = get_address(node).to_bounds(m_min_size);
+          return std::none_of(
+            planes.begin(), planes.end(), [&](const auto& plane) {
+              return is_above(bounds, plane);
+            });
+        });
+    }
+  }
+
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
+  /**
+   * Checks whether the given bounding box is entirely above the given plane, i.e.,
+   * whether the corner of the box that is furthest below the plane is above the plane.
+   */
+  static bool is_above(const vm::bbox<T, 3>& bounds, const vm::plane<T, 3>& plane)
+  {
+    auto corner = vm::vec<T, 3>{};
+    for (size_t i = 0; i < 3; ++i)
+    {
+      corner[i] = plane.normal[i] >= T(0) ? bounds.min[i] : bounds.max[i];
+    }
+    return plane.point_distance(corner) > T(0);
+  }
+
   void check(const vm::bbox<T, 3>& bounds) const
   {
     if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max))
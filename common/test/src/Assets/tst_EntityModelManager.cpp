@@ -0,0 +1,225 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "Assets/ModelDefinition.h"
+#include "Exceptions.h"
+#include "IO/EntityModelLoader.h"
+#include "TestLogger.h"
+
+#include <kdl/thread_pool.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/bbox_io.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+namespace
+{
+class TestEntityModelLoader : public IO::EntityModelLoader
+{
+public:
+  mutable std::atomic<size_t> initializeCount = 0;
+
+  // initializing "blocking.mdl" waits until it is unblocked
+  mutable std::mutex mutex;
+  mutable std::condition_variable condition;
+  mutable bool blocking = false;
+  mutable bool blocked = false;
+  mutable bool timedOut = false;
+
+  void unblock() const
+  {
+    {
+      const auto lock = std::lock_guard{mutex};
+      blocking = false;
+    }
+    condition.notify_all();
+  }
+
+  bool waitUntilBlocked() const
+  {
+    auto lock = std::unique_lock{mutex};
+    return condition.wait_for(lock, std::chrono::seconds{10}, [&]() { return blocked; });
+  }
+
+private:
+  std::unique_ptr<EntityModel> doInitializeModel(
+    const std::filesystem::path& path, Logger&) const override
+  {
+    ++initializeCount;
+    if (path == "blocking.mdl")
+    {
+      auto lock = std::unique_lock{mutex};
+      blocked = true;
+      condition.notify_all();
+      timedOut = !condition.wait_for(
+        lock, std::chrono::seconds{10}, [&]() { return !blocking; });
+    }
+    else if (path == "missing.mdl")
+    {
+      throw GameException{"Could not load model " + path.string()};
+    }
+
+    auto model = std::make_unique<EntityModel>(
+      path.string(), PitchType::Normal, Orientation::Oriented);
+    model->addFrame();
+    model->addFrame();
+    return model;
+  }
+
+  void doLoadFrame(
+    const std::filesystem::path&,
+    const size_t frameIndex,
+    EntityModel& model,
+    Logger&) const override
+  {
+    const auto size = float(frameIndex + 1);
+    model.loadFrame(frameIndex, "frame", vm::bbox3f{size});
+  }
+};
+} // namespace
+
+TEST_CASE("EntityModelManagerTest.loadModelInBackground")
+{
+  auto logger = TestLogger{};
+  auto loader = TestEntityModelLoader{};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  const auto spec = ModelSpecification{"model.mdl", 0, 1};
+
+  // the model is not available until it was loaded and processed
+  CHECK(manager.frame(spec) == nullptr);
+  CHECK(manager.frame(spec) == nullptr);
+
+  manager.waitForPendingModels();
+  CHECK(loader.initializeCount == 1u);
+
+  CHECK(manager.processLoadedModels() == std::vector<std::filesystem::path>{"model.mdl"});
+  CHECK(manager.processLoadedModels().empty());
+
+  const auto* frame = manager.frame(spec);
+  REQUIRE(frame != nullptr);
+  CHECK(frame->loaded());
+  CHECK(frame->bounds() == vm::bbox3f{2.0f});
+
+  // other frames are loaded on demand
+  const auto* otherFrame = manager.frame(ModelSpecification{"model.mdl", 0, 0});
+  REQUIRE(otherFrame != nullptr);
+  CHECK(otherFrame->bounds() == vm::bbox3f{1.0f});
+
+  CHECK(loader.initializeCount == 1u);
+}
+
+TEST_CASE("EntityModelManagerTest.loadFrameWhileLoadingModel")
+{
+  if (kdl::default_thread_pool().num_workers() == 0)
+  {
+    // models are loaded on the calling thread
+    return;
+  }
+
+  auto logger = TestLogger{};
+  auto loader = TestEntityModelLoader{};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  const auto spec = ModelSpecification{"model.mdl", 0, 0};
+  CHECK(manager.frame(spec) == nullptr);
+  manager.waitForPendingModels();
+  manager.processLoadedModels();
+
+  loader.blocking = true;
+  CHECK(manager.frame(ModelSpecification{"blocking.mdl", 0, 0}) == nullptr);
+  REQUIRE(loader.waitUntilBlocked());
+
+  // loading a frame on this thread does not wait for the model that is being loaded
+  const auto* frame = manager.frame(ModelSpecification{"model.mdl", 0, 1});
+  CHECK(frame != nullptr);
+
+  loader.unblock();
+  manager.waitForPendingModels();
+  CHECK_FALSE(loader.timedOut);
+  CHECK(
+    manager.processLoadedModels() == std::vector<std::filesystem::path>{"blocking.mdl"});
+}
+
+TEST_CASE("EntityModelManagerTest.loadMissingModel")
+{
+  auto logger = TestLogger{};
+  auto loader = TestEntityModelLoader{};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  const auto spec = ModelSpecification{"missing.mdl", 0, 0};
+  CHECK(manager.frame(spec) == nullptr);
+
+  manager.waitForPendingModels();
+  CHECK(
+    manager.processLoadedModels() == std::vector<std::filesystem::path>{"missing.mdl"});
+  CHECK(logger.countMessages(LogLevel::Error) == 1u);
+
+  // the model is not loaded again
+  CHECK(manager.frame(spec) == nullptr);
+  manager.waitForPendingModels();
+  CHECK(manager.processLoadedModels().empty());
+  CHECK(loader.initializeCount == 1u);
+}
+
+TEST_CASE("EntityModelManagerTest.clearDiscardsLoadedModels")
+{
+  auto logger = TestLogger{};
+  auto loader = TestEntityModelLoader{};
+
+  auto manager = EntityModelManager{0, 0, logger};
+  manager.setLoader(&loader);
+
+  const auto spec = ModelSpecification{"model.mdl", 0, 0};
+  CHECK(manager.frame(spec) == nullptr);
+
+  manager.clear();
+  CHECK(manager.processLoadedModels().empty());
+
+  // the model is loaded again after clearing
+  CHECK(manager.frame(spec) == nullptr);
+  manager.waitForPendingModels();
+  CHECK(manager.processLoadedModels() == std::vector<std::filesystem::path>{"model.mdl"});
+  CHECK(loader.initializeCount == 2u);
+}
+
+} // namespace Assets
+} // namespace TrenchBroom
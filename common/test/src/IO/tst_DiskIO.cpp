@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <string>
 
 #include "Catch2.h"
 
@@ -59,6 +60,7 @@ TestEnvironment makeTestEnvironment()
       env.createFile("test2.map", "//test file\n{}");
       env.createFile("anotherDir/subDirTest/test2.map", "//sub dir test file\n{}");
       env.createFile("anotherDir/test3.map", "//yet another test file\n{}");
+      env.createFile("dir1/large.bin", std::string(128 * 1024, 'x'));
     }};
 }
 } // namespace
@@ -124,6 +126,21 @@ TEST_CASE("DiskIO")
       Disk::openFile(env.dir() / "does_not_exist.txt"), FileNotFoundException);
     CHECK(Disk::openFile(env.dir() / "test.txt") != nullptr);
     CHECK(Disk::openFile(env.dir() / "anotherDir/subDirTest/test2.map") != nullptr);
+
+    const auto smallFile = Disk::openFile(env.dir() / "test.txt");
+    CHECK(dynamic_cast<const CFile*>(smallFile.get()) != nullptr);
+
+    const auto largeFile = Disk::openFile(env.dir() / "dir1/large.bin");
+    const auto* mmapFile = dynamic_cast<const MmapFile*>(largeFile.get());
+    REQUIRE(mmapFile != nullptr);
+    CHECK(mmapFile->size() == 128u * 1024u);
+    CHECK(
+      std::string{mmapFile->begin(), mmapFile->end()} == std::string(128 * 1024, 'x'));
+
+    const auto view = FileView{"view", largeFile, 1024, 16};
+    auto bufferedReader = view.reader().buffer();
+    CHECK(bufferedReader.begin() == mmapFile->begin() + 1024);
+    CHECK(bufferedReader.stringView() == std::string(16, 'x'));
   }
 
   SECTION("resolvePath")
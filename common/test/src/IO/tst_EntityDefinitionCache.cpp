@@ -0,0 +1,160 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Color.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/EntityDefinitionClassInfo.h"
+#include "IO/FgdParser.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TestParserStatus.h"
+#include "Logger.h"
+
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+struct ParseResult
+{
+  std::vector<EntityDefinitionSourceFile> sourceFiles;
+  std::vector<EntityDefinitionClassInfo> classInfos;
+  std::vector<std::tuple<LogLevel, std::string>> messages;
+};
+
+ParseResult parseFgd(const std::filesystem::path& path)
+{
+  auto file = Disk::openFile(path);
+  auto reader = file->reader().buffer();
+  auto parser =
+    FgdParser{reader.stringView(), Color{1.0f, 1.0f, 1.0f, 1.0f}, file->path()};
+
+  auto testStatus = TestParserStatus{};
+  auto status = BufferedParserStatus{testStatus};
+  auto classInfos = parser.parseResolvedClassInfos(status);
+  return {
+    kdl::vec_concat(
+      std::vector<EntityDefinitionSourceFile>{
+        {file->path(), hashEntityDefinitionSource(reader.stringView())}},
+      parser.includedFiles()),
+    std::move(classInfos),
+    status.messages()};
+}
+
+std::vector<std::string> classNames(const std::vector<EntityDefinitionClassInfo>& infos)
+{
+  return kdl::vec_transform(infos, [](const auto& info) { return info.name; });
+}
+} // namespace
+
+TEST_CASE("EntityDefinitionCache")
+{
+  auto env = TestEnvironment{[](TestEnvironment& e) {
+    e.createFile("host.fgd", R"(
+@BaseClass = Base []
+@include "point.fgd"
+@SolidClass size(-8 -8 -8, 8 8 8) base(Base) = worldspawn []
+@include "missing.fgd"
+)");
+    e.createFile("point.fgd", R"(
+@PointClass base(Base) = info_player_start []
+)");
+  }};
+
+  const auto hostPath = env.dir() / "host.fgd";
+  auto [sourceFiles, classInfos, messages] = parseFgd(hostPath);
+
+  CHECK(
+    classNames(classInfos)
+    == std::vector<std::string>{"info_player_start", "worldspawn"});
+
+  REQUIRE(sourceFiles.size() == 3u);
+  CHECK(sourceFiles[0].path == hostPath);
+  CHECK(sourceFiles[0].hash != std::nullopt);
+  CHECK(sourceFiles[1].path == env.dir() / "point.fgd");
+  CHECK(sourceFiles[1].hash != std::nullopt);
+  CHECK(sourceFiles[2].path == env.dir() / "missing.fgd");
+  CHECK(sourceFiles[2].hash == std::nullopt);
+
+  // the solid class must not have a size, and the missing file cannot be included
+  CHECK(std::count_if(messages.begin(), messages.end(), [](const auto& message) {
+          return std::get<0>(message) == LogLevel::Warn;
+        }) == 1);
+  CHECK(std::count_if(messages.begin(), messages.end(), [](const auto& message) {
+          return std::get<0>(message) == LogLevel::Error;
+        }) == 1);
+
+  auto status = TestParserStatus{};
+  auto cache = EntityDefinitionCache{};
+  CHECK(cache.classInfos(hostPath, status) == nullptr);
+
+  cache.setClassInfos(hostPath, sourceFiles, classInfos, messages);
+
+  SECTION("Returns class infos if no file has changed")
+  {
+    const auto* cachedClassInfos = cache.classInfos(hostPath, status);
+    REQUIRE(cachedClassInfos != nullptr);
+    CHECK(classNames(*cachedClassInfos) == classNames(classInfos));
+  }
+
+  SECTION("Reports the messages of the parser again")
+  {
+    REQUIRE(cache.classInfos(hostPath, status) != nullptr);
+    CHECK(status.countStatus(LogLevel::Warn) == 1u);
+    CHECK(status.countStatus(LogLevel::Error) == 1u);
+
+    REQUIRE(cache.classInfos(hostPath, status) != nullptr);
+    CHECK(status.countStatus(LogLevel::Warn) == 2u);
+    CHECK(status.countStatus(LogLevel::Error) == 2u);
+  }
+
+  SECTION("Discards class infos if an included file has changed")
+  {
+    env.createFile("point.fgd", R"(
+@PointClass base(Base) = info_player_deathmatch []
+)");
+    CHECK(cache.classInfos(hostPath, status) == nullptr);
+    CHECK(status.countStatus(LogLevel::Warn) == 0u);
+  }
+
+  SECTION("Discards class infos if a missing included file was created")
+  {
+    env.createFile("missing.fgd", R"(
+@PointClass base(Base) = info_player_deathmatch []
+)");
+    CHECK(cache.classInfos(hostPath, status) == nullptr);
+  }
+}
+} // namespace IO
+} // namespace TrenchBroom
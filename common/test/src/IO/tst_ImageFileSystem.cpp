@@ -23,6 +23,7 @@
 #include "IO/File.h"
 #include "IO/IdPakFileSystem.h"
 #include "IO/PathInfo.h"
+#include "IO/TestEnvironment.h"
 #include "IO/WadFileSystem.h"
 #include "IO/ZipFileSystem.h"
 
@@ -943,5 +944,34 @@ TEST_CASE("Flat ImageFileSystems")
     CHECK(contents == cr8_czg_03_contents);
   }
 }
+
+TEST_CASE("ImageFileSystem archive mapping")
+{
+  auto env = TestEnvironment{};
+
+  const auto wadPath = env.dir() / "cr8_czg.wad";
+  std::filesystem::copy_file(
+    Disk::getCurrentWorkingDir() / "fixture/test/IO/Wad/cr8_czg.wad", wadPath);
+
+  auto fs = WadFileSystem{wadPath};
+
+  SECTION("Files opened from the archive can be read")
+  {
+    const auto cr8_czg_3_d = fs.openFile("cr8_czg_3.D");
+    const auto speedM_1_d = fs.openFile("speedM_1.D");
+
+    auto reader = cr8_czg_3_d->reader();
+    auto contents = std::vector<unsigned char>(reader.size());
+    reader.read(contents.data(), reader.size());
+    CHECK(contents == cr8_czg_03_contents);
+  }
+
+  SECTION("Changing the archive while no file is open")
+  {
+    // the archive is not mapped, so it can be changed
+    std::filesystem::resize_file(wadPath, std::filesystem::file_size(wadPath) / 2);
+    CHECK_THROWS_AS(fs.openFile("cr8_czg_3.D"), FileSystemException);
+  }
+}
 } // namespace IO
 } // namespace TrenchBroom
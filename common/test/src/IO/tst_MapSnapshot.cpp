@@ -0,0 +1,151 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
+#include "IO/NodeWriter.h"
+#include "Model/BezierPatch.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/PatchNode.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/result.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+std::unique_ptr<Model::WorldNode> makeWorld(const Model::MapFormat mapFormat)
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = Model::BrushBuilder{mapFormat, worldBounds};
+
+  auto world = std::make_unique<Model::WorldNode>(
+    Model::EntityPropertyConfig{}, Model::Entity{}, mapFormat);
+  world->defaultLayer()->addChild(
+    new Model::BrushNode{builder.createCube(64.0, "some_texture").value()});
+
+  auto* layerNode = new Model::LayerNode{Model::Layer{"Custom Layer"}};
+  world->addChild(layerNode);
+
+  auto* groupNode = new Model::GroupNode{Model::Group{"Group"}};
+  layerNode->addChild(groupNode);
+  groupNode->addChild(
+    new Model::BrushNode{builder.createCube(32.0, "other_texture").value()});
+
+  auto* entityNode =
+    new Model::EntityNode{Model::Entity{{}, {{"classname", "func_door"}}}};
+  groupNode->addChild(entityNode);
+  entityNode->addChild(
+    new Model::BrushNode{builder.createCube(16.0, "door_texture").value()});
+
+  world->defaultLayer()->addChild(new Model::PatchNode{Model::BezierPatch{
+    3,
+    3,
+    {{0, 0, 0, 0, 0},
+     {1, 0, 0, 0.5, 0},
+     {2, 0, 0, 1, 0},
+     {0, 1, 0, 0, 0.5},
+     {1, 1, 1, 0.5, 0.5},
+     {2, 1, 0, 1, 0.5},
+     {0, 2, 0, 0, 1},
+     {1, 2, 0, 0.5, 1},
+     {2, 2, 0, 1, 1}},
+    "patch_texture"}});
+
+  return world;
+}
+
+std::string writeMap(const Model::WorldNode& world, const std::string& gameName)
+{
+  auto str = std::stringstream{};
+  writeGameComment(str, gameName, Model::formatName(world.mapFormat()));
+
+  auto writer = NodeWriter{world, str};
+  writer.writeMap();
+  return str.str();
+}
+
+std::string writeSnapshot(const MapSnapshot& snapshot)
+{
+  auto str = std::stringstream{};
+  snapshot.write(str);
+  return str.str();
+}
+} // namespace
+
+TEST_CASE("MapSnapshotTest.write")
+{
+  const auto mapFormat = GENERATE(
+    Model::MapFormat::Standard,
+    Model::MapFormat::Valve,
+    Model::MapFormat::Quake2,
+    Model::MapFormat::Quake3);
+
+  CAPTURE(mapFormat);
+
+  const auto world = makeWorld(mapFormat);
+
+  const auto snapshot = MapSnapshot{*world, "Test"};
+  CHECK(writeSnapshot(snapshot) == writeMap(*world, "Test"));
+}
+
+TEST_CASE("MapSnapshotTest.writeAfterChange")
+{
+  auto world = makeWorld(Model::MapFormat::Standard);
+  const auto expected = writeMap(*world, "Test");
+
+  const auto snapshot = MapSnapshot{*world, "Test"};
+
+  // the snapshot does not depend on the world
+  auto* layerNode = world->defaultLayer();
+  auto brushNode = std::unique_ptr<Model::Node>{layerNode->children().front()};
+  layerNode->removeChild(brushNode.get());
+  REQUIRE(writeMap(*world, "Test") != expected);
+
+  CHECK(writeSnapshot(snapshot) == expected);
+}
+
+TEST_CASE("MapSnapshotTest.doesNotSetFilePositions")
+{
+  auto world = makeWorld(Model::MapFormat::Standard);
+  auto* brushNode = world->defaultLayer()->children().front();
+  brushNode->setFilePosition(100, 7);
+
+  const auto snapshot = MapSnapshot{*world, "Test"};
+  writeSnapshot(snapshot);
+
+  CHECK(brushNode->lineNumber() == 100);
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -113,6 +113,102 @@ f  8/4/6  5/3/6  6/2/6  7/1/6
 )");
 }
 
+TEST_CASE("ObjSerializer.writeBrushes")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Quake3};
+
+  // positions are only shared within a brush, texture coordinates and normals are shared
+  // by all brushes
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  map.defaultLayer()->addChild(new Model::BrushNode{
+    builder.createCuboid(vm::bbox3{{0, 0, 0}, {32, 32, 32}}, "some_texture").value()});
+  map.defaultLayer()->addChild(new Model::BrushNode{
+    builder.createCuboid(vm::bbox3{{32, 0, 0}, {64, 32, 32}}, "other_texture").value()});
+
+  auto objStream = std::ostringstream{};
+  auto mtlStream = std::ostringstream{};
+  const auto mtlFilename = "some_file_name.mtl";
+  const auto objOptions =
+    ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+
+  auto writer = NodeWriter{
+    map, std::make_unique<ObjSerializer>(objStream, mtlStream, mtlFilename, objOptions)};
+  writer.writeMap();
+
+  CHECK(objStream.str() == R"(mtllib some_file_name.mtl
+# vertices
+v 0 0 -32
+v 0 0 -0
+v 0 32 -0
+v 0 32 -32
+v 32 32 -0
+v 32 0 -0
+v 32 0 -32
+v 32 32 -32
+v 32 0 -32
+v 32 0 -0
+v 32 32 -0
+v 32 32 -32
+v 64 32 -0
+v 64 0 -0
+v 64 0 -32
+v 64 32 -32
+
+# texture coordinates
+vt 32 -0
+vt 0 -0
+vt 0 32
+vt 32 32
+vt 64 32
+vt 64 -0
+
+# normals
+vn -1 0 -0
+vn 0 0 1
+vn 0 -1 -0
+vn 0 1 -0
+vn 0 0 -1
+vn 1 0 -0
+
+o entity0_brush0
+usemtl some_texture
+f  1/1/1  2/2/1  3/3/1  4/4/1
+usemtl some_texture
+f  5/4/2  3/3/2  2/2/2  6/1/2
+usemtl some_texture
+f  6/1/3  2/2/3  1/3/3  7/4/3
+usemtl some_texture
+f  8/4/4  4/3/4  3/2/4  5/1/4
+usemtl some_texture
+f  7/1/5  1/2/5  4/3/5  8/4/5
+usemtl some_texture
+f  8/4/6  5/3/6  6/2/6  7/1/6
+
+o entity0_brush1
+usemtl other_texture
+f  9/1/1  10/2/1  11/3/1  12/4/1
+usemtl other_texture
+f  13/5/2  11/4/2  10/1/2  14/6/2
+usemtl other_texture
+f  14/6/3  10/1/3  9/4/3  15/5/3
+usemtl other_texture
+f  16/5/4  12/4/4  11/1/4  13/6/4
+usemtl other_texture
+f  15/6/5  9/1/5  12/4/5  16/5/5
+usemtl other_texture
+f  16/4/6  13/3/6  14/2/6  15/1/6
+
+)");
+
+  CHECK(mtlStream.str() == R"(newmtl other_texture
+
+newmtl some_texture
+
+)");
+}
+
 TEST_CASE("ObjSerializer.writePatch")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -22,9 +22,12 @@
 #include "IO/Reader.h"
 #include "IO/ReaderException.h"
 
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -224,5 +227,38 @@ TEST_CASE("FileReaderTest.subReader")
 {
   subReader(file()->reader());
 }
+
+TEST_CASE("FileReaderTest.readConcurrently")
+{
+  // readers of the same file may seek and read on different threads
+  const auto reader = file()->reader();
+
+  auto mismatches = std::atomic<size_t>{0};
+  auto threads = std::vector<std::thread>{};
+  for (size_t i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&, i]() {
+      for (size_t j = 0; j < 1000; ++j)
+      {
+        const auto offset = (i + j) % 10;
+        auto s = reader.subReaderFromBegin(offset, 10 - offset);
+        for (size_t k = offset; k < 10; ++k)
+        {
+          if (s.readChar<char>() != buff()[k])
+          {
+            ++mismatches;
+          }
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  CHECK(mismatches == 0u);
+}
 } // namespace IO
 } // namespace TrenchBroom
@@ -0,0 +1,272 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/ReadWalTexture.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+
+#include <kdl/result.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace IO
+{
+namespace
+{
+std::vector<std::filesystem::path> listEntries(const TextureCache& cache)
+{
+  auto result = std::vector<std::filesystem::path>{};
+  for (const auto& entry : std::filesystem::directory_iterator{cache.directory()})
+  {
+    result.push_back(entry.path());
+  }
+  return result;
+}
+
+std::vector<unsigned char> bufferData(const Assets::Texture& texture, const size_t i)
+{
+  const auto& buffer = texture.buffersIfUnprepared()[i];
+  return std::vector<unsigned char>(buffer.data(), buffer.data() + buffer.size());
+}
+
+template <typename T>
+void overwrite(const std::filesystem::path& path, const size_t offset, const T value)
+{
+  auto stream = std::fstream{path, std::ios::in | std::ios::out | std::ios::binary};
+  stream.seekp(std::streamoff(offset));
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+} // namespace
+
+TEST_CASE("TextureCache")
+{
+  auto env = TestEnvironment{};
+
+  auto fs = DiskFileSystem{IO::Disk::getCurrentWorkingDir()};
+  auto paletteFile = fs.openFile("fixture/test/colormap.pcx");
+  const auto palette = Assets::loadPalette(*paletteFile).value();
+
+  const auto file = fs.openFile("fixture/test/IO/Wal/lavatest.wal");
+  REQUIRE(file != nullptr);
+
+  auto decodeCount = size_t(0);
+  const auto decode = [&](Reader& reader) {
+    ++decodeCount;
+    return readWalTexture("lavatest", reader, palette);
+  };
+
+  const auto cache = TextureCache{env.dir() / "cache", 1024u * 1024u};
+  REQUIRE(std::filesystem::is_directory(cache.directory()));
+
+  SECTION("Decoded textures are loaded from the cache")
+  {
+    auto reader = file->reader().buffer();
+    const auto decoded =
+      decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode).value();
+    CHECK(decodeCount == 1u);
+    CHECK(listEntries(cache).size() == 1u);
+
+    reader = file->reader().buffer();
+    const auto cached =
+      decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode).value();
+    CHECK(decodeCount == 1u);
+
+    CHECK(cached.name() == decoded.name());
+    CHECK(cached.width() == decoded.width());
+    CHECK(cached.height() == decoded.height());
+    CHECK(cached.averageColor() == decoded.averageColor());
+    CHECK(cached.format() == decoded.format());
+    CHECK(cached.type() == decoded.type());
+    CHECK(cached.gameData() == decoded.gameData());
+    REQUIRE(
+      cached.buffersIfUnprepared().size() == decoded.buffersIfUnprepared().size());
+    for (size_t i = 0; i < decoded.buffersIfUnprepared().size(); ++i)
+    {
+      CHECK(bufferData(cached, i) == bufferData(decoded, i));
+    }
+  }
+
+  SECTION("Changing the decoder hash invalidates an entry")
+  {
+    auto reader = file->reader().buffer();
+    decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode).value();
+
+    reader = file->reader().buffer();
+    decodeTextureWithCache(&cache, "lavatest", *file, reader, 1, decode).value();
+    CHECK(decodeCount == 2u);
+  }
+
+  SECTION("Changing the source data invalidates an entry")
+  {
+    auto reader = file->reader().buffer();
+    const auto key = makeTextureCacheKey(
+      "lavatest", file->path(), reader.begin(), reader.end());
+    cache.store(key, decode(reader).value());
+    REQUIRE(cache.load(key) != std::nullopt);
+
+    auto changedData = std::string{reader.begin(), reader.end()};
+    changedData.back() = char(changedData.back() + 1);
+    const auto changedKey = makeTextureCacheKey(
+      "lavatest",
+      file->path(),
+      changedData.data(),
+      changedData.data() + changedData.size());
+    CHECK(cache.load(changedKey) == std::nullopt);
+  }
+
+  SECTION("Broken entries are removed")
+  {
+    auto reader = file->reader().buffer();
+    decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode).value();
+
+    const auto entries = listEntries(cache);
+    REQUIRE(entries.size() == 1u);
+    std::filesystem::resize_file(entries.front(), 16);
+
+    reader = file->reader().buffer();
+    CHECK(decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode)
+            .is_success());
+    CHECK(decodeCount == 2u);
+    CHECK(listEntries(cache).size() == 1u);
+  }
+
+  SECTION("Clearing removes all entries")
+  {
+    auto reader = file->reader().buffer();
+    decodeTextureWithCache(&cache, "lavatest", *file, reader, 0, decode).value();
+    REQUIRE(listEntries(cache).size() == 1u);
+
+    cache.clear();
+    CHECK(listEntries(cache).empty());
+  }
+}
+
+TEST_CASE("TextureCache.trim")
+{
+  auto env = TestEnvironment{};
+
+  const auto makeTexture = [](const std::string& name) {
+    auto buffers = Assets::TextureBufferList{};
+    buffers.emplace_back(1024u);
+    return Assets::Texture{
+      name,
+      16,
+      16,
+      Color{},
+      std::move(buffers),
+      GL_RGBA,
+      Assets::TextureType::Opaque};
+  };
+
+  const auto data1 = std::string{"texture1"};
+  const auto data2 = std::string{"texture2"};
+  const auto key1 = makeTextureCacheKey(
+    "texture1", "texture1", data1.data(), data1.data() + data1.size());
+  const auto key2 = makeTextureCacheKey(
+    "texture2", "texture2", data2.data(), data2.data() + data2.size());
+
+  // each entry is larger than 1024 bytes, so only one entry fits
+  const auto cache = TextureCache{env.dir() / "cache", 2000u};
+  cache.store(key1, makeTexture("texture1"));
+  cache.store(key2, makeTexture("texture2"));
+  REQUIRE(listEntries(cache).size() == 2u);
+
+  // make the first entry the least recently used one
+  for (const auto& entry : listEntries(cache))
+  {
+    std::filesystem::last_write_time(
+      entry, std::filesystem::file_time_type::clock::now() - std::chrono::hours{1});
+  }
+  REQUIRE(cache.load(key2) != std::nullopt);
+
+  cache.trim();
+  CHECK(listEntries(cache).size() == 1u);
+  CHECK(cache.load(key1) == std::nullopt);
+  CHECK(cache.load(key2) != std::nullopt);
+}
+
+TEST_CASE("TextureCache.corruptEntries")
+{
+  auto env = TestEnvironment{};
+
+  auto buffers = Assets::TextureBufferList{};
+  buffers.emplace_back(16u * 16u * 4u);
+  const auto texture = Assets::Texture{
+    "texture", 16, 16, Color{}, std::move(buffers), GL_RGBA, Assets::TextureType::Opaque};
+
+  const auto data = std::string{"texture"};
+  const auto key =
+    makeTextureCacheKey("texture", "texture", data.data(), data.data() + data.size());
+
+  const auto cache = TextureCache{env.dir() / "cache", 1024u * 1024u};
+  cache.store(key, texture);
+
+  const auto entries = listEntries(cache);
+  REQUIRE(entries.size() == 1u);
+  const auto& entry = entries.front();
+
+  // the entry ends with the buffer count, the buffer size and the buffer data
+  const auto entrySize = size_t(std::filesystem::file_size(entry));
+  const auto bufferSizeOffset = entrySize - 1024u - sizeof(uint64_t);
+  const auto bufferCountOffset = bufferSizeOffset - sizeof(uint32_t);
+
+  SECTION("Buffer count exceeds the entry")
+  {
+    overwrite(entry, bufferCountOffset, uint32_t(0xFFFFFFFF));
+  }
+
+  SECTION("Buffer size exceeds the entry")
+  {
+    overwrite(entry, bufferSizeOffset, uint64_t(0xFFFFFFFFFFFFFFFF));
+  }
+
+  SECTION("Buffer is smaller than the texture")
+  {
+    overwrite(entry, bufferSizeOffset, uint64_t(16));
+    std::filesystem::resize_file(entry, bufferSizeOffset + sizeof(uint64_t) + 16u);
+  }
+
+  SECTION("Unknown format")
+  {
+    // the format is stored before the texture type and the game data flag
+    const auto formatOffset = bufferCountOffset - 2u * sizeof(uint8_t) - sizeof(uint32_t);
+    overwrite(entry, formatOffset, uint32_t(0));
+  }
+
+  CHECK(cache.load(key) == std::nullopt);
+  CHECK(listEntries(cache).empty());
+}
+
+} // namespace IO
+} // namespace TrenchBroom
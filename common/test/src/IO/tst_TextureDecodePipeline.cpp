@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Quake3ShaderFileSystem.h"
+#include "IO/ReadQuake3ShaderTexture.h"
+#include "IO/TextureDecodePipeline.h"
+#include "IO/VirtualFileSystem.h"
+#include "Logger.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::IO
+{
+
+TEST_CASE("TextureDecodePipeline")
+{
+  auto logger = NullLogger{};
+
+  const auto testDir = Disk::getCurrentWorkingDir() / "fixture/test/IO/Shader/reader";
+  const auto fallbackDir =
+    Disk::getCurrentWorkingDir() / "fixture/test/IO/Shader/reader/fallback";
+  const auto texturePrefix = std::filesystem::path{"textures"};
+  const auto shaderSearchPath = std::filesystem::path{"scripts"};
+  const auto textureSearchPaths = std::vector<std::filesystem::path>{texturePrefix};
+
+  auto fs = VirtualFileSystem{};
+  fs.mount("", std::make_unique<DiskFileSystem>(testDir));
+  fs.mount("", std::make_unique<DiskFileSystem>(fallbackDir));
+  fs.mount(
+    "",
+    std::make_unique<Quake3ShaderFileSystem>(
+      fs, shaderSearchPath, textureSearchPaths, logger));
+
+  const auto shaderNames = std::vector<std::string>{
+    "test/with_editor_image",
+    "test/with_shader_path",
+    "test/with_light_image",
+    "test/with_stage_map",
+  };
+
+  auto preparedTextures = kdl::vec_transform(shaderNames, [&](const auto& shaderName) {
+    return prepareQuake3ShaderTexture(
+      shaderName, *fs.openFile(texturePrefix / shaderName), fs);
+  });
+
+  SECTION("Prepared shaders count the size of their editor image")
+  {
+    const auto imageFile = fs.openFile(texturePrefix / "test/editor_image.jpg");
+    CHECK(preparedTextures.front().size == imageFile->size());
+  }
+
+  SECTION("Shader collection exceeding the limit")
+  {
+    const auto maxInFlightBytes =
+      std::max_element(
+        preparedTextures.begin(),
+        preparedTextures.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.size < rhs.size; })
+        ->size;
+
+    auto totalBytes = size_t(0);
+    for (const auto& preparedTexture : preparedTextures)
+    {
+      totalBytes += preparedTexture.size;
+    }
+    REQUIRE(totalBytes > maxInFlightBytes);
+
+    // counts the bytes of the textures that were added but not decoded yet
+    auto inFlightBytes = std::atomic<std::ptrdiff_t>{0};
+    auto maxObservedInFlightBytes = std::ptrdiff_t{0};
+
+    auto pipeline = TextureDecodePipeline{maxInFlightBytes};
+    for (auto& preparedTexture : preparedTextures)
+    {
+      const auto size = std::ptrdiff_t(preparedTexture.size);
+      pipeline.add(PreparedTexture{
+        [decode = std::move(preparedTexture.decode), size, &inFlightBytes]() {
+          auto result = decode();
+          inFlightBytes -= size;
+          return result;
+        },
+        preparedTexture.size});
+
+      maxObservedInFlightBytes =
+        std::max(maxObservedInFlightBytes, inFlightBytes += size);
+    }
+
+    const auto results = pipeline.finish();
+    CHECK(maxObservedInFlightBytes <= std::ptrdiff_t(maxInFlightBytes));
+
+    REQUIRE(results.size() == shaderNames.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      CHECK_FALSE(results[i].exception);
+      REQUIRE(results[i].texture);
+      REQUIRE(results[i].texture->is_success());
+      CHECK(results[i].texture->value().name() == shaderNames[i]);
+    }
+  }
+}
+
+} // namespace TrenchBroom::IO
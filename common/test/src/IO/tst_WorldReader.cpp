@@ -17,10 +17,12 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
+#include "Logger.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceAttributes.h"
@@ -34,14 +36,19 @@
 #include "Model/WorldNode.h"
 #include "TestUtils.h"
 
+#include <kdl/vector_utils.h>
+
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
 #include <vecmath/vec.h>
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -49,6 +56,44 @@ namespace TrenchBroom
 {
 namespace IO
 {
+namespace
+{
+class RecordingParserStatus : public ParserStatus
+{
+private:
+  static NullLogger _logger;
+
+public:
+  std::vector<std::tuple<LogLevel, std::string>> messages;
+  std::vector<double> progress;
+
+  RecordingParserStatus()
+    : ParserStatus{_logger, "prefix"}
+  {
+  }
+
+private:
+  void doProgress(const double p) override { progress.push_back(p); }
+  void doLog(const LogLevel level, const std::string& str) override
+  {
+    messages.emplace_back(level, str);
+  }
+};
+
+NullLogger RecordingParserStatus::_logger;
+
+std::vector<std::tuple<std::string, size_t>> collectNodes(const Model::Node& node)
+{
+  auto result = std::vector<std::tuple<std::string, size_t>>{};
+  result.emplace_back(node.name(), node.lineNumber());
+  for (const auto* child : node.children())
+  {
+    result = kdl::vec_concat(std::move(result), collectNodes(*child));
+  }
+  return result;
+}
+} // namespace
+
 TEST_CASE("WorldReaderTest.parseEmptyMap")
 {
   const auto data = "";
@@ -1293,6 +1338,115 @@ TEST_CASE("WorldReaderTest.parseEscapedDoubleQuotationMarks")
   CHECK(*worldNode->entity().property("message") == "yay \\\"Mr. Robot!\\\"");
 }
 
+TEST_CASE("WorldReaderTest.parseInParallel")
+{
+  const auto data = std::string{R"(// Game: Quake
+// Format: Valve
+{
+"classname" "worldspawn"
+"message" "braces in strings { } \"{\" }"
+"wad" "c:\quake\"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) {grate [ 0 -1 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) {grate [ 1 0 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) "{quoted }" [ -1 0 0 -0 ] [ 0 -1 0 -0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) __TB_empty [ 1 0 0 -0 ] [ 0 -1 0 -0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) __TB_empty [ -1 0 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) __TB_empty [ 0 1 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+}
+}
+; a Heretic 2 comment }
+{
+"classname" "light"
+"origin" "0 0 0"
+"origin" "1 1 1"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "Unnamed"
+"_tb_id" "1"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex [ 0 -1 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex [ 1 0 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex [ -1 0 0 -0 ] [ 0 -1 0 -0 ] 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex [ 1 0 0 -0 ] [ 0 -1 0 -0 ] 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex [ -1 0 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex [ 0 1 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+( 64 64 16 ) ( 64 64 16 ) ( 64 65 16 ) tex [ 0 1 0 -0 ] [ 0 0 -1 -0 ] 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+"_tb_group" "1"
+}
+{
+"classname" "info_null"
+"_tb_group" "2"
+})"};
+
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto serialStatus = RecordingParserStatus{};
+  auto serialReader = WorldReader{data, Model::MapFormat::Valve, {}};
+  const auto serialWorld = serialReader.read(worldBounds, serialStatus);
+
+  auto parallelStatus = RecordingParserStatus{};
+  auto parallelReader = WorldReader{data, Model::MapFormat::Valve, {}};
+  parallelReader.setParallelParseChunkSize(1);
+  const auto parallelWorld = parallelReader.read(worldBounds, parallelStatus);
+
+  REQUIRE(serialWorld != nullptr);
+  REQUIRE(parallelWorld != nullptr);
+
+  // duplicate property, invalid face and invalid group ID
+  CHECK(serialStatus.messages.size() == 3u);
+  CHECK(parallelStatus.messages == serialStatus.messages);
+  CHECK(collectNodes(*parallelWorld) == collectNodes(*serialWorld));
+  CHECK(parallelWorld->entity() == serialWorld->entity());
+
+  // progress is reported whenever a chunk has been parsed
+  REQUIRE(parallelStatus.progress.size() > 1u);
+  CHECK(std::is_sorted(parallelStatus.progress.begin(), parallelStatus.progress.end()));
+  CHECK(parallelStatus.progress.back() == 1.0);
+
+  SECTION("Falls back to serial parsing on errors")
+  {
+    const auto invalidData = data + "\n{\n\"classname\" \"light\"\n( }";
+
+    auto expectedStatus = RecordingParserStatus{};
+    auto expectedReader = WorldReader{invalidData, Model::MapFormat::Valve, {}};
+    auto expectedError = std::string{};
+    try
+    {
+      expectedReader.read(worldBounds, expectedStatus);
+    }
+    catch (const ParserException& e)
+    {
+      expectedError = e.what();
+    }
+
+    auto status = RecordingParserStatus{};
+    auto reader = WorldReader{invalidData, Model::MapFormat::Valve, {}};
+    reader.setParallelParseChunkSize(1);
+    auto error = std::string{};
+    try
+    {
+      reader.read(worldBounds, status);
+    }
+    catch (const ParserException& e)
+    {
+      error = e.what();
+    }
+
+    CHECK_FALSE(expectedError.empty());
+    CHECK(error == expectedError);
+    CHECK(status.messages == expectedStatus.messages);
+  }
+}
+
 TEST_CASE("WorldReaderTest.parsePropertyWithUnescapedPathAndTrailingBackslash")
 {
   const auto data = R"(
@@ -2248,6 +2248,67 @@ TEST_CASE("moveFaceWithUVLock")
   }
 }
 
+TEST_CASE("BrushTest.applyPreparedVertexMove")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto uvLock = GENERATE(false, true);
+
+  auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+  const auto brush = builder.createCube(64.0, "asdf").value();
+
+  const auto topFace =
+    vm::polygon3{brush.face(*brush.findFace(vm::vec3::pos_z())).vertexPositions()};
+  const auto topEdge = vm::segment3{topFace.vertices()[0], topFace.vertices()[1]};
+  const auto topVertex = topFace.vertices()[0];
+
+  SECTION("Vertices")
+  {
+    const auto delta = vm::vec3{8.0, 8.0, 8.0};
+    auto expected = brush;
+    REQUIRE(expected.moveVertices(worldBounds, {topVertex}, delta, uvLock).is_success());
+
+    auto actual = brush;
+    auto move = actual.prepareMoveVertices(worldBounds, {topVertex}, delta);
+    REQUIRE(move);
+    REQUIRE(actual.applyVertexMove(worldBounds, std::move(*move), uvLock).is_success());
+    CHECK(actual == expected);
+
+    CHECK_FALSE(brush.prepareMoveVertices(worldBounds, {topVertex}, vm::vec3::zero()));
+  }
+
+  SECTION("Edges")
+  {
+    const auto delta = vm::vec3{0.0, 0.0, 16.0};
+    auto expected = brush;
+    REQUIRE(expected.moveEdges(worldBounds, {topEdge}, delta, uvLock).is_success());
+
+    auto actual = brush;
+    auto move = actual.prepareMoveEdges(worldBounds, {topEdge}, delta);
+    REQUIRE(move);
+    REQUIRE(actual.applyVertexMove(worldBounds, std::move(*move), uvLock).is_success());
+    CHECK(actual == expected);
+
+    CHECK_FALSE(
+      brush.prepareMoveEdges(worldBounds, {topEdge}, vm::vec3{0.0, 0.0, 8192.0}));
+  }
+
+  SECTION("Faces")
+  {
+    const auto delta = vm::vec3{8.0, 0.0, 0.0};
+    auto expected = brush;
+    REQUIRE(expected.moveFaces(worldBounds, {topFace}, delta, uvLock).is_success());
+
+    auto actual = brush;
+    auto move = actual.prepareMoveFaces(worldBounds, {topFace}, delta);
+    REQUIRE(move);
+    REQUIRE(actual.applyVertexMove(worldBounds, std::move(*move), uvLock).is_success());
+    CHECK(actual == expected);
+
+    CHECK_FALSE(
+      brush.prepareMoveFaces(worldBounds, {topFace}, vm::vec3{0.0, 0.0, 8192.0}));
+  }
+}
+
 TEST_CASE("BrushTest.subtractCuboidFromCuboid")
 {
   const vm::bbox3 worldBounds(4096.0);
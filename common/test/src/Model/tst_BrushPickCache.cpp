@@ -0,0 +1,182 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/BrushPickCache.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/ray.h>
+#include <vecmath/scalar.h>
+#include <vecmath/vec.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+std::optional<std::tuple<FloatType, size_t>> findFaceHitNaive(
+  const Brush& brush, const vm::ray3& ray)
+{
+  for (size_t i = 0u; i < brush.faceCount(); ++i)
+  {
+    const auto distance = brush.face(i).intersectWithRay(ray);
+    if (!vm::is_nan(distance))
+    {
+      return std::make_tuple(distance, i);
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<vm::vec3> makePrismPoints(const size_t sides)
+{
+  auto result = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < sides; ++i)
+  {
+    const auto angle = 2.0 * vm::constants<double>::pi() * double(i) / double(sides);
+    const auto x = std::round(64.0 * std::cos(angle));
+    const auto y = std::round(64.0 * std::sin(angle));
+    result.emplace_back(x, y, -32.0);
+    result.emplace_back(x, y, 32.0);
+  }
+  return result;
+}
+
+void checkRay(const Brush& brush, const BrushPickCache& cache, const vm::ray3& ray)
+{
+  CAPTURE(ray.origin, ray.direction);
+  CHECK(cache.findFaceHit(brush, ray) == findFaceHitNaive(brush, ray));
+}
+} // namespace
+
+TEST_CASE("BrushPickCache.findFaceHit")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto rotatedCuboid = builder.createCuboid(vm::vec3{64, 32, 16}, "texture").value();
+  REQUIRE(rotatedCuboid
+            .transform(
+              worldBounds,
+              vm::rotation_matrix(vm::normalize(vm::vec3{1, 2, 3}), vm::to_radians(30.0)),
+              false)
+            .is_success());
+
+  using T = std::tuple<std::string, Brush>;
+
+  // clang-format off
+  const auto
+  [name,                      brush] = GENERATE_REF(values<T>({
+  {"cube",                    builder.createCube(64.0, "texture").value()},
+  {"rotated cuboid",          rotatedCuboid},
+  {"octagonal prism",         builder.createBrush(makePrismPoints(8), "tex").value()},
+  {"24 sided prism",          builder.createBrush(makePrismPoints(24), "tex").value()},
+  {"irregular brush",         builder.createBrush(std::vector<vm::vec3>{
+                                {-32, -16, -40},
+                                { 48, -32, -24},
+                                { 16,  56, -32},
+                                {-40,  24,  -8},
+                                {  8,   0,  64},
+                                { 24, -24,  40},
+                              }, "texture").value()},
+  }));
+  // clang-format on
+
+  CAPTURE(name);
+
+  const auto cache = BrushPickCache{brush};
+  const auto bounds = brush.bounds();
+
+  auto randEngine = std::mt19937{};
+  auto coord = std::uniform_real_distribution<double>{-128.0, 128.0};
+
+  SECTION("Random rays")
+  {
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      const auto origin =
+        vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)};
+      const auto target =
+        vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)};
+      checkRay(brush, cache, vm::ray3{origin, vm::normalize(target - origin)});
+    }
+  }
+
+  SECTION("Rays towards the vertices")
+  {
+    for (const auto* vertex : brush.vertices())
+    {
+      for (size_t i = 0; i < 20; ++i)
+      {
+        const auto origin =
+          vm::vec3{coord(randEngine), coord(randEngine), coord(randEngine)};
+        checkRay(
+          brush, cache, vm::ray3{origin, vm::normalize(vertex->position() - origin)});
+      }
+    }
+  }
+
+  SECTION("Axis aligned rays on a grid")
+  {
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+      const auto u = (axis + 1u) % 3u;
+      const auto v = (axis + 2u) % 3u;
+      for (auto a = std::floor(bounds.min[u]); a <= bounds.max[u]; a += 8.0)
+      {
+        for (auto b = std::floor(bounds.min[v]); b <= bounds.max[v]; b += 8.0)
+        {
+          auto origin = vm::vec3{};
+          origin[axis] = bounds.min[axis] - 16.0;
+          origin[u] = a;
+          origin[v] = b;
+
+          auto direction = vm::vec3{};
+          direction[axis] = 1.0;
+          checkRay(brush, cache, vm::ray3{origin, direction});
+
+          origin[axis] = bounds.max[axis] + 16.0;
+          direction[axis] = -1.0;
+          checkRay(brush, cache, vm::ray3{origin, direction});
+        }
+      }
+    }
+  }
+}
+
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/BezierPatch.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushError.h"
+#include "Model/BrushFace.h"
+#include "Model/CompactNodeContents.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeContents.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <variant>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+TEST_CASE("CompactNodeContentsTest.restoreBrush")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brush = builder.createCube(64.0, "texture").value();
+  REQUIRE(brush.transform(worldBounds, vm::rotation_matrix(0.1, 0.2, 0.3), false)
+            .is_success());
+
+  const auto compactContents = CompactNodeContents{NodeContents{brush}};
+  CHECK(
+    compactContents.memoryUsage()
+    >= brush.faceCount() * (sizeof(BrushFace) + sizeof(ParaxialTexCoordSystem)));
+
+  const auto restoredContents = compactContents.restore(worldBounds);
+  REQUIRE(restoredContents.is_success());
+
+  const auto& restoredBrush = std::get<Brush>(restoredContents.value().get());
+  CHECK(restoredBrush == brush);
+  CHECK(restoredBrush.vertexPositions() == brush.vertexPositions());
+  CHECK(restoredBrush.bounds() == brush.bounds());
+
+  // the stored contents can be restored again
+  CHECK(compactContents.restore(worldBounds).is_success());
+}
+
+TEST_CASE("CompactNodeContentsTest.restoreEntity")
+{
+  const auto entity = Entity{{}, {{"classname", "light"}, {"origin", "1 2 3"}}};
+
+  const auto compactContents = CompactNodeContents{NodeContents{entity}};
+  CHECK(compactContents.memoryUsage() >= sizeof(Entity));
+
+  const auto restoredContents = compactContents.restore(vm::bbox3{8192.0});
+  REQUIRE(restoredContents.is_success());
+  CHECK(std::get<Entity>(restoredContents.value().get()) == entity);
+}
+
+TEST_CASE("CompactNodeContentsTest.memoryUsageOfParallelTexCoordSystems")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Valve, worldBounds};
+  const auto brush = builder.createCube(64.0, "texture").value();
+
+  const auto compactContents = CompactNodeContents{NodeContents{brush}};
+  CHECK(
+    compactContents.memoryUsage()
+    >= brush.faceCount() * (sizeof(BrushFace) + sizeof(ParallelTexCoordSystem)));
+}
+
+TEST_CASE("CompactNodeContentsTest.restoreInvalidBrush")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto brush = builder.createCube(64.0, "texture").value();
+  const auto compactContents = CompactNodeContents{NodeContents{brush}};
+
+  // the brush does not fit into these world bounds
+  CHECK(compactContents.restore(vm::bbox3{16.0}).is_error());
+}
+} // namespace Model
+} // namespace TrenchBroom
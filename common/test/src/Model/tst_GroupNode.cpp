@@ -27,6 +27,7 @@
 #include "Model/GroupNode.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
+#include "Model/NodeContents.h"
 #include "Model/PatchNode.h"
 #include "Model/UpdateLinkedGroupsError.h"
 #include "Model/WorldNode.h"
@@ -621,5 +622,176 @@ TEST_CASE("GroupNodeTest.updateLinkedGroupsAndPreserveEntityProperties")
     })
     .transform_error([](const auto&) { FAIL(); });
 }
+
+TEST_CASE("GroupNodeTest.updateLinkedGroupNodes")
+{
+  const auto worldBounds = vm::bbox3(8192.0);
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* nestedGroupNode = new GroupNode{Group{"nested"}};
+  auto* nestedEntityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode, nestedGroupNode});
+  nestedGroupNode->addChild(nestedEntityNode);
+
+  transformNode(groupNode, vm::translation_matrix(vm::vec3(1.0, 0.0, 0.0)), worldBounds);
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+  transformNode(
+    *groupNodeClone, vm::translation_matrix(vm::vec3(0.0, 2.0, 0.0)), worldBounds);
+  setGroupName(*static_cast<GroupNode*>(groupNodeClone->children().back()), "other");
+
+  auto* entityNodeClone = static_cast<EntityNode*>(groupNodeClone->children().front());
+  auto* nestedEntityNodeClone =
+    static_cast<EntityNode*>(groupNodeClone->children().back()->children().front());
+
+  transformNode(
+    *nestedEntityNode, vm::translation_matrix(vm::vec3(0.0, 0.0, 3.0)), worldBounds);
+  REQUIRE(nestedEntityNode->entity().origin() == vm::vec3(1.0, 0.0, 3.0));
+
+  SECTION("Target group list contains only source group")
+  {
+    updateLinkedGroupNodes(groupNode, {nestedEntityNode}, {&groupNode}, worldBounds)
+      .transform([&](const UpdateLinkedGroupNodesResult& r) { CHECK(r.empty()); })
+      .transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Update only the corresponding nodes")
+  {
+    updateLinkedGroupNodes(
+      groupNode, {nestedEntityNode}, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const UpdateLinkedGroupNodesResult& r) {
+        REQUIRE(r.size() == 1u);
+
+        const auto& [nodeToUpdate, newContents] = r.front();
+        CHECK(nodeToUpdate == nestedEntityNodeClone);
+        CHECK(
+          std::get<Entity>(newContents.get()).origin() == vm::vec3(1.0, 2.0, 3.0));
+      })
+      .transform_error([](const auto&) { FAIL(); });
+
+    CHECK(entityNodeClone->entity().origin() == vm::vec3(1.0, 2.0, 0.0));
+  }
+
+  SECTION("Preserve nested group names")
+  {
+    updateLinkedGroupNodes(
+      groupNode, {nestedGroupNode}, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const UpdateLinkedGroupNodesResult& r) {
+        REQUIRE(r.size() == 1u);
+
+        const auto& [nodeToUpdate, newContents] = r.front();
+        CHECK(nodeToUpdate == groupNodeClone->children().back());
+        CHECK(std::get<Group>(newContents.get()).name() == "other");
+      })
+      .transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Fail if the target group has no corresponding node")
+  {
+    auto nestedGroupNodeClone = std::unique_ptr<Node>{nestedEntityNodeClone->parent()};
+    groupNodeClone->removeChild(nestedGroupNodeClone.get());
+
+    updateLinkedGroupNodes(
+      groupNode, {nestedEntityNode}, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const UpdateLinkedGroupNodesResult&) { FAIL(); })
+      .transform_error([](const UpdateLinkedGroupsError& e) {
+        CHECK(e == UpdateLinkedGroupsError::UpdateIsInconsistent);
+      });
+  }
+
+  SECTION("Fail if the target group's children are in a different order")
+  {
+    groupNodeClone->removeChild(entityNodeClone);
+    groupNodeClone->addChild(entityNodeClone);
+
+    updateLinkedGroupNodes(groupNode, {entityNode}, {groupNodeClone.get()}, worldBounds)
+      .transform([&](const UpdateLinkedGroupNodesResult&) { FAIL(); })
+      .transform_error([](const UpdateLinkedGroupsError& e) {
+        CHECK(e == UpdateLinkedGroupsError::UpdateIsInconsistent);
+      });
+  }
+}
+
+TEST_CASE("GroupNodeTest.canUpdateLinkedGroupNodes")
+{
+  const auto worldBounds = vm::bbox3(8192.0);
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* nestedGroupNode = new GroupNode{Group{"nested"}};
+  auto* nestedEntityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode, nestedGroupNode});
+  nestedGroupNode->addChild(nestedEntityNode);
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds))};
+  auto* entityNodeClone = groupNodeClone->children().front();
+  auto* nestedGroupNodeClone = groupNodeClone->children().back();
+
+  CHECK(canUpdateLinkedGroupNodes(groupNode, {nestedEntityNode}, *groupNodeClone));
+
+  SECTION("Children in a different order")
+  {
+    groupNodeClone->removeChild(entityNodeClone);
+    groupNodeClone->addChild(entityNodeClone);
+
+    CHECK_FALSE(canUpdateLinkedGroupNodes(groupNode, {entityNode}, *groupNodeClone));
+    CHECK_FALSE(
+      canUpdateLinkedGroupNodes(groupNode, {nestedEntityNode}, *groupNodeClone));
+  }
+
+  SECTION("Additional children below a node on the path")
+  {
+    nestedGroupNodeClone->addChild(new EntityNode{Entity{}});
+
+    CHECK(canUpdateLinkedGroupNodes(groupNode, {entityNode}, *groupNodeClone));
+    CHECK_FALSE(
+      canUpdateLinkedGroupNodes(groupNode, {nestedEntityNode}, *groupNodeClone));
+  }
+}
+
+TEST_CASE("GroupNodeTest.addPendingContentChanges")
+{
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* otherEntityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode, otherEntityNode});
+
+  REQUIRE_FALSE(groupNode.hasPendingChanges());
+
+  SECTION("Adding no changes does not set pending changes")
+  {
+    groupNode.addPendingContentChanges({});
+    CHECK_FALSE(groupNode.hasPendingChanges());
+  }
+
+  SECTION("Content changes are accumulated")
+  {
+    groupNode.addPendingContentChanges({entityNode});
+    groupNode.addPendingContentChanges({otherEntityNode});
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(
+      groupNode.nodesWithPendingContentChanges()
+      == std::vector<Node*>{entityNode, otherEntityNode});
+  }
+
+  SECTION("Other pending changes require a full update")
+  {
+    groupNode.setHasPendingChanges(true);
+    groupNode.addPendingContentChanges({entityNode});
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(groupNode.nodesWithPendingContentChanges().empty());
+  }
+
+  SECTION("Clearing pending changes clears content changes")
+  {
+    groupNode.addPendingContentChanges({entityNode});
+    groupNode.setHasPendingChanges(false);
+    CHECK_FALSE(groupNode.hasPendingChanges());
+    CHECK(groupNode.nodesWithPendingContentChanges().empty());
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
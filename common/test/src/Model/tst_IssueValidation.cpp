@@ -0,0 +1,271 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Assets/EntityModel.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Issue.h"
+#include "Model/IssueValidation.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/Validator.h"
+#include "Model/WorldNode.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Model
+{
+namespace
+{
+/**
+ * Finds an issue for every brush and counts how often it validated a brush.
+ */
+class TestBrushValidator : public Validator
+{
+public:
+  mutable std::atomic<size_t> validatedCount = 0;
+
+  TestBrushValidator()
+    : Validator{freeIssueType(), "Test brush validator", IssueDependency::Geometry}
+  {
+  }
+
+private:
+  void doValidate(
+    BrushNode& brushNode, std::vector<std::unique_ptr<Issue>>& issues) const override
+  {
+    ++validatedCount;
+    issues.push_back(std::make_unique<Issue>(type(), brushNode, "brush"));
+  }
+};
+
+/**
+ * Finds an issue for every entity and counts how often it validated an entity.
+ */
+class TestEntityValidator : public Validator
+{
+public:
+  mutable std::atomic<size_t> validatedCount = 0;
+
+  TestEntityValidator()
+    : Validator{freeIssueType(), "Test entity validator", IssueDependency::Properties}
+  {
+  }
+
+private:
+  void doValidate(
+    EntityNode& entityNode, std::vector<std::unique_ptr<Issue>>& issues) const override
+  {
+    ++validatedCount;
+    issues.push_back(std::make_unique<Issue>(type(), entityNode, "entity"));
+  }
+};
+
+/**
+ * Finds an issue for every entity and counts how often it validated an entity, but only
+ * depends on the geometry of the entities.
+ */
+class TestEntityBoundsValidator : public Validator
+{
+public:
+  mutable std::atomic<size_t> validatedCount = 0;
+
+  TestEntityBoundsValidator()
+    : Validator{
+        freeIssueType(), "Test entity bounds validator", IssueDependency::Geometry}
+  {
+  }
+
+private:
+  void doValidate(
+    EntityNode& entityNode, std::vector<std::unique_ptr<Issue>>& issues) const override
+  {
+    ++validatedCount;
+    issues.push_back(std::make_unique<Issue>(type(), entityNode, "entity bounds"));
+  }
+};
+} // namespace
+
+TEST_CASE("IssueValidation.validateIssues")
+{
+  constexpr auto mapFormat = MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto world = WorldNode{{}, {}, mapFormat};
+
+  auto nodes = std::vector<Node*>{};
+  for (size_t i = 0; i < 100; ++i)
+  {
+    auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+    auto* entityNode = new EntityNode{Entity{}};
+    world.defaultLayer()->addChild(brushNode);
+    world.defaultLayer()->addChild(entityNode);
+    nodes.push_back(brushNode);
+    nodes.push_back(entityNode);
+  }
+
+  auto brushValidator = TestBrushValidator{};
+  auto entityValidator = TestEntityValidator{};
+  const auto validators =
+    std::vector<const Validator*>{&brushValidator, &entityValidator};
+
+  const auto issues = validateIssues(nodes, validators);
+
+  SECTION("Issues are returned in the order of the nodes")
+  {
+    REQUIRE(issues.size() == nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      CHECK(&issues[i]->node() == nodes[i]);
+    }
+  }
+
+  SECTION("New issues are numbered in the order of the nodes")
+  {
+    for (size_t i = 1; i < issues.size(); ++i)
+    {
+      CHECK(issues[i - 1]->seqId() < issues[i]->seqId());
+    }
+  }
+
+  SECTION("Valid nodes are not validated again")
+  {
+    CHECK(validateIssues(nodes, validators) == issues);
+    CHECK(brushValidator.validatedCount == 100u);
+    CHECK(entityValidator.validatedCount == 100u);
+  }
+
+  SECTION("Changing the properties of an entity only runs validators that depend on them")
+  {
+    auto* entityNode = static_cast<EntityNode*>(nodes[1]);
+    entityNode->setEntity(Entity{{}, {{"classname", "info_player_start"}}});
+
+    const auto newIssues = validateIssues(nodes, validators);
+    CHECK(brushValidator.validatedCount == 100u);
+    CHECK(entityValidator.validatedCount == 101u);
+
+    // the issue of the entity was replaced, the issues of the brushes were kept
+    CHECK(newIssues[0] == issues[0]);
+    CHECK(newIssues[1]->seqId() > issues.back()->seqId());
+    CHECK(&newIssues[1]->node() == entityNode);
+  }
+
+  SECTION("Changing the geometry of a brush only runs validators that depend on it")
+  {
+    auto* brushNode = static_cast<BrushNode*>(nodes[0]);
+    auto brush = brushNode->brush();
+    REQUIRE(
+      brush.transform(worldBounds, vm::translation_matrix(vm::vec3{16, 0, 0}), false)
+        .is_success());
+    brushNode->setBrush(std::move(brush));
+
+    const auto newIssues = validateIssues(nodes, validators);
+    CHECK(brushValidator.validatedCount == 101u);
+    CHECK(entityValidator.validatedCount == 100u);
+
+    CHECK(newIssues[0]->seqId() > issues.back()->seqId());
+    CHECK(newIssues[1] == issues[1]);
+  }
+
+  SECTION("Invalidating all issues runs every validator again")
+  {
+    for (auto* node : nodes)
+    {
+      node->invalidateIssues();
+    }
+
+    const auto newIssues = validateIssues(nodes, validators);
+    CHECK(brushValidator.validatedCount == 200u);
+    CHECK(entityValidator.validatedCount == 200u);
+    CHECK(newIssues.size() == issues.size());
+  }
+}
+
+TEST_CASE("IssueValidation.entityBounds")
+{
+  constexpr auto mapFormat = MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto world = WorldNode{{}, {}, mapFormat};
+
+  auto* pointEntityNode = new EntityNode{Entity{}};
+  auto* brushEntityNode = new EntityNode{Entity{}};
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  world.defaultLayer()->addChildren({pointEntityNode, brushEntityNode});
+  brushEntityNode->addChild(brushNode);
+
+  const auto nodes = std::vector<Node*>{pointEntityNode, brushEntityNode};
+
+  auto validator = TestEntityBoundsValidator{};
+  const auto validators = std::vector<const Validator*>{&validator};
+
+  validateIssues(nodes, validators);
+  REQUIRE(validator.validatedCount == 2u);
+
+  SECTION("Setting a model that changes the bounds of an entity")
+  {
+    auto model = Assets::EntityModel{
+      "model", Assets::PitchType::Normal, Assets::Orientation::Oriented};
+    model.addFrame();
+    const auto& frame = model.loadFrame(0, "frame", vm::bbox3f{256.0f});
+
+    pointEntityNode->setModelFrame(&frame);
+    validateIssues(nodes, validators);
+    CHECK(validator.validatedCount == 3u);
+
+    pointEntityNode->setModelFrame(&frame);
+    validateIssues(nodes, validators);
+    CHECK(validator.validatedCount == 3u);
+  }
+
+  SECTION("Changing the geometry of a brush entity's child")
+  {
+    auto brush = brushNode->brush();
+    REQUIRE(
+      brush.transform(worldBounds, vm::translation_matrix(vm::vec3{16, 0, 0}), false)
+        .is_success());
+    brushNode->setBrush(std::move(brush));
+
+    validateIssues(nodes, validators);
+    CHECK(validator.validatedCount == 3u);
+  }
+}
+
+} // namespace Model
+} // namespace TrenchBroom
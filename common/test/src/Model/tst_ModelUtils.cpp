@@ -479,6 +479,66 @@ TEST_CASE("ModelUtils.collectTouchingNodes")
       std::vector<Node*>{&groupNode, &entityNode, &brushNode, &patchNode}));
 }
 
+TEST_CASE("ModelUtils.collectTouchingNodesInWorld")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* layerNode = worldNode.defaultLayer();
+
+  auto* brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  auto* farBrushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+  transformNode(
+    *farBrushNode, vm::translation_matrix(vm::vec3d{1024, 0, 0}), worldBounds);
+
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* groupedBrushNode = new BrushNode{builder.createCube(32.0, "texture").value()};
+  groupNode->addChild(groupedBrushNode);
+
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* entityBrushNode = new BrushNode{builder.createCube(16.0, "texture").value()};
+  entityNode->addChild(entityBrushNode);
+
+  layerNode->addChildren({brushNode, farBrushNode, groupNode, entityNode});
+
+  auto touchesOrigin = BrushNode{builder.createCube(24.0, "texture").value()};
+
+  // the world's spatial index is used when the world is passed, the layer is searched
+  // exhaustively
+  const auto worldNodes = std::vector<Node*>{&worldNode};
+  const auto layerNodes = std::vector<Node*>{layerNode};
+
+  const auto expected = std::vector<Node*>{brushNode, groupNode, entityBrushNode};
+  CHECK_THAT(
+    collectTouchingNodes(worldNodes, {&touchesOrigin}),
+    Catch::Matchers::Equals(expected));
+  CHECK_THAT(
+    collectTouchingNodes(layerNodes, {&touchesOrigin}),
+    Catch::Matchers::Equals(expected));
+
+  // the spatial index is updated when a node is moved
+  transformNode(
+    *farBrushNode, vm::translation_matrix(vm::vec3d{-1024, 0, 0}), worldBounds);
+
+  const auto expectedAfterMove =
+    std::vector<Node*>{brushNode, farBrushNode, groupNode, entityBrushNode};
+  CHECK_THAT(
+    collectTouchingNodes(worldNodes, {&touchesOrigin}),
+    Catch::Matchers::Equals(expectedAfterMove));
+  CHECK_THAT(
+    collectContainedNodes(worldNodes, {&touchesOrigin}),
+    Catch::Matchers::Equals(std::vector<Node*>{entityBrushNode}));
+
+  // query brushes are not counted as touching themselves
+  CHECK_THAT(
+    collectTouchingNodes(worldNodes, {brushNode}),
+    Catch::Matchers::Equals(
+      std::vector<Node*>{farBrushNode, groupNode, entityBrushNode}));
+}
+
 TEST_CASE("ModelUtils.collectContainedNodes")
 {
   constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -406,6 +406,25 @@ TEST_CASE("NodeTest.replaceChildren")
   CHECK(child3->parent() == &root);
 }
 
+TEST_CASE("NodeTest.insertChildren")
+{
+  auto root = TestNode{};
+  auto* child1 = new TestNode{};
+  auto* child2 = new TestNode{};
+  auto* child3 = new TestNode{};
+  auto* child4 = new TestNode{};
+  auto* child5 = new TestNode{};
+
+  root.addChildren({child2, child4});
+  root.insertChildren({{4, child5}, {0, child1}, {2, child3}});
+
+  CHECK(root.children() == std::vector<Node*>{child1, child2, child3, child4, child5});
+  CHECK(child1->parent() == &root);
+  CHECK(child3->parent() == &root);
+  CHECK(child5->parent() == &root);
+  CHECK(root.descendantCount() == 5u);
+}
+
 TEST_CASE("NodeTest.partialSelection")
 {
   TestNode root;
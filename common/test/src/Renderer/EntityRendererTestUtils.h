@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Renderer/EntityRenderer.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+/**
+ * Validates the bounds of an entity renderer and exposes its bounds vertex arrays without
+ * rendering, which would require an OpenGL context.
+ */
+class EntityRendererTestAccess
+{
+public:
+  static void validateBounds(EntityRenderer& renderer) { renderer.validateBounds(); }
+
+  static const auto& pointEntityWireframeVertices(const EntityRenderer& renderer)
+  {
+    return renderer.m_pointEntityWireframeVertices;
+  }
+
+  static const auto& brushEntityWireframeVertices(const EntityRenderer& renderer)
+  {
+    return renderer.m_brushEntityWireframeVertices;
+  }
+
+  static const auto& solidVertices(const EntityRenderer& renderer)
+  {
+    return renderer.m_solidVertices;
+  }
+};
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,244 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/EntityModelManager.h"
+#include "Logger.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/MapFormat.h"
+#include "Model/VisibilityState.h"
+#include "Renderer/EntityRenderer.h"
+#include "Renderer/EntityRendererTestUtils.h"
+#include "Renderer/GLVertex.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+Model::Entity makePointEntity(const vm::vec3& origin)
+{
+  return Model::Entity{
+    {},
+    {{"classname", "info_null"},
+     {"origin",
+      std::to_string(origin.x()) + " " + std::to_string(origin.y()) + " "
+        + std::to_string(origin.z())}}};
+}
+
+std::vector<vm::vec3f> wireframePositions(const vm::bbox3& bounds)
+{
+  auto positions = std::vector<vm::vec3f>{};
+  bounds.for_each_edge([&](const vm::vec3& v1, const vm::vec3& v2) {
+    positions.push_back(vm::vec3f(v1));
+    positions.push_back(vm::vec3f(v2));
+  });
+  return positions;
+}
+
+std::vector<vm::vec3f> solidPositions(const vm::bbox3& bounds)
+{
+  auto positions = std::vector<vm::vec3f>{};
+  bounds.for_each_face([&](
+                         const vm::vec3& v1,
+                         const vm::vec3& v2,
+                         const vm::vec3& v3,
+                         const vm::vec3& v4,
+                         const vm::vec3&) {
+    positions.push_back(vm::vec3f(v1));
+    positions.push_back(vm::vec3f(v2));
+    positions.push_back(vm::vec3f(v3));
+    positions.push_back(vm::vec3f(v4));
+  });
+  return positions;
+}
+
+/**
+ * Checks that the given bounds vertex array contains one slot for each of the given
+ * entities and that the vertices of every slot match the bounds of its entity.
+ */
+template <typename BoundsVertexArray, typename GetPositions>
+void checkSlots(
+  const BoundsVertexArray& array,
+  const std::vector<const Model::EntityNode*>& expectedEntities,
+  const GetPositions& getPositions)
+{
+  CHECK_THAT(array.entities, Catch::UnorderedEquals(expectedEntities));
+
+  const auto verticesPerSlot = getPositions(vm::bbox3{}).size();
+  REQUIRE(array.vertices.size() == array.entities.size() * verticesPerSlot);
+
+  for (size_t i = 0; i < array.entities.size(); ++i)
+  {
+    auto positions = std::vector<vm::vec3f>{};
+    for (size_t j = 0; j < verticesPerSlot; ++j)
+    {
+      positions.push_back(getVertexComponent<0>(array.vertices[i * verticesPerSlot + j]));
+    }
+    CHECK(positions == getPositions(array.entities[i]->logicalBounds()));
+  }
+}
+
+void checkBounds(
+  const EntityRenderer& renderer,
+  const std::vector<const Model::EntityNode*>& expectedSolidEntities,
+  const std::vector<const Model::EntityNode*>& expectedPointEntityWireframeEntities,
+  const std::vector<const Model::EntityNode*>& expectedBrushEntityWireframeEntities)
+{
+  checkSlots(
+    EntityRendererTestAccess::solidVertices(renderer),
+    expectedSolidEntities,
+    solidPositions);
+  checkSlots(
+    EntityRendererTestAccess::pointEntityWireframeVertices(renderer),
+    expectedPointEntityWireframeEntities,
+    wireframePositions);
+  checkSlots(
+    EntityRendererTestAccess::brushEntityWireframeVertices(renderer),
+    expectedBrushEntityWireframeEntities,
+    wireframePositions);
+}
+} // namespace
+
+TEST_CASE("EntityRendererTest.validateBounds")
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  constexpr auto mapFormat = Model::MapFormat::Standard;
+
+  auto pointEntity1 = Model::EntityNode{makePointEntity({0, 0, 0})};
+  auto pointEntity2 = Model::EntityNode{makePointEntity({64, 0, 0})};
+  auto pointEntity3 = Model::EntityNode{makePointEntity({128, 0, 0})};
+  const auto pointEntities =
+    std::vector<const Model::EntityNode*>{&pointEntity1, &pointEntity2, &pointEntity3};
+
+  auto brushEntity = Model::EntityNode{Model::Entity{{}, {{"classname", "func_door"}}}};
+  brushEntity.addChild(new Model::BrushNode{
+    Model::BrushBuilder{mapFormat, worldBounds}.createCube(64.0, "texture").value()});
+
+  auto logger = NullLogger{};
+  auto entityModelManager = Assets::EntityModelManager{0, 0, logger};
+  const auto editorContext = Model::EditorContext{};
+  auto renderer = EntityRenderer{logger, entityModelManager, editorContext};
+
+  renderer.addEntity(&pointEntity1);
+  renderer.addEntity(&pointEntity2);
+  renderer.addEntity(&pointEntity3);
+  renderer.addEntity(&brushEntity);
+  EntityRendererTestAccess::validateBounds(renderer);
+
+  // point entities without a model have solid bounds, brush entities wireframe bounds
+  checkBounds(renderer, pointEntities, {}, {&brushEntity});
+
+  SECTION("Removing an entity")
+  {
+    const auto& solidEntities =
+      EntityRendererTestAccess::solidVertices(renderer).entities;
+    REQUIRE(solidEntities.size() == 3u);
+
+    // removing an entity from a middle slot moves the last slot into its place
+    const auto* removedEntity = solidEntities[1];
+    SECTION("Removing the entity in the last slot")
+    {
+      removedEntity = solidEntities[2];
+    }
+
+    auto expectedSolidEntities = std::vector<const Model::EntityNode*>{};
+    for (const auto* entityNode : pointEntities)
+    {
+      if (entityNode != removedEntity)
+      {
+        expectedSolidEntities.push_back(entityNode);
+      }
+    }
+
+    renderer.removeEntity(removedEntity);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, expectedSolidEntities, {}, {&brushEntity});
+
+    for (const auto* entityNode : expectedSolidEntities)
+    {
+      renderer.removeEntity(entityNode);
+    }
+    renderer.removeEntity(&brushEntity);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, {}, {}, {});
+  }
+
+  SECTION("Invalidating an entity rebuilds its bounds")
+  {
+    pointEntity2.setEntity(makePointEntity({64, 64, 64}));
+    renderer.invalidateEntity(&pointEntity2);
+
+    SECTION("Invalidating the entity again before validating")
+    {
+      pointEntity2.setEntity(makePointEntity({64, 128, 64}));
+      renderer.invalidateEntity(&pointEntity2);
+    }
+
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, pointEntities, {}, {&brushEntity});
+  }
+
+  SECTION("Overriding the bounds color adds wireframe bounds to all point entities")
+  {
+    renderer.setOverrideBoundsColor(true);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, pointEntities, pointEntities, {&brushEntity});
+
+    renderer.setOverrideBoundsColor(false);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, pointEntities, {}, {&brushEntity});
+  }
+
+  SECTION("Hidden entities don't occupy any slots")
+  {
+    pointEntity1.setVisibilityState(Model::VisibilityState::Hidden);
+    renderer.invalidateEntity(&pointEntity1);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, {&pointEntity2, &pointEntity3}, {}, {&brushEntity});
+
+    pointEntity1.setVisibilityState(Model::VisibilityState::Shown);
+    renderer.invalidateEntity(&pointEntity1);
+    EntityRendererTestAccess::validateBounds(renderer);
+
+    checkBounds(renderer, pointEntities, {}, {&brushEntity});
+  }
+}
+} // namespace Renderer
+} // namespace TrenchBroom
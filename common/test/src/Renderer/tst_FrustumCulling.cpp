@@ -0,0 +1,196 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "Renderer/FrustumCulling.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+namespace
+{
+/**
+ * A camera at the origin that looks along the positive X axis. At a distance of 100
+ * units, it sees everything within 75 units of its view direction, and it sees nothing
+ * that is further than 1000 units away.
+ */
+PerspectiveCamera makeCamera()
+{
+  return PerspectiveCamera{
+    90.0f,
+    1.0f,
+    1000.0f,
+    Camera::Viewport{0, 0, 800, 800},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{1, 0, 0},
+    vm::vec3f{0, 0, 1}};
+}
+
+vm::bbox3 cubeAt(const vm::vec3& center, const FloatType size = 8.0)
+{
+  const auto halfSize = vm::vec3::fill(size / 2.0);
+  return vm::bbox3{center - halfSize, center + halfSize};
+}
+} // namespace
+
+TEST_CASE("ViewFrustum.intersects")
+{
+  // a box from (0, 0, 0) to (10, 10, 10)
+  const auto frustum = ViewFrustum{{
+    vm::plane3{{10, 0, 0}, {1, 0, 0}},
+    vm::plane3{{0, 0, 0}, {-1, 0, 0}},
+    vm::plane3{{0, 10, 0}, {0, 1, 0}},
+    vm::plane3{{0, 0, 0}, {0, -1, 0}},
+    vm::plane3{{0, 0, 10}, {0, 0, 1}},
+    vm::plane3{{0, 0, 0}, {0, 0, -1}},
+  }};
+
+  CHECK(frustum.intersects(vm::bbox3{{2, 2, 2}, {8, 8, 8}}));
+  CHECK(frustum.intersects(vm::bbox3{{-2, -2, -2}, {12, 12, 12}}));
+  CHECK(frustum.intersects(vm::bbox3{{8, 8, 8}, {12, 12, 12}}));
+  CHECK(frustum.intersects(vm::bbox3{{10, 2, 2}, {12, 8, 8}}));
+  CHECK_FALSE(frustum.intersects(vm::bbox3{{11, 2, 2}, {12, 8, 8}}));
+  CHECK_FALSE(frustum.intersects(vm::bbox3{{-4, -4, -4}, {-2, 8, 8}}));
+}
+
+TEST_CASE("ViewFrustum.fromCamera")
+{
+  const auto camera = makeCamera();
+  const auto frustum = ViewFrustum::fromCamera(camera);
+
+  CHECK(frustum.planes().size() == 6u);
+
+  // in front of the camera
+  CHECK(frustum.intersects(cubeAt({100, 0, 0})));
+  CHECK(frustum.intersects(cubeAt({100, 70, 0})));
+  CHECK(frustum.intersects(cubeAt({100, 0, -70})));
+
+  // outside of the side planes
+  CHECK_FALSE(frustum.intersects(cubeAt({100, 120, 0})));
+  CHECK_FALSE(frustum.intersects(cubeAt({100, -120, 0})));
+  CHECK_FALSE(frustum.intersects(cubeAt({100, 0, 120})));
+  CHECK_FALSE(frustum.intersects(cubeAt({100, 0, -120})));
+
+  // behind the camera
+  CHECK_FALSE(frustum.intersects(cubeAt({-100, 0, 0})));
+
+  // beyond the far plane
+  CHECK_FALSE(frustum.intersects(cubeAt({1100, 0, 0})));
+
+  // the camera is inside of the box
+  CHECK(frustum.intersects(cubeAt({0, 0, 0}, 16.0)));
+}
+
+TEST_CASE("findVisibleNodes")
+{
+  constexpr auto mapFormat = Model::MapFormat::Standard;
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = Model::BrushBuilder{mapFormat, worldBounds};
+
+  auto world = Model::WorldNode{{}, {}, mapFormat};
+
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  for (int x = -8; x < 8; ++x)
+  {
+    for (int y = -8; y < 8; ++y)
+    {
+      for (int z = -2; z < 2; ++z)
+      {
+        const auto center = vm::vec3{double(x), double(y), double(z)} * 100.0;
+        auto* brushNode = new Model::BrushNode{
+          builder.createCuboid(cubeAt(center, 32.0), "texture").value()};
+        world.defaultLayer()->addChild(brushNode);
+        brushNodes.push_back(brushNode);
+      }
+    }
+  }
+
+  auto* visibleEntityNode = new Model::EntityNode{
+    Model::Entity{{}, {{"classname", "info_player_start"}, {"origin", "200 0 0"}}}};
+  auto* hiddenEntityNode = new Model::EntityNode{
+    Model::Entity{{}, {{"classname", "info_player_start"}, {"origin", "-200 0 0"}}}};
+  world.defaultLayer()->addChild(visibleEntityNode);
+  world.defaultLayer()->addChild(hiddenEntityNode);
+
+  const auto camera = makeCamera();
+  const auto frustum = ViewFrustum::fromCamera(camera);
+  const auto visibleNodes = findVisibleNodes(world, frustum);
+
+  const auto expectedBrushNodes =
+    kdl::vec_element_cast<const Model::BrushNode*>(kdl::vec_filter(
+      brushNodes, [&](const auto* brushNode) {
+        return frustum.intersects(brushNode->physicalBounds());
+      }));
+
+  CHECK_FALSE(expectedBrushNodes.empty());
+  CHECK(expectedBrushNodes.size() < brushNodes.size());
+  CHECK_THAT(visibleNodes.brushNodes, Catch::UnorderedEquals(expectedBrushNodes));
+  CHECK(
+    visibleNodes.entityNodes == std::vector<const Model::EntityNode*>{visibleEntityNode});
+  CHECK(visibleNodes.patchNodes.empty());
+}
+
+TEST_CASE("mergeIndexRanges")
+{
+  using R = std::vector<IndexRange>;
+  using T = std::tuple<R, R>;
+
+  // clang-format off
+  const auto
+  [ranges,                             expectedRanges] = GENERATE(values<T>({
+  {R{},                                R{}},
+  {R{{0, 3}},                          R{{0, 3}}},
+  {R{{0, 3}, {3, 6}},                  R{{0, 9}}},
+  {R{{3, 6}, {0, 3}},                  R{{0, 9}}},
+  {R{{0, 3}, {6, 3}},                  R{{0, 3}, {6, 3}}},
+  {R{{6, 3}, {0, 3}, {3, 3}},          R{{0, 9}}},
+  {R{{0, 6}, {3, 6}},                  R{{0, 9}}},
+  {R{{0, 9}, {3, 3}},                  R{{0, 9}}},
+  {R{{12, 3}, {0, 3}, {3, 3}, {9, 3}}, R{{0, 6}, {9, 6}}},
+  }));
+  // clang-format on
+
+  CAPTURE(ranges);
+
+  auto mergedRanges = ranges;
+  mergeIndexRanges(mergedRanges);
+  CHECK(mergedRanges == expectedRanges);
+}
+
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -0,0 +1,286 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchNode.h"
+#include "Model/VisibilityState.h"
+#include "Renderer/AllocationTracker.h"
+#include "Renderer/BrushRendererArrays.h"
+#include "Renderer/GLVertex.h"
+#include "Renderer/PatchRenderer.h"
+
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+namespace Renderer
+{
+class PatchRendererTestAccess
+{
+public:
+  static const auto& patchInfo(const PatchRenderer& renderer)
+  {
+    return renderer.m_patchInfo;
+  }
+
+  static const BrushVertexArray& vertexArray(const PatchRenderer& renderer)
+  {
+    return *renderer.m_vertexArray;
+  }
+
+  static const BrushIndexArray& edgeIndices(const PatchRenderer& renderer)
+  {
+    return *renderer.m_edgeIndices;
+  }
+
+  static const auto& faceIndices(const PatchRenderer& renderer)
+  {
+    return *renderer.m_faces;
+  }
+};
+
+namespace
+{
+Model::BezierPatch makePatch(
+  const size_t rowCount, const size_t columnCount, const std::string& textureName)
+{
+  auto points = std::vector<Model::BezierPatch::Point>{};
+  for (size_t row = 0; row < rowCount; ++row)
+  {
+    for (size_t column = 0; column < columnCount; ++column)
+    {
+      points.emplace_back(
+        double(column * 16), double(row * 16), double((row + column) % 2 * 8), 0.0, 0.0);
+    }
+  }
+  return Model::BezierPatch{rowCount, columnCount, std::move(points), textureName};
+}
+
+void validate(PatchRenderer& renderer)
+{
+  if (!renderer.valid())
+  {
+    renderer.validate();
+  }
+}
+
+using RangeList = std::vector<AllocationTracker::Range>;
+
+AllocationTracker::Range range(const AllocationTracker::Block* block)
+{
+  return AllocationTracker::Range{block->pos, block->size};
+}
+
+RangeList sorted(RangeList ranges)
+{
+  std::sort(ranges.begin(), ranges.end());
+  return ranges;
+}
+
+/**
+ * Checks that the given renderer has allocated exactly one vertex range, one edge index
+ * range and one face index range in the index array of its texture for each of the given
+ * patches, and that these ranges contain the patch's grid.
+ */
+void checkAllocations(
+  const PatchRenderer& renderer,
+  const std::vector<const Model::PatchNode*>& expectedPatches)
+{
+  REQUIRE(renderer.valid());
+
+  const auto& patchInfo = PatchRendererTestAccess::patchInfo(renderer);
+  const auto& vertexArray = PatchRendererTestAccess::vertexArray(renderer);
+  const auto& edgeIndices = PatchRendererTestAccess::edgeIndices(renderer);
+  const auto& faceIndices = PatchRendererTestAccess::faceIndices(renderer);
+
+  auto patches = std::vector<const Model::PatchNode*>{};
+  auto vertexRanges = RangeList{};
+  auto edgeIndexRanges = RangeList{};
+  auto faceIndexRanges = std::unordered_map<const Assets::Texture*, RangeList>{};
+
+  for (const auto& [patchNode, info] : patchInfo)
+  {
+    patches.push_back(patchNode);
+
+    const auto& grid = patchNode->grid();
+    const auto& vertices = vertexArray.vertices();
+
+    REQUIRE(info.vertexKey != nullptr);
+    REQUIRE(info.vertexKey->size == grid.points.size());
+    vertexRanges.push_back(range(info.vertexKey));
+
+    for (size_t i = 0; i < grid.points.size(); ++i)
+    {
+      CHECK(
+        getVertexComponent<0>(vertices[info.vertexKey->pos + i])
+        == vm::vec3f{grid.points[i].position});
+    }
+
+    const auto isPatchVertex = [&](const GLuint index) {
+      return index >= info.vertexKey->pos
+             && index < info.vertexKey->pos + info.vertexKey->size;
+    };
+
+    // every edge of the border loop has two indices
+    REQUIRE(info.edgeIndicesKey != nullptr);
+    CHECK(
+      info.edgeIndicesKey->size
+      == 4u * (grid.pointRowCount - 1u + grid.pointColumnCount - 1u));
+    edgeIndexRanges.push_back(range(info.edgeIndicesKey));
+
+    const auto edgesBegin = edgeIndices.indices().begin() + info.edgeIndicesKey->pos;
+    CHECK(std::all_of(
+      edgesBegin, edgesBegin + info.edgeIndicesKey->size, isPatchVertex));
+
+    // every quad has two triangles
+    REQUIRE(info.faceIndicesKey != nullptr);
+    CHECK(info.texture == patchNode->patch().texture());
+    CHECK(
+      info.faceIndicesKey->size == 6u * grid.quadRowCount() * grid.quadColumnCount());
+    faceIndexRanges[info.texture].push_back(range(info.faceIndicesKey));
+
+    REQUIRE(faceIndices.count(info.texture) == 1u);
+    const auto facesBegin =
+      faceIndices.at(info.texture)->indices().begin() + info.faceIndicesKey->pos;
+    CHECK(std::all_of(
+      facesBegin, facesBegin + info.faceIndicesKey->size, isPatchVertex));
+  }
+
+  CHECK_THAT(patches, Catch::UnorderedEquals(expectedPatches));
+
+  // no ranges are leaked, and there are no index arrays for unused textures
+  CHECK(vertexArray.allocationTracker().usedBlocks() == sorted(vertexRanges));
+  CHECK(edgeIndices.allocationTracker().usedBlocks() == sorted(edgeIndexRanges));
+  CHECK(faceIndices.size() == faceIndexRanges.size());
+  for (const auto& [texture, indices] : faceIndices)
+  {
+    CHECK(indices->allocationTracker().usedBlocks() == sorted(faceIndexRanges[texture]));
+  }
+}
+} // namespace
+
+TEST_CASE("PatchRendererTest.allocations")
+{
+  auto texture1 = Assets::Texture{"texture1", 64, 64};
+  auto texture2 = Assets::Texture{"texture2", 64, 64};
+
+  auto patchNode1 = Model::PatchNode{makePatch(3, 3, "texture1")};
+  auto patchNode2 = Model::PatchNode{makePatch(3, 5, "texture1")};
+  auto patchNode3 = Model::PatchNode{makePatch(5, 3, "texture2")};
+  patchNode1.setTexture(&texture1);
+  patchNode2.setTexture(&texture1);
+  patchNode3.setTexture(&texture2);
+
+  const auto editorContext = Model::EditorContext{};
+  auto renderer = PatchRenderer{editorContext};
+
+  renderer.addPatch(&patchNode1);
+  renderer.addPatch(&patchNode2);
+  renderer.addPatch(&patchNode3);
+  validate(renderer);
+
+  checkAllocations(renderer, {&patchNode1, &patchNode2, &patchNode3});
+
+  SECTION("Updating a patch")
+  {
+    patchNode2.setPatch(makePatch(5, 7, "texture1"));
+    renderer.invalidatePatch(&patchNode2);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode1, &patchNode2, &patchNode3});
+  }
+
+  SECTION("Removing a patch")
+  {
+    renderer.removePatch(&patchNode1);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode2, &patchNode3});
+
+    SECTION("Removing the last patch with a texture drops the texture's index array")
+    {
+      renderer.removePatch(&patchNode3);
+      validate(renderer);
+
+      checkAllocations(renderer, {&patchNode2});
+      CHECK(PatchRendererTestAccess::faceIndices(renderer).count(&texture2) == 0u);
+    }
+  }
+
+  SECTION("Removing an invalid patch")
+  {
+    renderer.invalidatePatch(&patchNode1);
+    renderer.removePatch(&patchNode1);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode2, &patchNode3});
+  }
+
+  SECTION("Hiding and showing a patch")
+  {
+    patchNode1.setVisibilityState(Model::VisibilityState::Hidden);
+    renderer.invalidatePatch(&patchNode1);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode2, &patchNode3});
+
+    patchNode1.setVisibilityState(Model::VisibilityState::Shown);
+    renderer.invalidatePatch(&patchNode1);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode1, &patchNode2, &patchNode3});
+  }
+
+  SECTION("Changing the texture of a patch moves it to the other texture's index array")
+  {
+    patchNode1.setTexture(&texture2);
+    patchNode2.setTexture(&texture2);
+    renderer.invalidatePatch(&patchNode1);
+    renderer.invalidatePatch(&patchNode2);
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode1, &patchNode2, &patchNode3});
+    CHECK(PatchRendererTestAccess::faceIndices(renderer).count(&texture1) == 0u);
+  }
+
+  SECTION("Invalidating all patches")
+  {
+    renderer.invalidate();
+    CHECK_FALSE(renderer.valid());
+    validate(renderer);
+
+    checkAllocations(renderer, {&patchNode1, &patchNode2, &patchNode3});
+  }
+
+  renderer.clear();
+  patchNode1.setTexture(nullptr);
+  patchNode2.setTexture(nullptr);
+  patchNode3.setTexture(nullptr);
+}
+} // namespace Renderer
+} // namespace TrenchBroom
@@ -76,6 +76,26 @@ TEST_CASE("AutosaverTest.makeBackupPathMatcher")
   CHECK_FALSE(matcher("test.2-crash.map", getPathInfo));
 }
 
+TEST_CASE("AutosaverTest.makeBackupTempPathMatcher")
+{
+  auto env = makeTestEnvironment();
+  env.createFile("test.1.map.tmp", "some content");
+  env.createFile("test.3.map.tmp", "some content");
+  env.createFile("test.map.tmp", "some content");
+  env.createFile("other.1.map.tmp", "some content");
+  auto fs = IO::DiskFileSystem{env.dir()};
+
+  const auto matcher = makeBackupTempPathMatcher("test");
+  const auto getPathInfo = [&](const auto& p) { return fs.pathInfo(p); };
+
+  CHECK(matcher("test.1.map.tmp", getPathInfo));
+  CHECK(matcher("test.3.map.tmp", getPathInfo));
+  CHECK_FALSE(matcher("test.2.map.tmp", getPathInfo));
+  CHECK_FALSE(matcher("test.1.map", getPathInfo));
+  CHECK_FALSE(matcher("test.map.tmp", getPathInfo));
+  CHECK_FALSE(matcher("other.1.map.tmp", getPathInfo));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInterval")
 {
   using namespace std::literals::chrono_literals;
@@ -92,6 +112,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -109,6 +130,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   Autosaver autosaver(document, 0s);
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -134,6 +156,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -159,6 +182,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -168,15 +192,46 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
   CHECK_FALSE(env.fileExists("autosave/test.2.map"));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
   CHECK(env.fileExists("autosave/test.2.map"));
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesSnapshot")
+{
+  using namespace std::literals::chrono_literals;
+
+  IO::TestEnvironment env;
+  NullLogger logger;
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  Autosaver autosaver(document, 0s);
+
+  // modify the map
+  auto* brushNode = createBrushNode("some_texture");
+  document->addNodes({{document->currentLayer(), {brushNode}}});
+
+  autosaver.triggerAutosave(logger);
+
+  // edits made while the backup is written do not affect the backup
+  document->removeNodes({brushNode});
+
+  autosaver.waitForAutosave(logger);
+
+  REQUIRE(env.fileExists("autosave/test.1.map"));
+  CHECK_FALSE(env.fileExists("autosave/test.1.map.tmp"));
+  CHECK_THAT(
+    env.loadFile("autosave/test.1.map"), Catch::Matchers::Contains("some_texture"));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesPresent")
 {
   // https://github.com/TrenchBroom/TrenchBroom/issues/2544
@@ -199,8 +254,62 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.2.map"));
 }
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverDeletesStaleTempFiles")
+{
+  using namespace std::literals::chrono_literals;
+
+  IO::TestEnvironment env;
+  env.createDirectory("autosave");
+  env.createFile("autosave/test.3.map.tmp", "some content");
+  env.createFile("autosave/other.1.map.tmp", "some content");
+
+  NullLogger logger;
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  Autosaver autosaver(document, 0s);
+
+  // modify the map
+  document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
+
+  autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
+
+  CHECK(env.fileExists("autosave/test.1.map"));
+  CHECK_FALSE(env.fileExists("autosave/test.3.map.tmp"));
+  CHECK(env.fileExists("autosave/other.1.map.tmp"));
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverDeletesTempFileOnFailure")
+{
+  using namespace std::literals::chrono_literals;
+
+  IO::TestEnvironment env;
+
+  // the finished backup would be moved into this directory, where another directory
+  // with the name of the temporary file is in the way
+  env.createDirectory("autosave/test.1.map/test.1.map.tmp");
+
+  NullLogger logger;
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  Autosaver autosaver(document, 0s);
+
+  // modify the map
+  document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
+
+  autosaver.triggerAutosave(logger);
+  autosaver.waitForAutosave(logger);
+
+  CHECK_FALSE(env.fileExists("autosave/test.1.map.tmp"));
+}
 } // namespace View
 } // namespace TrenchBroom
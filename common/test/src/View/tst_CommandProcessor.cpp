@@ -242,6 +242,21 @@ public:
   }
 };
 
+class MemoryCommand : public NullCommand
+{
+private:
+  size_t m_memoryUsage;
+
+public:
+  MemoryCommand(std::string name, const size_t memoryUsage)
+    : NullCommand{std::move(name)}
+    , m_memoryUsage{memoryUsage}
+  {
+  }
+
+  size_t memoryUsage() const override { return m_memoryUsage; }
+};
+
 TEST_CASE("CommandProcessorTest.doAndUndoSuccessfulCommand")
 {
   /*
@@ -818,5 +833,66 @@ TEST_CASE("CommandProcessorTest.collateTransactions")
 
   commandProcessor.undo();
 }
+
+TEST_CASE("CommandProcessorTest.undoMemoryBudget")
+{
+  auto commandProcessor = CommandProcessor{nullptr};
+  commandProcessor.setUndoMemoryBudget(250u);
+
+  commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd1", 100u));
+  commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd2", 100u));
+  CHECK(commandProcessor.undoCommandName() == "cmd2");
+
+  SECTION("The oldest commands are removed when the budget is exceeded")
+  {
+    commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd3", 100u));
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undoCommandName() == "cmd2");
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+
+  SECTION("The most recent command is kept even if it exceeds the budget")
+  {
+    commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd3", 300u));
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+
+  SECTION("Lowering the budget removes commands immediately")
+  {
+    commandProcessor.setUndoMemoryBudget(150u);
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+
+  SECTION("Without a budget, no commands are removed")
+  {
+    commandProcessor.setUndoMemoryBudget(std::nullopt);
+    commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd3", 300u));
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+
+  SECTION("The memory usage of transactions is the sum of their commands")
+  {
+    commandProcessor.startTransaction("transaction", TransactionScope::Oneshot);
+    commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd3", 50u));
+    commandProcessor.executeAndStore(std::make_unique<MemoryCommand>("cmd4", 50u));
+    commandProcessor.commitTransaction();
+
+    CHECK(commandProcessor.undoCommandName() == "transaction");
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undoCommandName() == "cmd2");
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+}
 } // namespace View
 } // namespace TrenchBroom
@@ -35,11 +35,13 @@
 #include "View/PasteType.h"
 
 #include <kdl/result.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/mat_ext.h>
 
 #include <functional>
 #include <set>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -564,6 +566,104 @@ TEST_CASE_METHOD(MapDocumentTest, "GroupNodesTest.recursiveLinkedGroups")
   }
 }
 
+TEST_CASE_METHOD(
+  MapDocumentTest, "GroupNodesTest.updateLinkedGroupsAfterUndoingRemoval")
+{
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auto* brushNode = createBrushNode();
+    Model::transformNode(
+      *brushNode,
+      vm::translation_matrix(vm::vec3{FloatType(i) * 64.0, 0, 0}),
+      document->worldBounds());
+    brushNodes.push_back(brushNode);
+  }
+
+  document->addNodes(
+    {{document->parentForNodes(), kdl::vec_element_cast<Model::Node*>(brushNodes)}});
+  document->selectNodes(kdl::vec_element_cast<Model::Node*>(brushNodes));
+
+  auto* groupNode = document->groupSelection("test");
+  REQUIRE(groupNode != nullptr);
+
+  document->deselectAll();
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  REQUIRE(linkedGroupNode != nullptr);
+  document->deselectAll();
+
+  document->openGroup(groupNode);
+  document->selectNodes({brushNodes[1]});
+  document->deleteObjects();
+  REQUIRE(linkedGroupNode->childCount() == 2u);
+
+  document->undoCommand();
+  REQUIRE(linkedGroupNode->childCount() == 3u);
+
+  // the restored node must be at its original position, otherwise the nodes of the
+  // linked groups no longer correspond to each other
+  CHECK(groupNode->children() == kdl::vec_element_cast<Model::Node*>(brushNodes));
+
+  document->deselectAll();
+  document->selectNodes({brushNodes[2]});
+  REQUIRE(document->translateObjects({0, 0, 64}));
+
+  const auto& linkedChildren = linkedGroupNode->children();
+  REQUIRE(linkedChildren.size() == 3u);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    CHECK(linkedChildren[i]->physicalBounds() == brushNodes[i]->physicalBounds());
+  }
+}
+
+TEST_CASE_METHOD(
+  MapDocumentTest, "GroupNodesTest.updateLinkedGroupsWithDifferentChildOrder")
+{
+  auto* brushNode = createBrushNode();
+  auto* entityNode = new Model::EntityNode{Model::Entity{}};
+  document->addNodes({{document->parentForNodes(), {brushNode, entityNode}}});
+  document->selectNodes({brushNode, entityNode});
+
+  auto* groupNode = document->groupSelection("test");
+  REQUIRE(groupNode != nullptr);
+  REQUIRE(groupNode->children() == std::vector<Model::Node*>{brushNode, entityNode});
+
+  document->deselectAll();
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  REQUIRE(linkedGroupNode != nullptr);
+  document->deselectAll();
+
+  // linked groups loaded from a map file need not have their children in the same order
+  auto* linkedBrushNode = linkedGroupNode->children().front();
+  REQUIRE(dynamic_cast<Model::BrushNode*>(linkedBrushNode) != nullptr);
+  linkedGroupNode->removeChild(linkedBrushNode);
+  linkedGroupNode->addChild(linkedBrushNode);
+
+  document->openGroup(groupNode);
+  document->selectNodes({entityNode});
+  REQUIRE(document->translateObjects({0, 0, 64}));
+
+  // the linked group is updated entirely because its nodes cannot be matched by position
+  const auto& linkedChildren = linkedGroupNode->children();
+  REQUIRE(linkedChildren.size() == 2u);
+
+  const auto linkedBrushNodes = kdl::vec_filter(linkedChildren, [](const auto* node) {
+    return dynamic_cast<const Model::BrushNode*>(node) != nullptr;
+  });
+  const auto linkedEntityNodes = kdl::vec_filter(linkedChildren, [](const auto* node) {
+    return dynamic_cast<const Model::EntityNode*>(node) != nullptr;
+  });
+  REQUIRE(linkedBrushNodes.size() == 1u);
+  REQUIRE(linkedEntityNodes.size() == 1u);
+
+  CHECK(linkedBrushNodes.front()->physicalBounds() == brushNode->physicalBounds());
+  CHECK(
+    static_cast<Model::EntityNode*>(linkedEntityNodes.front())->entity().origin()
+    == entityNode->entity().origin());
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "GroupNodesTest.selectLinkedGroups")
 {
   auto* entityNode = new Model::EntityNode{Model::Entity{}};
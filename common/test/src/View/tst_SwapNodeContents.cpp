@@ -196,6 +196,53 @@ TEST_CASE_METHOD(MapDocumentTest, "SwapNodesContentCommandTest.updateLinkedGroup
     == brushNode->physicalBounds().transform(linkedGroupNode->group().transformation()));
 }
 
+TEST_CASE_METHOD(
+  MapDocumentTest, "SwapNodesContentCommandTest.updateLinkedGroupsOnlyChangedNodes")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
+  auto* brushNode = createBrushNode();
+  auto* otherBrushNode = createBrushNode();
+  groupNode->addChildren({brushNode, otherBrushNode});
+  document->addNodes({{document->parentForNodes(), {groupNode}}});
+
+  document->selectNodes({groupNode});
+  auto* linkedGroupNode = document->createLinkedDuplicate();
+  document->deselectAll();
+
+  document->selectNodes({linkedGroupNode});
+  document->translateObjects(vm::vec3(32.0, 0.0, 0.0));
+  document->deselectAll();
+
+  REQUIRE(linkedGroupNode->childCount() == 2u);
+  auto* linkedBrushNode = linkedGroupNode->children().front();
+  auto* otherLinkedBrushNode = linkedGroupNode->children().back();
+
+  const auto originalLinkedBrushBounds = linkedBrushNode->physicalBounds();
+
+  document->selectNodes({brushNode});
+  document->translateObjects(vm::vec3(0.0, 16.0, 0.0));
+
+  // the linked nodes are updated in place
+  REQUIRE(
+    linkedGroupNode->children()
+    == std::vector<Model::Node*>{linkedBrushNode, otherLinkedBrushNode});
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == brushNode->physicalBounds().transform(linkedGroupNode->group().transformation()));
+  CHECK(
+    otherLinkedBrushNode->physicalBounds()
+    == otherBrushNode->physicalBounds().transform(
+      linkedGroupNode->group().transformation()));
+
+  document->undoCommand();
+  CHECK(linkedBrushNode->physicalBounds() == originalLinkedBrushBounds);
+
+  document->redoCommand();
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == originalLinkedBrushBounds.translate(vm::vec3(0.0, 16.0, 0.0)));
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "SwapNodesContentCommandTest.updateLinkedGroupsFails")
 {
   auto* groupNode = new Model::GroupNode{Model::Group{"group"}};
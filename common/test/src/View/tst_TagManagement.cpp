@@ -683,5 +683,34 @@ TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagUpdateBrushFaceTags")
     CHECK(!faces[i].hasTag(tag));
   }
 }
+
+TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagUpdateInTransaction")
+{
+  // the tags must be up to date while the change notifications are batched
+  auto* brushNode = createBrushNode("asdf");
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  auto* entityNode = new Model::EntityNode{{}, {{"classname", "brush_entity"}}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+
+  const auto& entityTag = document->smartTag("entity");
+  const auto& contentFlagsTag = document->smartTag("contentflags");
+
+  auto transaction = Transaction{document};
+
+  document->reparentNodes({{entityNode, {brushNode}}});
+  CHECK(brushNode->hasTag(entityTag));
+
+  Model::ChangeBrushFaceAttributesRequest request;
+  request.setContentFlags(1);
+
+  document->selectBrushFaces({Model::BrushFaceHandle(brushNode, 0u)});
+  document->setFaceAttributes(request);
+  document->deselectAll();
+
+  CHECK(brushNode->brush().faces()[0].hasTag(contentFlagsTag));
+
+  transaction.commit();
+}
 } // namespace View
 } // namespace TrenchBroom
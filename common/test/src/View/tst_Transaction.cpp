@@ -18,12 +18,27 @@
  */
 
 #include "MapDocumentTest.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFaceHandle.h"
+#include "Model/BrushNode.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
+#include "Model/NodeContents.h"
+#include "Model/WorldNode.h"
+#include "NotifierConnection.h"
 #include "TestUtils.h"
+#include "View/TransactionScope.h"
+
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/mat_ext.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom::View
@@ -86,4 +101,190 @@ TEST_CASE_METHOD(MapDocumentTest, "Transaction")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "Transaction.batchNotifications")
+{
+  auto* entityNode = new Model::EntityNode{Model::Entity{}};
+  auto* brushNode = createBrushNode();
+  document->addNodes({{document->parentForNodes(), {entityNode, brushNode}}});
+  document->selectNodes({entityNode});
+
+  auto deferredCalls = std::vector<std::vector<Model::Node*>>{};
+  auto immediateCalls = std::vector<std::vector<Model::Node*>>{};
+  auto deferredFaceCalls = std::vector<std::vector<Model::BrushFaceHandle>>{};
+  auto immediateFaceCalls = std::vector<std::vector<Model::BrushFaceHandle>>{};
+
+  auto connection = NotifierConnection{};
+  connection += document->nodesDidChangeNotifier.connect(
+    [&](const auto& nodes) { deferredCalls.push_back(nodes); });
+  connection += document->nodesDidChangeNotifier.connectImmediately(
+    [&](const auto& nodes) { immediateCalls.push_back(nodes); });
+  connection += document->brushFacesDidChangeNotifier.connect(
+    [&](const auto& handles) { deferredFaceCalls.push_back(handles); });
+  connection += document->brushFacesDidChangeNotifier.connectImmediately(
+    [&](const auto& handles) { immediateFaceCalls.push_back(handles); });
+
+  const auto clearCalls = [&]() {
+    deferredCalls.clear();
+    immediateCalls.clear();
+    deferredFaceCalls.clear();
+    immediateFaceCalls.clear();
+  };
+
+  SECTION("Changes are passed to observers once when the transaction is committed")
+  {
+    auto transaction = Transaction{document};
+    document->translateObjects(vm::vec3{1, 0, 0});
+    document->translateObjects(vm::vec3{1, 0, 0});
+
+    CHECK(deferredCalls.empty());
+    CHECK(immediateCalls.size() >= 2u);
+
+    transaction.commit();
+
+    REQUIRE(deferredCalls.size() == 1u);
+    CHECK(std::count(deferredCalls[0].begin(), deferredCalls[0].end(), entityNode) == 1);
+  }
+
+  SECTION("Immediate observers receive every notification")
+  {
+    document->translateObjects(vm::vec3{1, 0, 0});
+    const auto callsPerChange = immediateCalls.size();
+    REQUIRE(callsPerChange > 0u);
+    REQUIRE(deferredCalls.size() == 1u);
+    clearCalls();
+
+    auto transaction = Transaction{document};
+    document->translateObjects(vm::vec3{1, 0, 0});
+    document->translateObjects(vm::vec3{1, 0, 0});
+    document->translateObjects(vm::vec3{1, 0, 0});
+
+    CHECK(immediateCalls.size() == 3u * callsPerChange);
+    CHECK(deferredCalls.empty());
+
+    transaction.commit();
+
+    CHECK(immediateCalls.size() == 3u * callsPerChange);
+    CHECK(deferredCalls.size() == 1u);
+  }
+
+  SECTION("Undo passes changes to observers once")
+  {
+    {
+      auto transaction = Transaction{document};
+      document->translateObjects(vm::vec3{1, 0, 0});
+      document->translateObjects(vm::vec3{1, 0, 0});
+      transaction.commit();
+    }
+    clearCalls();
+
+    document->undoCommand();
+
+    REQUIRE(deferredCalls.size() == 1u);
+    CHECK(std::count(deferredCalls[0].begin(), deferredCalls[0].end(), entityNode) == 1);
+    CHECK(immediateCalls.size() >= 2u);
+  }
+
+  SECTION("Redo passes changes to observers once")
+  {
+    {
+      auto transaction = Transaction{document};
+      document->translateObjects(vm::vec3{1, 0, 0});
+      document->translateObjects(vm::vec3{1, 0, 0});
+      transaction.commit();
+    }
+    document->undoCommand();
+    clearCalls();
+
+    document->redoCommand();
+
+    REQUIRE(deferredCalls.size() == 1u);
+    CHECK(std::count(deferredCalls[0].begin(), deferredCalls[0].end(), entityNode) == 1);
+    CHECK(immediateCalls.size() >= 2u);
+  }
+
+  SECTION("Removed nodes are not passed to observers")
+  {
+    auto transaction = Transaction{document};
+    document->translateObjects(vm::vec3{1, 0, 0});
+    document->deleteObjects();
+
+    // the immediate observers have seen the change before the node was removed
+    CHECK(std::any_of(immediateCalls.begin(), immediateCalls.end(), [&](const auto& n) {
+      return kdl::vec_contains(n, entityNode);
+    }));
+
+    transaction.commit();
+
+    for (const auto& nodes : deferredCalls)
+    {
+      CHECK_FALSE(kdl::vec_contains(nodes, entityNode));
+    }
+  }
+
+  SECTION("Faces which no longer exist are not passed to observers")
+  {
+    const auto faceCount = brushNode->brush().faceCount();
+    REQUIRE(faceCount == 6u);
+
+    const auto hasFace = [&](const size_t faceIndex) {
+      return [&, faceIndex](const auto& handles) {
+        return std::any_of(handles.begin(), handles.end(), [&](const auto& handle) {
+          return handle.node() == brushNode && handle.faceIndex() == faceIndex;
+        });
+      };
+    };
+
+    auto transaction = Transaction{document};
+
+    // no command reports changed faces yet, so notify the observers directly
+    document->brushFacesDidChangeNotifier(std::vector<Model::BrushFaceHandle>{
+      {brushNode, 0u}, {brushNode, faceCount - 1u}});
+
+    REQUIRE(std::any_of(
+      immediateFaceCalls.begin(), immediateFaceCalls.end(), hasFace(faceCount - 1u)));
+    REQUIRE(deferredFaceCalls.empty());
+
+    // replace the brush by a tetrahedron, which has fewer faces
+    const auto builder =
+      Model::BrushBuilder{document->world()->mapFormat(), document->worldBounds()};
+    const auto points =
+      std::vector<vm::vec3>{{0, 0, 0}, {32, 0, 0}, {0, 32, 0}, {0, 0, 32}};
+    auto tetrahedron = builder.createBrush(points, "texture").value();
+    REQUIRE(tetrahedron.faceCount() < faceCount);
+
+    auto nodesToSwap = std::vector<std::pair<Model::Node*, Model::NodeContents>>{};
+    nodesToSwap.emplace_back(brushNode, std::move(tetrahedron));
+    document->swapNodeContents("Swap Nodes", std::move(nodesToSwap), {});
+
+    transaction.commit();
+
+    REQUIRE(deferredFaceCalls.size() == 1u);
+    CHECK(hasFace(0u)(deferredFaceCalls.front()));
+    CHECK_FALSE(hasFace(faceCount - 1u)(deferredFaceCalls.front()));
+    CHECK(kdl::vec_contains(kdl::vec_flatten(deferredCalls), brushNode));
+  }
+
+  SECTION("Cancelling a transaction closes its batch")
+  {
+    auto transaction = Transaction{document};
+    document->translateObjects(vm::vec3{1, 0, 0});
+    transaction.cancel();
+    clearCalls();
+
+    document->translateObjects(vm::vec3{1, 0, 0});
+    CHECK(deferredCalls.size() == 1u);
+  }
+
+  SECTION("Changes in long running transactions are passed to observers immediately")
+  {
+    document->startTransaction("", TransactionScope::LongRunning);
+    document->translateObjects(vm::vec3{1, 0, 0});
+
+    // the translation is batched by its own one shot transaction
+    CHECK(deferredCalls.size() == 1u);
+
+    document->commitTransaction();
+  }
+}
+
 } // namespace TrenchBroom::View
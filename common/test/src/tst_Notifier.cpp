@@ -19,6 +19,7 @@
 
 #include "Notifier.h"
 
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -355,6 +356,47 @@ TEST_CASE("NotifierTest.notifyObservers - test type qualifiers and value categor
   }
 }
 
+TEST_CASE("NotifierTest.notifyObservers - rvalue arguments are moved once")
+{
+  // long enough to be allocated on the heap so that moving from it leaves it empty
+  const auto str =
+    std::string{"some string that is too long for small string optimization"};
+
+  auto n = Notifier<std::string>{};
+
+  auto calls = std::vector<std::string>{};
+  auto con = NotifierConnection{};
+  con += n.connect([&](std::string s) { calls.push_back(std::move(s)); });
+  con += n.connect([&](std::string s) { calls.push_back(std::move(s)); });
+
+  SECTION("Every observer receives the argument")
+  {
+    n.notify(std::string{str});
+    CHECK(calls == std::vector<std::string>{str, str});
+  }
+
+  SECTION("The batch receives the argument after the immediate observers")
+  {
+    class Batch : public NotifierBatch<std::string>
+    {
+    public:
+      std::vector<std::string> values;
+
+      void add(std::string s) override { values.push_back(std::move(s)); }
+      void flush(const std::function<void(std::string)>&) override {}
+    };
+
+    auto& batch = n.setBatch<Batch>();
+    con += n.connectImmediately([&](std::string s) { calls.push_back(std::move(s)); });
+
+    n.beginBatch();
+    n.notify(std::string{str});
+    CHECK(calls == std::vector<std::string>{str});
+    CHECK(batch.values == std::vector<std::string>{str});
+    n.endBatch();
+  }
+}
+
 TEST_CASE("NotifyAfter")
 {
   auto n = Notifier<const Param&>{};
@@ -417,4 +459,79 @@ TEST_CASE("NotifyBeforeAndAfter")
     CHECK(moveCount <= 3);
   }
 }
+TEST_CASE("NotifierTest.batch")
+{
+  auto n = Notifier<const std::vector<int>&>{};
+  auto& batch = n.setBatch<VectorNotifierBatch<int>>();
+
+  auto deferredCalls = std::vector<std::vector<int>>{};
+  auto immediateCalls = std::vector<std::vector<int>>{};
+
+  auto con = NotifierConnection{};
+  con += n.connect([&](const auto& values) { deferredCalls.push_back(values); });
+  con += n.connectImmediately(
+    [&](const auto& values) { immediateCalls.push_back(values); });
+
+  SECTION("Without an open batch, all observers are notified immediately")
+  {
+    n.notify(std::vector<int>{1, 2});
+    CHECK(deferredCalls == std::vector<std::vector<int>>{{1, 2}});
+    CHECK(immediateCalls == std::vector<std::vector<int>>{{1, 2}});
+  }
+
+  SECTION("Notifications are merged until the outermost batch is closed")
+  {
+    n.beginBatch();
+    n.notify(std::vector<int>{1, 2});
+
+    n.beginBatch();
+    n.notify(std::vector<int>{3, 1});
+    n.endBatch();
+
+    CHECK(deferredCalls.empty());
+    CHECK(batch.values() == std::vector<int>{1, 2, 3});
+
+    n.notify(std::vector<int>{2, 4});
+    CHECK(deferredCalls.empty());
+    CHECK(immediateCalls == std::vector<std::vector<int>>{{1, 2}, {3, 1}, {2, 4}});
+
+    n.endBatch();
+    CHECK(deferredCalls == std::vector<std::vector<int>>{{1, 2, 3, 4}});
+    CHECK(batch.values().empty());
+  }
+
+  SECTION("Closing a batch without notifications does not notify")
+  {
+    n.beginBatch();
+    n.endBatch();
+    CHECK(deferredCalls.empty());
+  }
+
+  SECTION("Discarded values are not passed to the observers")
+  {
+    n.beginBatch();
+    n.notify(std::vector<int>{1, 2, 3});
+    batch.discard([](const auto i) { return i % 2 == 1; });
+    n.notify(std::vector<int>{1});
+    n.endBatch();
+
+    CHECK(deferredCalls == std::vector<std::vector<int>>{{2, 1}});
+  }
+
+  SECTION("Observers that disconnect during a batch are not notified")
+  {
+    auto o = Observer{};
+    {
+      const auto c = n.connect([&](const auto& values) {
+        o.notify1Calls.insert(o.notify1Calls.end(), values.begin(), values.end());
+      });
+      n.beginBatch();
+      n.notify(std::vector<int>{1});
+    }
+    n.endBatch();
+
+    CHECK(o.notify1Calls.empty());
+    CHECK(deferredCalls == std::vector<std::vector<int>>{{1}});
+  }
+}
 } // namespace TrenchBroom
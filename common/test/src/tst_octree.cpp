@@ -23,6 +23,7 @@
 
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/vec.h>
 
@@ -615,6 +616,96 @@ TEST_CASE("octree.find_intersectors")
   }
 }
 
+TEST_CASE("octree.find_overlaps")
+{
+  auto tree = octree<double, int>{32.0};
+
+  SECTION("empty tree") { CHECK(tree.find_overlaps({{0, 0, 0}, {1, 1, 1}}).empty()); }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // the leaf that contains the data does not intersect the bounds
+    CHECK(tree.find_overlaps({{0, 0, 0}, {16, 16, 16}}).empty());
+    CHECK(tree.find_overlaps({{-64, -64, -64}, {-32, -32, -32}}).empty());
+
+    // the leaf that contains the data intersects the bounds
+    CHECK(tree.find_overlaps({{0, 0, 0}, {48, 48, 48}}) == std::vector<int>{1});
+
+    // the leaf that contains the data touches the bounds
+    CHECK(tree.find_overlaps({{0, 0, 0}, {32, 32, 32}}) == std::vector<int>{1});
+
+    // the leaf that contains the data is contained in the bounds
+    CHECK(tree.find_overlaps({{0, 0, 0}, {128, 128, 128}}) == std::vector<int>{1});
+
+    // the bounds are contained in the leaf that contains the data
+    CHECK(tree.find_overlaps({{40, 40, 40}, {50, 50, 50}}) == std::vector<int>{1});
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+    tree.insert({{-16, -16, -16}, {16, 16, 16}}, 3);
+
+    CHECK_THAT(
+      tree.find_overlaps({{40, 40, 40}, {50, 50, 50}}),
+      Catch::UnorderedEquals(std::vector<int>{1, 3}));
+    CHECK_THAT(
+      tree.find_overlaps({{-50, -50, -50}, {-40, -40, -40}}),
+      Catch::UnorderedEquals(std::vector<int>{2, 3}));
+  }
+}
+
+TEST_CASE("octree.find_in_convex_volume")
+{
+  using plane = vm::plane<double, 3>;
+
+  auto tree = octree<double, int>{32.0};
+
+  // a box from (-8, -8, -8) to (40, 40, 40) with outward pointing normals
+  const auto box = std::vector<plane>{
+    plane{{40, 0, 0}, {1, 0, 0}},
+    plane{{-8, 0, 0}, {-1, 0, 0}},
+    plane{{0, 40, 0}, {0, 1, 0}},
+    plane{{0, -8, 0}, {0, -1, 0}},
+    plane{{0, 0, 40}, {0, 0, 1}},
+    plane{{0, 0, -8}, {0, 0, -1}},
+  };
+
+  SECTION("empty tree") { CHECK(tree.find_in_convex_volume(box).empty()); }
+
+  SECTION("single node")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    // the leaf that contains the data intersects the volume
+    CHECK(tree.find_in_convex_volume(box) == std::vector<int>{1});
+
+    // the leaf that contains the data is below a single plane
+    CHECK(
+      tree.find_in_convex_volume({plane{{0, 0, 100}, {0, 0, 1}}}) == std::vector<int>{1});
+
+    // the leaf that contains the data is above one of the planes
+    CHECK(tree.find_in_convex_volume({plane{{0, 0, 16}, {0, 0, 1}}}).empty());
+
+    // the leaf that contains the data is above a diagonal plane
+    const auto diagonal = plane{{16, 16, 16}, vm::normalize(vm::vec3d{1, 1, 1})};
+    CHECK(tree.find_in_convex_volume({diagonal}).empty());
+  }
+
+  SECTION("multiple nodes")
+  {
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+    tree.insert({{-16, -16, -16}, {16, 16, 16}}, 3);
+
+    CHECK_THAT(
+      tree.find_in_convex_volume(box), Catch::UnorderedEquals(std::vector<int>{1, 3}));
+  }
+}
+
 TEST_CASE("octree.find_containers")
 {
   auto tree = octree<double, int>{32.0};
@@ -0,0 +1,412 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kdl
+{
+namespace detail
+{
+struct block_pool_registry
+{
+  std::mutex mutex;
+  std::vector<void (*)()> trim_functions;
+};
+
+inline block_pool_registry& get_block_pool_registry()
+{
+  // deliberately leaked like the shared states of the pools
+  static auto* registry = new block_pool_registry{};
+  return *registry;
+}
+} // namespace detail
+
+/**
+ * Allocates memory blocks of a fixed size and alignment from larger chunks.
+ *
+ * Deallocated blocks are put into a free list and reused by later allocations. Every
+ * thread has its own free list, so that most allocations and deallocations don't need to
+ * synchronize with other threads. Blocks are moved between the thread local free lists
+ * and a shared free list in batches. A block may be deallocated by a different thread
+ * than the one that allocated it.
+ *
+ * A thread's local free list is destroyed when the thread exits, and its blocks are moved
+ * to the shared free list. Blocks that are allocated or deallocated by the thread after
+ * that, e.g. by destructors of static objects, are taken from or put into the shared free
+ * list directly. The shared free list is never destroyed.
+ *
+ * Chunks are only returned to the system when the pool is trimmed (see trim), otherwise
+ * the memory used by a pool grows up to the maximum number of blocks that were in use at
+ * the same time and remains reserved for later allocations.
+ *
+ * @tparam Size the size of the blocks
+ * @tparam Align the alignment of the blocks
+ * @tparam BatchSize the number of blocks per chunk, and the number of blocks that are
+ * moved between the thread local free lists and the shared free list at once
+ */
+template <std::size_t Size, std::size_t Align, std::size_t BatchSize = 256>
+class block_pool
+{
+private:
+  static_assert(
+    Align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "alignment is supported by operator new");
+  static_assert(BatchSize > 0, "batch size must not be zero");
+
+  struct free_block
+  {
+    free_block* next;
+  };
+
+  static constexpr std::size_t block_align =
+    Align > alignof(free_block) ? Align : alignof(free_block);
+  static constexpr std::size_t block_size =
+    ((Size > sizeof(free_block) ? Size : sizeof(free_block)) + block_align - 1u)
+    / block_align * block_align;
+
+  struct free_list
+  {
+    free_block* first = nullptr;
+    std::size_t count = 0;
+
+    void push(free_block* block)
+    {
+      block->next = first;
+      first = block;
+      ++count;
+    }
+
+    free_block* pop()
+    {
+      assert(first != nullptr);
+      auto* block = first;
+      first = block->next;
+      --count;
+      return block;
+    }
+
+    /**
+     * Moves up to the given number of blocks from the front of this list to the front of
+     * the given list.
+     */
+    void move_to(free_list& other, const std::size_t max_count)
+    {
+      auto moved = std::size_t(0);
+      while (first != nullptr && moved < max_count)
+      {
+        other.push(pop());
+        ++moved;
+      }
+    }
+
+    /**
+     * Moves all blocks of this list to the front of the given list.
+     */
+    void move_all_to(free_list& other)
+    {
+      while (first != nullptr)
+      {
+        other.push(pop());
+      }
+    }
+  };
+
+  struct shared_state
+  {
+    std::mutex mutex;
+    free_list blocks;
+    // sorted by address
+    std::vector<std::byte*> chunks;
+  };
+
+  struct local_state
+  {
+    free_list blocks;
+
+    ~local_state()
+    {
+      auto& shared = get_shared_state();
+      const auto lock = std::lock_guard{shared.mutex};
+      blocks.move_all_to(shared.blocks);
+      local_state_destroyed() = true;
+    }
+  };
+
+  static shared_state& get_shared_state()
+  {
+    // deliberately leaked so that it outlives all thread local states
+    static auto* state = []() {
+      auto& registry = detail::get_block_pool_registry();
+      const auto lock = std::lock_guard{registry.mutex};
+      registry.trim_functions.push_back(&trim);
+      return new shared_state{};
+    }();
+    return *state;
+  }
+
+  static bool& local_state_destroyed()
+  {
+    // trivially destructible, so it remains accessible after the calling thread's local
+    // state was destroyed
+    thread_local auto destroyed = false;
+    return destroyed;
+  }
+
+  static local_state& get_local_state()
+  {
+    thread_local auto state = local_state{};
+    return state;
+  }
+
+  // expects the shared mutex to be locked
+  static void add_chunk(shared_state& shared, free_list& list)
+  {
+    auto* chunk = static_cast<std::byte*>(::operator new(block_size * BatchSize));
+    shared.chunks.insert(
+      std::upper_bound(shared.chunks.begin(), shared.chunks.end(), chunk, std::less<>{}),
+      chunk);
+
+    // push the blocks in reverse order so that they are handed out in address order
+    for (std::size_t i = BatchSize; i > 0u; --i)
+    {
+      list.push(reinterpret_cast<free_block*>(chunk + (i - 1u) * block_size));
+    }
+  }
+
+  static void refill(free_list& local)
+  {
+    auto& shared = get_shared_state();
+    const auto lock = std::lock_guard{shared.mutex};
+
+    if (shared.blocks.count > 0u)
+    {
+      shared.blocks.move_to(local, BatchSize);
+      return;
+    }
+
+    add_chunk(shared, local);
+  }
+
+public:
+  /**
+   * Allocates a block of memory with the size and alignment of this pool.
+   */
+  static void* allocate()
+  {
+    if (local_state_destroyed())
+    {
+      auto& shared = get_shared_state();
+      const auto lock = std::lock_guard{shared.mutex};
+      if (shared.blocks.count == 0u)
+      {
+        add_chunk(shared, shared.blocks);
+      }
+      return shared.blocks.pop();
+    }
+
+    auto& local = get_local_state().blocks;
+    if (local.count == 0u)
+    {
+      refill(local);
+    }
+    return local.pop();
+  }
+
+  /**
+   * Deallocates a block of memory that was allocated by this pool.
+   */
+  static void deallocate(void* ptr) noexcept
+  {
+    if (ptr == nullptr)
+    {
+      return;
+    }
+
+    if (local_state_destroyed())
+    {
+      auto& shared = get_shared_state();
+      const auto lock = std::lock_guard{shared.mutex};
+      shared.blocks.push(static_cast<free_block*>(ptr));
+      return;
+    }
+
+    auto& local = get_local_state().blocks;
+    local.push(static_cast<free_block*>(ptr));
+
+    if (local.count > 2u * BatchSize)
+    {
+      auto& shared = get_shared_state();
+      const auto lock = std::lock_guard{shared.mutex};
+      local.move_to(shared.blocks, BatchSize);
+    }
+  }
+
+  /**
+   * Returns the number of chunks that this pool has allocated and not yet released.
+   */
+  static std::size_t chunk_count()
+  {
+    auto& shared = get_shared_state();
+    const auto lock = std::lock_guard{shared.mutex};
+    return shared.chunks.size();
+  }
+
+  /**
+   * Returns the chunks whose blocks are all free to the system.
+   *
+   * The free blocks of the calling thread are considered, but the free blocks of other
+   * threads are not, so chunks that contain such blocks are kept.
+   */
+  static void trim()
+  {
+    auto& shared = get_shared_state();
+    if (!local_state_destroyed())
+    {
+      auto& local = get_local_state().blocks;
+      const auto lock = std::lock_guard{shared.mutex};
+      local.move_all_to(shared.blocks);
+    }
+
+    const auto lock = std::lock_guard{shared.mutex};
+    const auto find_chunk = [&](const free_block* block) {
+      const auto* address = reinterpret_cast<const std::byte*>(block);
+      const auto it = std::upper_bound(
+        shared.chunks.begin(), shared.chunks.end(), address, std::less<>{});
+      assert(it != shared.chunks.begin());
+      return std::size_t(std::distance(shared.chunks.begin(), it) - 1);
+    };
+
+    auto free_counts = std::vector<std::size_t>(shared.chunks.size(), 0u);
+    for (auto* block = shared.blocks.first; block != nullptr; block = block->next)
+    {
+      ++free_counts[find_chunk(block)];
+    }
+
+    // unlink the blocks of the chunks that are entirely free
+    for (auto** next = &shared.blocks.first; *next != nullptr;)
+    {
+      if (free_counts[find_chunk(*next)] == BatchSize)
+      {
+        *next = (*next)->next;
+        --shared.blocks.count;
+      }
+      else
+      {
+        next = &(*next)->next;
+      }
+    }
+
+    auto kept_chunks = std::vector<std::byte*>{};
+    for (std::size_t i = 0; i < shared.chunks.size(); ++i)
+    {
+      if (free_counts[i] == BatchSize)
+      {
+        ::operator delete(shared.chunks[i]);
+      }
+      else
+      {
+        kept_chunks.push_back(shared.chunks[i]);
+      }
+    }
+    shared.chunks = std::move(kept_chunks);
+  }
+};
+
+/**
+ * A block pool for objects of the given type.
+ */
+template <typename T, std::size_t BatchSize = 256>
+using object_pool = block_pool<sizeof(T), alignof(T), BatchSize>;
+
+/**
+ * Trims every block pool that has been used so far (see block_pool::trim). Call this
+ * after freeing a large number of blocks, e.g. when a document was closed.
+ */
+inline void trim_block_pools()
+{
+  auto trim_functions = std::vector<void (*)()>{};
+  {
+    auto& registry = detail::get_block_pool_registry();
+    const auto lock = std::lock_guard{registry.mutex};
+    trim_functions = registry.trim_functions;
+  }
+
+  for (auto* trim_function : trim_functions)
+  {
+    trim_function();
+  }
+}
+
+/**
+ * A standard allocator which allocates single objects from an object_pool and arrays of
+ * objects with operator new. This is useful for node based containers such as std::map.
+ */
+template <typename T>
+class pool_allocator
+{
+public:
+  using value_type = T;
+
+  pool_allocator() noexcept = default;
+
+  template <typename U>
+  pool_allocator(const pool_allocator<U>&) noexcept
+  {
+  }
+
+  T* allocate(const std::size_t n)
+  {
+    return n == 1u ? static_cast<T*>(object_pool<T>::allocate())
+                   : static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, const std::size_t n) noexcept
+  {
+    if (n == 1u)
+    {
+      object_pool<T>::deallocate(ptr);
+    }
+    else
+    {
+      ::operator delete(ptr);
+    }
+  }
+
+  template <typename U>
+  friend bool operator==(const pool_allocator&, const pool_allocator<U>&) noexcept
+  {
+    return true;
+  }
+
+  template <typename U>
+  friend bool operator!=(const pool_allocator&, const pool_allocator<U>&) noexcept
+  {
+    return false;
+  }
+};
+
+} // namespace kdl
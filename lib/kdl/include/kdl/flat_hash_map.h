@@ -0,0 +1,185 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "kdl/flat_hash_table.h"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace kdl
+{
+/**
+ * A hash map that stores its entries in a single contiguous array using open addressing.
+ *
+ * Compared to std::unordered_map, inserting and erasing entries does not allocate memory
+ * for every entry, and iterating and looking up entries causes fewer cache misses. This
+ * makes it suitable for maps with many small entries that change frequently, such as maps
+ * keyed by pointers.
+ *
+ * Inserting or erasing an entry invalidates all iterators, pointers and references to the
+ * entries of the map.
+ */
+template <
+  typename K,
+  typename V,
+  typename Hash = std::hash<K>,
+  typename KeyEqual = std::equal_to<K>>
+class flat_hash_map
+{
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<const K, V>;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+private:
+  struct key_of
+  {
+    const K& operator()(const value_type& value) const { return value.first; }
+  };
+
+  using table_type = detail::flat_hash_table<value_type, K, key_of, Hash, KeyEqual>;
+  table_type m_table;
+
+public:
+  using iterator = typename table_type::iterator;
+  using const_iterator = typename table_type::const_iterator;
+
+  flat_hash_map() = default;
+
+  flat_hash_map(std::initializer_list<value_type> values)
+  {
+    m_table.reserve(values.size());
+    for (const auto& value : values)
+    {
+      insert(value);
+    }
+  }
+
+  iterator begin() { return m_table.begin(); }
+  iterator end() { return m_table.end(); }
+  const_iterator begin() const { return m_table.begin(); }
+  const_iterator end() const { return m_table.end(); }
+  const_iterator cbegin() const { return m_table.begin(); }
+  const_iterator cend() const { return m_table.end(); }
+
+  bool empty() const { return m_table.empty(); }
+  size_type size() const { return m_table.size(); }
+  size_type capacity() const { return m_table.capacity(); }
+
+  void reserve(const size_type count) { m_table.reserve(count); }
+
+  /**
+   * Removes all entries. The memory used by the map is not released.
+   */
+  void clear() { m_table.clear(); }
+
+  iterator find(const K& key) { return m_table.find(key); }
+  const_iterator find(const K& key) const { return m_table.find(key); }
+  size_type count(const K& key) const { return m_table.count(key); }
+
+  V& at(const K& key)
+  {
+    const auto it = find(key);
+    if (it == end())
+    {
+      throw std::out_of_range{"key not found"};
+    }
+    return it->second;
+  }
+
+  const V& at(const K& key) const
+  {
+    const auto it = find(key);
+    if (it == end())
+    {
+      throw std::out_of_range{"key not found"};
+    }
+    return it->second;
+  }
+
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+  {
+    return m_table.emplace_with_key(
+      key,
+      std::piecewise_construct,
+      std::forward_as_tuple(key),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value)
+  {
+    return m_table.emplace_with_key(value.first, value);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value)
+  {
+    const auto key = value.first;
+    return m_table.emplace_with_key(key, std::move(value));
+  }
+
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& mapped)
+  {
+    auto result = try_emplace(key, std::forward<M>(mapped));
+    if (!result.second)
+    {
+      result.first->second = std::forward<M>(mapped);
+    }
+    return result;
+  }
+
+  void erase(const const_iterator pos) { m_table.erase(pos); }
+  size_type erase(const K& key) { return m_table.erase(key); }
+
+  friend bool operator==(const flat_hash_map& lhs, const flat_hash_map& rhs)
+  {
+    if (lhs.size() != rhs.size())
+    {
+      return false;
+    }
+    for (const auto& [key, value] : lhs)
+    {
+      const auto it = rhs.find(key);
+      if (it == rhs.end() || !(it->second == value))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flat_hash_map& lhs, const flat_hash_map& rhs)
+  {
+    return !(lhs == rhs);
+  }
+};
+} // namespace kdl
@@ -0,0 +1,131 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "kdl/flat_hash_table.h"
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+namespace kdl
+{
+/**
+ * A hash set that stores its values in a single contiguous array using open addressing.
+ *
+ * Compared to std::unordered_set, inserting and erasing values does not allocate memory
+ * for every value, and iterating and looking up values causes fewer cache misses. This
+ * makes it suitable for sets of small values that change frequently, such as pointers.
+ *
+ * Inserting or erasing a value invalidates all iterators, pointers and references to the
+ * values of the set.
+ */
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class flat_hash_set
+{
+public:
+  using key_type = T;
+  using value_type = T;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+private:
+  struct key_of
+  {
+    const T& operator()(const T& value) const { return value; }
+  };
+
+  using table_type = detail::flat_hash_table<T, T, key_of, Hash, KeyEqual>;
+  table_type m_table;
+
+public:
+  // the values of a set must not be modified
+  using iterator = typename table_type::const_iterator;
+  using const_iterator = typename table_type::const_iterator;
+
+  flat_hash_set() = default;
+
+  flat_hash_set(std::initializer_list<T> values)
+  {
+    m_table.reserve(values.size());
+    for (const auto& value : values)
+    {
+      insert(value);
+    }
+  }
+
+  const_iterator begin() const { return m_table.begin(); }
+  const_iterator end() const { return m_table.end(); }
+  const_iterator cbegin() const { return m_table.begin(); }
+  const_iterator cend() const { return m_table.end(); }
+
+  bool empty() const { return m_table.empty(); }
+  size_type size() const { return m_table.size(); }
+  size_type capacity() const { return m_table.capacity(); }
+
+  void reserve(const size_type count) { m_table.reserve(count); }
+
+  /**
+   * Removes all values. The memory used by the set is not released.
+   */
+  void clear() { m_table.clear(); }
+
+  const_iterator find(const T& value) const { return m_table.find(value); }
+  size_type count(const T& value) const { return m_table.count(value); }
+
+  std::pair<iterator, bool> insert(const T& value)
+  {
+    return m_table.emplace_with_key(value, value);
+  }
+
+  std::pair<iterator, bool> insert(T&& value)
+  {
+    const auto& key = value;
+    return m_table.emplace_with_key(key, std::move(value));
+  }
+
+  void erase(const const_iterator pos) { m_table.erase(pos); }
+  size_type erase(const T& value) { return m_table.erase(value); }
+
+  friend bool operator==(const flat_hash_set& lhs, const flat_hash_set& rhs)
+  {
+    if (lhs.size() != rhs.size())
+    {
+      return false;
+    }
+    for (const auto& value : lhs)
+    {
+      if (rhs.count(value) == 0u)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flat_hash_set& lhs, const flat_hash_set& rhs)
+  {
+    return !(lhs == rhs);
+  }
+};
+} // namespace kdl
@@ -0,0 +1,375 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdl
+{
+namespace detail
+{
+/**
+ * An open addressing hash table with linear probing that stores its values in a single
+ * contiguous array. This is the implementation of flat_hash_map and flat_hash_set.
+ *
+ * Erasing a value moves the following values of its probe sequence back to close the
+ * gap, so the table never contains tombstones and lookups remain fast after many values
+ * were inserted and erased.
+ *
+ * Unlike the standard unordered containers, inserting or erasing a value may move other
+ * values, so any insertion or erasure invalidates all iterators, pointers and references
+ * into the table.
+ *
+ * @tparam Value the type of the stored values
+ * @tparam Key the type of the keys
+ * @tparam KeyOf a function object type that returns the key of a value
+ * @tparam Hash the hash function object type
+ * @tparam KeyEqual the key equality function object type
+ */
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+class flat_hash_table
+{
+private:
+  using slot_type = std::optional<Value>;
+
+  static constexpr std::size_t min_capacity = 8u;
+
+  template <bool Const>
+  class iterator_impl
+  {
+  private:
+    using slot_ptr = std::conditional_t<Const, const slot_type*, slot_type*>;
+
+    slot_ptr m_slot{nullptr};
+    slot_ptr m_end{nullptr};
+
+    friend class flat_hash_table;
+    friend class iterator_impl<!Const>;
+
+    iterator_impl(slot_ptr slot, slot_ptr end)
+      : m_slot{slot}
+      , m_end{end}
+    {
+      skip_empty();
+    }
+
+    void skip_empty()
+    {
+      while (m_slot != m_end && !m_slot->has_value())
+      {
+        ++m_slot;
+      }
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Value*, Value*>;
+    using reference = std::conditional_t<Const, const Value&, Value&>;
+
+    iterator_impl() = default;
+
+    template <bool C = Const, typename = std::enable_if_t<C>>
+    iterator_impl(const iterator_impl<false>& other)
+      : m_slot{other.m_slot}
+      , m_end{other.m_end}
+    {
+    }
+
+    reference operator*() const { return **m_slot; }
+
+    pointer operator->() const { return &**m_slot; }
+
+    iterator_impl& operator++()
+    {
+      ++m_slot;
+      skip_empty();
+      return *this;
+    }
+
+    iterator_impl operator++(int)
+    {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs)
+    {
+      return lhs.m_slot == rhs.m_slot;
+    }
+
+    friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs)
+    {
+      return !(lhs == rhs);
+    }
+  };
+
+public:
+  using iterator = iterator_impl<false>;
+  using const_iterator = iterator_impl<true>;
+
+private:
+  // the number of slots is either zero or a power of two
+  std::vector<slot_type> m_slots;
+  std::size_t m_size{0u};
+  unsigned int m_shift{0u};
+  Hash m_hash;
+  KeyEqual m_key_equal;
+
+public:
+  flat_hash_table() = default;
+
+  flat_hash_table(const flat_hash_table& other) = default;
+
+  flat_hash_table(flat_hash_table&& other) noexcept
+    : m_slots{std::move(other.m_slots)}
+    , m_size{std::exchange(other.m_size, 0u)}
+    , m_shift{other.m_shift}
+    , m_hash{std::move(other.m_hash)}
+    , m_key_equal{std::move(other.m_key_equal)}
+  {
+    other.m_slots.clear();
+  }
+
+  // std::pair<const K, V> is not assignable, so the slots cannot be copy assigned
+  flat_hash_table& operator=(flat_hash_table other) noexcept
+  {
+    swap(*this, other);
+    return *this;
+  }
+
+  friend void swap(flat_hash_table& lhs, flat_hash_table& rhs) noexcept
+  {
+    using std::swap;
+    swap(lhs.m_slots, rhs.m_slots);
+    swap(lhs.m_size, rhs.m_size);
+    swap(lhs.m_shift, rhs.m_shift);
+    swap(lhs.m_hash, rhs.m_hash);
+    swap(lhs.m_key_equal, rhs.m_key_equal);
+  }
+
+  iterator begin() { return iterator{m_slots.data(), slots_end()}; }
+  iterator end() { return iterator{slots_end(), slots_end()}; }
+  const_iterator begin() const { return const_iterator{m_slots.data(), slots_end()}; }
+  const_iterator end() const { return const_iterator{slots_end(), slots_end()}; }
+
+  bool empty() const { return m_size == 0u; }
+  std::size_t size() const { return m_size; }
+
+  /**
+   * Returns the number of slots, which is always greater than the size unless the table
+   * is empty.
+   */
+  std::size_t capacity() const { return m_slots.size(); }
+
+  /**
+   * Ensures that the given number of values can be stored without rehashing.
+   */
+  void reserve(const std::size_t count)
+  {
+    auto capacity = std::max(min_capacity, m_slots.size());
+    while (exceeds_max_load(count, capacity))
+    {
+      capacity *= 2u;
+    }
+    if (capacity != m_slots.size())
+    {
+      rehash(capacity);
+    }
+  }
+
+  /**
+   * Removes all values, but keeps the slots so that they can be reused.
+   */
+  void clear()
+  {
+    if (m_size > 0u)
+    {
+      for (auto& slot : m_slots)
+      {
+        slot.reset();
+      }
+      m_size = 0u;
+    }
+  }
+
+  iterator find(const Key& key) { return make_iterator(find_index(key)); }
+
+  const_iterator find(const Key& key) const
+  {
+    return const_iterator{m_slots.data() + find_index(key), slots_end()};
+  }
+
+  std::size_t count(const Key& key) const
+  {
+    return find_index(key) != m_slots.size() ? 1u : 0u;
+  }
+
+  /**
+   * Inserts a value constructed from the given arguments unless a value with the given
+   * key exists already. The constructed value must have the given key, and the key must
+   * not be used after the value was constructed, since it may have been moved from.
+   *
+   * @return an iterator to the value with the given key and true if a value was inserted
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> emplace_with_key(const Key& key, Args&&... args)
+  {
+    if (const auto index = find_index(key); index != m_slots.size())
+    {
+      return {make_iterator(index), false};
+    }
+
+    if (exceeds_max_load(m_size + 1u, m_slots.size()))
+    {
+      rehash(std::max(min_capacity, m_slots.size() * 2u));
+    }
+
+    const auto index = free_index_for(key);
+    m_slots[index].emplace(std::forward<Args>(args)...);
+    ++m_size;
+    return {make_iterator(index), true};
+  }
+
+  void erase(const const_iterator pos)
+  {
+    assert(pos.m_slot != slots_end() && pos.m_slot->has_value());
+    erase_index(static_cast<std::size_t>(pos.m_slot - m_slots.data()));
+  }
+
+  std::size_t erase(const Key& key)
+  {
+    if (const auto index = find_index(key); index != m_slots.size())
+    {
+      erase_index(index);
+      return 1u;
+    }
+    return 0u;
+  }
+
+private:
+  slot_type* slots_end() { return m_slots.data() + m_slots.size(); }
+  const slot_type* slots_end() const { return m_slots.data() + m_slots.size(); }
+
+  iterator make_iterator(const std::size_t index)
+  {
+    return iterator{m_slots.data() + index, slots_end()};
+  }
+
+  static bool exceeds_max_load(const std::size_t count, const std::size_t capacity)
+  {
+    // the maximum load factor is 3/4
+    return count * 4u > capacity * 3u;
+  }
+
+  std::size_t mask() const { return m_slots.size() - 1u; }
+
+  std::size_t ideal_index(const Key& key) const
+  {
+    // Fibonacci hashing spreads hash values that differ only in their high bits, such as
+    // aligned pointers with an identity hash, over all slots.
+    const auto hash = static_cast<std::uint64_t>(m_hash(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash >> m_shift);
+  }
+
+  std::size_t find_index(const Key& key) const
+  {
+    if (m_size == 0u)
+    {
+      return m_slots.size();
+    }
+
+    for (auto i = ideal_index(key);; i = (i + 1u) & mask())
+    {
+      if (!m_slots[i])
+      {
+        return m_slots.size();
+      }
+      if (m_key_equal(KeyOf{}(*m_slots[i]), key))
+      {
+        return i;
+      }
+    }
+  }
+
+  std::size_t free_index_for(const Key& key) const
+  {
+    auto i = ideal_index(key);
+    while (m_slots[i])
+    {
+      i = (i + 1u) & mask();
+    }
+    return i;
+  }
+
+  void rehash(const std::size_t capacity)
+  {
+    assert(capacity >= min_capacity && (capacity & (capacity - 1u)) == 0u);
+    assert(!exceeds_max_load(m_size, capacity));
+
+    auto old_slots = std::exchange(m_slots, std::vector<slot_type>(capacity));
+
+    m_shift = 64u;
+    for (auto c = capacity; c > 1u; c >>= 1u)
+    {
+      --m_shift;
+    }
+
+    for (auto& slot : old_slots)
+    {
+      if (slot)
+      {
+        m_slots[free_index_for(KeyOf{}(*slot))].emplace(std::move(*slot));
+      }
+    }
+  }
+
+  void erase_index(std::size_t hole)
+  {
+    m_slots[hole].reset();
+    --m_size;
+
+    // Move the following values of the probe sequence back into the hole unless their
+    // ideal slot lies after the hole, in which case they must stay where they are.
+    for (auto i = (hole + 1u) & mask(); m_slots[i]; i = (i + 1u) & mask())
+    {
+      const auto ideal = ideal_index(KeyOf{}(*m_slots[i]));
+      if (((i - ideal) & mask()) >= ((i - hole) & mask()))
+      {
+        m_slots[hole].emplace(std::move(*m_slots[i]));
+        m_slots[i].reset();
+        hole = i;
+      }
+    }
+  }
+};
+} // namespace detail
+} // namespace kdl
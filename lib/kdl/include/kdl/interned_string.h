@@ -0,0 +1,211 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace kdl
+{
+namespace detail
+{
+/**
+ * Stores one copy of every distinct string that was interned. The strings are stored in
+ * deques so that their addresses remain stable when more strings are added. Strings are
+ * never removed from the pool.
+ *
+ * The pool is split into shards that are selected by the hash of a string. Each shard has
+ * its own mutex, so that threads which intern different strings rarely wait for each
+ * other, e.g. when a map is parsed in parallel.
+ */
+class string_pool
+{
+private:
+  struct shard
+  {
+    std::mutex mutex;
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, const std::string*> index;
+  };
+
+  static constexpr std::size_t ShardCount = 64;
+  std::array<shard, ShardCount> m_shards;
+
+public:
+  const std::string* const empty_str = intern(std::string_view{});
+
+  const std::string* intern(const std::string_view str)
+  {
+    auto& shard = m_shards[std::hash<std::string_view>{}(str) % ShardCount];
+
+    const auto lock = std::lock_guard{shard.mutex};
+    if (const auto it = shard.index.find(str); it != shard.index.end())
+    {
+      return it->second;
+    }
+
+    const auto& pooled = shard.strings.emplace_back(str);
+    shard.index.emplace(std::string_view{pooled}, &pooled);
+    return &pooled;
+  }
+
+  std::size_t size()
+  {
+    auto result = std::size_t{0};
+    for (auto& shard : m_shards)
+    {
+      const auto lock = std::lock_guard{shard.mutex};
+      result += shard.strings.size();
+    }
+    return result;
+  }
+
+  static string_pool& instance()
+  {
+    // intentionally leaked so that interned strings remain valid during static
+    // destruction
+    static auto* pool = new string_pool{};
+    return *pool;
+  }
+};
+} // namespace detail
+
+/**
+ * An immutable string that refers to a single shared copy of its value in a global pool.
+ *
+ * Creating an interned string requires a lookup in the pool, but copying, assigning and
+ * comparing interned strings for equality is as cheap as copying or comparing a pointer.
+ * All copies of an interned string share the same storage, so storing many equal strings
+ * only requires the memory for a pointer each.
+ *
+ * This is suitable for values that are repeated many times, such as the texture names of
+ * brush faces. The pool only ever grows, so it should not be used for arbitrary strings.
+ */
+class interned_string
+{
+private:
+  const std::string* m_str;
+
+public:
+  /**
+   * Creates an empty interned string.
+   */
+  interned_string()
+    : m_str{detail::string_pool::instance().empty_str}
+  {
+  }
+
+  /**
+   * Creates an interned string with the given value. This requires a lookup in the pool,
+   * which is guarded by a mutex per shard of the pool.
+   */
+  explicit interned_string(const std::string_view str)
+    : m_str{detail::string_pool::instance().intern(str)}
+  {
+  }
+
+  /**
+   * Returns the pooled value of this string. The returned reference remains valid for the
+   * lifetime of the program.
+   */
+  const std::string& str() const { return *m_str; }
+
+  bool empty() const { return m_str->empty(); }
+
+  /**
+   * Returns the number of distinct strings that were interned so far.
+   */
+  static std::size_t pool_size() { return detail::string_pool::instance().size(); }
+
+  friend bool operator==(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_str == rhs.m_str;
+  }
+
+  friend bool operator!=(const interned_string& lhs, const interned_string& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const interned_string& lhs, const interned_string& rhs)
+  {
+    return lhs.m_str != rhs.m_str && *lhs.m_str < *rhs.m_str;
+  }
+
+  friend bool operator<=(const interned_string& lhs, const interned_string& rhs)
+  {
+    return !(rhs < lhs);
+  }
+
+  friend bool operator>(const interned_string& lhs, const interned_string& rhs)
+  {
+    return rhs < lhs;
+  }
+
+  friend bool operator>=(const interned_string& lhs, const interned_string& rhs)
+  {
+    return !(lhs < rhs);
+  }
+
+  friend bool operator==(const interned_string& lhs, const std::string_view rhs)
+  {
+    return *lhs.m_str == rhs;
+  }
+
+  friend bool operator==(const std::string_view lhs, const interned_string& rhs)
+  {
+    return rhs == lhs;
+  }
+
+  friend bool operator!=(const interned_string& lhs, const std::string_view rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator!=(const std::string_view lhs, const interned_string& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend std::ostream& operator<<(std::ostream& str, const interned_string& s)
+  {
+    str << *s.m_str;
+    return str;
+  }
+
+  friend struct std::hash<interned_string>;
+};
+} // namespace kdl
+
+template <>
+struct std::hash<kdl::interned_string>
+{
+  std::size_t operator()(const kdl::interned_string& s) const noexcept
+  {
+    return std::hash<const std::string*>{}(s.m_str);
+  }
+};
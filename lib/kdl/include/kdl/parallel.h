@@ -21,102 +21,179 @@
 #ifndef KDL_PARALLEL_H
 #define KDL_PARALLEL_H
 
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
-#ifdef _WIN32
-#include <ppl.h>
-#endif
-
+#include <algorithm>
 #include <atomic>
-#include <future> // for std::async
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <thread>
 #include <utility> // for std::declval
 #include <vector>
 
 namespace kdl
 {
+namespace detail
+{
+struct parallel_for_state
+{
+  size_t count;
+  size_t chunk_size;
+  size_t num_chunks;
+
+  std::atomic<size_t> next_chunk = 0;
+  std::atomic<bool> failed = false;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t finished_chunks = 0;
+  std::exception_ptr exception;
+
+  parallel_for_state(const size_t count_, const size_t chunk_size_)
+    : count{count_}
+    , chunk_size{chunk_size_}
+    , num_chunks{(count_ + chunk_size_ - 1) / chunk_size_}
+  {
+  }
+};
+
+/**
+ * Claims and runs chunks until no chunks are left. The lambda is only accessed while a
+ * chunk is claimed, so it is safe to call this after the thread that started the loop
+ * has returned.
+ */
+template <class L>
+void run_parallel_for_chunks(parallel_for_state& state, L& lambda)
+{
+  size_t finished = 0;
+  while (true)
+  {
+    const auto chunk = state.next_chunk.fetch_add(1);
+    if (chunk >= state.num_chunks)
+    {
+      break;
+    }
+
+    if (!state.failed)
+    {
+      const auto first = chunk * state.chunk_size;
+      const auto last = std::min(first + state.chunk_size, state.count);
+      try
+      {
+        for (size_t i = first; i < last; ++i)
+        {
+          lambda(i);
+        }
+      }
+      catch (...)
+      {
+        const auto lock = std::lock_guard{state.mutex};
+        if (!state.exception)
+        {
+          state.exception = std::current_exception();
+        }
+        state.failed = true;
+      }
+    }
+    ++finished;
+  }
+
+  if (finished > 0)
+  {
+    const auto lock = std::lock_guard{state.mutex};
+    state.finished_chunks += finished;
+    if (state.finished_chunks == state.num_chunks)
+    {
+      state.condition.notify_all();
+    }
+  }
+}
+} // namespace detail
+
 /**
  * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
  *
- * Lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
+ * The index range is split into chunks which are processed in parallel by the workers of
+ * the given thread pool and the calling thread. The calling thread keeps processing
+ * chunks until none are left, so it is safe to call this function from within a lambda
+ * that is itself run by parallel_for: if all workers are busy, the calling thread
+ * processes all chunks on its own.
  *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * If the lambda throws an exception, the remaining chunks are skipped and the first
+ * exception is rethrown once all running chunks have finished.
  *
  * @tparam L type of lambda
  * @param count the maximum value (exclusive) to pass to lambda
  * @param lambda the lambda to run
+ * @param pool the thread pool to use, defaults to the process wide thread pool
  */
 template <class L>
-void parallel_for(const size_t count, L&& lambda)
+void parallel_for(
+  const size_t count, L&& lambda, thread_pool& pool = default_thread_pool())
 {
-#ifdef _WIN32
-  concurrency::parallel_for<size_t>(0, count, lambda);
-#else
-  size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-  if (numThreads == 0)
+  // create a few chunks per thread so that uneven work loads are balanced
+  constexpr size_t ChunksPerThread = 4;
+  const auto chunk_size =
+    std::max(count / (pool.concurrency() * ChunksPerThread), size_t(1));
+
+  if (count <= chunk_size)
   {
-    numThreads = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+      lambda(i);
+    }
+    return;
   }
 
-  std::atomic<size_t> nextIndex(0);
+  auto state = std::make_shared<detail::parallel_for_state>(count, chunk_size);
 
-  std::vector<std::future<void>> threads;
-  threads.resize(numThreads);
-
-  for (size_t i = 0; i < numThreads; ++i)
+  const auto num_helpers = std::min(pool.num_workers(), state->num_chunks - 1);
+  for (size_t i = 0; i < num_helpers; ++i)
   {
-    threads[i] = std::async(std::launch::async, [&]() {
-      while (true)
-      {
-        const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-        if (ourIndex >= count)
-        {
-          break;
-        }
-        lambda(ourIndex);
-      }
-    });
+    pool.submit([state, &lambda]() { detail::run_parallel_for_chunks(*state, lambda); });
   }
 
-  for (size_t i = 0; i < numThreads; ++i)
+  detail::run_parallel_for_chunks(*state, lambda);
+
+  auto lock = std::unique_lock{state->mutex};
+  state->condition.wait(
+    lock, [&]() { return state->finished_chunks == state->num_chunks; });
+
+  if (state->exception)
   {
-    threads[i].wait();
+    std::rethrow_exception(state->exception);
   }
-#endif
 }
 
 /**
  * Applies the given lambda to each element of the input (passing elements as rvalue
  * references), and returns a vector of the resulting values, in their original order.
  *
- * The lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
- *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * The lambda is executed in parallel using the given thread pool, see parallel_for.
  *
  * @tparam T the type of the vector elements
  * @tparam L the type of the lambda to apply
  * @param input the vector
  * @param transform the lambda to apply, must be of type `auto(T&&)`
+ * @param pool the thread pool to use, defaults to the process wide thread pool
  * @return a vector containing the transformed values
  */
 template <class T, class L>
-auto vec_parallel_transform(std::vector<T> input, L&& transform)
+auto vec_parallel_transform(
+  std::vector<T> input, L&& transform, thread_pool& pool = default_thread_pool())
 {
   using ResultType = std::optional<decltype(transform(std::declval<T&&>()))>;
 
   std::vector<ResultType> result;
   result.resize(input.size());
 
-  parallel_for(input.size(), [&](const size_t index) {
-    result[index] = transform(std::move(input[index]));
-  });
+  parallel_for(
+    input.size(),
+    [&](const size_t index) { result[index] = transform(std::move(input[index])); },
+    pool);
 
   return vec_transform(std::move(result), [](ResultType&& x) { return std::move(*x); });
 }
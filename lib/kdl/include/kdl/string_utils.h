@@ -24,7 +24,12 @@
 
 #include <algorithm> // for std::search
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
+#include <limits>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -331,6 +336,109 @@ inline std::optional<long> str_to_long(const std::string& str)
   }
 }
 
+namespace detail
+{
+/**
+ * Copies the given range into a null terminated buffer on the stack and passes it to the
+ * given function. Ranges that don't fit into the buffer are copied into a std::string.
+ */
+template <typename F>
+auto with_null_terminated(const char* begin, const char* end, const F& f)
+{
+  constexpr auto BufferSize = size_t(64);
+
+  const auto length = static_cast<size_t>(end - begin);
+  if (length >= BufferSize)
+  {
+    const auto str = std::string{begin, end};
+    return f(str.c_str());
+  }
+
+  char buffer[BufferSize];
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+  return f(static_cast<const char*>(buffer));
+}
+
+inline bool is_decimal_digit(const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/**
+ * Parses a range of the form [+-]digits that has at most 18 digits without any
+ * conversions or allocations. Returns an empty optional if the range has any other form.
+ */
+inline std::optional<std::int64_t> str_to_int64_fast_path(
+  const char* begin, const char* end)
+{
+  constexpr auto MaxDigits = std::ptrdiff_t(18);
+
+  auto* c = begin;
+  const auto negative = c != end && *c == '-';
+  if (c != end && (*c == '+' || *c == '-'))
+  {
+    ++c;
+  }
+
+  if (c == end || end - c > MaxDigits)
+  {
+    return std::nullopt;
+  }
+
+  auto result = std::int64_t(0);
+  for (; c != end; ++c)
+  {
+    if (!is_decimal_digit(*c))
+    {
+      return std::nullopt;
+    }
+    result = result * 10 + (*c - '0');
+  }
+
+  return negative ? -result : result;
+}
+} // namespace detail
+
+/**
+ * Interprets the given range of characters as a signed long integer and returns it. If
+ * the range cannot be parsed, returns an empty optional.
+ *
+ * This behaves like str_to_long(const std::string&), but ranges that consist of an
+ * optional sign and a few digits are parsed directly, and no other range requires a heap
+ * allocation unless it is longer than 63 characters.
+ *
+ * @param begin the start of the range
+ * @param end the end of the range
+ * @return the signed long integer value or an empty optional if the given range cannot
+ * be interpreted as a signed long integer
+ */
+inline std::optional<long> str_to_long(const char* begin, const char* end)
+{
+  if (const auto result = detail::str_to_int64_fast_path(begin, end))
+  {
+    if (
+      *result < std::numeric_limits<long>::min()
+      || *result > std::numeric_limits<long>::max())
+    {
+      return std::nullopt;
+    }
+    return static_cast<long>(*result);
+  }
+
+  return detail::with_null_terminated(
+    begin, end, [](const char* str) -> std::optional<long> {
+      char* parse_end = nullptr;
+      errno = 0;
+      const auto result = std::strtol(str, &parse_end, 10);
+      if (parse_end == str || errno == ERANGE)
+      {
+        return std::nullopt;
+      }
+      return result;
+    });
+}
+
 /**
  * Interprets the given string as a signed long long integer and returns it. If the given
  * string cannot be parsed, returns an empty optional.
@@ -475,6 +583,161 @@ inline std::optional<double> str_to_double(const std::string& str)
   }
 }
 
+namespace detail
+{
+/**
+ * Parses a range of the form [+-]digits[.digits][(e|E)[+-]digits] without any
+ * conversions or allocations. Returns an empty optional if the range has any other form
+ * or if the result cannot be computed exactly.
+ *
+ * Integers up to 2^53 and powers of ten up to 10^22 are exact doubles, so the product or
+ * quotient of two such values is correctly rounded and therefore identical to the result
+ * of strtod (Clinger's fast path).
+ */
+inline std::optional<double> str_to_double_fast_path(const char* begin, const char* end)
+{
+  constexpr auto MaxMantissa = std::uint64_t(1) << 53;
+  constexpr auto MaxExponent = 22;
+  constexpr double PowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  auto* c = begin;
+  const auto negative = c != end && *c == '-';
+  if (c != end && (*c == '+' || *c == '-'))
+  {
+    ++c;
+  }
+
+  auto mantissa = std::uint64_t(0);
+  auto exponent = 0;
+  auto has_digits = false;
+
+  const auto read_digit = [&](const bool is_fraction) {
+    const auto digit = static_cast<std::uint64_t>(*c - '0');
+    if (mantissa > (MaxMantissa - digit) / 10)
+    {
+      return false;
+    }
+    mantissa = mantissa * 10 + digit;
+    has_digits = true;
+    if (is_fraction)
+    {
+      --exponent;
+    }
+    return true;
+  };
+
+  for (; c != end && is_decimal_digit(*c); ++c)
+  {
+    if (!read_digit(false))
+    {
+      return std::nullopt;
+    }
+  }
+
+  if (c != end && *c == '.')
+  {
+    for (++c; c != end && is_decimal_digit(*c); ++c)
+    {
+      if (!read_digit(true))
+      {
+        return std::nullopt;
+      }
+    }
+  }
+
+  if (!has_digits)
+  {
+    return std::nullopt;
+  }
+
+  if (c != end && (*c == 'e' || *c == 'E'))
+  {
+    ++c;
+    const auto negative_exponent = c != end && *c == '-';
+    if (c != end && (*c == '+' || *c == '-'))
+    {
+      ++c;
+    }
+    if (c == end)
+    {
+      return std::nullopt;
+    }
+
+    auto explicit_exponent = 0;
+    for (; c != end && is_decimal_digit(*c); ++c)
+    {
+      explicit_exponent = explicit_exponent * 10 + (*c - '0');
+      if (explicit_exponent > 2 * MaxExponent)
+      {
+        return std::nullopt;
+      }
+    }
+    exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+
+  if (c != end)
+  {
+    return std::nullopt;
+  }
+
+  // integer valued numbers, by far the most common case in map files, are exact already
+  auto result = static_cast<double>(mantissa);
+  if (exponent < 0)
+  {
+    if (exponent < -MaxExponent)
+    {
+      return std::nullopt;
+    }
+    result /= PowersOfTen[-exponent];
+  }
+  else if (exponent > 0)
+  {
+    if (exponent > MaxExponent)
+    {
+      return std::nullopt;
+    }
+    result *= PowersOfTen[exponent];
+  }
+
+  return negative ? -result : result;
+}
+} // namespace detail
+
+/**
+ * Interprets the given range of characters as a 64 bit floating point value and returns
+ * it. If the range cannot be parsed, returns an empty optional.
+ *
+ * This behaves like str_to_double(const std::string&), but ranges that contain plain
+ * decimal numbers are parsed directly, and no other range requires a heap allocation
+ * unless it is longer than 63 characters.
+ *
+ * @param begin the start of the range
+ * @param end the end of the range
+ * @return the 64 bit floating point value or an empty optional if the given range cannot
+ * be interpreted as a 64 bit floating point value
+ */
+inline std::optional<double> str_to_double(const char* begin, const char* end)
+{
+  if (const auto result = detail::str_to_double_fast_path(begin, end))
+  {
+    return result;
+  }
+
+  return detail::with_null_terminated(
+    begin, end, [](const char* str) -> std::optional<double> {
+      char* parse_end = nullptr;
+      errno = 0;
+      const auto result = std::strtod(str, &parse_end);
+      if (parse_end == str || errno == ERANGE)
+      {
+        return std::nullopt;
+      }
+      return result;
+    });
+}
+
 /**
  * Interprets the given string as a long double value value and returns it. If the given
  * string cannot be parsed, returns an empty optional.
@@ -0,0 +1,284 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace kdl
+{
+/**
+ * A fixed size pool of worker threads which execute submitted tasks.
+ *
+ * Every worker owns a task queue. A worker takes tasks from the back of its own queue
+ * and, if its own queue is empty, steals tasks from the front of the other workers'
+ * queues. Tasks submitted by a worker of this pool are pushed onto that worker's queue,
+ * tasks submitted by any other thread are distributed over all queues in a round robin
+ * fashion.
+ *
+ * The workers are started when the pool is created and joined when it is destroyed. The
+ * destructor waits until all pending tasks have been executed.
+ *
+ * Tasks must not throw exceptions.
+ */
+class thread_pool
+{
+public:
+  using task = std::function<void()>;
+
+private:
+  struct task_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  struct worker_info
+  {
+    const thread_pool* pool = nullptr;
+    size_t index = 0;
+  };
+
+  std::vector<std::unique_ptr<task_queue>> m_queues;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  size_t m_pendingTasks = 0;
+  bool m_stop = false;
+
+  std::atomic<size_t> m_nextQueue = 0;
+
+public:
+  /**
+   * Creates a new thread pool with the given number of worker threads. If the number of
+   * workers is 0, then every submitted task is executed immediately by the submitting
+   * thread.
+   */
+  explicit thread_pool(const size_t num_workers)
+  {
+    m_queues.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i)
+    {
+      m_queues.push_back(std::make_unique<task_queue>());
+    }
+
+    m_workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i)
+    {
+      m_workers.emplace_back([this, i]() { run_worker(i); });
+    }
+  }
+
+  ~thread_pool()
+  {
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+      worker.join();
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool(thread_pool&&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+  thread_pool& operator=(thread_pool&&) = delete;
+
+  /**
+   * Returns the number of worker threads of this pool.
+   */
+  size_t num_workers() const { return m_workers.size(); }
+
+  /**
+   * Returns the number of threads that can work on a parallel computation, that is, the
+   * worker threads of this pool and the thread that starts the computation.
+   */
+  size_t concurrency() const { return num_workers() + 1; }
+
+  /**
+   * Indicates whether the calling thread is a worker of this pool.
+   */
+  bool is_worker_thread() const { return current_worker().pool == this; }
+
+  /**
+   * Submits the given task for execution by a worker thread.
+   */
+  void submit(task t)
+  {
+    if (m_queues.empty())
+    {
+      t();
+      return;
+    }
+
+    const auto& worker = current_worker();
+    const auto queue_index = worker.pool == this
+                               ? worker.index
+                               : m_nextQueue.fetch_add(1) % m_queues.size();
+
+    auto& queue = *m_queues[queue_index];
+    {
+      // count the task before publishing it, otherwise a worker could take it and
+      // decrement the pending task count before it was incremented
+      const auto lock = std::lock_guard{m_mutex};
+      ++m_pendingTasks;
+
+      const auto queue_lock = std::lock_guard{queue.mutex};
+      queue.tasks.push_back(std::move(t));
+    }
+    m_condition.notify_one();
+  }
+
+private:
+  static worker_info& current_worker()
+  {
+    static thread_local auto info = worker_info{};
+    return info;
+  }
+
+  std::optional<task> take_task(const size_t index)
+  {
+    auto result = pop_back(*m_queues[index]);
+    for (size_t i = 1; !result && i < m_queues.size(); ++i)
+    {
+      result = pop_front(*m_queues[(index + i) % m_queues.size()]);
+    }
+
+    if (result)
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      --m_pendingTasks;
+    }
+    return result;
+  }
+
+  static std::optional<task> pop_back(task_queue& queue)
+  {
+    const auto lock = std::lock_guard{queue.mutex};
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+    auto result = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return result;
+  }
+
+  static std::optional<task> pop_front(task_queue& queue)
+  {
+    const auto lock = std::lock_guard{queue.mutex};
+    if (queue.tasks.empty())
+    {
+      return std::nullopt;
+    }
+    auto result = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return result;
+  }
+
+  void run_worker(const size_t index)
+  {
+    current_worker() = worker_info{this, index};
+
+    while (true)
+    {
+      if (auto t = take_task(index))
+      {
+        (*t)();
+        continue;
+      }
+
+      auto lock = std::unique_lock{m_mutex};
+      m_condition.wait(lock, [&]() { return m_stop || m_pendingTasks > 0; });
+      if (m_stop && m_pendingTasks == 0)
+      {
+        return;
+      }
+    }
+  }
+};
+
+namespace detail
+{
+inline std::atomic<size_t>& default_thread_pool_concurrency()
+{
+  static auto concurrency = std::atomic<size_t>{0};
+  return concurrency;
+}
+
+inline std::atomic<bool>& default_thread_pool_created()
+{
+  static auto created = std::atomic<bool>{false};
+  return created;
+}
+} // namespace detail
+
+/**
+ * Sets the concurrency of the default thread pool, i.e. the number of worker threads plus
+ * one for the calling thread. A value of 0 selects the number of threads returned by
+ * std::thread::hardware_concurrency(), a value of 1 disables parallel execution.
+ *
+ * This has no effect once the default thread pool has been created.
+ *
+ * @param concurrency the concurrency
+ * @return true if the value was applied and false if the pool was already created
+ */
+inline bool set_default_thread_pool_concurrency(const size_t concurrency)
+{
+  if (detail::default_thread_pool_created())
+  {
+    return false;
+  }
+  detail::default_thread_pool_concurrency() = concurrency;
+  return true;
+}
+
+/**
+ * Returns the process wide thread pool, creating it on first use.
+ */
+inline thread_pool& default_thread_pool()
+{
+  static auto pool = []() {
+    detail::default_thread_pool_created() = true;
+
+    auto concurrency = detail::default_thread_pool_concurrency().load();
+    if (concurrency == 0)
+    {
+      concurrency = static_cast<size_t>(std::thread::hardware_concurrency());
+    }
+    return std::make_unique<thread_pool>(concurrency > 1 ? concurrency - 1 : 0);
+  }();
+  return *pool;
+}
+} // namespace kdl
@@ -0,0 +1,225 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/block_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+TEST_CASE("block_pool.allocate")
+{
+  using pool = block_pool<24, 8, 4>;
+
+  auto blocks = std::vector<void*>{};
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    blocks.push_back(pool::allocate());
+  }
+
+  CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+  CHECK(std::all_of(blocks.begin(), blocks.end(), [](const auto* block) {
+    return reinterpret_cast<std::uintptr_t>(block) % 8u == 0u;
+  }));
+
+  for (auto* block : blocks)
+  {
+    pool::deallocate(block);
+  }
+}
+
+TEST_CASE("block_pool.deallocate")
+{
+  using pool = block_pool<16, 16, 4>;
+
+  SECTION("Deallocated blocks are reused")
+  {
+    auto* block = pool::allocate();
+    pool::deallocate(block);
+    CHECK(pool::allocate() == block);
+    pool::deallocate(block);
+  }
+
+  SECTION("Deallocating null does nothing")
+  {
+    pool::deallocate(nullptr);
+    auto* block = pool::allocate();
+    CHECK(block != nullptr);
+    pool::deallocate(block);
+  }
+}
+
+TEST_CASE("block_pool.threads")
+{
+  using pool = block_pool<32, 8, 16>;
+
+  // a multiple of the batch size, so that all allocated chunks are used up
+  constexpr auto NumBlocks = std::size_t(1024);
+
+  // allocate on one thread and deallocate on another
+  auto blocks = std::vector<void*>{};
+  auto allocator = std::thread{[&]() {
+    for (std::size_t i = 0; i < NumBlocks; ++i)
+    {
+      blocks.push_back(pool::allocate());
+      *static_cast<std::size_t*>(blocks.back()) = i;
+    }
+  }};
+  allocator.join();
+
+  auto deallocator = std::thread{[&]() {
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+  }};
+  deallocator.join();
+
+  // the blocks returned by the exited threads are available to this thread
+  auto reused = std::vector<void*>{};
+  for (std::size_t i = 0; i < NumBlocks; ++i)
+  {
+    reused.push_back(pool::allocate());
+  }
+
+  std::sort(blocks.begin(), blocks.end());
+  std::sort(reused.begin(), reused.end());
+  CHECK(reused == blocks);
+
+  for (auto* block : reused)
+  {
+    pool::deallocate(block);
+  }
+}
+
+TEST_CASE("block_pool.deallocateAfterThreadExit")
+{
+  using pool = block_pool<8, 8, 4>;
+
+  struct late_deallocator
+  {
+    void* block = nullptr;
+
+    ~late_deallocator() { pool::deallocate(block); }
+  };
+
+  auto* block = static_cast<void*>(nullptr);
+  auto thread = std::thread{[&]() {
+    // constructed before the pool's thread local state, so it is destroyed after it
+    thread_local auto deallocator = late_deallocator{};
+    block = pool::allocate();
+    deallocator.block = block;
+  }};
+  thread.join();
+
+  // the block was put into the shared free list and is available to this thread
+  auto reused = std::vector<void*>{};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    reused.push_back(pool::allocate());
+  }
+
+  CHECK(std::find(reused.begin(), reused.end(), block) != reused.end());
+
+  for (auto* reusedBlock : reused)
+  {
+    pool::deallocate(reusedBlock);
+  }
+}
+
+TEST_CASE("block_pool.trim")
+{
+  using pool = block_pool<40, 8, 4>;
+
+  auto blocks = std::vector<void*>{};
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    blocks.push_back(pool::allocate());
+  }
+  REQUIRE(pool::chunk_count() == 2u);
+
+  SECTION("Chunks with blocks in use are kept")
+  {
+    pool::trim();
+    CHECK(pool::chunk_count() == 2u);
+
+    for (auto* block : blocks)
+    {
+      pool::deallocate(block);
+    }
+  }
+
+  SECTION("Free chunks are released")
+  {
+    // the first four blocks belong to the same chunk
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      pool::deallocate(blocks[i]);
+    }
+
+    pool::trim();
+    CHECK(pool::chunk_count() == 1u);
+
+    for (std::size_t i = 4; i < 8; ++i)
+    {
+      pool::deallocate(blocks[i]);
+    }
+
+    trim_block_pools();
+    CHECK(pool::chunk_count() == 0u);
+
+    // the pool can still be used after all chunks were released
+    auto* block = pool::allocate();
+    CHECK(pool::chunk_count() == 1u);
+    pool::deallocate(block);
+  }
+}
+
+TEST_CASE("pool_allocator")
+{
+  using allocator = pool_allocator<std::pair<const int, int>>;
+
+  auto map = std::map<int, int, std::less<int>, allocator>{};
+  for (int i = 0; i < 1000; ++i)
+  {
+    map[i] = 2 * i;
+  }
+
+  CHECK(map.size() == 1000u);
+  CHECK(map[500] == 1000);
+
+  map.clear();
+  CHECK(map.empty());
+
+  auto vector = std::vector<int, pool_allocator<int>>{};
+  for (int i = 0; i < 1000; ++i)
+  {
+    vector.push_back(i);
+  }
+  CHECK(vector[999] == 999);
+}
+} // namespace kdl
@@ -0,0 +1,294 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/flat_hash_map.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+namespace
+{
+// maps all keys to a few hash values to provoke long probe sequences
+struct bad_hash
+{
+  std::size_t operator()(const int i) const { return std::size_t(i % 3); }
+};
+
+template <typename Map>
+std::vector<typename Map::value_type> sorted_entries(const Map& map)
+{
+  auto result =
+    std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>>{};
+  for (const auto& [key, value] : map)
+  {
+    result.emplace_back(key, value);
+  }
+  std::sort(result.begin(), result.end());
+  return {result.begin(), result.end()};
+}
+} // namespace
+
+TEST_CASE("flat_hash_map.constructor")
+{
+  SECTION("default constructor")
+  {
+    const auto m = flat_hash_map<int, std::string>{};
+    CHECK(m.empty());
+    CHECK(m.size() == 0u);
+    CHECK(m.capacity() == 0u);
+    CHECK(m.begin() == m.end());
+  }
+
+  SECTION("initializer list")
+  {
+    const auto m = flat_hash_map<int, std::string>{{1, "a"}, {2, "b"}, {1, "c"}};
+    CHECK(m.size() == 2u);
+    CHECK(m.at(1) == "a");
+    CHECK(m.at(2) == "b");
+  }
+}
+
+TEST_CASE("flat_hash_map.copy_and_move")
+{
+  auto m = flat_hash_map<int, std::string>{{1, "a"}, {2, "b"}};
+
+  auto copy = m;
+  CHECK(copy == m);
+
+  copy[3] = "c";
+  CHECK(copy != m);
+  CHECK(m.count(3) == 0u);
+
+  copy = m;
+  CHECK(copy == m);
+
+  auto moved = std::move(copy);
+  CHECK(moved == m);
+  CHECK(copy.empty());
+  CHECK(copy.find(1) == copy.end());
+
+  copy = std::move(moved);
+  CHECK(copy == m);
+}
+
+TEST_CASE("flat_hash_map.insert")
+{
+  auto m = flat_hash_map<int, std::string>{};
+
+  auto [it1, inserted1] = m.insert({1, "a"});
+  CHECK(inserted1);
+  CHECK(it1->first == 1);
+  CHECK(it1->second == "a");
+
+  auto [it2, inserted2] = m.insert({1, "b"});
+  CHECK_FALSE(inserted2);
+  CHECK(it2->second == "a");
+
+  auto [it3, inserted3] = m.try_emplace(2, 3u, 'x');
+  CHECK(inserted3);
+  CHECK(it3->second == "xxx");
+
+  auto [it4, inserted4] = m.insert_or_assign(2, "y");
+  CHECK_FALSE(inserted4);
+  CHECK(it4->second == "y");
+
+  CHECK(m.size() == 2u);
+}
+
+TEST_CASE("flat_hash_map.subscript")
+{
+  auto m = flat_hash_map<int, int>{};
+  m[1] += 2;
+  m[1] += 3;
+  m[2] = 7;
+
+  CHECK(m.size() == 2u);
+  CHECK(m[1] == 5);
+  CHECK(m[2] == 7);
+}
+
+TEST_CASE("flat_hash_map.at")
+{
+  auto m = flat_hash_map<int, int>{{1, 2}};
+  CHECK(m.at(1) == 2);
+  CHECK_THROWS_AS(m.at(2), std::out_of_range);
+
+  const auto& cm = m;
+  CHECK(cm.at(1) == 2);
+  CHECK_THROWS_AS(cm.at(2), std::out_of_range);
+}
+
+TEST_CASE("flat_hash_map.find")
+{
+  auto m = flat_hash_map<int, int>{{1, 2}, {3, 4}};
+  CHECK(m.find(1) != m.end());
+  CHECK(m.find(1)->second == 2);
+  CHECK(m.find(2) == m.end());
+  CHECK(m.count(3) == 1u);
+  CHECK(m.count(4) == 0u);
+
+  m.find(3)->second = 5;
+  CHECK(m.at(3) == 5);
+}
+
+TEST_CASE("flat_hash_map.erase")
+{
+  auto m = flat_hash_map<int, int, bad_hash>{};
+  for (int i = 0; i < 100; ++i)
+  {
+    m[i] = i * 2;
+  }
+
+  SECTION("erase by key")
+  {
+    for (int i = 0; i < 100; i += 2)
+    {
+      CHECK(m.erase(i) == 1u);
+    }
+    CHECK(m.erase(0) == 0u);
+    CHECK(m.size() == 50u);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      CHECK(m.count(i) == (i % 2 == 0 ? 0u : 1u));
+    }
+  }
+
+  SECTION("erase by iterator")
+  {
+    m.erase(m.find(50));
+    CHECK(m.size() == 99u);
+    CHECK(m.find(50) == m.end());
+    for (int i = 0; i < 100; ++i)
+    {
+      if (i != 50)
+      {
+        CHECK(m.at(i) == i * 2);
+      }
+    }
+  }
+}
+
+TEST_CASE("flat_hash_map.clear")
+{
+  auto m = flat_hash_map<int, int>{{1, 2}, {3, 4}};
+  const auto capacity = m.capacity();
+
+  m.clear();
+  CHECK(m.empty());
+  CHECK(m.begin() == m.end());
+  CHECK(m.capacity() == capacity);
+
+  m[5] = 6;
+  CHECK(m.size() == 1u);
+  CHECK(m.at(5) == 6);
+}
+
+TEST_CASE("flat_hash_map.reserve")
+{
+  auto m = flat_hash_map<int, int>{};
+  m.reserve(100u);
+  const auto capacity = m.capacity();
+  CHECK(capacity >= 100u);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    m[i] = i;
+  }
+  CHECK(m.capacity() == capacity);
+}
+
+TEST_CASE("flat_hash_map.pointer_keys")
+{
+  auto values = std::vector<std::unique_ptr<int>>{};
+  auto m = flat_hash_map<const int*, int>{};
+  for (int i = 0; i < 1000; ++i)
+  {
+    values.push_back(std::make_unique<int>(i));
+    m[values.back().get()] = i;
+  }
+
+  CHECK(m.size() == 1000u);
+  for (const auto& value : values)
+  {
+    CHECK(m.at(value.get()) == *value);
+  }
+}
+
+TEST_CASE("flat_hash_map.move_only_values")
+{
+  auto m = flat_hash_map<int, std::unique_ptr<int>>{};
+  for (int i = 0; i < 100; ++i)
+  {
+    m.try_emplace(i, std::make_unique<int>(i));
+  }
+  for (int i = 0; i < 100; i += 3)
+  {
+    m.erase(i);
+  }
+  for (int i = 0; i < 100; ++i)
+  {
+    const auto it = m.find(i);
+    if (i % 3 == 0)
+    {
+      CHECK(it == m.end());
+    }
+    else
+    {
+      REQUIRE(it != m.end());
+      CHECK(*it->second == i);
+    }
+  }
+}
+
+TEST_CASE("flat_hash_map.matches_unordered_map")
+{
+  auto rng = std::mt19937{42};
+  auto dist = std::uniform_int_distribution<int>{0, 499};
+
+  auto expected = std::unordered_map<int, int>{};
+  auto actual = flat_hash_map<int, int, bad_hash>{};
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    const auto key = dist(rng);
+    if (dist(rng) % 3 == 0)
+    {
+      CHECK(actual.erase(key) == expected.erase(key));
+    }
+    else
+    {
+      expected[key] = i;
+      actual[key] = i;
+    }
+  }
+
+  CHECK(actual.size() == expected.size());
+  CHECK(sorted_entries(actual) == sorted_entries(expected));
+}
+} // namespace kdl
@@ -0,0 +1,165 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/flat_hash_set.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+namespace
+{
+// maps all values to a few hash values to provoke long probe sequences
+struct bad_hash
+{
+  std::size_t operator()(const int i) const { return std::size_t(i % 3); }
+};
+
+template <typename Set>
+std::vector<int> sorted_values(const Set& set)
+{
+  auto result = std::vector<int>{set.begin(), set.end()};
+  std::sort(result.begin(), result.end());
+  return result;
+}
+} // namespace
+
+TEST_CASE("flat_hash_set.constructor")
+{
+  SECTION("default constructor")
+  {
+    const auto s = flat_hash_set<int>{};
+    CHECK(s.empty());
+    CHECK(s.size() == 0u);
+    CHECK(s.begin() == s.end());
+  }
+
+  SECTION("initializer list")
+  {
+    const auto s = flat_hash_set<int>{3, 1, 2, 1};
+    CHECK(s.size() == 3u);
+    CHECK(sorted_values(s) == std::vector<int>{1, 2, 3});
+  }
+}
+
+TEST_CASE("flat_hash_set.copy_and_move")
+{
+  auto s = flat_hash_set<std::string>{"a", "b"};
+
+  auto copy = s;
+  CHECK(copy == s);
+
+  copy.insert("c");
+  CHECK(copy != s);
+  CHECK(s.count("c") == 0u);
+
+  copy = s;
+  CHECK(copy == s);
+
+  auto moved = std::move(copy);
+  CHECK(moved == s);
+  CHECK(copy.empty());
+}
+
+TEST_CASE("flat_hash_set.insert")
+{
+  auto s = flat_hash_set<std::string>{};
+
+  auto [it1, inserted1] = s.insert("a");
+  CHECK(inserted1);
+  CHECK(*it1 == "a");
+
+  const auto b = std::string{"b"};
+  auto [it2, inserted2] = s.insert(b);
+  CHECK(inserted2);
+  CHECK(*it2 == "b");
+
+  auto [it3, inserted3] = s.insert("a");
+  CHECK_FALSE(inserted3);
+  CHECK(*it3 == "a");
+
+  CHECK(s.size() == 2u);
+}
+
+TEST_CASE("flat_hash_set.erase")
+{
+  auto s = flat_hash_set<int, bad_hash>{};
+  for (int i = 0; i < 100; ++i)
+  {
+    s.insert(i);
+  }
+
+  for (int i = 0; i < 100; i += 2)
+  {
+    CHECK(s.erase(i) == 1u);
+  }
+  CHECK(s.erase(0) == 0u);
+
+  s.erase(s.find(1));
+  CHECK(s.size() == 49u);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    CHECK(s.count(i) == (i % 2 == 0 || i == 1 ? 0u : 1u));
+  }
+}
+
+TEST_CASE("flat_hash_set.clear")
+{
+  auto s = flat_hash_set<int>{1, 2, 3};
+  const auto capacity = s.capacity();
+
+  s.clear();
+  CHECK(s.empty());
+  CHECK(s.begin() == s.end());
+  CHECK(s.capacity() == capacity);
+  CHECK(s.count(1) == 0u);
+}
+
+TEST_CASE("flat_hash_set.matches_unordered_set")
+{
+  auto rng = std::mt19937{7};
+  auto dist = std::uniform_int_distribution<int>{0, 999};
+
+  auto expected = std::unordered_set<int>{};
+  auto actual = flat_hash_set<int>{};
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    const auto value = dist(rng);
+    if (dist(rng) % 2 == 0)
+    {
+      CHECK(actual.erase(value) == expected.erase(value));
+    }
+    else
+    {
+      CHECK(actual.insert(value).second == expected.insert(value).second);
+    }
+  }
+
+  CHECK(actual.size() == expected.size());
+  CHECK(sorted_values(actual) == sorted_values(expected));
+}
+} // namespace kdl
@@ -0,0 +1,140 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#include "kdl/interned_string.h"
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+TEST_CASE("interned_string.constructor")
+{
+  CHECK(interned_string{}.str() == "");
+  CHECK(interned_string{}.empty());
+  CHECK(interned_string{}.str().data() == interned_string{""}.str().data());
+
+  const auto s = interned_string{"some_texture"};
+  CHECK(s.str() == "some_texture");
+  CHECK_FALSE(s.empty());
+  CHECK(&s.str() == &interned_string{std::string{"some_texture"}}.str());
+  CHECK(&s.str() != &interned_string{"other_texture"}.str());
+}
+
+TEST_CASE("interned_string.pool_size")
+{
+  const auto before = interned_string::pool_size();
+  const auto s1 = interned_string{"interned_string.pool_size"};
+  CHECK(interned_string::pool_size() == before + 1u);
+
+  const auto s2 = interned_string{"interned_string.pool_size"};
+  const auto s3 = s1;
+  CHECK(s2 == s1);
+  CHECK(s3 == s1);
+  CHECK(interned_string::pool_size() == before + 1u);
+}
+
+TEST_CASE("interned_string.compare")
+{
+  const auto a = interned_string{"a"};
+  const auto b = interned_string{"b"};
+
+  CHECK(a == interned_string{"a"});
+  CHECK_FALSE(a == b);
+  CHECK(a != b);
+  CHECK_FALSE(a != interned_string{"a"});
+
+  CHECK(a < b);
+  CHECK_FALSE(b < a);
+  CHECK_FALSE(a < a);
+  CHECK(a <= a);
+  CHECK(a <= b);
+  CHECK(b > a);
+  CHECK(b >= b);
+  CHECK_FALSE(a >= b);
+
+  CHECK(a == "a");
+  CHECK("a" == a);
+  CHECK(a == std::string{"a"});
+  CHECK(a != "b");
+  CHECK("b" != a);
+
+  // ordering is lexicographic and does not depend on the order of interning
+  const auto strings = std::set<interned_string>{
+    interned_string{"zz"}, interned_string{"aa"}, interned_string{"mm"}};
+  CHECK(
+    std::vector<interned_string>{strings.begin(), strings.end()}
+    == std::vector<interned_string>{
+      interned_string{"aa"}, interned_string{"mm"}, interned_string{"zz"}});
+}
+
+TEST_CASE("interned_string.hash")
+{
+  const auto strings = std::unordered_set<interned_string>{
+    interned_string{"a"}, interned_string{"b"}, interned_string{"a"}};
+  CHECK(strings.size() == 2u);
+  CHECK(strings.count(interned_string{"a"}) == 1u);
+  CHECK(strings.count(interned_string{"c"}) == 0u);
+}
+
+TEST_CASE("interned_string.stream_insertion")
+{
+  auto str = std::stringstream{};
+  str << interned_string{"some_texture"};
+  CHECK(str.str() == "some_texture");
+}
+
+TEST_CASE("interned_string.threads")
+{
+  constexpr auto NumThreads = 4u;
+  constexpr auto NumStrings = 1000u;
+
+  auto results = std::vector<std::vector<const std::string*>>(NumThreads);
+  auto threads = std::vector<std::thread>{};
+  for (std::size_t t = 0; t < NumThreads; ++t)
+  {
+    threads.emplace_back([&, t]() {
+      for (std::size_t i = 0; i < NumStrings; ++i)
+      {
+        const auto s = interned_string{"interned_string.threads." + std::to_string(i)};
+        results[t].push_back(&s.str());
+      }
+    });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (std::size_t t = 1; t < NumThreads; ++t)
+  {
+    CHECK(results[t] == results[0]);
+  }
+  const auto distinct =
+    std::set<const std::string*>{results[0].begin(), results[0].end()};
+  CHECK(distinct.size() == NumStrings);
+}
+} // namespace kdl
@@ -26,7 +26,9 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <catch2/catch.hpp>
@@ -73,6 +75,75 @@ TEST_CASE("for 10000")
   }
 }
 
+TEST_CASE("for with custom thread pool")
+{
+  constexpr size_t TestSize = 1'000;
+
+  for (const size_t numWorkers : {0u, 1u, 3u})
+  {
+    auto pool = kdl::thread_pool{numWorkers};
+
+    auto sum = std::atomic<size_t>{0};
+    kdl::parallel_for(
+      TestSize, [&](const size_t i) { std::atomic_fetch_add(&sum, i); }, pool);
+
+    CHECK(sum == TestSize * (TestSize - 1) / 2);
+  }
+}
+
+TEST_CASE("for nested")
+{
+  constexpr size_t OuterSize = 64;
+  constexpr size_t InnerSize = 64;
+
+  // use a single worker to ensure that the nested loops cannot rely on idle workers
+  auto pool = kdl::thread_pool{1};
+
+  std::array<std::atomic<size_t>, OuterSize * InnerSize> counts;
+  for (auto& count : counts)
+  {
+    count = 0;
+  }
+
+  kdl::parallel_for(
+    OuterSize,
+    [&](const size_t i) {
+      kdl::parallel_for(
+        InnerSize,
+        [&](const size_t j) { std::atomic_fetch_add(&counts[i * InnerSize + j], 1u); },
+        pool);
+    },
+    pool);
+
+  for (const auto& count : counts)
+  {
+    CHECK(count == 1u);
+  }
+}
+
+TEST_CASE("for rethrows exception")
+{
+  auto pool = kdl::thread_pool{3};
+
+  CHECK_THROWS_AS(
+    kdl::parallel_for(
+      10'000,
+      [](const size_t i) {
+        if (i == 5'000)
+        {
+          throw std::runtime_error{"error"};
+        }
+      },
+      pool),
+    std::runtime_error);
+
+  // the pool remains usable
+  auto count = std::atomic<size_t>{0};
+  kdl::parallel_for(
+    100, [&](const size_t) { std::atomic_fetch_add(&count, size_t(1)); }, pool);
+  CHECK(count == 100u);
+}
+
 TEST_CASE("transform")
 {
   const auto L = [](const int& v) { return v * 10; };
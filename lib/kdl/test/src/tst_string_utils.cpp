@@ -20,8 +20,10 @@
 
 #include "kdl/string_utils.h"
 
+#include <cmath>
 #include <optional>
 #include <ostream>
+#include <random>
 
 #include <catch2/catch.hpp>
 
@@ -149,6 +151,31 @@ TEST_CASE("string_format_test.str_to_long")
   CHECK(str_to_long("") == std::nullopt);
 }
 
+TEST_CASE("string_format_test.str_to_long_range")
+{
+  const auto str_to_long_range = [](const std::string& str) {
+    return str_to_long(str.data(), str.data() + str.size());
+  };
+
+  CHECK(str_to_long_range("0") == std::optional<long>{0l});
+  CHECK(str_to_long_range("+1") == std::optional<long>{1l});
+  CHECK(str_to_long_range("123231") == std::optional<long>{123231l});
+  CHECK(str_to_long_range("-123231") == std::optional<long>{-123231l});
+  CHECK(str_to_long_range("2147483647") == std::optional<long>{2147483647l});
+  CHECK(str_to_long_range("-2147483646") == std::optional<long>{-2147483646l});
+  CHECK(str_to_long_range("123231b") == std::optional<long>{123231l});
+  CHECK(str_to_long_range("   123231   ") == std::optional<long>{123231l});
+  CHECK(str_to_long_range("a123231") == std::nullopt);
+  CHECK(str_to_long_range("-") == std::nullopt);
+  CHECK(str_to_long_range(" ") == std::nullopt);
+  CHECK(str_to_long_range("") == std::nullopt);
+  CHECK(str_to_long_range("99999999999999999999999") == std::nullopt);
+
+  // the range must not be null terminated
+  const auto str = std::string{"12345"};
+  CHECK(str_to_long(str.data(), str.data() + 3) == std::optional<long>{123l});
+}
+
 TEST_CASE("string_format_test.str_to_long_long")
 {
   CHECK(str_to_long_long("0") == std::optional<long long>{0ll});
@@ -233,6 +260,64 @@ TEST_CASE("string_format_test.str_to_double")
   CHECK(str_to_double("") == std::nullopt);
 }
 
+TEST_CASE("string_format_test.str_to_double_range")
+{
+  const auto str_to_double_range = [](const std::string& str) {
+    return str_to_double(str.data(), str.data() + str.size());
+  };
+
+  CHECK(str_to_double_range("0") == std::optional<double>{0.0});
+  CHECK(str_to_double_range("1.0") == std::optional<double>{1.0});
+  CHECK(str_to_double_range("+1.5") == std::optional<double>{1.5});
+  CHECK(str_to_double_range("-64") == std::optional<double>{-64.0});
+  CHECK(str_to_double_range(".25") == std::optional<double>{0.25});
+  CHECK(str_to_double_range("2.") == std::optional<double>{2.0});
+  CHECK(str_to_double_range("1e3") == std::optional<double>{1000.0});
+  CHECK(str_to_double_range("1.5e-3") == std::optional<double>{0.0015});
+  CHECK(str_to_double_range("0x10") == std::optional<double>{16.0});
+  CHECK(str_to_double_range("1e") == std::optional<double>{1.0});
+  CHECK(str_to_double_range("  2.5") == std::optional<double>{2.5});
+  CHECK(str_to_double_range("a123231.0") == std::nullopt);
+  CHECK(str_to_double_range("-") == std::nullopt);
+  CHECK(str_to_double_range(".") == std::nullopt);
+  CHECK(str_to_double_range(" ") == std::nullopt);
+  CHECK(str_to_double_range("") == std::nullopt);
+  CHECK(str_to_double_range("1e999") == std::nullopt);
+
+  const auto negativeZero = str_to_double_range("-0");
+  CHECK(negativeZero == std::optional<double>{0.0});
+  CHECK(std::signbit(*negativeZero));
+
+  // the range must not be null terminated
+  const auto str = std::string{"1.2345"};
+  CHECK(str_to_double(str.data(), str.data() + 3) == std::optional<double>{1.2});
+
+  SECTION("results are identical to str_to_double(const std::string&)")
+  {
+    auto rng = std::mt19937{0};
+    auto mantissas = std::uniform_int_distribution<long long>{
+      -999'999'999'999'999'999ll, 999'999'999'999'999'999ll};
+    auto digits = std::uniform_int_distribution<int>{0, 19};
+    auto exponents = std::uniform_int_distribution<int>{-30, 30};
+
+    for (size_t i = 0; i < 100'000; ++i)
+    {
+      auto mantissa = std::to_string(mantissas(rng));
+      const auto pointPosition = size_t(digits(rng));
+      if (pointPosition < mantissa.size())
+      {
+        mantissa.insert(mantissa.size() - pointPosition, ".");
+      }
+      if (i % 2 == 0)
+      {
+        mantissa += "e" + std::to_string(exponents(rng));
+      }
+
+      CHECK(str_to_double_range(mantissa) == str_to_double(mantissa));
+    }
+  }
+}
+
 TEST_CASE("string_format_test.str_to_long_double")
 {
   CHECK(str_to_long_double("0") == std::optional<long double>{0.0L});
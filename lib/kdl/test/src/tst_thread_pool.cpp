@@ -0,0 +1,140 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace kdl
+{
+namespace
+{
+class latch
+{
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  size_t m_count;
+
+public:
+  explicit latch(const size_t count)
+    : m_count{count}
+  {
+  }
+
+  void count_down()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    --m_count;
+    m_condition.notify_all();
+  }
+
+  void wait()
+  {
+    auto lock = std::unique_lock{m_mutex};
+    m_condition.wait(lock, [&]() { return m_count == 0; });
+  }
+};
+} // namespace
+
+TEST_CASE("thread_pool.concurrency")
+{
+  CHECK(thread_pool{0}.num_workers() == 0u);
+  CHECK(thread_pool{0}.concurrency() == 1u);
+  CHECK(thread_pool{3}.num_workers() == 3u);
+  CHECK(thread_pool{3}.concurrency() == 4u);
+}
+
+TEST_CASE("thread_pool.submit")
+{
+  SECTION("without workers, tasks run on the submitting thread")
+  {
+    auto pool = thread_pool{0};
+
+    auto thread_id = std::thread::id{};
+    pool.submit([&]() { thread_id = std::this_thread::get_id(); });
+    CHECK(thread_id == std::this_thread::get_id());
+  }
+
+  SECTION("with workers, tasks run on worker threads")
+  {
+    constexpr size_t NumTasks = 1000;
+    auto pool = thread_pool{4};
+
+    auto done = latch{NumTasks};
+    auto ran_on_worker = std::atomic<size_t>{0};
+    for (size_t i = 0; i < NumTasks; ++i)
+    {
+      pool.submit([&]() {
+        if (pool.is_worker_thread())
+        {
+          ++ran_on_worker;
+        }
+        done.count_down();
+      });
+    }
+
+    done.wait();
+    CHECK(ran_on_worker == NumTasks);
+    CHECK_FALSE(pool.is_worker_thread());
+  }
+
+  SECTION("tasks can submit tasks")
+  {
+    constexpr size_t NumTasks = 100;
+    auto pool = thread_pool{2};
+
+    auto done = latch{NumTasks * NumTasks};
+    for (size_t i = 0; i < NumTasks; ++i)
+    {
+      pool.submit([&]() {
+        for (size_t j = 0; j < NumTasks; ++j)
+        {
+          pool.submit([&]() { done.count_down(); });
+        }
+      });
+    }
+
+    done.wait();
+  }
+}
+
+TEST_CASE("thread_pool.destructor_runs_pending_tasks")
+{
+  constexpr size_t NumTasks = 1000;
+  auto count = std::atomic<size_t>{0};
+
+  {
+    auto pool = thread_pool{2};
+    for (size_t i = 0; i < NumTasks; ++i)
+    {
+      pool.submit([&]() { ++count; });
+    }
+  }
+
+  CHECK(count == NumTasks);
+}
+} // namespace kdl